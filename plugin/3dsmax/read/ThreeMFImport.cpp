@@ -26,11 +26,17 @@
 #include "utility.h"
 #include "types.h"
 
+#include <conversion.h>
+#include <parallel.h>
+
 #include <Max.h>
 #include <color.h>
 
 #include <stdmat.h>
 
+#include <algorithm>
+#include <vector>
+
 ClassDesc2* GetThreeMFImportDesc()
 {
     static M3mf::ThreeMFImportClassDesc threeMfClassDesc;
@@ -39,6 +45,13 @@ ClassDesc2* GetThreeMFImportDesc()
 
 namespace M3mf {
 
+namespace {
+
+// vertices and faces filled per task
+constexpr size_t chunkSize { 65536 };
+
+} // namespace
+
 ThreeMFImport::ThreeMFImport()
 {
 }
@@ -119,75 +132,58 @@ bool ThreeMFImport::read(std::wstring_view fileName)
     Lib3MF::PWrapper wrapper = Lib3MF::CWrapper::loadLibrary();
     Lib3MF::PModel model = wrapper->CreateModel();
     Lib3MF::PReader reader3MF = model->QueryReader("3mf");
+
+    // convert the build items into meshes and their instances, only the node creation below
+    // depends on the host
+    SceneData scene;
     try {
         reader3MF->ReadFromFile(wstring_to_utf8(fileName.data()));
+        importModel(model, scene);
     } catch (Lib3MF::ELib3MFException e) {
-        return e.getErrorCode();
+        return false;
     }
 
-    // iterate through builditem(s)
-    Lib3MF::PBuildItemIterator buildItemIterator = model->GetBuildItems();
-    while (buildItemIterator->MoveNext()) {
-        Lib3MF::PBuildItem buildItem = buildItemIterator->GetCurrent();
-        Lib3MF::PObject object = buildItem->GetObjectResource();
-
-        // name
-        std::string_view objectName;
-        if (object->GetName().empty()) {
-            const std::string name { "Object_" + std::to_string(buildItem->GetObjectResourceID()) };
-            objectName = name;
-        } else {
-            objectName = object->GetName();
-        }
+    // one standard material per distinct material, shared by all the nodes using it
+    std::vector<StdMat2*> materials;
+    materials.reserve(scene.materials.size());
+    for (const MaterialData& material : scene.materials) {
+        materials.push_back(createMaterial(material.color));
+    }
 
-        // transform
-        sLib3MFTransform affineTransform;
-        if (buildItem->HasObjectTransform()) {
-            affineTransform = std::move(buildItem->GetObjectTransform());
-        } else {
-            affineTransform = std::move(wrapper->GetIdentityTransform());
+    // the material of every mesh, a Multi/Sub-Object material over its face MatIDs
+    // if the mesh has several
+    std::vector<Mtl*> meshMaterials(scene.meshes.size());
+    for (size_t index = 0; index < scene.meshes.size(); ++index) {
+        const MeshData& mesh = scene.meshes[index];
+        if (mesh.sceneMaterials.size() == 1) {
+            meshMaterials[index] = materials[mesh.sceneMaterials[0]];
+            continue;
         }
 
-        // components
-        if (object->IsComponentsObject()) {
-            Lib3MF::PComponentsObject componentsObject = model->GetComponentsObjectByID(object->GetResourceID());
-
-            // we care only about model. ignore support, solidsupport, other
-            if (componentsObject->GetType() == Lib3MF::eObjectType::Model) {
-                for (uint32_t nIndex = 0; nIndex < componentsObject->GetComponentCount(); nIndex++) {
-                    Lib3MF::PComponent component = componentsObject->GetComponent(nIndex);
-
-                    sLib3MFTransform compAffineTransform;
-                    if (component->HasTransform()) {
-                        compAffineTransform = std::move(component->GetTransform());
-                    } else {
-                        compAffineTransform = std::move(affineTransform);
-                    }
-
-                    Lib3MF::PMeshObject meshObject = model->GetMeshObjectByID(component->GetObjectResourceID());
-                    bool status = createMeshObject(wrapper, model, meshObject, compAffineTransform, objectName);
-                    if (!status) {
-                        return false;
-                    }
-                }
-            }
+        MultiMtl* multiMaterial = NewDefaultMultiMtl();
+        multiMaterial->SetName(_T("Multi Material"));
+        multiMaterial->SetNumSubMtls(static_cast<int>(mesh.sceneMaterials.size()));
+        for (size_t slot = 0; slot < mesh.sceneMaterials.size(); ++slot) {
+            multiMaterial->SetSubMtl(static_cast<int>(slot), materials[mesh.sceneMaterials[slot]]);
         }
+        meshMaterials[index] = multiMaterial;
+    }
 
-        // mesh
-        if (object->IsMeshObject()) {
-            Lib3MF::PMeshObject meshObject = model->GetMeshObjectByID(object->GetResourceID());
-            bool status = createMeshObject(wrapper, model, meshObject, affineTransform, objectName);
-
-            if (!status) {
-                return false;
-            }
+    bool status { true };
+    for (const MeshInstance& instance : scene.instances) {
+        status = createMeshObject(scene.meshes[instance.mesh], instance, meshMaterials[instance.mesh]);
+        if (!status) {
+            break;
         }
     }
 
-    return true;
+    // draw update, once for all nodes
+    _impInterface->RedrawViews();
+
+    return status;
 }
 
-bool ThreeMFImport::createMeshObject(const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model, const Lib3MF::PMeshObject& mesh, const sLib3MFTransform& transform, std::string_view objectName)
+bool ThreeMFImport::createMeshObject(const MeshData& mesh, const MeshInstance& instance, Mtl* material)
 {
     bool status { true };
 
@@ -200,60 +196,42 @@ bool ThreeMFImport::createMeshObject(const Lib3MF::PWrapper& wrapper, const Lib3
     // get the pointer to the Mesh
     Mesh* mMesh = &object->GetMesh();
 
-    // set vertex positions for the Mesh
-    std::vector<Lib3MF::sPosition> vertPos;
-    mesh->GetVertices(vertPos);
-
-    // base material color
-    M3mf::ColorM materialColor { 0.5f, 0.5f, 0.5f };
-
-    status = mMesh->setNumVerts(mesh->GetVertexCount());
-    if (!status) {
-        return false;
-    }
-    for (auto index = 0; index < vertPos.size(); ++index) {
-        mMesh->setVert(index, vertPos[index].m_Coordinates[0], vertPos[index].m_Coordinates[1], vertPos[index].m_Coordinates[2]);
-    }
-
-    // set triangle indices for the Mesh
-    std::vector<Lib3MF::sTriangle> triangleIndices;
-    mesh->GetTriangleIndices(triangleIndices);
-
-    status = mMesh->setNumFaces(mesh->GetTriangleCount());
+    // allocate the vertices and faces of the Mesh
+    const uint32_t vertexCount = mesh.vertexCount();
+    const uint32_t triangleCount = mesh.triangleCount();
+    status = mMesh->setNumVerts(vertexCount) && mMesh->setNumFaces(triangleCount);
     if (!status) {
+        delete object;
         return false;
     }
 
-    // triangle properties
-    std::vector<Lib3MF::sTriangleProperties> properties;
-    mesh->GetAllTriangleProperties(properties);
-
-    // verify that lib3mf resource ID is present in model
-    ResourceIDCheck resourceIDCheck(model);
-
-    for (uint32_t index = 0; index < mesh->GetTriangleCount(); ++index) {
-        // create a face and set it's indicies
-        Face& face = mMesh->faces[index];
-        face.setMatID(1);
-        face.setEdgeVisFlags(1, 1, 1);
-
-        // face indices
-        DWORD indicies[3];
-        indicies[0] = triangleIndices[index].m_Indices[0];
-        indicies[1] = triangleIndices[index].m_Indices[1];
-        indicies[2] = triangleIndices[index].m_Indices[2];
-
-        face.setVerts(indicies);
-
-        // BaseMaterial
-        if (resourceIDCheck.isRessourceIDValid(properties[index].m_ResourceID) && model->GetPropertyTypeByID(properties[index].m_ResourceID) == Lib3MF::ePropertyType::BaseMaterial) {
-            Lib3MF::PBaseMaterialGroup baseMaterialGroup = model->GetBaseMaterialGroupByID(properties[index].m_ResourceID);
-
-            sLib3MFColor color(baseMaterialGroup->GetDisplayColor(properties[index].m_PropertyIDs[0]));
-
-            wrapper->ColorToFloatRGBA(color, materialColor[0], materialColor[1], materialColor[2], materialColor[3]);
+    // fill them straight from the flat arrays, in chunks on all hardware threads. Meshes
+    // of one vertex chunk and one face chunk are filled on the calling thread, starting
+    // threads for every small node of a plate costs more than the fill itself
+    Point3* verts = mMesh->verts;
+    Face* faces = mMesh->faces;
+    const size_t vertexChunkCount = (vertexCount + chunkSize - 1) / chunkSize;
+    const size_t faceChunkCount = (triangleCount + chunkSize - 1) / chunkSize;
+    const size_t chunkCount = vertexChunkCount + faceChunkCount;
+    const uint32_t threadCount = (chunkCount <= 2) ? 1 : hardwareThreadCount();
+
+    parallelFor(chunkCount, threadCount, [&](size_t chunk) {
+        if (chunk < vertexChunkCount) {
+            const size_t end = std::min<size_t>((chunk + 1) * chunkSize, vertexCount);
+            for (size_t index = chunk * chunkSize; index < end; ++index) {
+                verts[index].Set(mesh.positions[index * 3], mesh.positions[index * 3 + 1], mesh.positions[index * 3 + 2]);
+            }
+        } else {
+            chunk -= vertexChunkCount;
+            const size_t end = std::min<size_t>((chunk + 1) * chunkSize, triangleCount);
+            for (size_t index = chunk * chunkSize; index < end; ++index) {
+                Face& face = faces[index];
+                face.setMatID(mesh.faceMaterials.empty() ? 0 : static_cast<MtlID>(mesh.faceMaterials[index]));
+                face.setEdgeVisFlags(1, 1, 1);
+                face.setVerts(mesh.indices[index * 3], mesh.indices[index * 3 + 1], mesh.indices[index * 3 + 2]);
+            }
         }
-    }
+    });
 
     // build bbox and invalidate cache
     mMesh->buildBoundingBox();
@@ -268,7 +246,7 @@ bool ThreeMFImport::createMeshObject(const Lib3MF::PWrapper& wrapper, const Lib3
     }
 
     // set the affine matrix
-    Matrix3 xformM(M3mf::convert(transform));
+    Matrix3 xformM(M3mf::convert(instance.transform));
     node->SetTransform(0, xformM);
 
     // set the reference
@@ -277,41 +255,22 @@ bool ThreeMFImport::createMeshObject(const Lib3MF::PWrapper& wrapper, const Lib3
     // add the node to the scene
     _impInterface->AddNodeToScene(node);
 
-    // create a new Standard material
-    StdMat2* standardMat = NewDefaultStdMat();
-    standardMat->SetName(_T("Standard Material"));
-    standardMat->SetAmbient(Color(materialColor[0], materialColor[1], materialColor[2]), 0);
-    standardMat->SetDiffuse(Color(materialColor[0], materialColor[1], materialColor[2]), 0);
-    standardMat->SetSpecular(Color(materialColor[0], materialColor[1], materialColor[2]), 0);
-
     // assign the material to the node
-    node->GetINode()->SetMtl(standardMat);
-
-    // draw update
-    _impInterface->RedrawViews();
+    node->GetINode()->SetMtl(material);
 
     return status;
 }
 
-ResourceIDCheck::ResourceIDCheck(Lib3MF::PModel model)
+StdMat2* ThreeMFImport::createMaterial(const ColorRGBA& color)
 {
-    auto pResources = model->GetResources();
-    if (pResources->Count() != 0) {
-        while (pResources->MoveNext()) {
-            auto pResource = pResources->GetCurrent();
-            _resourceIDs.insert(pResource->GetResourceID());
-        }
-    }
-}
+    // create a new Standard material
+    StdMat2* standardMat = NewDefaultStdMat();
+    standardMat->SetName(_T("Standard Material"));
+    standardMat->SetAmbient(Color(color[0], color[1], color[2]), 0);
+    standardMat->SetDiffuse(Color(color[0], color[1], color[2]), 0);
+    standardMat->SetSpecular(Color(color[0], color[1], color[2]), 0);
 
-bool ResourceIDCheck::isRessourceIDValid(uint32_t ID)
-{
-    auto iter = _resourceIDs.find(ID);
-    if (iter != _resourceIDs.end()) {
-        return true;
-    } else {
-        return false;
-    }
+    return standardMat;
 }
 
 } // namespace M3mf
\ No newline at end of file
@@ -37,6 +37,8 @@
 
 #include <lib3mf_implicit.hpp>
 
+#include <scene.h>
+
 #include <mesh.h>
 
 #include <set>
@@ -48,6 +50,8 @@ static const TCHAR _className[] = _T("ThreeMFImport");
 
 extern HINSTANCE hInstance;
 
+class StdMat2;
+
 namespace M3mf {
 
 class ThreeMFImport : public SceneImport
@@ -71,11 +75,10 @@ public:
 private:
     bool read(std::wstring_view fileName);
 
-    bool createMeshObject(const Lib3MF::PWrapper& wrapper, 
-                          const Lib3MF::PModel& model, 
-                          const Lib3MF::PMeshObject& mesh, 
-                          const sLib3MFTransform& transform, 
-                          std::string_view objectName);
+    bool createMeshObject(const MeshData& mesh, const MeshInstance& instance, Mtl* material);
+
+    // standard material of the given color
+    StdMat2* createMaterial(const ColorRGBA& color);
 
 private:
     ImpInterface* _impInterface;
@@ -118,16 +121,6 @@ public:
     }
 };
 
-class ResourceIDCheck
-{
-public:
-    ResourceIDCheck(Lib3MF::PModel model);
-    bool isRessourceIDValid(uint32_t ID);
-
-private:
-    std::set<uint32_t> _resourceIDs;
-};
-
 } // namespace M3mf
 
 #endif // PLUGIN_3DSMAX_THREEMFIMPORT_H
\ No newline at end of file
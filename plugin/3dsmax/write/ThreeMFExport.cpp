@@ -26,6 +26,9 @@
 #include "types.h"
 #include "utility.h"
 
+#include <conversion.h>
+#include <instancing.h>
+
 #include <Max.h>
 
 #include <stdmat.h>
@@ -38,6 +41,18 @@ ClassDesc2* GetThreeMFExportDesc()
 
 namespace M3mf {
 
+namespace {
+
+struct NodeGeometryHash
+{
+    size_t operator()(const std::pair<Object*, Mtl*>& key) const
+    {
+        return std::hash<Object*>()(key.first) ^ (std::hash<Mtl*>()(key.second) << 1);
+    }
+};
+
+} // namespace
+
 ThreeMFExport::ThreeMFExport()
 {
 }
@@ -145,100 +160,130 @@ bool ThreeMFExport::write(Interface* ip, INode* pNode, std::wstring_view filenam
 
 bool ThreeMFExport::exportSelected(Interface* ip, const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model)
 {
+    std::vector<INode*> nodes;
     for (auto i = 0; i < ip->GetSelNodeCount(); i++) {
-        INode* childNode = ip->GetSelNode(i);
-        createBuildItem(childNode, wrapper, model);
+        nodes.push_back(ip->GetSelNode(i));
     }
 
-    return true;
+    return exportNodes(nodes, wrapper, model);
 }
 
 bool ThreeMFExport::exportAll(INode* pNode, const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model)
 {
+    std::vector<INode*> nodes;
     for (auto i = 0; i < pNode->NumberOfChildren(); i++) {
-        INode* childNode = pNode->GetChildNode(i);
-        createBuildItem(childNode, wrapper, model);
+        nodes.push_back(pNode->GetChildNode(i));
+    }
+
+    return exportNodes(nodes, wrapper, model);
+}
+
+bool ThreeMFExport::exportNodes(const std::vector<INode*>& nodes, const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model)
+{
+    // instances and references share the object reference. The material is assigned per node,
+    // so it is part of the key as well.
+    InstanceGroups<std::pair<Object*, Mtl*>, NodeGeometryHash> instances;
+    std::vector<size_t> exportedNodes;
+    for (auto i = 0; i < nodes.size(); ++i) {
+        Object* pObject = nodes[i]->GetObjectRef();
+
+        // check if the object can be converted into an edtiable mesh
+        if (pObject == nullptr || !pObject->CanConvertToType(triObjectClassID)) {
+            continue;
+        }
+
+        instances.add({ pObject, nodes[i]->GetMtl() }, i);
+        exportedNodes.push_back(i);
+    }
+
+    // one mesh per shared geometry, one instance per node in scene order
+    SceneData scene;
+    scene.meshes.resize(instances.size());
+    for (size_t i = 0; i < instances.size(); ++i) {
+        extractMesh(nodes[instances.groups()[i].nodes.front()], scene.meshes[i]);
+    }
+
+    scene.instances.resize(exportedNodes.size());
+    for (size_t i = 0; i < exportedNodes.size(); ++i) {
+        scene.instances[i].mesh = static_cast<uint32_t>(instances.groupOf(i));
+        extractTransform(nodes[exportedNodes[i]], scene.instances[i]);
     }
 
+    exportScene(wrapper, model, scene);
+
     return true;
 }
 
-bool ThreeMFExport::createBuildItem(INode* childNode, const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model)
+void ThreeMFExport::extractMesh(INode* childNode, MeshData& mesh)
 {
     Object* pObject = childNode->GetObjectRef();
 
-    // check if the object can be converted into an edtiable mesh
-    if (pObject != nullptr && pObject->CanConvertToType(triObjectClassID)) {
-        TriObject* pTriObject = static_cast<TriObject*>(pObject);
-        pTriObject->ConvertToType(0, triObjectClassID);
-
-        Mesh* pMesh = &pTriObject->GetMesh();
-
-        // vertices
-        std::vector<Lib3MF::sPosition> vertices;
-        vertices.resize(pMesh->getNumVerts());
-        for (auto i = 0; i < vertices.size(); ++i) {
-            Point3* vertPos = &pMesh->getVert(i);
-            vertices[i].m_Coordinates[0] = static_cast<float>(vertPos->x);
-            vertices[i].m_Coordinates[1] = static_cast<float>(vertPos->y);
-            vertices[i].m_Coordinates[2] = static_cast<float>(vertPos->z);
-        }
+    TriObject* pTriObject = static_cast<TriObject*>(pObject);
+    pTriObject->ConvertToType(0, triObjectClassID);
 
-        // triangle
-        std::vector<Lib3MF::sTriangle> triangles;
-        triangles.resize(pMesh->getNumFaces());
-        for (auto i = 0; i < triangles.size(); ++i) {
-            Face* face = &pMesh->faces[i];
-            DWORD* pIndices = face->getAllVerts();
-            for (auto j = 0; j < 3; ++j) {
-                triangles[i].m_Indices[j] = pIndices[j];
-            }
-        }
+    Mesh* pMesh = &pTriObject->GetMesh();
 
-        // add mesh object
-        auto meshObject = model->AddMeshObject();
-        std::wstring_view wfileName(childNode->GetName());
-        meshObject->SetName(wstring_to_utf8(wfileName.data()));
-        meshObject->SetGeometry(vertices, triangles);
+    std::wstring_view wfileName(childNode->GetName());
+    mesh.name = wstring_to_utf8(wfileName.data());
 
-        // get the local transform
-        Matrix3 worldTM = childNode->GetNodeTM(0);
-        Matrix3 parentTM = childNode->GetParentTM(0);
-        Matrix3 localTM = worldTM * Inverse(parentTM);
+    // vertices
+    const size_t numVerts = pMesh->getNumVerts();
+    mesh.positions.resize(numVerts * 3);
+    for (size_t i = 0; i < numVerts; ++i) {
+        const Point3& vertPos = pMesh->getVert(static_cast<int>(i));
+        mesh.positions[i * 3] = vertPos.x;
+        mesh.positions[i * 3 + 1] = vertPos.y;
+        mesh.positions[i * 3 + 2] = vertPos.z;
+    }
 
-        // Material
-        M3mf::ColorM diffuseColorM { 0.5f, 0.5f, 0.5f };
+    // triangle
+    const size_t numFaces = pMesh->getNumFaces();
+    mesh.indices.resize(numFaces * 3);
+    for (size_t i = 0; i < numFaces; ++i) {
+        DWORD* pIndices = pMesh->faces[i].getAllVerts();
+        for (size_t j = 0; j < 3; ++j) {
+            mesh.indices[i * 3 + j] = pIndices[j];
+        }
+    }
 
+    // vertex colors (map channel 0)
+    if (pMesh->numCVerts > 0 && pMesh->vcFace != nullptr) {
+        // one color per face vertex
+        mesh.colors.resize(numFaces * 3 * 4);
+        for (size_t i = 0; i < numFaces; ++i) {
+            DWORD* pColorIndices = pMesh->vcFace[i].getAllTVerts();
+            for (size_t j = 0; j < 3; ++j) {
+                const VertColor& vertColor = pMesh->vertCol[pColorIndices[j]];
+                float* rgba = &mesh.colors[(i * 3 + j) * 4];
+                rgba[0] = vertColor.x;
+                rgba[1] = vertColor.y;
+                rgba[2] = vertColor.z;
+                rgba[3] = 1.0f;
+            }
+        }
+    } else {
+        // Material
         Mtl* mtl = childNode->GetMtl();
 
         StdMat2* stdmat = dynamic_cast<StdMat2*>(mtl);
         if (stdmat) {
             auto diffColor = stdmat->GetDiffuse(0);
-            diffuseColorM[0] = diffColor.r;
-            diffuseColorM[1] = diffColor.g;
-            diffuseColorM[2] = diffColor.b;
-        }
-
-        auto baseMaterialGroup = model->AddBaseMaterialGroup();
-        Lib3MF_uint32 color = baseMaterialGroup->AddMaterial("Material Color", wrapper->FloatRGBAToColor(diffuseColorM[0], diffuseColorM[1], diffuseColorM[2], 1.0f));
-
-        sLib3MFTriangleProperties sTriangleProperty;
-        sTriangleProperty.m_ResourceID = baseMaterialGroup->GetResourceID();
-        sTriangleProperty.m_PropertyIDs[0] = color;
-        sTriangleProperty.m_PropertyIDs[1] = color;
-        sTriangleProperty.m_PropertyIDs[2] = color;
-
-        for (auto i = 0; i < pMesh->getNumFaces(); i++) {
-            meshObject->SetTriangleProperties(i, sTriangleProperty);
+            mesh.materialColor = { diffColor.r, diffColor.g, diffColor.b, 1.0f };
         }
+    }
+}
 
-        // set object property
-        meshObject->SetObjectLevelProperty(sTriangleProperty.m_ResourceID, sTriangleProperty.m_PropertyIDs[0]);
+void ThreeMFExport::extractTransform(INode* childNode, MeshInstance& instance)
+{
+    // get the local transform
+    Matrix3 worldTM = childNode->GetNodeTM(0);
+    Matrix3 parentTM = childNode->GetParentTM(0);
+    Matrix3 localTM = worldTM * Inverse(parentTM);
 
-        model->AddBuildItem(meshObject.get(), M3mf::convert(localTM));
-    }
+    instance.transform = M3mf::convert(localTM);
 
-    return true;
+    std::wstring_view wname(childNode->GetName());
+    instance.name = wstring_to_utf8(wname.data());
 }
 
 } // namespace M3mf
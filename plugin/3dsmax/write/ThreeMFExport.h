@@ -35,7 +35,10 @@
 
 #include <lib3mf_implicit.hpp>
 
+#include <scene.h>
+
 #include <string_view>
+#include <vector>
 
 #define ThreeMFExport_CLASS_ID Class_ID(0x776d5450, 0x7fc77efd)
 
@@ -71,7 +74,11 @@ private:
 
     bool exportAll(INode* pNode, const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model);
 
-    bool createBuildItem(INode* childNode, const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model);
+    bool exportNodes(const std::vector<INode*>& nodes, const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model);
+
+    void extractMesh(INode* childNode, MeshData& mesh);
+
+    void extractTransform(INode* childNode, MeshInstance& instance);
 
 private:
     bool _isSelected { false };
@@ -0,0 +1,410 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "conversion.h"
+
+#include <limits>
+#include <map>
+
+namespace M3mf {
+
+namespace {
+
+class ModelImporter
+{
+public:
+    ModelImporter(const Lib3MF::PModel& model, SceneData& scene)
+        : _model(model)
+        , _scene(scene)
+        , _meshOffset(static_cast<uint32_t>(scene.meshes.size()))
+    {
+    }
+
+    void addObject(const Lib3MF::PObject& object, const sLib3MFTransform& transform, const std::string& name, uint32_t depth)
+    {
+        const uint32_t resourceID = object->GetResourceID();
+
+        // mesh
+        if (object->IsMeshObject()) {
+            MeshInstance instance;
+            instance.mesh = meshIndex(resourceID);
+            instance.transform = transform;
+            instance.name = name;
+            _scene.instances.push_back(std::move(instance));
+            return;
+        }
+
+        // components
+        if (object->IsComponentsObject()) {
+            Lib3MF::PComponentsObject componentsObject = _model->GetComponentsObjectByID(resourceID);
+
+            // we care only about model. ignore support, solidsupport, other
+            if (componentsObject->GetType() != Lib3MF::eObjectType::Model) {
+                return;
+            }
+
+            // a valid model has no cycles, this only guards against broken files
+            if (depth > maxComponentDepth) {
+                return;
+            }
+
+            for (uint32_t nIndex = 0; nIndex < componentsObject->GetComponentCount(); nIndex++) {
+                Lib3MF::PComponent component = componentsObject->GetComponent(nIndex);
+
+                if (component->HasTransform()) {
+                    addObject(component->GetObjectResource(), multiply(component->GetTransform(), transform), name, depth + 1);
+                } else {
+                    addObject(component->GetObjectResource(), transform, name, depth + 1);
+                }
+            }
+        }
+    }
+
+    // converts all meshes referenced by the instances
+    void importMeshes()
+    {
+        PropertyTypeCache propertyTypes(_model);
+        _scene.meshes.reserve(_meshOffset + _meshObjects.size());
+        for (const Lib3MF::PMeshObject& meshObject : _meshObjects) {
+            _scene.meshes.push_back(importMesh(meshObject, propertyTypes));
+        }
+
+        // one scene material per distinct (group, property ID)
+        std::map<std::pair<uint32_t, uint32_t>, uint32_t> materialIndices;
+        for (uint32_t index = 0; index < _scene.materials.size(); ++index) {
+            const MaterialData& material = _scene.materials[index];
+            materialIndices.emplace(std::make_pair(material.resourceID, material.propertyID), index);
+        }
+
+        for (size_t index = _meshOffset; index < _scene.meshes.size(); ++index) {
+            MeshData& mesh = _scene.meshes[index];
+            mesh.sceneMaterials.clear();
+            for (const MaterialData& material : mesh.materials) {
+                const auto key = std::make_pair(material.resourceID, material.propertyID);
+                auto iter = materialIndices.find(key);
+                if (iter == materialIndices.end()) {
+                    iter = materialIndices.emplace(key, static_cast<uint32_t>(_scene.materials.size())).first;
+                    _scene.materials.push_back(material);
+                }
+                mesh.sceneMaterials.push_back(iter->second);
+            }
+        }
+    }
+
+private:
+    uint32_t meshIndex(uint32_t resourceID)
+    {
+        auto iter = _meshIndices.find(resourceID);
+        if (iter != _meshIndices.end()) {
+            return iter->second;
+        }
+
+        const uint32_t index = _meshOffset + static_cast<uint32_t>(_meshObjects.size());
+        _meshObjects.push_back(_model->GetMeshObjectByID(resourceID));
+        _meshIndices.emplace(resourceID, index);
+        return index;
+    }
+
+private:
+    static constexpr uint32_t maxComponentDepth { 64 };
+
+    Lib3MF::PModel _model;
+    SceneData& _scene;
+
+    // index of the first mesh this importer adds to the scene
+    uint32_t _meshOffset;
+
+    // mesh objects in the order of SceneData::meshes
+    std::vector<Lib3MF::PMeshObject> _meshObjects;
+
+    // mesh object resource ID -> index into SceneData::meshes
+    std::unordered_map<uint32_t, uint32_t> _meshIndices;
+};
+
+} // namespace
+
+PropertyTypeCache::PropertyTypeCache(const Lib3MF::PModel& model)
+    : _model(model)
+{
+}
+
+Lib3MF::ePropertyType PropertyTypeCache::get(uint32_t resourceID)
+{
+    if (resourceID == _lastResourceID) {
+        return _lastPropertyType;
+    }
+
+    auto iter = _propertyTypes.find(resourceID);
+    if (iter == _propertyTypes.end()) {
+        iter = _propertyTypes.emplace(resourceID, _model->GetPropertyTypeByID(resourceID)).first;
+    }
+
+    _lastResourceID = resourceID;
+    _lastPropertyType = iter->second;
+    return _lastPropertyType;
+}
+
+void importModel(const Lib3MF::PModel& model, SceneData& scene)
+{
+    ModelImporter importer(model, scene);
+
+    // iterate through builditem(s)
+    Lib3MF::PBuildItemIterator buildItemIterator = model->GetBuildItems();
+    while (buildItemIterator->MoveNext()) {
+        Lib3MF::PBuildItem buildItem = buildItemIterator->GetCurrent();
+        Lib3MF::PObject object = buildItem->GetObjectResource();
+
+        // name
+        std::string name = object->GetName();
+        if (name.empty()) {
+            name = "Object_" + std::to_string(buildItem->GetObjectResourceID());
+        }
+
+        // transform
+        const sLib3MFTransform transform = buildItem->HasObjectTransform() ? buildItem->GetObjectTransform() : identityTransform();
+
+        importer.addObject(object, transform, name, 0);
+    }
+
+    importer.importMeshes();
+}
+
+MeshArrays readMesh(const Lib3MF::PMeshObject& meshObject, PropertyTypeCache& propertyTypes)
+{
+    MeshArrays arrays;
+    arrays.name = meshObject->GetName();
+    meshObject->GetVertices(arrays.vertices);
+    meshObject->GetTriangleIndices(arrays.triangles);
+
+    // resolve the colors and properties of all triangles at once
+    meshObject->GetAllTriangleColors(arrays.rgbaValues, arrays.colorResourceIDs);
+    meshObject->GetAllTriangleProperties(arrays.triangleProperties);
+
+    uint32_t objectResourceID { 0 };
+    if (!meshObject->GetObjectLevelProperty(objectResourceID, arrays.objectPropertyID)) {
+        arrays.objectPropertyID = 0;
+    }
+
+    // property types of the referenced resources, consecutive triangles mostly share them.
+    // resource ID 0 marks triangles without a property.
+    arrays.propertyTypes.emplace(0, Lib3MF::ePropertyType::NoPropertyType);
+    uint32_t lastResourceID { 0 };
+    for (const uint32_t resourceID : arrays.colorResourceIDs) {
+        if (resourceID != lastResourceID) {
+            arrays.propertyTypes.emplace(resourceID, propertyTypes.get(resourceID));
+            lastResourceID = resourceID;
+        }
+    }
+
+    return arrays;
+}
+
+MeshData convertMesh(MeshArrays arrays)
+{
+    MeshData mesh;
+    mesh.name = std::move(arrays.name);
+
+    // vertices
+    const std::vector<Lib3MF::sPosition>& vertices = arrays.vertices;
+    mesh.positions.resize(vertices.size() * 3);
+    for (size_t index = 0; index < vertices.size(); ++index) {
+        mesh.positions[index * 3] = vertices[index].m_Coordinates[0];
+        mesh.positions[index * 3 + 1] = vertices[index].m_Coordinates[1];
+        mesh.positions[index * 3 + 2] = vertices[index].m_Coordinates[2];
+    }
+
+    // triangles
+    const std::vector<Lib3MF::sTriangle>& triangles = arrays.triangles;
+    mesh.indices.resize(triangles.size() * 3);
+    for (size_t index = 0; index < triangles.size(); ++index) {
+        mesh.indices[index * 3] = triangles[index].m_Indices[0];
+        mesh.indices[index * 3 + 1] = triangles[index].m_Indices[1];
+        mesh.indices[index * 3 + 2] = triangles[index].m_Indices[2];
+    }
+
+    // (group, property ID) -> index into mesh.materials
+    std::unordered_map<uint64_t, uint32_t> materialSlots;
+    uint64_t lastKey { std::numeric_limits<uint64_t>::max() };
+    uint32_t lastSlot { 0 };
+
+    uint32_t lastResourceID { 0 };
+    Lib3MF::ePropertyType propertyType = arrays.propertyTypes.at(0);
+
+    bool hasVertexColors { false };
+    mesh.colorSources.resize(triangles.size(), ColorSource::None);
+    mesh.faceMaterials.resize(triangles.size());
+    for (size_t index = 0; index < triangles.size(); ++index) {
+        const uint32_t resourceID = arrays.colorResourceIDs[index];
+        if (resourceID != lastResourceID) {
+            propertyType = arrays.propertyTypes.at(resourceID);
+            lastResourceID = resourceID;
+        }
+
+        // color
+        if (propertyType == Lib3MF::ePropertyType::Colors) {
+            mesh.colorSources[index] = ColorSource::VertexColor;
+            hasVertexColors = true;
+        }
+
+        // baseMaterial
+        MaterialData material;
+        if (propertyType == Lib3MF::ePropertyType::BaseMaterial) {
+            const Lib3MF_single* rgba = &arrays.rgbaValues[index * 12];
+            mesh.colorSources[index] = ColorSource::Material;
+            mesh.materialColor = { rgba[0], rgba[1], rgba[2], rgba[3] };
+
+            // the material the color was resolved from, which is the object level one for
+            // triangles without a property
+            const Lib3MF::sTriangleProperties& properties = arrays.triangleProperties[index];
+            material.resourceID = resourceID;
+            material.propertyID = (properties.m_ResourceID != 0) ? properties.m_PropertyIDs[0] : arrays.objectPropertyID;
+            material.color = mesh.materialColor;
+        }
+
+        // bucket the triangle by its material, consecutive triangles mostly share it
+        const uint64_t key = (static_cast<uint64_t>(material.resourceID) << 32) | material.propertyID;
+        if (key != lastKey) {
+            auto iter = materialSlots.find(key);
+            if (iter == materialSlots.end()) {
+                iter = materialSlots.emplace(key, static_cast<uint32_t>(mesh.materials.size())).first;
+                mesh.materials.push_back(material);
+            }
+            lastKey = key;
+            lastSlot = iter->second;
+        }
+        mesh.faceMaterials[index] = lastSlot;
+    }
+
+    // every mesh has at least the default material
+    if (mesh.materials.empty()) {
+        mesh.materials.emplace_back();
+    }
+
+    if (hasVertexColors) {
+        mesh.colors = std::move(arrays.rgbaValues);
+    } else {
+        mesh.colorSources.clear();
+    }
+
+    return mesh;
+}
+
+MeshData importMesh(const Lib3MF::PMeshObject& meshObject, PropertyTypeCache& propertyTypes)
+{
+    return convertMesh(readMesh(meshObject, propertyTypes));
+}
+
+void exportScene(const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model, const SceneData& scene)
+{
+    // one mesh object per mesh
+    std::vector<Lib3MF::PMeshObject> meshObjects;
+    meshObjects.reserve(scene.meshes.size());
+    for (const MeshData& mesh : scene.meshes) {
+        meshObjects.push_back(exportMesh(wrapper, model, mesh));
+    }
+
+    // one build item per instance
+    for (const MeshInstance& instance : scene.instances) {
+        model->AddBuildItem(meshObjects[instance.mesh].get(), instance.transform);
+    }
+}
+
+Lib3MF::PMeshObject exportMesh(const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model, const MeshData& mesh)
+{
+    // vertices
+    std::vector<Lib3MF::sPosition> vertices(mesh.vertexCount());
+    for (size_t index = 0; index < vertices.size(); ++index) {
+        vertices[index].m_Coordinates[0] = mesh.positions[index * 3];
+        vertices[index].m_Coordinates[1] = mesh.positions[index * 3 + 1];
+        vertices[index].m_Coordinates[2] = mesh.positions[index * 3 + 2];
+    }
+
+    // triangles
+    std::vector<Lib3MF::sTriangle> triangles(mesh.triangleCount());
+    for (size_t index = 0; index < triangles.size(); ++index) {
+        triangles[index].m_Indices[0] = mesh.indices[index * 3];
+        triangles[index].m_Indices[1] = mesh.indices[index * 3 + 1];
+        triangles[index].m_Indices[2] = mesh.indices[index * 3 + 2];
+    }
+
+    // add mesh object
+    auto meshObject = model->AddMeshObject();
+    meshObject->SetName(mesh.name);
+    meshObject->SetGeometry(vertices, triangles);
+
+    std::vector<Lib3MF::sTriangleProperties> triangleProperties(triangles.size());
+    if (!mesh.colors.empty()) {
+        // one color per face vertex, the color group only stores the distinct ones
+        std::vector<Lib3MF::sColor> faceVertColors(triangles.size() * 3);
+        for (size_t i = 0; i < faceVertColors.size(); ++i) {
+            const float* rgba = &mesh.colors[i * 4];
+            faceVertColors[i] = wrapper->FloatRGBAToColor(rgba[0], rgba[1], rgba[2], rgba[3]);
+        }
+
+        auto colorGroup = model->AddColorGroup();
+        std::vector<Lib3MF_uint32> propertyIDs;
+        colorGroup->AddColorsDeduplicated(faceVertColors, propertyIDs);
+
+        for (size_t i = 0; i < triangleProperties.size(); ++i) {
+            triangleProperties[i].m_ResourceID = colorGroup->GetResourceID();
+            for (size_t j = 0; j < 3; ++j) {
+                triangleProperties[i].m_PropertyIDs[j] = propertyIDs[i * 3 + j];
+            }
+        }
+    } else {
+        // material, per triangle if the mesh was imported with several of them
+        auto baseMaterialGroup = model->AddBaseMaterialGroup();
+        const bool perTriangle = !mesh.faceMaterials.empty() && mesh.faceMaterials.size() == triangles.size();
+
+        std::vector<Lib3MF_uint32> materialIDs;
+        if (perTriangle) {
+            for (const MaterialData& material : mesh.materials) {
+                const ColorRGBA& color = material.color;
+                materialIDs.push_back(baseMaterialGroup->AddMaterial("Material Color", wrapper->FloatRGBAToColor(color[0], color[1], color[2], color[3])));
+            }
+        } else {
+            const ColorRGBA& color = mesh.materialColor;
+            materialIDs.push_back(baseMaterialGroup->AddMaterial("Material Color", wrapper->FloatRGBAToColor(color[0], color[1], color[2], color[3])));
+        }
+
+        for (size_t i = 0; i < triangleProperties.size(); ++i) {
+            const Lib3MF_uint32 materialID = perTriangle ? materialIDs[mesh.faceMaterials[i]] : materialIDs[0];
+            triangleProperties[i].m_ResourceID = baseMaterialGroup->GetResourceID();
+            triangleProperties[i].m_PropertyIDs[0] = materialID;
+            triangleProperties[i].m_PropertyIDs[1] = materialID;
+            triangleProperties[i].m_PropertyIDs[2] = materialID;
+        }
+    }
+
+    if (!triangleProperties.empty()) {
+        meshObject->SetAllTriangleProperties(triangleProperties);
+
+        // object level property
+        meshObject->SetObjectLevelProperty(triangleProperties[0].m_ResourceID, triangleProperties[0].m_PropertyIDs[0]);
+    }
+
+    return meshObject;
+}
+
+} // namespace M3mf
@@ -0,0 +1,106 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef PLUGIN_CORE_CONVERSION_H
+#define PLUGIN_CORE_CONVERSION_H
+
+#include "scene.h"
+
+#include <lib3mf_implicit.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace M3mf {
+
+// looks up the property type of each resource only once
+class PropertyTypeCache
+{
+public:
+    PropertyTypeCache(const Lib3MF::PModel& model);
+    Lib3MF::ePropertyType get(uint32_t resourceID);
+
+private:
+    Lib3MF::PModel _model;
+    std::unordered_map<uint32_t, Lib3MF::ePropertyType> _propertyTypes;
+
+    // consecutive triangles mostly share their resource
+    uint32_t _lastResourceID { 0 };
+    Lib3MF::ePropertyType _lastPropertyType { Lib3MF::ePropertyType::NoPropertyType };
+};
+
+// arrays of a mesh object as lib3mf returns them, with the property types of the resources
+// its triangles reference
+struct MeshArrays
+{
+    std::string name;
+    std::vector<Lib3MF::sPosition> vertices;
+    std::vector<Lib3MF::sTriangle> triangles;
+
+    // GetAllTriangleColors
+    std::vector<Lib3MF_single> rgbaValues;
+    std::vector<Lib3MF_uint32> colorResourceIDs;
+
+    // GetAllTriangleProperties
+    std::vector<Lib3MF::sTriangleProperties> triangleProperties;
+
+    // property ID of the object level property, GetAllTriangleColors resolves the triangles without
+    // a property to it
+    uint32_t objectPropertyID { 0 };
+
+    std::unordered_map<uint32_t, Lib3MF::ePropertyType> propertyTypes;
+};
+
+// 3MF -> scene
+
+// converts all build items of the model into instances. Components are flattened into one
+// instance per mesh with the accumulated transform, and a mesh object referenced several
+// times is converted once.
+//
+// Every distinct base material of the meshes gets one entry in SceneData::materials. The scene
+// only needs host node creation afterwards.
+void importModel(const Lib3MF::PModel& model, SceneData& scene);
+
+// reads the arrays of a mesh object from lib3mf
+MeshArrays readMesh(const Lib3MF::PMeshObject& meshObject, PropertyTypeCache& propertyTypes);
+
+// converts the geometry, colors and per triangle base materials of a mesh object from its
+// arrays, without calling into lib3mf
+MeshData convertMesh(MeshArrays arrays);
+
+// readMesh and convertMesh in one
+MeshData importMesh(const Lib3MF::PMeshObject& meshObject, PropertyTypeCache& propertyTypes);
+
+// scene -> 3MF
+
+// adds every mesh of the scene as a mesh object and every instance as a build item
+void exportScene(const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model, const SceneData& scene);
+
+// adds a mesh object with the geometry and colors of the mesh
+Lib3MF::PMeshObject exportMesh(const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model, const MeshData& mesh);
+
+} // namespace M3mf
+
+#endif // PLUGIN_CORE_CONVERSION_H
@@ -0,0 +1,106 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef PLUGIN_CORE_INSTANCING_H
+#define PLUGIN_CORE_INSTANCING_H
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace M3mf {
+
+// Groups the scene nodes that are about to be exported by the geometry they reference.
+// Every group is written once as a 3MF mesh resource and each of its nodes becomes a build
+// item referencing that resource with its own transform.
+//
+// Key identifies the shared geometry in the host (e.g. Maya shape node, 3DSMax object reference).
+// Groups are kept in the order in which their first node was added, so resources are written
+// in scene order.
+template <typename Key, typename Hash = std::hash<Key>>
+class InstanceGroups final
+{
+public:
+    struct Group
+    {
+        Key key;
+        std::vector<std::size_t> nodes;
+    };
+
+    InstanceGroups() = default;
+    ~InstanceGroups() = default;
+
+    InstanceGroups(InstanceGroups&& other) = default;
+    InstanceGroups(const InstanceGroups&) = delete;
+    InstanceGroups& operator=(const InstanceGroups&) = delete;
+    InstanceGroups& operator=(InstanceGroups&&) = default;
+
+    // registers a node and returns the index of the group it belongs to
+    std::size_t add(const Key& key, std::size_t node)
+    {
+        auto it = m_lookup.find(key);
+        if (it == m_lookup.end()) {
+            it = m_lookup.emplace(key, m_groups.size()).first;
+            m_groups.push_back(Group { key, {} });
+        }
+
+        m_groups[it->second].nodes.push_back(node);
+        m_nodeGroups.push_back(it->second);
+
+        return it->second;
+    }
+
+    // group of the n-th added node
+    std::size_t groupOf(std::size_t n) const
+    {
+        return m_nodeGroups[n];
+    }
+
+    const std::vector<Group>& groups() const
+    {
+        return m_groups;
+    }
+
+    // number of distinct geometries
+    std::size_t size() const
+    {
+        return m_groups.size();
+    }
+
+    // number of registered nodes
+    std::size_t nodeCount() const
+    {
+        return m_nodeGroups.size();
+    }
+
+private:
+    std::vector<Group> m_groups;
+    std::vector<std::size_t> m_nodeGroups;
+    std::unordered_map<Key, std::size_t, Hash> m_lookup;
+};
+
+} // namespace M3mf
+
+#endif // PLUGIN_CORE_INSTANCING_H
@@ -0,0 +1,45 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef PLUGIN_CORE_PARALLEL_H
+#define PLUGIN_CORE_PARALLEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace M3mf {
+
+// number of threads the hardware can run concurrently, at least 1
+uint32_t hardwareThreadCount();
+
+// calls fn(index) for every index in [0, count) on up to threadCount threads, the calling
+// thread included. Indices are handed out one at a time, so items of very different cost
+// still balance. The first exception thrown by fn is rethrown on the calling thread once
+// all threads have finished.
+void parallelFor(size_t count, uint32_t threadCount, const std::function<void(size_t)>& fn);
+
+} // namespace M3mf
+
+#endif // PLUGIN_CORE_PARALLEL_H
@@ -0,0 +1,97 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "scene.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace M3mf {
+
+sLib3MFTransform identityTransform()
+{
+    sLib3MFTransform xform;
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            xform.m_Fields[row][col] = (row == col) ? 1.0f : 0.0f;
+        }
+    }
+
+    return xform;
+}
+
+sLib3MFTransform multiply(const sLib3MFTransform& first, const sLib3MFTransform& second)
+{
+    // 3MF transforms act on row vectors, the implicit fourth column is (0, 0, 0, 1)
+    sLib3MFTransform xform;
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            float value = (row == 3) ? second.m_Fields[3][col] : 0.0f;
+            for (int k = 0; k < 3; ++k) {
+                value += first.m_Fields[row][k] * second.m_Fields[k][col];
+            }
+            xform.m_Fields[row][col] = value;
+        }
+    }
+
+    return xform;
+}
+
+void collapseVertexColors(const MeshData& mesh, std::vector<int32_t>& vertices, std::vector<float>& colors)
+{
+    vertices.clear();
+    colors.clear();
+    if (mesh.colors.empty()) {
+        return;
+    }
+
+    // position of every vertex in the output, dense over all vertices of the mesh
+    constexpr uint32_t noSlot { std::numeric_limits<uint32_t>::max() };
+    std::vector<uint32_t> slots(mesh.vertexCount(), noSlot);
+
+    vertices.reserve(mesh.vertexCount());
+    colors.reserve(static_cast<size_t>(mesh.vertexCount()) * 4);
+
+    const size_t triangleCount = mesh.triangleCount();
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+        if (!mesh.colorSources.empty() && mesh.colorSources[triangle] != ColorSource::VertexColor) {
+            continue;
+        }
+
+        for (size_t corner = triangle * 3; corner < triangle * 3 + 3; ++corner) {
+            const uint32_t vertex = mesh.indices[corner];
+            uint32_t& slot = slots[vertex];
+            if (slot == noSlot) {
+                slot = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(static_cast<int32_t>(vertex));
+                colors.resize(colors.size() + 4);
+            }
+
+            const float* rgba = &mesh.colors[corner * 4];
+            std::copy(rgba, rgba + 4, &colors[static_cast<size_t>(slot) * 4]);
+        }
+    }
+}
+
+} // namespace M3mf
@@ -0,0 +1,134 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef PLUGIN_CORE_SCENE_H
+#define PLUGIN_CORE_SCENE_H
+
+#include <lib3mf_implicit.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace M3mf {
+
+// RGBA color
+using ColorRGBA = std::array<float, 4>;
+
+// where the colors of a triangle come from
+enum class ColorSource : uint8_t
+{
+    None,
+    VertexColor,
+    Material
+};
+
+// 3MF base material, identified by its base material group and its property ID in the group.
+// resourceID 0 is the default material of the triangles without a base material.
+struct MaterialData
+{
+    uint32_t resourceID { 0 };
+    uint32_t propertyID { 0 };
+    ColorRGBA color { 0.5f, 0.5f, 0.5f, 1.0f };
+};
+
+// host independent triangle mesh, stored in flat arrays
+struct MeshData
+{
+    std::string name;
+
+    // x, y, z of every vertex
+    std::vector<float> positions;
+
+    // three vertex indices per triangle
+    std::vector<uint32_t> indices;
+
+    // r, g, b, a of the three corners of every triangle, empty if the mesh has no vertex colors
+    std::vector<float> colors;
+
+    // source of the colors of every triangle. Only filled on import, on export
+    // all colors are written as vertex colors.
+    std::vector<ColorSource> colorSources;
+
+    // display color of the whole mesh, written as its base material on export
+    ColorRGBA materialColor { 0.5f, 0.5f, 0.5f, 1.0f };
+
+    // base materials of the triangles in order of first use, never empty. Only filled on import.
+    std::vector<MaterialData> materials;
+
+    // index into materials of every triangle, only filled on import
+    std::vector<uint32_t> faceMaterials;
+
+    // index into SceneData::materials of every entry of materials, filled by importModel
+    std::vector<uint32_t> sceneMaterials;
+
+    uint32_t vertexCount() const
+    {
+        return static_cast<uint32_t>(positions.size() / 3);
+    }
+
+    uint32_t triangleCount() const
+    {
+        return static_cast<uint32_t>(indices.size() / 3);
+    }
+};
+
+// placement of a mesh in the scene
+struct MeshInstance
+{
+    // index into SceneData::meshes
+    uint32_t mesh { 0 };
+
+    // 3MF affine transform (row vectors, translation in the last row)
+    sLib3MFTransform transform;
+
+    std::string name;
+};
+
+// flattened scene: every instance references one of the meshes, and a mesh
+// shared by several instances is stored once
+struct SceneData
+{
+    std::vector<MeshData> meshes;
+    std::vector<MeshInstance> instances;
+
+    // distinct base materials of the meshes, one host material each
+    std::vector<MaterialData> materials;
+};
+
+// one color per vertex from the vertex colored triangle corners, for hosts that store colors
+// per vertex. Where the corners of a vertex disagree, the last one wins. vertices receives the
+// colored vertices in order of first use, colors their r, g, b, a.
+void collapseVertexColors(const MeshData& mesh, std::vector<int32_t>& vertices, std::vector<float>& colors);
+
+// identity transform
+sLib3MFTransform identityTransform();
+
+// transform that applies first, then second
+sLib3MFTransform multiply(const sLib3MFTransform& first, const sLib3MFTransform& second);
+
+} // namespace M3mf
+
+#endif // PLUGIN_CORE_SCENE_H
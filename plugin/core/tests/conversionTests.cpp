@@ -0,0 +1,462 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <conversion.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+namespace M3mf {
+
+namespace {
+
+class ConversionTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        wrapper = Lib3MF::CWrapper::loadLibrary();
+        model = wrapper->CreateModel();
+    }
+
+    // single triangle or a quad of two triangles, offset in x
+    Lib3MF::PMeshObject addMesh(uint32_t triangleCount, float offset)
+    {
+        std::vector<Lib3MF::sPosition> vertices = {
+            { { offset, 0.0f, 0.0f } }, { { offset + 1.0f, 0.0f, 0.0f } }, { { offset + 1.0f, 1.0f, 0.0f } }, { { offset, 1.0f, 0.0f } }
+        };
+        std::vector<Lib3MF::sTriangle> triangles;
+        for (uint32_t i = 0; i < triangleCount; ++i) {
+            triangles.push_back({ { 0, 1 + i % 2, 2 + i % 2 } });
+        }
+
+        Lib3MF::PMeshObject meshObject = model->AddMeshObject();
+        meshObject->SetGeometry(vertices, triangles);
+        return meshObject;
+    }
+
+    // writes the model into a package and reads it into a new one
+    Lib3MF::PModel writeAndRead(const Lib3MF::PModel& source)
+    {
+        std::vector<Lib3MF_uint8> buffer;
+        source->QueryWriter("3mf")->WriteToBuffer(buffer);
+
+        Lib3MF::PModel result = wrapper->CreateModel();
+        result->QueryReader("3mf")->ReadFromBuffer(buffer);
+        return result;
+    }
+
+    Lib3MF::PWrapper wrapper;
+    Lib3MF::PModel model;
+};
+
+sLib3MFTransform translation(float x, float y, float z)
+{
+    sLib3MFTransform transform = identityTransform();
+    transform.m_Fields[3][0] = x;
+    transform.m_Fields[3][1] = y;
+    transform.m_Fields[3][2] = z;
+    return transform;
+}
+
+sLib3MFTransform scale(float factor)
+{
+    sLib3MFTransform transform = identityTransform();
+    for (int i = 0; i < 3; ++i) {
+        transform.m_Fields[i][i] = factor;
+    }
+    return transform;
+}
+
+// 90 degrees around z, x goes to y
+sLib3MFTransform rotationZ()
+{
+    sLib3MFTransform transform = identityTransform();
+    transform.m_Fields[0][0] = 0.0f;
+    transform.m_Fields[0][1] = 1.0f;
+    transform.m_Fields[1][0] = -1.0f;
+    transform.m_Fields[1][1] = 0.0f;
+    return transform;
+}
+
+// point transformed as a row vector
+std::array<float, 3> apply(const sLib3MFTransform& transform, const std::array<float, 3>& point)
+{
+    std::array<float, 3> result;
+    for (int col = 0; col < 3; ++col) {
+        result[col] = transform.m_Fields[3][col];
+        for (int row = 0; row < 3; ++row) {
+            result[col] += point[row] * transform.m_Fields[row][col];
+        }
+    }
+    return result;
+}
+
+void expectTransformEq(const sLib3MFTransform& actual, const sLib3MFTransform& expected)
+{
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            EXPECT_FLOAT_EQ(actual.m_Fields[row][col], expected.m_Fields[row][col]) << "field " << row << ", " << col;
+        }
+    }
+}
+
+void expectColorEq(const float* actual, const ColorRGBA& expected)
+{
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_NEAR(actual[i], expected[i], 1.0f / 255.0f) << "channel " << i;
+    }
+}
+
+// mesh of the given triangles over vertexCount vertices, every corner colored with colors[corner]
+MeshData coloredMesh(uint32_t vertexCount, const std::vector<uint32_t>& indices, const std::vector<ColorRGBA>& colors)
+{
+    MeshData mesh;
+    mesh.positions.resize(vertexCount * 3, 0.0f);
+    mesh.indices = indices;
+    for (const ColorRGBA& color : colors) {
+        mesh.colors.insert(mesh.colors.end(), color.begin(), color.end());
+    }
+    return mesh;
+}
+
+} // namespace
+
+TEST_F(ConversionTest, NestedComponentsComposeTransforms)
+{
+    Lib3MF::PMeshObject meshObject = addMesh(1, 0.0f);
+
+    // mesh scaled by 2 inside a component moved up by 5, inside a build item rotated around z
+    Lib3MF::PComponentsObject inner = model->AddComponentsObject();
+    inner->AddComponent(meshObject.get(), scale(2.0f));
+    Lib3MF::PComponentsObject outer = model->AddComponentsObject();
+    outer->AddComponent(inner.get(), translation(0.0f, 5.0f, 0.0f));
+    model->AddBuildItem(outer.get(), rotationZ());
+
+    // the same mesh once more, directly
+    model->AddBuildItem(meshObject.get(), translation(7.0f, 0.0f, 0.0f));
+
+    SceneData scene;
+    importModel(model, scene);
+
+    ASSERT_EQ(scene.meshes.size(), 1u);
+    ASSERT_EQ(scene.instances.size(), 2u);
+    EXPECT_EQ(scene.instances[0].mesh, 0u);
+    EXPECT_EQ(scene.instances[1].mesh, 0u);
+
+    // (1, 0, 0) -> scaled (2, 0, 0) -> moved (2, 5, 0) -> rotated (-5, 2, 0)
+    const auto point = apply(scene.instances[0].transform, { 1.0f, 0.0f, 0.0f });
+    EXPECT_FLOAT_EQ(point[0], -5.0f);
+    EXPECT_FLOAT_EQ(point[1], 2.0f);
+    EXPECT_FLOAT_EQ(point[2], 0.0f);
+
+    expectTransformEq(scene.instances[0].transform, multiply(multiply(scale(2.0f), translation(0.0f, 5.0f, 0.0f)), rotationZ()));
+    expectTransformEq(scene.instances[1].transform, translation(7.0f, 0.0f, 0.0f));
+}
+
+TEST_F(ConversionTest, ComponentsOtherThanModelAreSkipped)
+{
+    Lib3MF::PMeshObject meshObject = addMesh(1, 0.0f);
+
+    Lib3MF::PComponentsObject support = model->AddComponentsObject();
+    support->SetType(Lib3MF::eObjectType::Support);
+    support->AddComponent(meshObject.get(), identityTransform());
+    model->AddBuildItem(support.get(), identityTransform());
+
+    Lib3MF::PComponentsObject part = model->AddComponentsObject();
+    part->AddComponent(meshObject.get(), translation(1.0f, 2.0f, 3.0f));
+    model->AddBuildItem(part.get(), identityTransform());
+
+    SceneData scene;
+    importModel(model, scene);
+
+    ASSERT_EQ(scene.instances.size(), 1u);
+    expectTransformEq(scene.instances[0].transform, translation(1.0f, 2.0f, 3.0f));
+}
+
+TEST_F(ConversionTest, TrianglesAreBucketedByMaterial)
+{
+    const ColorRGBA red { 1.0f, 0.0f, 0.0f, 1.0f };
+    const ColorRGBA green { 0.0f, 1.0f, 0.0f, 1.0f };
+
+    Lib3MF::PBaseMaterialGroup materials = model->AddBaseMaterialGroup();
+    const uint32_t redID = materials->AddMaterial("red", wrapper->RGBAToColor(255, 0, 0, 255));
+    const uint32_t greenID = materials->AddMaterial("green", wrapper->RGBAToColor(0, 255, 0, 255));
+
+    Lib3MF::PColorGroup colors = model->AddColorGroup();
+    const uint32_t blueID = colors->AddColor(wrapper->RGBAToColor(0, 0, 255, 255));
+    const uint32_t whiteID = colors->AddColor(wrapper->RGBAToColor(255, 255, 255, 255));
+
+    // red, green, vertex colors, red
+    Lib3MF::PMeshObject mixed = addMesh(4, 0.0f);
+    std::vector<Lib3MF::sTriangleProperties> properties(4);
+    properties[0] = { materials->GetResourceID(), { redID, redID, redID } };
+    properties[1] = { materials->GetResourceID(), { greenID, greenID, greenID } };
+    properties[2] = { colors->GetResourceID(), { blueID, whiteID, blueID } };
+    properties[3] = { materials->GetResourceID(), { redID, redID, redID } };
+    mixed->SetAllTriangleProperties(properties);
+    model->AddBuildItem(mixed.get(), identityTransform());
+
+    // red only
+    Lib3MF::PMeshObject plain = addMesh(2, 2.0f);
+    plain->SetObjectLevelProperty(materials->GetResourceID(), redID);
+    plain->SetAllTriangleProperties(std::vector<Lib3MF::sTriangleProperties>(2, properties[0]));
+    model->AddBuildItem(plain.get(), identityTransform());
+
+    // no properties at all
+    Lib3MF::PMeshObject bare = addMesh(1, 4.0f);
+    model->AddBuildItem(bare.get(), identityTransform());
+
+    SceneData scene;
+    importModel(model, scene);
+    ASSERT_EQ(scene.meshes.size(), 3u);
+
+    // materials of the first mesh in order of first use, the vertex colored triangle uses the default
+    const MeshData& mixedMesh = scene.meshes[0];
+    ASSERT_EQ(mixedMesh.materials.size(), 3u);
+    EXPECT_EQ(mixedMesh.materials[0].resourceID, materials->GetResourceID());
+    EXPECT_EQ(mixedMesh.materials[0].propertyID, redID);
+    EXPECT_EQ(mixedMesh.materials[1].propertyID, greenID);
+    EXPECT_EQ(mixedMesh.materials[2].resourceID, 0u);
+    expectColorEq(mixedMesh.materials[0].color.data(), red);
+    expectColorEq(mixedMesh.materials[1].color.data(), green);
+    EXPECT_EQ(mixedMesh.faceMaterials, (std::vector<uint32_t> { 0, 1, 2, 0 }));
+
+    EXPECT_EQ(mixedMesh.colorSources, (std::vector<ColorSource> { ColorSource::Material, ColorSource::Material, ColorSource::VertexColor, ColorSource::Material }));
+    ASSERT_EQ(mixedMesh.colors.size(), 4u * 12u);
+    expectColorEq(&mixedMesh.colors[2 * 12], { 0.0f, 0.0f, 1.0f, 1.0f });
+    expectColorEq(&mixedMesh.colors[2 * 12 + 4], { 1.0f, 1.0f, 1.0f, 1.0f });
+    expectColorEq(&mixedMesh.colors[2 * 12 + 8], { 0.0f, 0.0f, 1.0f, 1.0f });
+
+    const MeshData& plainMesh = scene.meshes[1];
+    ASSERT_EQ(plainMesh.materials.size(), 1u);
+    EXPECT_EQ(plainMesh.faceMaterials, (std::vector<uint32_t> { 0, 0 }));
+    EXPECT_TRUE(plainMesh.colors.empty());
+
+    const MeshData& bareMesh = scene.meshes[2];
+    ASSERT_EQ(bareMesh.materials.size(), 1u);
+    EXPECT_EQ(bareMesh.materials[0].resourceID, 0u);
+
+    // red, green and the default material once for the whole scene
+    ASSERT_EQ(scene.materials.size(), 3u);
+    EXPECT_EQ(mixedMesh.sceneMaterials, (std::vector<uint32_t> { 0, 1, 2 }));
+    EXPECT_EQ(plainMesh.sceneMaterials, (std::vector<uint32_t> { 0 }));
+    EXPECT_EQ(bareMesh.sceneMaterials, (std::vector<uint32_t> { 2 }));
+}
+
+TEST_F(ConversionTest, ObjectLevelMaterialsAreDistinct)
+{
+    Lib3MF::PBaseMaterialGroup materials = model->AddBaseMaterialGroup();
+    const uint32_t redID = materials->AddMaterial("red", wrapper->RGBAToColor(255, 0, 0, 255));
+    const uint32_t blueID = materials->AddMaterial("blue", wrapper->RGBAToColor(0, 0, 255, 255));
+
+    // base materials only on the objects, none on the triangles
+    Lib3MF::PMeshObject redMesh = addMesh(2, 0.0f);
+    redMesh->SetObjectLevelProperty(materials->GetResourceID(), redID);
+    model->AddBuildItem(redMesh.get(), identityTransform());
+
+    Lib3MF::PMeshObject blueMesh = addMesh(2, 2.0f);
+    blueMesh->SetObjectLevelProperty(materials->GetResourceID(), blueID);
+    model->AddBuildItem(blueMesh.get(), identityTransform());
+
+    Lib3MF::PMeshObject bare = addMesh(1, 4.0f);
+    model->AddBuildItem(bare.get(), identityTransform());
+
+    SceneData scene;
+    importModel(model, scene);
+    ASSERT_EQ(scene.meshes.size(), 3u);
+
+    const MeshData& red = scene.meshes[0];
+    ASSERT_EQ(red.materials.size(), 1u);
+    EXPECT_EQ(red.materials[0].resourceID, materials->GetResourceID());
+    EXPECT_EQ(red.materials[0].propertyID, redID);
+    expectColorEq(red.materials[0].color.data(), { 1.0f, 0.0f, 0.0f, 1.0f });
+
+    const MeshData& blue = scene.meshes[1];
+    ASSERT_EQ(blue.materials.size(), 1u);
+    EXPECT_EQ(blue.materials[0].propertyID, blueID);
+    expectColorEq(blue.materials[0].color.data(), { 0.0f, 0.0f, 1.0f, 1.0f });
+
+    // red, blue and the default material of the bare mesh
+    ASSERT_EQ(scene.materials.size(), 3u);
+    EXPECT_EQ(red.sceneMaterials, (std::vector<uint32_t> { 0 }));
+    EXPECT_EQ(blue.sceneMaterials, (std::vector<uint32_t> { 1 }));
+    EXPECT_EQ(scene.meshes[2].sceneMaterials, (std::vector<uint32_t> { 2 }));
+    expectColorEq(scene.materials[0].color.data(), { 1.0f, 0.0f, 0.0f, 1.0f });
+    expectColorEq(scene.materials[1].color.data(), { 0.0f, 0.0f, 1.0f, 1.0f });
+    EXPECT_EQ(scene.materials[2].resourceID, 0u);
+}
+
+TEST_F(ConversionTest, ExportImportRoundTrip)
+{
+    SceneData scene;
+
+    // vertex colored triangle
+    MeshData colored;
+    colored.name = "colored";
+    colored.positions = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+    colored.indices = { 0, 1, 2 };
+    colored.colors = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f };
+    scene.meshes.push_back(colored);
+
+    // quad with one material per triangle, as imported
+    MeshData multiMaterial;
+    multiMaterial.name = "multiMaterial";
+    multiMaterial.positions = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+    multiMaterial.indices = { 0, 1, 2, 0, 2, 3 };
+    multiMaterial.materials = { { 1, 0, { 1.0f, 1.0f, 0.0f, 1.0f } }, { 1, 1, { 0.0f, 1.0f, 1.0f, 1.0f } } };
+    multiMaterial.faceMaterials = { 1, 0 };
+    scene.meshes.push_back(multiMaterial);
+
+    // single material
+    MeshData gray;
+    gray.name = "gray";
+    gray.positions = colored.positions;
+    gray.indices = colored.indices;
+    gray.materialColor = { 0.2f, 0.4f, 0.6f, 1.0f };
+    scene.meshes.push_back(gray);
+
+    for (uint32_t mesh = 0; mesh < 3; ++mesh) {
+        MeshInstance instance;
+        instance.mesh = mesh;
+        instance.transform = multiply(rotationZ(), translation(3.0f * mesh, 1.0f, 2.0f));
+        scene.instances.push_back(instance);
+    }
+
+    exportScene(wrapper, model, scene);
+
+    SceneData imported;
+    importModel(writeAndRead(model), imported);
+
+    ASSERT_EQ(imported.meshes.size(), 3u);
+    ASSERT_EQ(imported.instances.size(), 3u);
+    for (uint32_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(imported.instances[i].mesh, i);
+        expectTransformEq(imported.instances[i].transform, scene.instances[i].transform);
+        EXPECT_EQ(imported.meshes[i].name, scene.meshes[i].name);
+        EXPECT_EQ(imported.meshes[i].positions, scene.meshes[i].positions);
+        EXPECT_EQ(imported.meshes[i].indices, scene.meshes[i].indices);
+    }
+
+    // vertex colors per corner
+    ASSERT_EQ(imported.meshes[0].colors.size(), colored.colors.size());
+    for (size_t corner = 0; corner < 3; ++corner) {
+        expectColorEq(&imported.meshes[0].colors[corner * 4], { colored.colors[corner * 4], colored.colors[corner * 4 + 1], colored.colors[corner * 4 + 2], colored.colors[corner * 4 + 3] });
+    }
+
+    // materials per triangle
+    const MeshData& multiMaterialMesh = imported.meshes[1];
+    ASSERT_EQ(multiMaterialMesh.materials.size(), 2u);
+    expectColorEq(multiMaterialMesh.materials[0].color.data(), multiMaterial.materials[1].color);
+    expectColorEq(multiMaterialMesh.materials[1].color.data(), multiMaterial.materials[0].color);
+    EXPECT_EQ(multiMaterialMesh.faceMaterials, (std::vector<uint32_t> { 0, 1 }));
+
+    // material of the whole mesh
+    const MeshData& grayMesh = imported.meshes[2];
+    ASSERT_EQ(grayMesh.materials.size(), 1u);
+    expectColorEq(grayMesh.materials[0].color.data(), gray.materialColor);
+    expectColorEq(grayMesh.materialColor.data(), gray.materialColor);
+}
+
+TEST(CollapseVertexColors, LastCornerWins)
+{
+    const ColorRGBA red { 1.0f, 0.0f, 0.0f, 1.0f };
+    const ColorRGBA green { 0.0f, 1.0f, 0.0f, 1.0f };
+    const ColorRGBA blue { 0.0f, 0.0f, 1.0f, 1.0f };
+
+    // vertices 1 and 2 are red in the first triangle and green, blue in the second one
+    MeshData mesh = coloredMesh(4, { 0, 1, 2, 2, 1, 3 }, { red, red, red, blue, green, red });
+    mesh.colorSources = { ColorSource::VertexColor, ColorSource::VertexColor };
+
+    std::vector<int32_t> vertices;
+    std::vector<float> colors;
+    collapseVertexColors(mesh, vertices, colors);
+
+    EXPECT_EQ(vertices, (std::vector<int32_t> { 0, 1, 2, 3 }));
+    ASSERT_EQ(colors.size(), 4u * 4u);
+    expectColorEq(&colors[0], red);
+    expectColorEq(&colors[4], green);
+    expectColorEq(&colors[8], blue);
+    expectColorEq(&colors[12], red);
+}
+
+TEST(CollapseVertexColors, SkipsTrianglesWithoutVertexColors)
+{
+    const ColorRGBA red { 1.0f, 0.0f, 0.0f, 1.0f };
+    const ColorRGBA gray { 0.5f, 0.5f, 0.5f, 1.0f };
+    const ColorRGBA black { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    // a vertex colored triangle, then a material and an uncolored one that share its vertices
+    // and must not override their colors
+    MeshData mesh = coloredMesh(5, { 2, 3, 1, 4, 3, 0, 0, 1, 2 }, { red, red, red, gray, gray, gray, black, black, black });
+    mesh.colorSources = { ColorSource::VertexColor, ColorSource::Material, ColorSource::None };
+
+    std::vector<int32_t> vertices;
+    std::vector<float> colors;
+    collapseVertexColors(mesh, vertices, colors);
+
+    // only the vertices of the vertex colored triangle, in the order it uses them
+    EXPECT_EQ(vertices, (std::vector<int32_t> { 2, 3, 1 }));
+    ASSERT_EQ(colors.size(), 3u * 4u);
+    for (size_t vertex = 0; vertex < vertices.size(); ++vertex) {
+        expectColorEq(&colors[vertex * 4], red);
+    }
+}
+
+TEST(CollapseVertexColors, UsesAllTrianglesWithoutColorSources)
+{
+    const ColorRGBA red { 1.0f, 0.0f, 0.0f, 1.0f };
+    const ColorRGBA green { 0.0f, 1.0f, 0.0f, 1.0f };
+
+    // exported meshes have colors but no color sources, all their triangles are vertex colored
+    MeshData mesh = coloredMesh(4, { 3, 1, 0, 0, 2, 3 }, { red, red, red, green, green, green });
+
+    std::vector<int32_t> vertices;
+    std::vector<float> colors;
+    collapseVertexColors(mesh, vertices, colors);
+
+    // order of first use, not of the vertex indices
+    EXPECT_EQ(vertices, (std::vector<int32_t> { 3, 1, 0, 2 }));
+    ASSERT_EQ(colors.size(), 4u * 4u);
+    expectColorEq(&colors[0], green);
+    expectColorEq(&colors[4], red);
+    expectColorEq(&colors[8], green);
+    expectColorEq(&colors[12], green);
+}
+
+TEST(CollapseVertexColors, ClearsOutputWithoutColors)
+{
+    MeshData mesh = coloredMesh(3, { 0, 1, 2 }, {});
+
+    std::vector<int32_t> vertices { 7 };
+    std::vector<float> colors { 1.0f };
+    collapseVertexColors(mesh, vertices, colors);
+
+    EXPECT_TRUE(vertices.empty());
+    EXPECT_TRUE(colors.empty());
+}
+
+} // namespace M3mf
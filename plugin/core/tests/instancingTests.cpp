@@ -0,0 +1,159 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <conversion.h>
+#include <instancing.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace M3mf {
+
+namespace {
+
+// single triangle mesh, offset so different meshes have different geometry
+MeshData triangleMesh(const std::string& name, float offset)
+{
+    MeshData mesh;
+    mesh.name = name;
+    mesh.positions = { offset, 0.0f, 0.0f, offset + 1.0f, 0.0f, 0.0f, offset, 1.0f, 0.0f };
+    mesh.indices = { 0, 1, 2 };
+    return mesh;
+}
+
+sLib3MFTransform translation(float x, float y, float z)
+{
+    sLib3MFTransform transform = identityTransform();
+    transform.m_Fields[3][0] = x;
+    transform.m_Fields[3][1] = y;
+    transform.m_Fields[3][2] = z;
+    return transform;
+}
+
+} // namespace
+
+TEST(InstanceGroups, GroupsInOrderOfFirstNode)
+{
+    InstanceGroups<std::string> instances;
+    EXPECT_EQ(instances.add("sphere", 0), 0u);
+    EXPECT_EQ(instances.add("cube", 1), 1u);
+    EXPECT_EQ(instances.add("sphere", 2), 0u);
+    EXPECT_EQ(instances.add("cone", 3), 2u);
+    EXPECT_EQ(instances.add("cube", 4), 1u);
+
+    const auto& groups = instances.groups();
+    ASSERT_EQ(groups.size(), 3u);
+    EXPECT_EQ(groups[0].key, "sphere");
+    EXPECT_EQ(groups[1].key, "cube");
+    EXPECT_EQ(groups[2].key, "cone");
+
+    EXPECT_EQ(groups[0].nodes, (std::vector<std::size_t> { 0, 2 }));
+    EXPECT_EQ(groups[1].nodes, (std::vector<std::size_t> { 1, 4 }));
+    EXPECT_EQ(groups[2].nodes, (std::vector<std::size_t> { 3 }));
+}
+
+TEST(InstanceGroups, NodeCountAndGroupOf)
+{
+    InstanceGroups<int> instances;
+    EXPECT_EQ(instances.size(), 0u);
+    EXPECT_EQ(instances.nodeCount(), 0u);
+
+    const int keys[] = { 7, 7, 3, 7, 3, 9 };
+    for (std::size_t node = 0; node < 6; ++node) {
+        instances.add(keys[node], node);
+    }
+
+    EXPECT_EQ(instances.size(), 3u);
+    EXPECT_EQ(instances.nodeCount(), 6u);
+
+    const std::size_t expectedGroups[] = { 0, 0, 1, 0, 1, 2 };
+    for (std::size_t node = 0; node < 6; ++node) {
+        EXPECT_EQ(instances.groupOf(node), expectedGroups[node]) << "node " << node;
+        EXPECT_EQ(instances.groups()[instances.groupOf(node)].key, keys[node]);
+    }
+}
+
+TEST(InstanceGroups, SharedMeshIsWrittenOnce)
+{
+    // nodes 0, 2 and 3 instance shape "a", node 1 instances shape "b"
+    InstanceGroups<std::string> instances;
+    const std::string shapes[] = { "a", "b", "a", "a" };
+    for (std::size_t node = 0; node < 4; ++node) {
+        instances.add(shapes[node], node);
+    }
+
+    SceneData scene;
+    for (const auto& group : instances.groups()) {
+        scene.meshes.push_back(triangleMesh(group.key, static_cast<float>(scene.meshes.size())));
+    }
+    for (std::size_t node = 0; node < instances.nodeCount(); ++node) {
+        MeshInstance instance;
+        instance.mesh = static_cast<uint32_t>(instances.groupOf(node));
+        instance.transform = translation(10.0f * node, 0.0f, 0.0f);
+        scene.instances.push_back(instance);
+    }
+
+    Lib3MF::PWrapper wrapper = Lib3MF::CWrapper::loadLibrary();
+    Lib3MF::PModel model = wrapper->CreateModel();
+    exportScene(wrapper, model, scene);
+
+    // write and read back the package
+    std::vector<Lib3MF_uint8> buffer;
+    model->QueryWriter("3mf")->WriteToBuffer(buffer);
+    Lib3MF::PModel readModel = wrapper->CreateModel();
+    readModel->QueryReader("3mf")->ReadFromBuffer(buffer);
+
+    // one mesh resource per shape
+    Lib3MF::PMeshObjectIterator meshObjects = readModel->GetMeshObjects();
+    EXPECT_EQ(meshObjects->Count(), 2u);
+
+    // one build item per node, referencing the resource of its shape
+    Lib3MF::PBuildItemIterator buildItems = readModel->GetBuildItems();
+    ASSERT_EQ(buildItems->Count(), 4u);
+
+    std::vector<uint32_t> resourceIDs;
+    std::vector<float> offsets;
+    while (buildItems->MoveNext()) {
+        Lib3MF::PBuildItem buildItem = buildItems->GetCurrent();
+        resourceIDs.push_back(buildItem->GetObjectResourceID());
+        offsets.push_back(buildItem->GetObjectTransform().m_Fields[3][0]);
+    }
+
+    EXPECT_EQ(resourceIDs[0], resourceIDs[2]);
+    EXPECT_EQ(resourceIDs[0], resourceIDs[3]);
+    EXPECT_NE(resourceIDs[0], resourceIDs[1]);
+    EXPECT_EQ(offsets, (std::vector<float> { 0.0f, 10.0f, 20.0f, 30.0f }));
+
+    // and the import shares them again
+    SceneData imported;
+    importModel(readModel, imported);
+    ASSERT_EQ(imported.meshes.size(), 2u);
+    ASSERT_EQ(imported.instances.size(), 4u);
+    EXPECT_EQ(imported.instances[0].mesh, imported.instances[2].mesh);
+    EXPECT_EQ(imported.instances[0].mesh, imported.instances[3].mesh);
+    EXPECT_NE(imported.instances[0].mesh, imported.instances[1].mesh);
+}
+
+} // namespace M3mf
@@ -0,0 +1,292 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <triangulation.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace M3mf {
+
+namespace {
+
+using Point2 = std::array<float, 2>;
+using Vector3 = std::array<float, 3>;
+
+Vector3 position(const MeshData& mesh, uint32_t vertex)
+{
+    return { mesh.positions[vertex * 3], mesh.positions[vertex * 3 + 1], mesh.positions[vertex * 3 + 2] };
+}
+
+Vector3 triangleNormal(const MeshData& mesh, uint32_t triangle)
+{
+    const Vector3 a = position(mesh, mesh.indices[triangle * 3]);
+    const Vector3 b = position(mesh, mesh.indices[triangle * 3 + 1]);
+    const Vector3 c = position(mesh, mesh.indices[triangle * 3 + 2]);
+    const Vector3 ab { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    const Vector3 ac { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    return { ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+}
+
+float dot(const Vector3& a, const Vector3& b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+float signedArea(const std::vector<Point2>& polygon)
+{
+    float area { 0.0f };
+    for (size_t i = 0; i < polygon.size(); ++i) {
+        const Point2& a = polygon[i];
+        const Point2& b = polygon[(i + 1) % polygon.size()];
+        area += a[0] * b[1] - b[0] * a[1];
+    }
+    return area / 2.0f;
+}
+
+bool isInside(const std::vector<Point2>& polygon, const Point2& point)
+{
+    bool inside { false };
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        const Point2& a = polygon[i];
+        const Point2& b = polygon[j];
+        if ((a[1] > point[1]) != (b[1] > point[1]) && point[0] < (b[0] - a[0]) * (point[1] - a[1]) / (b[1] - a[1]) + a[0]) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+// a polygon in one of the six axis planes: the 2d points are placed into the plane normal to
+// axis, mirrored so that counter clockwise points face -axis instead of +axis if flip is set
+MeshData planarPolygon(const std::vector<Point2>& points, int axis, bool flip)
+{
+    MeshData mesh;
+    for (const Point2& point : points) {
+        Vector3 xyz;
+        xyz[axis] = 3.0f;
+        xyz[(axis + 1) % 3] = flip ? point[1] : point[0];
+        xyz[(axis + 2) % 3] = flip ? point[0] : point[1];
+        mesh.positions.insert(mesh.positions.end(), xyz.begin(), xyz.end());
+    }
+    return mesh;
+}
+
+std::vector<int32_t> sequence(size_t count)
+{
+    std::vector<int32_t> vertices(count);
+    for (size_t i = 0; i < count; ++i) {
+        vertices[i] = static_cast<int32_t>(i);
+    }
+    return vertices;
+}
+
+// triangulates one polygon given in the z = 0 plane
+MeshData triangulate2d(const std::vector<Point2>& polygon)
+{
+    MeshData mesh = planarPolygon(polygon, 2, false);
+    triangulatePolygons({ static_cast<int32_t>(polygon.size()) }, sequence(polygon.size()), {}, mesh);
+    return mesh;
+}
+
+// every triangle faces the way the polygon does, lies inside it, and together they cover it
+void expectCovers(const MeshData& mesh, const std::vector<Point2>& polygon)
+{
+    const float polygonArea = signedArea(polygon);
+    ASSERT_EQ(mesh.triangleCount(), polygon.size() - 2);
+
+    float area { 0.0f };
+    for (uint32_t triangle = 0; triangle < mesh.triangleCount(); ++triangle) {
+        std::vector<Point2> corners;
+        Point2 centroid { 0.0f, 0.0f };
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            const Point2& point = polygon[mesh.indices[triangle * 3 + corner]];
+            corners.push_back(point);
+            centroid[0] += point[0] / 3.0f;
+            centroid[1] += point[1] / 3.0f;
+        }
+
+        const float triangleArea = signedArea(corners);
+        EXPECT_GT(triangleArea * polygonArea, 0.0f) << "triangle " << triangle << " is inverted";
+        EXPECT_TRUE(isInside(polygon, centroid)) << "triangle " << triangle << " is outside";
+        area += triangleArea;
+    }
+
+    EXPECT_NEAR(area, polygonArea, 1e-4f);
+}
+
+// L-shape, counter clockwise
+const std::vector<Point2> lShape { { 0.0f, 0.0f }, { 2.0f, 0.0f }, { 2.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, 2.0f }, { 0.0f, 2.0f } };
+
+std::vector<Point2> star(uint32_t points)
+{
+    std::vector<Point2> polygon;
+    for (uint32_t i = 0; i < points * 2; ++i) {
+        const float angle = 3.14159265f * i / points;
+        const float radius = (i % 2) ? 0.4f : 1.0f;
+        polygon.push_back({ radius * std::cos(angle), radius * std::sin(angle) });
+    }
+    return polygon;
+}
+
+std::vector<Point2> reversed(std::vector<Point2> polygon)
+{
+    std::reverse(polygon.begin(), polygon.end());
+    return polygon;
+}
+
+} // namespace
+
+TEST(Triangulation, ConvexQuadIsFanned)
+{
+    MeshData mesh = triangulate2d({ { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } });
+    EXPECT_EQ(mesh.indices, (std::vector<uint32_t> { 0, 1, 2, 0, 2, 3 }));
+}
+
+TEST(Triangulation, ConvexPolygonIsFanned)
+{
+    std::vector<Point2> hexagon;
+    for (int i = 0; i < 6; ++i) {
+        hexagon.push_back({ std::cos(3.14159265f * i / 3.0f), std::sin(3.14159265f * i / 3.0f) });
+    }
+
+    MeshData mesh = triangulate2d(hexagon);
+    EXPECT_EQ(mesh.indices, (std::vector<uint32_t> { 0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 4, 5 }));
+    expectCovers(mesh, hexagon);
+}
+
+TEST(Triangulation, ConcavePolygonsAreEarClipped)
+{
+    expectCovers(triangulate2d(lShape), lShape);
+    expectCovers(triangulate2d(star(5)), star(5));
+    expectCovers(triangulate2d(star(16)), star(16));
+
+    // arrow, the only concave vertex is not next to the first one
+    const std::vector<Point2> arrow { { 0.0f, 0.0f }, { 2.0f, 0.0f }, { 2.0f, 2.0f }, { 1.0f, 0.5f }, { 0.0f, 2.0f } };
+    expectCovers(triangulate2d(arrow), arrow);
+}
+
+TEST(Triangulation, AnyWindingAndPlane)
+{
+    // counter and clockwise, in all six axis planes, so the normal points along +-x, +-y and +-z
+    for (const std::vector<Point2>& polygon : { lShape, reversed(lShape), star(6), reversed(star(6)) }) {
+        for (int axis = 0; axis < 3; ++axis) {
+            for (bool flip : { false, true }) {
+                SCOPED_TRACE(::testing::Message() << "axis " << axis << (flip ? " flipped" : "") << (signedArea(polygon) > 0.0f ? " ccw" : " cw"));
+
+                MeshData mesh = planarPolygon(polygon, axis, flip);
+                triangulatePolygons({ static_cast<int32_t>(polygon.size()) }, sequence(polygon.size()), {}, mesh);
+                expectCovers(mesh, polygon);
+
+                // the triangles keep the winding, so their normals agree with the polygon's
+                Vector3 normal { 0.0f, 0.0f, 0.0f };
+                normal[axis] = (signedArea(polygon) > 0.0f) != flip ? 1.0f : -1.0f;
+                for (uint32_t triangle = 0; triangle < mesh.triangleCount(); ++triangle) {
+                    EXPECT_GT(dot(triangleNormal(mesh, triangle), normal), 0.0f) << "triangle " << triangle;
+                }
+            }
+        }
+    }
+}
+
+TEST(Triangulation, DegeneratePolygonsFallBackToFan)
+{
+    // the two notches meet in a duplicated vertex, so no corner is an ear
+    const std::vector<Point2> touching { { 0.0f, 0.0f }, { 2.0f, 0.0f }, { 1.0f, 1.0f }, { 2.0f, 2.0f }, { 0.0f, 2.0f }, { 1.0f, 1.0f } };
+
+    // a notch down to a duplicated vertex on a collinear edge
+    const std::vector<Point2> collinear { { 0.0f, 0.0f }, { 2.0f, 0.0f }, { 4.0f, 0.0f }, { 4.0f, 2.0f }, { 2.0f, 0.0f }, { 0.0f, 2.0f } };
+
+    for (const std::vector<Point2>& polygon : { touching, collinear }) {
+        MeshData mesh = triangulate2d(polygon);
+
+        // still n - 2 triangles over the polygon's own vertices
+        ASSERT_EQ(mesh.triangleCount(), polygon.size() - 2);
+        for (uint32_t index : mesh.indices) {
+            EXPECT_LT(index, polygon.size());
+        }
+    }
+}
+
+TEST(Triangulation, PolygonsWithLessThanThreeVerticesAreSkipped)
+{
+    MeshData mesh;
+    for (int i = 0; i < 10; ++i) {
+        mesh.positions.insert(mesh.positions.end(), { static_cast<float>(i % 3), static_cast<float>(i / 3), 0.0f });
+    }
+
+    // line, triangle, point, quad and an empty polygon
+    const std::vector<int32_t> counts { 2, 3, 1, 4, 0 };
+    const std::vector<int32_t> vertices { 8, 9, 0, 1, 3, 7, 1, 2, 5, 4 };
+    std::vector<float> colors;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        colors.insert(colors.end(), { static_cast<float>(i), 0.0f, 0.0f, 1.0f });
+    }
+
+    triangulatePolygons(counts, vertices, colors, mesh);
+    EXPECT_EQ(mesh.indices, (std::vector<uint32_t> { 0, 1, 3, 1, 2, 5, 1, 5, 4 }));
+
+    // the polygon vertices the corners came from
+    ASSERT_EQ(mesh.colors.size(), mesh.indices.size() * 4);
+    const float sources[] = { 2, 3, 4, 6, 7, 8, 6, 8, 9 };
+    for (size_t corner = 0; corner < mesh.indices.size(); ++corner) {
+        EXPECT_EQ(mesh.colors[corner * 4], sources[corner]) << "corner " << corner;
+    }
+}
+
+TEST(Triangulation, ColorsFollowTheirPolygonVertex)
+{
+    // two quads sharing the edge 1-4, with different colors on either side of it
+    MeshData mesh;
+    mesh.positions = { 0, 0, 0, 1, 0, 0, 2, 0, 0, 0, 1, 0, 1, 1, 0, 2, 1, 0 };
+    const std::vector<int32_t> counts { 4, 4 };
+    const std::vector<int32_t> vertices { 0, 1, 4, 3, 1, 2, 5, 4 };
+
+    std::vector<float> colors;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        colors.insert(colors.end(), { static_cast<float>(i), static_cast<float>(vertices[i]), 0.5f, 1.0f });
+    }
+
+    triangulatePolygons(counts, vertices, colors, mesh);
+    EXPECT_EQ(mesh.indices, (std::vector<uint32_t> { 0, 1, 4, 0, 4, 3, 1, 2, 5, 1, 5, 4 }));
+
+    ASSERT_EQ(mesh.colors.size(), mesh.indices.size() * 4);
+    const float sources[] = { 0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7 };
+    for (size_t corner = 0; corner < mesh.indices.size(); ++corner) {
+        EXPECT_EQ(mesh.colors[corner * 4], sources[corner]) << "corner " << corner;
+        EXPECT_EQ(mesh.colors[corner * 4 + 1], static_cast<float>(mesh.indices[corner])) << "corner " << corner;
+        EXPECT_EQ(mesh.colors[corner * 4 + 2], 0.5f);
+        EXPECT_EQ(mesh.colors[corner * 4 + 3], 1.0f);
+    }
+
+    // no colors in, none out
+    triangulatePolygons(counts, vertices, {}, mesh);
+    EXPECT_TRUE(mesh.colors.empty());
+}
+
+} // namespace M3mf
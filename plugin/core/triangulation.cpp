@@ -0,0 +1,265 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "triangulation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace M3mf {
+
+namespace {
+
+using Vector3 = std::array<float, 3>;
+
+Vector3 position(const MeshData& mesh, int32_t vertex)
+{
+    const float* xyz = &mesh.positions[static_cast<size_t>(vertex) * 3];
+    return { xyz[0], xyz[1], xyz[2] };
+}
+
+Vector3 subtract(const Vector3& a, const Vector3& b)
+{
+    return { a[0] - b[0], a[1] - b[1], a[2] - b[2] };
+}
+
+Vector3 cross(const Vector3& a, const Vector3& b)
+{
+    return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+}
+
+float dot(const Vector3& a, const Vector3& b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// triangulates one polygon, corners are relative to its first vertex
+class PolygonTriangulator
+{
+public:
+    PolygonTriangulator(const MeshData& mesh)
+        : _mesh(mesh)
+    {
+    }
+
+    void triangulate(const int32_t* vertices, uint32_t count, std::vector<uint32_t>& corners)
+    {
+        // triangles need no further work
+        if (count == 3) {
+            corners.insert(corners.end(), { 0, 1, 2 });
+            return;
+        }
+
+        _points.resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            _points[i] = position(_mesh, vertices[i]);
+        }
+
+        // Newell's normal, robust for non planar polygons
+        Vector3 normal { 0.0f, 0.0f, 0.0f };
+        for (uint32_t i = 0; i < count; ++i) {
+            const Vector3& current = _points[i];
+            const Vector3& next = _points[(i + 1) % count];
+            normal[0] += (current[1] - next[1]) * (current[2] + next[2]);
+            normal[1] += (current[2] - next[2]) * (current[0] + next[0]);
+            normal[2] += (current[0] - next[0]) * (current[1] + next[1]);
+        }
+
+        if (isConvex(normal)) {
+            fan(count, corners);
+        } else {
+            earClip(normal, count, corners);
+        }
+    }
+
+private:
+    bool isConvex(const Vector3& normal) const
+    {
+        const size_t count = _points.size();
+        for (size_t i = 0; i < count; ++i) {
+            const Vector3 edge = subtract(_points[(i + 1) % count], _points[i]);
+            const Vector3 nextEdge = subtract(_points[(i + 2) % count], _points[(i + 1) % count]);
+            if (dot(cross(edge, nextEdge), normal) < 0.0f) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static void fan(uint32_t count, std::vector<uint32_t>& corners)
+    {
+        for (uint32_t i = 1; i + 1 < count; ++i) {
+            corners.insert(corners.end(), { 0, i, i + 1 });
+        }
+    }
+
+    void earClip(const Vector3& normal, uint32_t count, std::vector<uint32_t>& corners)
+    {
+        // project onto the axis plane the polygon is most parallel to, counter clockwise
+        uint32_t axis = 2;
+        if (std::fabs(normal[0]) > std::fabs(normal[1]) && std::fabs(normal[0]) > std::fabs(normal[2])) {
+            axis = 0;
+        } else if (std::fabs(normal[1]) > std::fabs(normal[2])) {
+            axis = 1;
+        }
+
+        uint32_t u = (axis + 1) % 3;
+        uint32_t v = (axis + 2) % 3;
+        if (normal[axis] < 0.0f) {
+            std::swap(u, v);
+        }
+
+        _projected.resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            _projected[i] = { _points[i][u], _points[i][v] };
+        }
+
+        _remaining.resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            _remaining[i] = i;
+        }
+
+        // cut off one ear after the other, the cursor stays where the last ear was
+        size_t cursor = 0;
+        size_t misses = 0;
+        while (_remaining.size() > 3) {
+            const size_t size = _remaining.size();
+
+            // self intersecting or degenerate, no ear left
+            if (misses == size) {
+                for (size_t i = 1; i + 1 < size; ++i) {
+                    corners.insert(corners.end(), { _remaining[0], _remaining[i], _remaining[i + 1] });
+                }
+                return;
+            }
+
+            const uint32_t previous = _remaining[(cursor + size - 1) % size];
+            const uint32_t current = _remaining[cursor];
+            const uint32_t next = _remaining[(cursor + 1) % size];
+            if (!isEar(previous, current, next)) {
+                cursor = (cursor + 1) % size;
+                ++misses;
+                continue;
+            }
+
+            corners.insert(corners.end(), { previous, current, next });
+            _remaining.erase(_remaining.begin() + cursor);
+            cursor %= _remaining.size();
+            misses = 0;
+        }
+
+        corners.insert(corners.end(), { _remaining[0], _remaining[1], _remaining[2] });
+    }
+
+    bool isEar(uint32_t previous, uint32_t current, uint32_t next) const
+    {
+        const auto& a = _projected[previous];
+        const auto& b = _projected[current];
+        const auto& c = _projected[next];
+
+        // reflex or collinear
+        if (area(a, b, c) <= 0.0f) {
+            return false;
+        }
+
+        // no other vertex may lie inside
+        for (uint32_t other : _remaining) {
+            if (other == previous || other == current || other == next) {
+                continue;
+            }
+
+            const auto& p = _projected[other];
+            if (area(a, b, p) >= 0.0f && area(b, c, p) >= 0.0f && area(c, a, p) >= 0.0f) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static float area(const std::array<float, 2>& a, const std::array<float, 2>& b, const std::array<float, 2>& c)
+    {
+        return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+    }
+
+private:
+    const MeshData& _mesh;
+
+    // scratch buffers, reused across the polygons of a mesh
+    std::vector<Vector3> _points;
+    std::vector<std::array<float, 2>> _projected;
+    std::vector<uint32_t> _remaining;
+};
+
+} // namespace
+
+void triangulatePolygons(const std::vector<int32_t>& polygonCounts,
+                         const std::vector<int32_t>& polygonVertices,
+                         const std::vector<float>& polygonColors,
+                         MeshData& mesh)
+{
+    size_t triangleCount { 0 };
+    for (int32_t count : polygonCounts) {
+        if (count >= 3) {
+            triangleCount += count - 2;
+        }
+    }
+
+    // position of every triangle corner in polygonVertices
+    std::vector<uint32_t> corners;
+    corners.reserve(triangleCount * 3);
+
+    PolygonTriangulator triangulator(mesh);
+    std::vector<uint32_t> polygonCorners;
+    uint32_t offset { 0 };
+    for (int32_t count : polygonCounts) {
+        if (count >= 3) {
+            polygonCorners.clear();
+            triangulator.triangulate(&polygonVertices[offset], static_cast<uint32_t>(count), polygonCorners);
+            for (uint32_t corner : polygonCorners) {
+                corners.push_back(offset + corner);
+            }
+        }
+        offset += static_cast<uint32_t>(count);
+    }
+
+    mesh.indices.resize(corners.size());
+    for (size_t i = 0; i < corners.size(); ++i) {
+        mesh.indices[i] = static_cast<uint32_t>(polygonVertices[corners[i]]);
+    }
+
+    mesh.colors.clear();
+    if (!polygonColors.empty()) {
+        mesh.colors.resize(corners.size() * 4);
+        for (size_t i = 0; i < corners.size(); ++i) {
+            const float* rgba = &polygonColors[static_cast<size_t>(corners[i]) * 4];
+            std::copy(rgba, rgba + 4, &mesh.colors[i * 4]);
+        }
+    }
+}
+
+} // namespace M3mf
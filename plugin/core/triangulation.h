@@ -0,0 +1,48 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef PLUGIN_CORE_TRIANGULATION_H
+#define PLUGIN_CORE_TRIANGULATION_H
+
+#include "scene.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace M3mf {
+
+// fills the triangles of the mesh from a polygon mesh as hosts store it: the vertex count of
+// every polygon and their vertex indices one polygon after the other, indexing mesh.positions.
+// polygonColors holds the r, g, b, a of every polygon vertex, or is empty without colors.
+//
+// Convex polygons are split into a fan, concave ones are ear clipped in the plane of their
+// normal. Polygons with less than three vertices are skipped.
+void triangulatePolygons(const std::vector<int32_t>& polygonCounts,
+                         const std::vector<int32_t>& polygonVertices,
+                         const std::vector<float>& polygonColors,
+                         MeshData& mesh);
+
+} // namespace M3mf
+
+#endif // PLUGIN_CORE_TRIANGULATION_H
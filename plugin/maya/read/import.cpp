@@ -25,20 +25,24 @@
 #include "import.h"
 #include "utility.h"
 
+#include <conversion.h>
+
+#include <maya/MColorArray.h>
 #include <maya/MDagPath.h>
+#include <maya/MFloatPointArray.h>
 #include <maya/MFnLambertShader.h>
 #include <maya/MFnMesh.h>
 #include <maya/MFnSet.h>
+#include <maya/MFnSingleIndexedComponent.h>
 #include <maya/MFnTransform.h>
 #include <maya/MGlobal.h>
 #include <maya/MIntArray.h>
 #include <maya/MMatrix.h>
 #include <maya/MPlug.h>
-#include <maya/MPointArray.h>
 #include <maya/MSelectionList.h>
 
-#include <vector>
 #include <assert.h>
+#include <string>
 
 namespace M3mf {
 
@@ -48,139 +52,97 @@ bool Import::read(std::string_view fileName)
     Lib3MF::PWrapper wrapper = Lib3MF::CWrapper::loadLibrary();
     Lib3MF::PModel model = wrapper->CreateModel();
     Lib3MF::PReader reader3MF = model->QueryReader("3mf");
+
+    // convert the build items into meshes and their instances, only the node creation below
+    // depends on the host
+    SceneData scene;
     try {
         reader3MF->ReadFromFile(fileName.data());
+        importModel(model, scene);
     } catch (Lib3MF::ELib3MFException e) {
         MGlobal::displayError(e.what());
-        return e.getErrorCode();
+        return false;
+    }
+
+    // one lambert shader per distinct material, shared by all the objects using it
+    std::vector<MObject> shadingEngines(scene.materials.size());
+    for (size_t index = 0; index < scene.materials.size(); ++index) {
+        const ColorRGBA& color = scene.materials[index].color;
+        const std::string shaderName = "Material_" + std::to_string(index);
+        MStatus status = createLambertShader(shaderName, MColor(color[0], color[1], color[2], color[3]), shadingEngines[index]);
+        if (!status) {
+            return false;
+        }
     }
 
-    // iterate through builditem(s)
-    Lib3MF::PBuildItemIterator buildItemIterator = model->GetBuildItems();
-    while (buildItemIterator->MoveNext()) {
-        Lib3MF::PBuildItem buildItem = buildItemIterator->GetCurrent();
-        Lib3MF::PObject object = buildItem->GetObjectResource();
-
-        // name
-        std::string_view objectName;
-        if (object->GetName().empty()) {
-            const std::string name { "Object_" + std::to_string(buildItem->GetObjectResourceID()) };
-            objectName = name;
-        } else {
-            objectName = object->GetName();
+    // face components of the meshes with several materials, shared by their instances
+    std::vector<std::vector<MObject>> faceComponents(scene.meshes.size());
+
+    // the members of every shading engine are collected and added at once
+    std::vector<MSelectionList> members(scene.materials.size());
+    for (const MeshInstance& instance : scene.instances) {
+        const MeshData& mesh = scene.meshes[instance.mesh];
+
+        MObject meshObject;
+        MStatus status = createMeshObject(mesh, instance, meshObject);
+        if (!status) {
+            return false;
         }
 
-        // transform
-        sLib3MFTransform affineTransform;
-        if (buildItem->HasObjectTransform()) {
-            affineTransform = std::move(buildItem->GetObjectTransform());
-        } else {
-            affineTransform = std::move(wrapper->GetIdentityTransform());
+        MDagPath meshPath;
+        MDagPath::getAPathTo(meshObject, meshPath);
+
+        // whole object
+        if (mesh.sceneMaterials.size() == 1) {
+            members[mesh.sceneMaterials[0]].add(meshPath);
+            continue;
         }
 
-        // components
-        if (object->IsComponentsObject()) {
-            Lib3MF::PComponentsObject componentsObject = model->GetComponentsObjectByID(object->GetResourceID());
-
-            // we care only about model. ignore support, solidsupport, other
-            if (componentsObject->GetType() == Lib3MF::eObjectType::Model) {
-                for (uint32_t nIndex = 0; nIndex < componentsObject->GetComponentCount(); nIndex++) {
-                    Lib3MF::PComponent component = componentsObject->GetComponent(nIndex);
-
-                    sLib3MFTransform compAffineTransform;
-                    if (component->HasTransform()) {
-                        compAffineTransform = std::move(component->GetTransform());
-                    } else {
-                        compAffineTransform = std::move(affineTransform);
-                    }
-
-                    Lib3MF::PMeshObject meshObject = model->GetMeshObjectByID(component->GetObjectResourceID());
-                    MStatus status = createMeshObject(wrapper, model, meshObject, compAffineTransform, objectName);
-                    if (!status) {
-                        return false;
-                    }
-                }
-            }
+        // the faces of every material
+        std::vector<MObject>& components = faceComponents[instance.mesh];
+        if (components.empty()) {
+            components = createFaceComponents(mesh);
         }
 
-        // mesh
-        if (object->IsMeshObject()) {
-            Lib3MF::PMeshObject meshObject = model->GetMeshObjectByID(object->GetResourceID());
-            MStatus status = createMeshObject(wrapper, model, meshObject, affineTransform, objectName);
+        for (size_t slot = 0; slot < components.size(); ++slot) {
+            members[mesh.sceneMaterials[slot]].add(meshPath, components[slot]);
+        }
+    }
 
-            if (!status) {
-                return false;
-            }
+    for (size_t index = 0; index < shadingEngines.size(); ++index) {
+        MFnSet fnSet(shadingEngines[index]);
+        MStatus status = fnSet.addMembers(members[index]);
+        if (!status) {
+            M3mf::messageBox("Error", "Adding shadingEngine members failed!");
+            return false;
         }
     }
 
     return true;
 }
 
-MStatus Import::createMeshObject(const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model, const Lib3MF::PMeshObject& mesh, const sLib3MFTransform& transform, std::string_view objectName)
+MStatus Import::createMeshObject(const MeshData& mesh, const MeshInstance& instance, MObject& meshObject)
 {
     MStatus status { MS::kSuccess };
 
-    MPointArray vertPosArray(mesh->GetVertexCount());
-    MIntArray faceCounts(mesh->GetTriangleCount());
-    MIntArray faceIndices;
-
-    // vertex index, color(rgba)
-    M3mf::SetOfIndexAndVertColor vertColorSet;
+    const uint32_t vertexCount = mesh.vertexCount();
+    const uint32_t triangleCount = mesh.triangleCount();
 
-    // base material color
-    M3mf::Color materialColor { 0.5f, 0.5f, 0.5f };
-
-    {
-        // fill out verts positions
-        std::vector<Lib3MF::sPosition> vertPos;
-        mesh->GetVertices(vertPos);
-
-        for (uint32_t index = 0; index < vertPos.size(); ++index) {
-            vertPosArray.set(index, vertPos[index].m_Coordinates[0], vertPos[index].m_Coordinates[1], vertPos[index].m_Coordinates[2]);
-        }
-
-        // fill out polygonCounts, polygonConnects
-        std::vector<Lib3MF::sTriangle> triangleIndices;
-        mesh->GetTriangleIndices(triangleIndices);
-
-        // triangle properties
-        std::vector<Lib3MF::sTriangleProperties> properties;
-        mesh->GetAllTriangleProperties(properties);
-
-        // verify that lib3mf resource ID is present in model
-        ResourceIDCheck resourceIDCheck(model);
-
-        for (uint32_t index = 0; index < mesh->GetTriangleCount(); ++index) {
-            // each face is a triangle only.
-            faceCounts.set(3, index);
-
-            // face indices
-            for (int tIndex = 0; tIndex < 3; ++tIndex) {
-                faceIndices.append(triangleIndices[index].m_Indices[tIndex]);
-            }
-
-            // color
-            if (resourceIDCheck.isRessourceIDValid(properties[index].m_ResourceID) && model->GetPropertyTypeByID(properties[index].m_ResourceID) == Lib3MF::ePropertyType::Colors) {
-                Lib3MF::PColorGroup colorGroup = model->GetColorGroupByID(properties[index].m_ResourceID);
-                for (int j = 0; j < 3; j++) {
-                    M3mf::Color vertexColor;
-                    wrapper->ColorToFloatRGBA(colorGroup->GetColor(properties[index].m_PropertyIDs[j]), vertexColor[0], vertexColor[1], vertexColor[2], vertexColor[3]);
-
-                    vertColorSet.emplace(std::make_pair(triangleIndices[index].m_Indices[j], vertexColor));
-                }
-            }
-
-            // baseMaterial
-            if (resourceIDCheck.isRessourceIDValid(properties[index].m_ResourceID) && model->GetPropertyTypeByID(properties[index].m_ResourceID) == Lib3MF::ePropertyType::BaseMaterial) {
-                Lib3MF::PBaseMaterialGroup baseMaterialGroup = model->GetBaseMaterialGroupByID(properties[index].m_ResourceID);
+    // fill out verts positions
+    MFloatPointArray vertPosArray(vertexCount);
+    for (uint32_t index = 0; index < vertexCount; ++index) {
+        vertPosArray.set(index, mesh.positions[index * 3], mesh.positions[index * 3 + 1], mesh.positions[index * 3 + 2]);
+    }
 
-                sLib3MFColor color(baseMaterialGroup->GetDisplayColor(properties[index].m_PropertyIDs[0]));
+    // fill out polygonCounts, polygonConnects. each face is a triangle only, so the
+    // connects are the index buffer as is.
+    MIntArray faceCounts(triangleCount, 3);
+    MIntArray faceIndices(reinterpret_cast<const int*>(mesh.indices.data()), triangleCount * 3);
 
-                wrapper->ColorToFloatRGBA(color, materialColor[0], materialColor[1], materialColor[2], materialColor[3]);
-            }
-        }
-    }
+    // one color per vertex
+    std::vector<int32_t> coloredVertices;
+    std::vector<float> vertexColors;
+    collapseVertexColors(mesh, coloredVertices, vertexColors);
 
     // dummy transform
     MFnTransform fnTransform;
@@ -192,7 +154,7 @@ MStatus Import::createMeshObject(const Lib3MF::PWrapper& wrapper, const Lib3MF::
 
     // mesh object
     MFnMesh meshFn;
-    MObject meshObject = meshFn.create(vertPosArray.length(), faceCounts.length(), vertPosArray, faceCounts, faceIndices, parent, &status);
+    meshObject = meshFn.create(vertPosArray.length(), faceCounts.length(), vertPosArray, faceCounts, faceIndices, parent, &status);
 
     if (status != MS::kSuccess) {
         M3mf::messageBox("Error", "Failed to create MFnMesh!");
@@ -200,21 +162,45 @@ MStatus Import::createMeshObject(const Lib3MF::PWrapper& wrapper, const Lib3MF::
     }
 
     // set affine transform
-    MTransformationMatrix xformM(M3mf::convert(transform));
+    MTransformationMatrix xformM(M3mf::convert(instance.transform));
     fnTransform.set(xformM.asMatrix());
 
     // vertex color
-    if (vertColorSet.size() > 0) {
-        status = assignVertexColors(meshObject, vertColorSet);
+    if (!coloredVertices.empty()) {
+        status = assignVertexColors(meshObject, coloredVertices, vertexColors);
     }
 
-    // base material
-    status = assignLamabertShader(meshObject, objectName.data(), MColor(materialColor[0], materialColor[1], materialColor[2], materialColor[3]));
-
     return status;
 }
 
-MStatus Import::assignVertexColors(const MObject& object, const SetOfIndexAndVertColor& vertColorSet)
+std::vector<MObject> Import::createFaceComponents(const MeshData& mesh)
+{
+    // bucket the faces by material in one pass, counting sort over the material slots
+    std::vector<uint32_t> offsets(mesh.materials.size() + 1, 0);
+    for (uint32_t slot : mesh.faceMaterials) {
+        ++offsets[slot + 1];
+    }
+    for (size_t slot = 1; slot < offsets.size(); ++slot) {
+        offsets[slot] += offsets[slot - 1];
+    }
+
+    std::vector<int> faces(mesh.faceMaterials.size());
+    std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+    for (size_t face = 0; face < mesh.faceMaterials.size(); ++face) {
+        faces[cursors[mesh.faceMaterials[face]]++] = static_cast<int>(face);
+    }
+
+    std::vector<MObject> components(mesh.materials.size());
+    for (size_t slot = 0; slot < components.size(); ++slot) {
+        MFnSingleIndexedComponent componentFn;
+        components[slot] = componentFn.create(MFn::kMeshPolygonComponent);
+        componentFn.addElements(MIntArray(faces.data() + offsets[slot], offsets[slot + 1] - offsets[slot]));
+    }
+
+    return components;
+}
+
+MStatus Import::assignVertexColors(const MObject& object, const std::vector<int32_t>& vertices, const std::vector<float>& colors)
 {
     MStatus status { MS::kSuccess };
 
@@ -225,17 +211,11 @@ MStatus Import::assignVertexColors(const MObject& object, const SetOfIndexAndVer
     MFnMesh meshFn(object);
 
     // setVertexColors
-    const uint32_t size = static_cast<uint32_t>(vertColorSet.size());
-    MColorArray colorArray(size);
-    MIntArray vertexList(size);
-
-    for (auto const& [index, color] : vertColorSet) {
-        vertexList.append(index);
-        MColor mColor(color[0], color[1], color[2], color[3]);
-        colorArray.append(mColor);
-    }
+    assert(colors.size() == vertices.size() * 4);
 
-    assert(colorArray.length() == vertexList.length());
+    const uint32_t size = static_cast<uint32_t>(vertices.size());
+    MColorArray colorArray(reinterpret_cast<const float(*)[4]>(colors.data()), size);
+    MIntArray vertexList(vertices.data(), size);
 
     status = meshFn.setVertexColors(colorArray, vertexList);
     if (!status) {
@@ -251,7 +231,7 @@ MStatus Import::assignVertexColors(const MObject& object, const SetOfIndexAndVer
     return status;
 }
 
-MStatus Import::assignLamabertShader(const MObject& object, std::string_view shaderName, const MColor& color)
+MStatus Import::createLambertShader(std::string_view shaderName, const MColor& color, MObject& shadingEngine)
 {
     MStatus status { MS::kSuccess };
 
@@ -273,14 +253,13 @@ MStatus Import::assignLamabertShader(const MObject& object, std::string_view sha
 
     MFnSet fnSet;
     MSelectionList selList;
-    MObject shadingEngine = fnSet.create(selList, MFnSet::kRenderableOnly, &status);
+    shadingEngine = fnSet.create(selList, MFnSet::kRenderableOnly, &status);
     if (!status) {
         M3mf::messageBox("Error", "creating shadingEngine failed!");
         return status;
     }
 
     fnSet.setName("shadingEngineGroup", &status);
-    fnSet.addMember(object);
     MFnSet fnSetShaderPlg(shadingEngine, &status);
     if (!status) {
         M3mf::messageBox("Error", "shadingEngineGroup failed!");
@@ -298,25 +277,4 @@ MStatus Import::assignLamabertShader(const MObject& object, std::string_view sha
     return status;
 }
 
-ResourceIDCheck::ResourceIDCheck(Lib3MF::PModel model)
-{
-    auto pResources = model->GetResources();
-    if (pResources->Count() != 0) {
-        while (pResources->MoveNext()) {
-            auto pResource = pResources->GetCurrent();
-            _resourceIDs.insert(pResource->GetResourceID());
-        }
-    }
-}
-
-bool ResourceIDCheck::isRessourceIDValid(uint32_t ID)
-{
-    auto iter = _resourceIDs.find(ID);
-    if (iter != _resourceIDs.end()) {
-        return true;
-    } else {
-        return false;
-    }
-}
-
 } // namespace M3mf
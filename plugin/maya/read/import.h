@@ -27,11 +27,12 @@
 
 #include "types.h"
 
-#include <lib3mf_implicit.hpp>
+#include <scene.h>
 
 #include <maya/MStatus.h>
 
 #include <string_view>
+#include <vector>
 
 namespace M3mf {
 
@@ -49,30 +50,20 @@ public:
     bool read(std::string_view fileName);
 
 private:
-    MStatus createMeshObject(const Lib3MF::PWrapper& wrapper, 
-                             const Lib3MF::PModel& model, 
-                             const Lib3MF::PMeshObject& mesh, 
-                             const sLib3MFTransform& transform, 
-                             std::string_view objectName);
+    MStatus createMeshObject(const MeshData& mesh, const MeshInstance& instance, MObject& meshObject);
 
-    MStatus assignVertexColors(const MObject& object, 
-                               const SetOfIndexAndVertColor& vertColorSet);
-
-    MStatus assignLamabertShader(const MObject& object, 
-                                 std::string_view shaderName, 
-                                 const MColor& color);
-};
+    // one polygon component per material of the mesh with its faces
+    std::vector<MObject> createFaceComponents(const MeshData& mesh);
 
-class ResourceIDCheck
-{
-public:
-    ResourceIDCheck(Lib3MF::PModel model);
-    bool isRessourceIDValid(uint32_t ID);
+    MStatus assignVertexColors(const MObject& object, 
+                               const std::vector<int32_t>& vertices, 
+                               const std::vector<float>& colors);
 
-private:
-    std::set<uint32_t> _resourceIDs;
+    MStatus createLambertShader(std::string_view shaderName, 
+                                const MColor& color, 
+                                MObject& shadingEngine);
 };
 
 } // namespace M3mf
 
-#endif // PLUGIN_MAYA_IMPORT_H
\ No newline at end of file
+#endif // PLUGIN_MAYA_IMPORT_H
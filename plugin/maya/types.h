@@ -23,7 +23,6 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <array>
-#include <set>
 
 #ifndef PLUGIN_MAYA_TYPES_H
 #define PLUGIN_MAYA_TYPES_H
@@ -33,8 +32,6 @@ namespace M3mf {
 // RGBA color
 using Color = std::array<float, 4>;
 
-using SetOfIndexAndVertColor = std::set<std::pair<uint32_t, Color>>;
-
 } // namespace M3mf
 
 #endif // PLUGIN_MAYA_TYPES_H
\ No newline at end of file
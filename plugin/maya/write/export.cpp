@@ -26,6 +26,11 @@
 #include "types.h"
 #include "utility.h"
 
+#include <conversion.h>
+#include <instancing.h>
+#include <triangulation.h>
+
+#include <maya/MColorArray.h>
 #include <maya/MDagPath.h>
 #include <maya/MFloatPointArray.h>
 #include <maya/MFnMesh.h>
@@ -35,6 +40,7 @@
 #include <maya/MIntArray.h>
 #include <maya/MItDependencyNodes.h>
 #include <maya/MMatrix.h>
+#include <maya/MObjectHandle.h>
 #include <maya/MPlug.h>
 #include <maya/MPlugArray.h>
 #include <maya/MSelectionList.h>
@@ -45,6 +51,18 @@
 
 namespace M3mf {
 
+namespace {
+
+struct ObjectHandleHash
+{
+    std::size_t operator()(const MObjectHandle& handle) const
+    {
+        return handle.hashCode();
+    }
+};
+
+} // namespace
+
 bool Export::write(std::string_view fileName, bool isSelected)
 {
     Lib3MF::PWrapper wrapper = Lib3MF::CWrapper::loadLibrary();
@@ -84,7 +102,7 @@ bool Export::exportSelected(const Lib3MF::PWrapper& wrapper, const Lib3MF::PMode
     }
 
     // iterate through all selected items
-    MStatus status { MS::kSuccess };
+    MDagPathArray paths;
     for (uint32_t i = 0; i < list.length(); ++i) {
         MDagPath path;
         list.getDagPath(i, path);
@@ -95,134 +113,130 @@ bool Export::exportSelected(const Lib3MF::PWrapper& wrapper, const Lib3MF::PMode
             path.pop(); // pop from the shape to the transform
         }
 
-        // create build item(s)
-        if (!createBuildItem(path, wrapper, model)) {
-            return false;
-        }
+        paths.append(path);
     }
 
-    return true;
+    return exportNodes(paths, wrapper, model);
 }
 
 bool Export::exportAll(const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model)
 {
-    MStatus status { MS::kSuccess };
+    MDagPathArray paths;
 
     MItDependencyNodes it(MFn::kMesh);
     while (!it.isDone()) {
-        MObject obj = it.item();
-        MDagPath pathToMeshObject = MDagPath::getAPathTo(obj);
-
-        MFnDagNode dagFn(pathToMeshObject);
-        MDagPath path;
-        dagFn.getPath(path);
-        path.pop(); // pop from the shape to the transform
+        // every instance of the shape becomes a build item
+        MDagPathArray pathsToMeshObject;
+        MDagPath::getAllPathsTo(it.item(), pathsToMeshObject);
 
-        // create build item(s)
-        if (!createBuildItem(path, wrapper, model)) {
-            return false;
+        for (uint32_t i = 0; i < pathsToMeshObject.length(); ++i) {
+            MDagPath path = pathsToMeshObject[i];
+            path.pop(); // pop from the shape to the transform
+            paths.append(path);
         }
 
         it.next();
     }
 
-    return true;
+    return exportNodes(paths, wrapper, model);
 }
 
-bool Export::createBuildItem(MDagPath& dagPath, const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model)
+bool Export::exportNodes(const MDagPathArray& paths, const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model)
 {
-    MStatus status { MS::kSuccess };
+    // group the transforms by the shape they instance
+    InstanceGroups<MObjectHandle, ObjectHandleHash> instances;
+    MDagPathArray shapePaths;
+    for (uint32_t i = 0; i < paths.length(); ++i) {
+        MDagPath shapePath = paths[i];
+        if (shapePath.apiType() == MFn::kTransform) {
+            shapePath.extendToShape();
+        }
+        if (shapePath.node().apiType() != MFn::kMesh) {
+            M3mf::messageBox("Error", "Object is not a mesh.");
+            return false;
+        }
 
-    // xform
-    MFnTransform xform(dagPath);
-    MTransformationMatrix xformM = xform.transformation(&status);
-    if (!status) {
-        M3mf::messageBox("Error", "Failed to get MTransformationMatrix.");
-        return false;
+        instances.add(MObjectHandle(shapePath.node()), i);
+        shapePaths.append(shapePath);
     }
 
-    // mesh
-    if (dagPath.apiType() == MFn::kTransform) {
-        dagPath.extendToShape();
-        if (dagPath.node().apiType() != MFn::kMesh) {
-            M3mf::messageBox("Error", "Object is not a mesh.");
+    // one mesh per shape, one instance per transform in selection/scene order
+    SceneData scene;
+    scene.meshes.resize(instances.size());
+    for (size_t i = 0; i < instances.size(); ++i) {
+        const auto& group = instances.groups()[i];
+        if (!extractMesh(shapePaths[static_cast<uint32_t>(group.nodes.front())], scene.meshes[i])) {
+            return false;
+        }
+    }
+
+    scene.instances.resize(paths.length());
+    for (uint32_t i = 0; i < paths.length(); ++i) {
+        scene.instances[i].mesh = static_cast<uint32_t>(instances.groupOf(i));
+        if (!extractTransform(paths[i], scene.instances[i])) {
             return false;
         }
     }
 
-    MFnMesh meshFn(dagPath.node(), &status);
+    exportScene(wrapper, model, scene);
+
+    return true;
+}
+
+bool Export::extractMesh(const MDagPath& shapePath, MeshData& mesh)
+{
+    MStatus status { MS::kSuccess };
+
+    MFnMesh meshFn(shapePath, &status);
     if (!status) {
         M3mf::messageBox("Error", "Failed to create MFnMesh.");
         return false;
     }
 
+    mesh.name = meshFn.fullPathName().asChar();
+
     // vertices
     MFloatPointArray vertPositions;
     meshFn.getPoints(vertPositions);
 
-    std::vector<Lib3MF::sPosition> vertices;
-    vertices.resize(vertPositions.length());
-    for (auto i = 0; i < vertices.size(); ++i) {
-        MVector vertPos(vertPositions[i].x, vertPositions[i].y, vertPositions[i].z);
-        vertices[i].m_Coordinates[0] = static_cast<float>(vertPos.x);
-        vertices[i].m_Coordinates[1] = static_cast<float>(vertPos.y);
-        vertices[i].m_Coordinates[2] = static_cast<float>(vertPos.z);
-    }
-
-    // triangle
-    std::vector<Lib3MF::sTriangle> triangles;
-    triangles.resize(meshFn.numPolygons());
-    MIntArray faceVertices;
-    for (auto i = 0; i < meshFn.numPolygons(); ++i) {
-        meshFn.getPolygonVertices(i, faceVertices);
-        if (faceVertices.length() < 3) {
-            continue;
-        }
-        if (faceVertices.length() > 3) {
-            m_needToTriangulate = true;
-            break;
-        }
-        for (auto j = 0; j < 3; ++j) {
-            triangles[i].m_Indices[j] = faceVertices[j];
-        }
+    mesh.positions.resize(vertPositions.length() * 3);
+    for (uint32_t i = 0; i < vertPositions.length(); ++i) {
+        mesh.positions[i * 3] = vertPositions[i].x;
+        mesh.positions[i * 3 + 1] = vertPositions[i].y;
+        mesh.positions[i * 3 + 2] = vertPositions[i].z;
     }
 
-    if (m_needToTriangulate) {
-        M3mf::messageBox("Error", "Export failed. Please triangluate the mesh before export.");
-        return false;
-    }
+    // polygons, with one color per polygon vertex
+    MIntArray polygonCounts;
+    MIntArray polygonVertices;
+    meshFn.getVertices(polygonCounts, polygonVertices);
 
-    // add mesh object
-    auto meshObject = model->AddMeshObject();
-    meshObject->SetName(meshFn.fullPathName().asChar());
-    meshObject->SetGeometry(vertices, triangles);
+    std::vector<int32_t> counts(polygonCounts.length());
+    polygonCounts.get(counts.data());
+    std::vector<int32_t> vertices(polygonVertices.length());
+    polygonVertices.get(vertices.data());
 
-    // color group
     MColorArray vertColors;
     meshFn.getFaceVertexColors(vertColors);
 
-    if (vertColors.length() > 0) {
-        auto colorGroup = model->AddColorGroup();
-        for (auto i = 0; i < meshFn.numPolygons(); i++) {
-            sLib3MFTriangleProperties sTriangleProperty;
-            sTriangleProperty.m_ResourceID = colorGroup->GetResourceID();
-            for (int j = 0; j < 3; j++) {
-                sTriangleProperty.m_PropertyIDs[j] = colorGroup->AddColor(wrapper->FloatRGBAToColor(vertColors[i * 3 + j][0], vertColors[i * 3 + j][1], vertColors[i * 3 + j][2], 1.0f));
-            }
+    std::vector<float> colors;
+    if (vertColors.length() > 0 && vertColors.length() == polygonVertices.length()) {
+        colors.resize(vertColors.length() * 4);
+        vertColors.get(reinterpret_cast<float(*)[4]>(colors.data()));
+        for (size_t i = 3; i < colors.size(); i += 4) {
+            colors[i] = 1.0f;
+        }
+    }
 
-            meshObject->SetTriangleProperties(i, sTriangleProperty);
+    // triangles, n-gons are triangulated on the fly
+    triangulatePolygons(counts, vertices, colors, mesh);
 
-            // Object Level Property
-            if (i == 0) {
-                meshObject->SetObjectLevelProperty(sTriangleProperty.m_ResourceID, sTriangleProperty.m_PropertyIDs[0]);
-            }
-        }
-    } else {
+    if (mesh.colors.empty()) {
         // Material
         MObjectArray shaders;
         MIntArray indices;
         meshFn.getConnectedShaders(0, shaders, indices);
-        M3mf::Color diffuseColor;
+        M3mf::Color diffuseColor { 0.5f, 0.5f, 0.5f, 1.0f };
         for (uint32_t index = 0; index < shaders.length(); ++index) {
             MPlugArray connections;
             MFnDependencyNode shaderGroup(shaders[index]);
@@ -245,24 +259,26 @@ bool Export::createBuildItem(MDagPath& dagPath, const Lib3MF::PWrapper& wrapper,
             }
         }
 
-        auto baseMaterialGroup = model->AddBaseMaterialGroup();
-        Lib3MF_uint32 diffColor = baseMaterialGroup->AddMaterial("Material Color", wrapper->FloatRGBAToColor(diffuseColor[0], diffuseColor[1], diffuseColor[2], 1.0f));
+        mesh.materialColor = { diffuseColor[0], diffuseColor[1], diffuseColor[2], 1.0f };
+    }
 
-        sLib3MFTriangleProperties sTriangleProperty;
-        sTriangleProperty.m_ResourceID = baseMaterialGroup->GetResourceID();
-        sTriangleProperty.m_PropertyIDs[0] = diffColor;
-        sTriangleProperty.m_PropertyIDs[1] = diffColor;
-        sTriangleProperty.m_PropertyIDs[2] = diffColor;
+    return true;
+}
 
-        for (auto i = 0; i < meshFn.numPolygons(); i++) {
-            meshObject->SetTriangleProperties(i, sTriangleProperty);
-        }
+bool Export::extractTransform(const MDagPath& dagPath, MeshInstance& instance)
+{
+    MStatus status { MS::kSuccess };
 
-        // set object property
-        meshObject->SetObjectLevelProperty(sTriangleProperty.m_ResourceID, sTriangleProperty.m_PropertyIDs[0]);
+    // xform
+    MFnTransform xform(dagPath);
+    MTransformationMatrix xformM = xform.transformation(&status);
+    if (!status) {
+        M3mf::messageBox("Error", "Failed to get MTransformationMatrix.");
+        return false;
     }
 
-    model->AddBuildItem(meshObject.get(), M3mf::convert(xformM.asMatrix()));
+    instance.transform = M3mf::convert(xformM.asMatrix());
+    instance.name = dagPath.partialPathName().asChar();
 
     return true;
 }
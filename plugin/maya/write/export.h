@@ -25,10 +25,13 @@
 #ifndef PLUGIN_MAYA_EXPORT_H
 #define PLUGIN_MAYA_EXPORT_H
 
+#include <scene.h>
+
 #include <lib3mf_implicit.hpp>
 
 #include <maya/MObject.h>
 #include <maya/MDagPath.h>
+#include <maya/MDagPathArray.h>
 
 #include <string_view>
 
@@ -52,10 +55,11 @@ private:
 
     bool exportAll(const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model);
 
-    bool createBuildItem(MDagPath& dagPath, const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model);
+    bool exportNodes(const MDagPathArray& paths, const Lib3MF::PWrapper& wrapper, const Lib3MF::PModel& model);
 
-private:
-    bool m_needToTriangulate { false };
+    bool extractMesh(const MDagPath& shapePath, MeshData& mesh);
+
+    bool extractTransform(const MDagPath& dagPath, MeshInstance& instance);
 };
 
 } // namespace M3mf
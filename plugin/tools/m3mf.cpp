@@ -0,0 +1,123 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Command line front end of the host independent conversion core. Runs the same
+// 3MF <-> scene conversions as the Maya and 3DSMax plugins without a host.
+//
+// usage:
+//   m3mf info <file.3mf>
+//   m3mf convert <input.3mf> <output.3mf>
+
+#include <conversion.h>
+
+#include <fmt/format.h>
+
+#include <lib3mf_implicit.hpp>
+
+#include <cstring>
+#include <string>
+
+namespace {
+
+void printUsage()
+{
+    fmt::print(stderr,
+               "usage:\n"
+               "  m3mf info <file.3mf>                   print the scene a 3MF file converts into\n"
+               "  m3mf convert <input.3mf> <output.3mf>  import a 3MF file into a scene and export it again\n");
+}
+
+void printScene(const M3mf::SceneData& scene)
+{
+    uint64_t vertexCount { 0 };
+    uint64_t triangleCount { 0 };
+    uint64_t coloredMeshCount { 0 };
+    for (const auto& mesh : scene.meshes) {
+        vertexCount += mesh.vertexCount();
+        triangleCount += mesh.triangleCount();
+        if (!mesh.colors.empty()) {
+            ++coloredMeshCount;
+        }
+    }
+
+    fmt::print("meshes:         {}\n", scene.meshes.size());
+    fmt::print("instances:      {}\n", scene.instances.size());
+    fmt::print("materials:      {}\n", scene.materials.size());
+    fmt::print("vertices:       {}\n", vertexCount);
+    fmt::print("triangles:      {}\n", triangleCount);
+    fmt::print("colored meshes: {}\n", coloredMeshCount);
+}
+
+int info(const std::string& fileName)
+{
+    Lib3MF::PWrapper wrapper = Lib3MF::CWrapper::loadLibrary();
+    Lib3MF::PModel model = wrapper->CreateModel();
+    model->QueryReader("3mf")->ReadFromFile(fileName);
+
+    M3mf::SceneData scene;
+    M3mf::importModel(model, scene);
+
+    printScene(scene);
+
+    return 0;
+}
+
+int convert(const std::string& inputFileName, const std::string& outputFileName)
+{
+    Lib3MF::PWrapper wrapper = Lib3MF::CWrapper::loadLibrary();
+    Lib3MF::PModel inputModel = wrapper->CreateModel();
+    inputModel->QueryReader("3mf")->ReadFromFile(inputFileName);
+
+    M3mf::SceneData scene;
+    M3mf::importModel(inputModel, scene);
+
+    Lib3MF::PModel outputModel = wrapper->CreateModel();
+    outputModel->SetUnit(inputModel->GetUnit());
+    M3mf::exportScene(wrapper, outputModel, scene);
+    outputModel->QueryWriter("3mf")->WriteToFile(outputFileName);
+
+    printScene(scene);
+
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try {
+        if (argc == 3 && std::strcmp(argv[1], "info") == 0) {
+            return info(argv[2]);
+        }
+        if (argc == 4 && std::strcmp(argv[1], "convert") == 0) {
+            return convert(argv[2], argv[3]);
+        }
+    } catch (Lib3MF::ELib3MFException& e) {
+        fmt::print(stderr, "error: {}\n", e.what());
+        return 1;
+    }
+
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,361 @@
+// Copyright (C) 2021 Hamed Sabri
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Times the 3MF <-> scene conversions of the plugins on real files, without a host.
+//
+// usage:
+//   m3mfBench [--repetitions N] [--plate N] [--polygons N] [<file.3mf>...]
+//
+// --plate N adds a generated plate of N distinct objects to the inputs.
+//
+// For every input the fastest and the median of N runs are reported for
+//   read    lib3mf reading the package
+//   import  converting the model into a scene (what the importers do before creating nodes)
+//   export  converting the scene back into a new model (what the exporters do after
+//           extracting the host meshes)
+//   write   lib3mf writing the new model into memory
+//
+// --polygons N generates N polygon meshes the way hosts store them, quads and concave n-gons,
+// and reports
+//   extract triangulating them into a scene (what the Maya exporter does with the arrays it
+//           reads from MFnMesh)
+// followed by export and write as above.
+
+#include <conversion.h>
+#include <triangulation.h>
+
+#include <fmt/format.h>
+
+#include <lib3mf_implicit.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct Timings
+{
+    std::vector<double> extract;
+    std::vector<double> read;
+    std::vector<double> import;
+    std::vector<double> exportScene;
+    std::vector<double> write;
+};
+
+// 3MF file, or a package generated in memory
+struct Input
+{
+    std::string name;
+    std::string fileName;
+    std::vector<Lib3MF_uint8> buffer;
+};
+
+// plate of objectCount distinct spheres of about 2000 triangles each, every other one with vertex colors
+Input createPlate(const Lib3MF::PWrapper& wrapper, uint32_t objectCount)
+{
+    constexpr uint32_t rings { 32 };
+    constexpr uint32_t segments { 32 };
+    constexpr float pi { 3.14159265f };
+
+    Lib3MF::PModel model = wrapper->CreateModel();
+    const uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(objectCount))));
+
+    for (uint32_t object = 0; object < objectCount; ++object) {
+        // every sphere has a slightly different radius, so no two meshes are the same
+        const float radius = 4.0f + 0.001f * object;
+
+        std::vector<Lib3MF::sPosition> vertices;
+        vertices.push_back({ { 0.0f, 0.0f, radius } });
+        for (uint32_t ring = 1; ring < rings; ++ring) {
+            const float theta = pi * ring / rings;
+            for (uint32_t segment = 0; segment < segments; ++segment) {
+                const float phi = 2.0f * pi * segment / segments;
+                vertices.push_back({ { radius * std::sin(theta) * std::cos(phi), radius * std::sin(theta) * std::sin(phi), radius * std::cos(theta) } });
+            }
+        }
+        vertices.push_back({ { 0.0f, 0.0f, -radius } });
+
+        const uint32_t bottom = static_cast<uint32_t>(vertices.size() - 1);
+        auto ringVertex = [](uint32_t ring, uint32_t segment) { return 1 + (ring - 1) * segments + segment % segments; };
+
+        std::vector<Lib3MF::sTriangle> triangles;
+        for (uint32_t segment = 0; segment < segments; ++segment) {
+            triangles.push_back({ { 0, ringVertex(1, segment), ringVertex(1, segment + 1) } });
+            for (uint32_t ring = 1; ring + 1 < rings; ++ring) {
+                triangles.push_back({ { ringVertex(ring, segment), ringVertex(ring + 1, segment), ringVertex(ring + 1, segment + 1) } });
+                triangles.push_back({ { ringVertex(ring, segment), ringVertex(ring + 1, segment + 1), ringVertex(ring, segment + 1) } });
+            }
+            triangles.push_back({ { ringVertex(rings - 1, segment), bottom, ringVertex(rings - 1, segment + 1) } });
+        }
+
+        auto meshObject = model->AddMeshObject();
+        meshObject->SetName("Sphere_" + std::to_string(object));
+        meshObject->SetGeometry(vertices, triangles);
+
+        if (object % 2 == 0) {
+            auto colorGroup = model->AddColorGroup();
+            const Lib3MF_uint32 red = colorGroup->AddColor(wrapper->RGBAToColor(255, 0, 0, 255));
+            const Lib3MF_uint32 blue = colorGroup->AddColor(wrapper->RGBAToColor(0, 0, 255, 255));
+
+            std::vector<Lib3MF::sTriangleProperties> properties(triangles.size());
+            for (size_t i = 0; i < properties.size(); ++i) {
+                properties[i].m_ResourceID = colorGroup->GetResourceID();
+                properties[i].m_PropertyIDs[0] = red;
+                properties[i].m_PropertyIDs[1] = (i % 2) ? red : blue;
+                properties[i].m_PropertyIDs[2] = blue;
+            }
+            meshObject->SetAllTriangleProperties(properties);
+        }
+
+        sLib3MFTransform transform = wrapper->GetTranslationTransform(10.0f * (object % columns), 10.0f * (object / columns), 0.0f);
+        model->AddBuildItem(meshObject.get(), transform);
+    }
+
+    Input input;
+    input.name = "plate of " + std::to_string(objectCount) + " objects";
+    model->QueryWriter("3mf")->WriteToBuffer(input.buffer);
+    return input;
+}
+
+// polygon mesh as the Maya exporter reads it from MFnMesh
+struct PolygonMesh
+{
+    std::vector<float> positions;
+    std::vector<int32_t> polygonCounts;
+    std::vector<int32_t> polygonVertices;
+    std::vector<float> polygonColors;
+};
+
+// objectCount distinct spheres of quads, each pole closed by a star shaped 32-gon, every other
+// one with vertex colors
+std::vector<PolygonMesh> createPolygonMeshes(uint32_t objectCount)
+{
+    constexpr uint32_t rings { 32 };
+    constexpr uint32_t segments { 32 };
+    constexpr float pi { 3.14159265f };
+
+    std::vector<PolygonMesh> meshes(objectCount);
+    for (uint32_t object = 0; object < objectCount; ++object) {
+        PolygonMesh& mesh = meshes[object];
+        const float radius = 4.0f + 0.001f * object;
+
+        // rings 1 .. rings - 1, the outermost ones alternate their radius for the star shape
+        for (uint32_t ring = 1; ring < rings; ++ring) {
+            const float theta = pi * ring / rings;
+            for (uint32_t segment = 0; segment < segments; ++segment) {
+                const float phi = 2.0f * pi * segment / segments;
+                const bool isStar = (ring == 1 || ring == rings - 1) && segment % 2 == 1;
+                const float ringRadius = radius * std::sin(theta) * (isStar ? 0.5f : 1.0f);
+                mesh.positions.insert(mesh.positions.end(), { ringRadius * std::cos(phi), ringRadius * std::sin(phi), radius * std::cos(theta) });
+            }
+        }
+
+        auto ringVertex = [](uint32_t ring, uint32_t segment) { return static_cast<int32_t>((ring - 1) * segments + segment % segments); };
+
+        // caps, the bottom one reversed to face outwards
+        mesh.polygonCounts.push_back(segments);
+        for (uint32_t segment = 0; segment < segments; ++segment) {
+            mesh.polygonVertices.push_back(ringVertex(1, segment));
+        }
+        mesh.polygonCounts.push_back(segments);
+        for (uint32_t segment = segments; segment > 0; --segment) {
+            mesh.polygonVertices.push_back(ringVertex(rings - 1, segment - 1));
+        }
+
+        for (uint32_t ring = 1; ring + 1 < rings; ++ring) {
+            for (uint32_t segment = 0; segment < segments; ++segment) {
+                mesh.polygonCounts.push_back(4);
+                mesh.polygonVertices.insert(mesh.polygonVertices.end(), { ringVertex(ring, segment), ringVertex(ring + 1, segment), ringVertex(ring + 1, segment + 1), ringVertex(ring, segment + 1) });
+            }
+        }
+
+        if (object % 2 == 0) {
+            for (size_t i = 0; i < mesh.polygonVertices.size(); ++i) {
+                const float blue = (i % 2) ? 1.0f : 0.0f;
+                mesh.polygonColors.insert(mesh.polygonColors.end(), { 1.0f - blue, 0.0f, blue, 1.0f });
+            }
+        }
+    }
+
+    return meshes;
+}
+
+void runPolygonsOnce(const Lib3MF::PWrapper& wrapper, const std::vector<PolygonMesh>& polygonMeshes, Timings& timings, M3mf::SceneData& scene)
+{
+    auto start = Clock::now();
+    scene = M3mf::SceneData();
+    scene.meshes.resize(polygonMeshes.size());
+    scene.instances.resize(polygonMeshes.size());
+    for (size_t i = 0; i < polygonMeshes.size(); ++i) {
+        const PolygonMesh& polygonMesh = polygonMeshes[i];
+        M3mf::MeshData& mesh = scene.meshes[i];
+        mesh.positions = polygonMesh.positions;
+        M3mf::triangulatePolygons(polygonMesh.polygonCounts, polygonMesh.polygonVertices, polygonMesh.polygonColors, mesh);
+
+        scene.instances[i].mesh = static_cast<uint32_t>(i);
+        scene.instances[i].transform = wrapper->GetTranslationTransform(10.0f * i, 0.0f, 0.0f);
+    }
+    timings.extract.push_back(millisecondsSince(start));
+
+    start = Clock::now();
+    Lib3MF::PModel outputModel = wrapper->CreateModel();
+    M3mf::exportScene(wrapper, outputModel, scene);
+    timings.exportScene.push_back(millisecondsSince(start));
+
+    start = Clock::now();
+    std::vector<Lib3MF_uint8> buffer;
+    outputModel->QueryWriter("3mf")->WriteToBuffer(buffer);
+    timings.write.push_back(millisecondsSince(start));
+}
+
+void runOnce(const Lib3MF::PWrapper& wrapper, const Input& input, Timings& timings, M3mf::SceneData& scene)
+{
+    auto start = Clock::now();
+    Lib3MF::PModel inputModel = wrapper->CreateModel();
+    if (input.buffer.empty()) {
+        inputModel->QueryReader("3mf")->ReadFromFile(input.fileName);
+    } else {
+        inputModel->QueryReader("3mf")->ReadFromBuffer(input.buffer);
+    }
+    timings.read.push_back(millisecondsSince(start));
+
+    start = Clock::now();
+    scene = M3mf::SceneData();
+    M3mf::importModel(inputModel, scene);
+    timings.import.push_back(millisecondsSince(start));
+
+    start = Clock::now();
+    Lib3MF::PModel outputModel = wrapper->CreateModel();
+    M3mf::exportScene(wrapper, outputModel, scene);
+    timings.exportScene.push_back(millisecondsSince(start));
+
+    start = Clock::now();
+    std::vector<Lib3MF_uint8> buffer;
+    outputModel->QueryWriter("3mf")->WriteToBuffer(buffer);
+    timings.write.push_back(millisecondsSince(start));
+}
+
+void printTimings(const char* phase, std::vector<double>& values)
+{
+    std::sort(values.begin(), values.end());
+    fmt::print("  {:<8} min {:>10.2f} ms   median {:>10.2f} ms\n", phase, values.front(), values[values.size() / 2]);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    uint32_t repetitions { 5 };
+    uint32_t plateObjectCount { 0 };
+    uint32_t polygonObjectCount { 0 };
+    std::vector<std::string> fileNames;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--plate") == 0 && i + 1 < argc) {
+            plateObjectCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--polygons") == 0 && i + 1 < argc) {
+            polygonObjectCount = std::max(1, std::atoi(argv[++i]));
+        } else {
+            fileNames.emplace_back(argv[i]);
+        }
+    }
+
+    if (fileNames.empty() && plateObjectCount == 0 && polygonObjectCount == 0) {
+        fmt::print(stderr, "usage: m3mfBench [--repetitions N] [--plate N] [--polygons N] [<file.3mf>...]\n");
+        return 1;
+    }
+
+    Lib3MF::PWrapper wrapper = Lib3MF::CWrapper::loadLibrary();
+
+    std::vector<Input> inputs;
+    if (plateObjectCount > 0) {
+        inputs.push_back(createPlate(wrapper, plateObjectCount));
+    }
+    for (const auto& fileName : fileNames) {
+        Input input;
+        input.name = fileName;
+        input.fileName = fileName;
+        inputs.push_back(std::move(input));
+    }
+
+    if (polygonObjectCount > 0) {
+        const std::vector<PolygonMesh> polygonMeshes = createPolygonMeshes(polygonObjectCount);
+
+        Timings timings;
+        M3mf::SceneData scene;
+        for (uint32_t i = 0; i < repetitions; ++i) {
+            runPolygonsOnce(wrapper, polygonMeshes, timings, scene);
+        }
+
+        uint64_t polygonCount { 0 };
+        uint64_t triangleCount { 0 };
+        for (size_t i = 0; i < polygonMeshes.size(); ++i) {
+            polygonCount += polygonMeshes[i].polygonCounts.size();
+            triangleCount += scene.meshes[i].triangleCount();
+        }
+
+        fmt::print("{} polygon meshes ({} polygons, {} triangles)\n", polygonMeshes.size(), polygonCount, triangleCount);
+        printTimings("extract", timings.extract);
+        printTimings("export", timings.exportScene);
+        printTimings("write", timings.write);
+    }
+
+    for (const auto& input : inputs) {
+        Timings timings;
+        M3mf::SceneData scene;
+        try {
+            for (uint32_t i = 0; i < repetitions; ++i) {
+                runOnce(wrapper, input, timings, scene);
+            }
+        } catch (Lib3MF::ELib3MFException& e) {
+            fmt::print(stderr, "{}: {}\n", input.name, e.what());
+            continue;
+        }
+
+        uint64_t triangleCount { 0 };
+        for (const auto& mesh : scene.meshes) {
+            triangleCount += mesh.triangleCount();
+        }
+
+        fmt::print("{} ({} meshes, {} instances, {} triangles)\n", input.name, scene.meshes.size(), scene.instances.size(), triangleCount);
+        printTimings("read", timings.read);
+        printTimings("import", timings.import);
+        printTimings("export", timings.exportScene);
+        printTimings("write", timings.write);
+    }
+
+    return 0;
+}
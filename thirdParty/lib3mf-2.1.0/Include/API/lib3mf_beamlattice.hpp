@@ -96,6 +96,10 @@ public:
 
 	void SetBallOptions (const eBeamLatticeBallMode eBallMode, const Lib3MF_double dBallRadius);
 
+	void GetBeamOptions (Lib3MF_double & dRadius, eBeamLatticeCapMode & eCapMode);
+
+	void SetBeamOptions (const Lib3MF_double dRadius, const eBeamLatticeCapMode eCapMode);
+
 	Lib3MF_uint32 GetBeamCount ();
 
 	sLib3MFBeam GetBeam (const Lib3MF_uint32 nIndex);
@@ -126,6 +130,14 @@ public:
 
 	IBeamSet * GetBeamSet (const Lib3MF_uint32 nIndex);
 
+	void GetBeamsInBox (const sLib3MFBox Box, Lib3MF_uint64 nBeamIndicesBufferSize, Lib3MF_uint64 * pBeamIndicesNeededCount, Lib3MF_uint32 * pBeamIndicesBuffer);
+
+	bool FindClosestBeam (const sLib3MFPosition Point, Lib3MF_uint32 & nBeamIndex, sLib3MFPosition & sClosestPoint, Lib3MF_double & dDistance);
+
+	bool RayCastBeams (const sLib3MFPosition Origin, const sLib3MFPosition Direction, const Lib3MF_double dMaxDistance, Lib3MF_uint32 & nBeamIndex, Lib3MF_double & dDistance);
+
+	void GetBeamsInsideClippingMesh (Lib3MF_uint64 nBeamIndicesBufferSize, Lib3MF_uint64 * pBeamIndicesNeededCount, Lib3MF_uint32 * pBeamIndicesBuffer);
+
 };
 
 } // namespace Impl
@@ -88,6 +88,12 @@ public:
 
 	sLib3MFColor GetColor (const Lib3MF_uint32 nPropertyID);
 
+	Lib3MF_uint32 AddColors(const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer);
+
+	void GetColors(Lib3MF_uint64 nColorsBufferSize, Lib3MF_uint64* pColorsNeededCount, sLib3MFColor * pColorsBuffer);
+
+	void AddColorsDeduplicated(const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer, Lib3MF_uint64 nPropertyIDsBufferSize, Lib3MF_uint64* pPropertyIDsNeededCount, Lib3MF_uint32 * pPropertyIDsBuffer);
+
 	void RemoveColor(const Lib3MF_uint32 nPropertyID);
 
 };
@@ -103,6 +103,14 @@ public:
 
 	void SetGeometry(const Lib3MF_uint64 nVerticesBufferSize, const sLib3MFPosition * pVerticesBuffer, const Lib3MF_uint64 nIndicesBufferSize, const sLib3MFTriangle * pIndicesBuffer);
 
+	void OptimizeLayout(const bool bSpatialSort, const bool bReorderTriangles, const bool bRenumberVertices);
+
+	void GetTrianglesInBox(const sLib3MFBox Box, Lib3MF_uint64 nTriangleIndicesBufferSize, Lib3MF_uint64* pTriangleIndicesNeededCount, Lib3MF_uint32 * pTriangleIndicesBuffer);
+
+	bool FindClosestTriangle(const sLib3MFPosition Point, Lib3MF_uint32 & nTriangleIndex, sLib3MFPosition & sClosestPoint, Lib3MF_double & dDistance);
+
+	bool RayCastTriangles(const sLib3MFPosition Origin, const sLib3MFPosition Direction, const Lib3MF_double dMaxDistance, Lib3MF_uint32 & nTriangleIndex, Lib3MF_double & dDistance);
+
 	bool IsManifoldAndOriented();
 
 	bool IsMeshObject();
@@ -125,6 +133,10 @@ public:
 
 	void GetAllTriangleProperties(Lib3MF_uint64 nPropertiesArrayBufferSize, Lib3MF_uint64* pPropertiesArrayNeededCount, sLib3MFTriangleProperties * pPropertiesArrayBuffer);
 
+	void GetAllTriangleColors(Lib3MF_uint64 nRGBAValuesBufferSize, Lib3MF_uint64* pRGBAValuesNeededCount, Lib3MF_single * pRGBAValuesBuffer, Lib3MF_uint64 nResourceIDsBufferSize, Lib3MF_uint64* pResourceIDsNeededCount, Lib3MF_uint32 * pResourceIDsBuffer);
+
+	void GetAllTriangleTex2Coords(Lib3MF_uint64 nUVValuesBufferSize, Lib3MF_uint64* pUVValuesNeededCount, Lib3MF_double * pUVValuesBuffer, Lib3MF_uint64 nResourceIDsBufferSize, Lib3MF_uint64* pResourceIDsNeededCount, Lib3MF_uint32 * pResourceIDsBuffer);
+
 	void ClearAllProperties();
 };
 
@@ -149,6 +149,10 @@ public:
 
 	ISliceStack * AddSliceStack(const Lib3MF_double dZBottom) override;
 
+	ISliceStack * AddSliceStackFromMeshObject(IMeshObject* pMeshObject, const Lib3MF_double dLayerHeight) override;
+
+	ISliceStack * AddSliceStackFromMeshObjectAtHeights(IMeshObject* pMeshObject, const Lib3MF_double dZBottom, const Lib3MF_uint64 nZValuesBufferSize, const Lib3MF_double * pZValuesBuffer) override;
+
 	ITexture2D * AddTexture2DFromAttachment(IAttachment* pTextureAttachment) override;
 
 	IBaseMaterialGroup * AddBaseMaterialGroup() override;
@@ -60,6 +60,7 @@ private:
 	* Put private members here.
 	*/
 	NMR::PModelReader m_pReader;
+	bool m_bInPlaceDecryption;
 
 protected:
 
@@ -103,6 +104,18 @@ public:
 
 	void SetContentEncryptionCallback(const Lib3MF::ContentEncryptionCallback pTheCallback, const Lib3MF_pvoid pUserData);
 
+	void SetInPlaceDecryption(const bool bInPlace);
+
+	void SetDecryptionThreadCount(const Lib3MF_uint32 nThreadCount);
+
+	Lib3MF_uint32 GetDecryptionThreadCount();
+
+	void SetSliceThreadCount(const Lib3MF_uint32 nThreadCount);
+
+	Lib3MF_uint32 GetSliceThreadCount();
+
+	IStatistics * GetStatistics() override;
+
 };
 
 }
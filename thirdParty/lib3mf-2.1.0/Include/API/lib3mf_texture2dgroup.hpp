@@ -88,6 +88,10 @@ public:
 
 	sLib3MFTex2Coord GetTex2Coord (const Lib3MF_uint32 nPropertyID);
 
+	Lib3MF_uint32 AddTex2Coords(const Lib3MF_uint64 nUVCoordinatesBufferSize, const sLib3MFTex2Coord * pUVCoordinatesBuffer);
+
+	void GetTex2Coords(Lib3MF_uint64 nUVCoordinatesBufferSize, Lib3MF_uint64* pUVCoordinatesNeededCount, sLib3MFTex2Coord * pUVCoordinatesBuffer);
+
 	void RemoveTex2Coord(const Lib3MF_uint32 nPropertyID);
 
 };
@@ -98,6 +98,14 @@ public:
 
 	void SetDecimalPrecision(const Lib3MF_uint32 nDecimalPrecision) override;
 
+	bool GetOptimizeMeshLayout() override;
+
+	void SetOptimizeMeshLayout(const bool bOptimizeMeshLayout) override;
+
+	void SetCompressionThreadCount(const Lib3MF_uint32 nThreadCount) override;
+
+	Lib3MF_uint32 GetCompressionThreadCount() override;
+
 	void AddKeyWrappingCallback(const std::string & sConsumerID, const Lib3MF::KeyWrappingCallback pTheCallback, const Lib3MF_pvoid pUserData);
 
 	void SetContentEncryptionCallback(const Lib3MF::ContentEncryptionCallback pTheCallback, const Lib3MF_pvoid pUserData);
@@ -110,6 +118,8 @@ public:
 
 	Lib3MF_uint32 GetWarningCount();
 
+	IStatistics * GetStatistics() override;
+
 };
 
 }
@@ -32,7 +32,10 @@ Abstract: Progress Monitor
 #define __NMR_PROGRESSMONITOR
 
 #include "Common/3MF_ProgressTypes.h"
+#include "Common/NMR_Types.h"
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <stack>
@@ -47,6 +50,18 @@ namespace NMR
 #define PROGRESS_READSLICESUPDATE 100
 #define PROGRESS_READBUFFERUPDATE 100
 
+// Minimal time in milliseconds between two progress reports of the same phase. Reports within this
+// interval are dropped, except for the first and the last report of every phase and the PROGRESS_DONE
+// report. Cancellation queries (QueryCancelled) are never dropped by time.
+#define PROGRESS_CALLBACKINTERVAL 100
+
+	// Time in seconds spent in each phase and the counters of one read or write
+	typedef struct {
+		double m_dTotalDuration;
+		double m_dPhaseDurations[PROGRESS_PHASECOUNT];
+		nfUint64 m_nCounters[PROGRESS_COUNTERCOUNT];
+	} PROGRESSSTATISTICS;
+
 	class CProgressMonitor
 	{
 	public:
@@ -63,6 +78,13 @@ namespace NMR
 		void SetMaxProgress(double);
 		void DecreaseMaxProgress(double);
 
+		// Clears all timers and counters and starts timing the given phase. Timing stops with PROGRESS_DONE.
+		void StartStatistics(ProgressIdentifier identifier);
+		// Thread-safe
+		void AddToCounter(ProgressCounter counter, nfUint64 nValue);
+		// Includes the time spent so far in the current phase
+		void GetStatistics(PROGRESSSTATISTICS & statistics);
+
 		static void GetProgressMessage(ProgressIdentifier progressIdentifier, std::string& progressString);
 
 	private:
@@ -73,6 +95,23 @@ namespace NMR
 		void* m_userData;
 		bool m_lastCallbackResult;
 		std::mutex m_callbackMutex;
+
+		// Reports are throttled by PROGRESS_CALLBACKINTERVAL. A dropped report is passed on when its phase ends.
+		nfUint32 m_nReportedPhases;
+		bool m_bReportPending;
+		std::chrono::steady_clock::time_point m_LastCallbackTime;
+		bool reportIsDue(ProgressIdentifier identifier);
+
+		// Set by a cancellation that was returned where it could not be thrown
+		bool m_bCancelPending;
+		// Requires m_callbackMutex
+		bool callProgressCallback(ProgressIdentifier identifier, bool throwIfCancelled);
+
+		bool m_bTiming;
+		std::chrono::steady_clock::time_point m_PhaseStartTime;
+		double m_dPhaseDurations[PROGRESS_PHASECOUNT];
+		std::atomic<nfUint64> m_nCounters[PROGRESS_COUNTERCOUNT];
+		std::mutex m_statisticsMutex;
 	};
 
 	typedef std::shared_ptr <CProgressMonitor> PProgressMonitor;
@@ -59,6 +59,23 @@ namespace NMR
 		PROGRESS_WRITETRIANGLES,
 		PROGRESS_WRITESLICES
 	};
+
+	// Number of phases that are timed by the progress monitor
+	const int PROGRESS_PHASECOUNT = PROGRESS_WRITESLICES + 1;
+
+	// Counters that are collected by the progress monitor during a read or write
+	enum ProgressCounter {
+		PROGRESSCOUNTER_PACKAGEBYTES = 0,
+		PROGRESSCOUNTER_XMLBYTES,
+		PROGRESSCOUNTER_ATTACHMENTBYTES,
+		PROGRESSCOUNTER_NODES,
+		PROGRESSCOUNTER_TRIANGLES,
+		PROGRESSCOUNTER_BEAMS,
+		PROGRESSCOUNTER_SLICES,
+		PROGRESSCOUNTER_CALLBACKS
+	};
+
+	const int PROGRESS_COUNTERCOUNT = PROGRESSCOUNTER_CALLBACKS + 1;
 	
 	// Matches dll interface type, always modify both!
 	// If the first parameter is -1, it does not indicate progress;In that case
@@ -35,6 +35,7 @@ NMR_MeshBeamLattice.h defines the class CMeshBeamLattice.
 
 #include "Common/Math/NMR_Geometry.h"
 #include "Common/Mesh/NMR_MeshTypes.h"
+#include "Common/Mesh/NMR_MeshBeamStore.h"
 #include "Common/NMR_Types.h"
 #include "Model/Classes/NMR_ModelTypes.h"
 
@@ -48,11 +49,13 @@ namespace NMR {
 
 		MESHNODES &m_Nodes;	// reference to the nodes of the parent mesh
 		std::unordered_set<nfInt32> m_OccupiedNodes;    // datastructure used to ensure that balls are only placed at nodes with beams
-		MESHBEAMS m_Beams;
+		CMeshBeamStore m_Beams;
 		std::vector<PBEAMSET> m_pBeamSets;
 		MESHBALLS m_Balls;
 		
 		nfDouble m_dMinLength;
+		nfDouble m_dDefaultRadius;
+		eModelBeamLatticeCapMode m_eCapMode;
 		eModelBeamLatticeBallMode m_eBallMode;
 		nfDouble m_dDefaultBallRadius;
 	public:
@@ -46,6 +46,7 @@ You can only add nodes and faces to mesh. You cannot remove the existing structu
 #include "Common/MeshInformation/NMR_MeshInformationHandler.h"
 #include "Common/NMR_Types.h"
 #include "Common/Mesh/NMR_BeamLattice.h"
+#include "Common/Mesh/NMR_MeshBVH.h"
 
 #include <map>
 
@@ -59,6 +60,10 @@ namespace NMR {
 
 		PMeshInformationHandler m_pMeshInformationHandler;
 
+		// Spatial indices, built on first use and dropped whenever faces or beams change
+		PMeshBVH m_pFaceBVH;
+		PMeshBVH m_pBeamBVH;
+
 	public:
 		CMesh();
 		CMesh(_In_opt_ CMesh * pMesh);
@@ -72,9 +77,14 @@ namespace NMR {
 		_Ret_notnull_ MESHNODE * addNode(_In_ const nfFloat posX, _In_ const nfFloat posY, _In_ const nfFloat posZ);
 		_Ret_notnull_ MESHFACE * addFace(_In_ MESHNODE * pNode1, _In_ MESHNODE * pNode2, _In_ MESHNODE * pNode3);
 		_Ret_notnull_ MESHFACE * addFace(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2, _In_ nfInt32 nNodeIndex3);
-		_Ret_notnull_ MESHBEAM * addBeam(_In_ MESHNODE * pNode1, _In_ MESHNODE * pNode2, _In_ nfDouble dRadius1, _In_ nfDouble dRadius2,
+		nfUint32 addBeam(_In_ MESHNODE * pNode1, _In_ MESHNODE * pNode2, _In_ nfDouble dRadius1, _In_ nfDouble dRadius2,
 			_In_ nfInt32 eCapMode1, _In_ nfInt32 eCapMode2);
+		void addBeams(_In_ nfUint32 nCount, _In_ const nfInt32 * pNodeIndices, _In_ const nfDouble * pRadii, _In_ const nfInt32 * pCapModes);
 		_Ret_notnull_ MESHBALL * addBall(_In_ MESHNODE * pNode, _In_ nfDouble dRadius);
+		// Append nCount nodes or faces and return the index of the first one. Their content is
+		// undefined and has to be set by the caller, which may do so concurrently via getNode/getFace.
+		nfUint32 allocNodes(_In_ nfUint32 nCount);
+		nfUint32 allocFaces(_In_ nfUint32 nCount);
 		_Ret_notnull_ PBEAMSET addBeamSet();
 		
 		nfUint32 getNodeCount();
@@ -87,7 +97,9 @@ namespace NMR {
 
 		_Ret_notnull_ MESHNODE * getNode(_In_ nfUint32 nIdx);
 		_Ret_notnull_ MESHFACE * getFace(_In_ nfUint32 nIdx);
-		_Ret_notnull_ MESHBEAM * getBeam(_In_ nfUint32 nIdx);
+		void getBeam(_In_ nfUint32 nIdx, _Out_ MESHBEAM & beam);
+		void setBeam(_In_ nfUint32 nIdx, _In_ const MESHBEAM & beam);
+		CMeshBeamStore & getBeamStore();
 		_Ret_notnull_ MESHBALL * getBall(_In_ nfUint32 nIdx);
 		_Ret_notnull_ PBEAMSET getBeamSet(_In_ nfUint32 nIdx);
 		_Ret_notnull_ MESHNODE * getOccupiedNode(_In_ nfUint32 nIdx);
@@ -121,6 +133,11 @@ namespace NMR {
 		void clearMeshInformationHandler();
 		void patchMeshInformationResources(_In_ std::map<UniqueResourceID, UniqueResourceID> &oldToNewMapping);
 		void extendOutbox(_Out_ NOUTBOX3& vOutBox, _In_ const NMATRIX3 mAccumulatedMatrix);
+
+		_Ret_notnull_ CMeshBVH * getFaceBVH();
+		_Ret_notnull_ CMeshBVH * getBeamBVH();
+		// Has to be called after node positions are changed in place
+		void invalidateSpatialIndex();
 	};
 
 	typedef std::shared_ptr <CMesh> PMesh;
@@ -0,0 +1,110 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshBVH.h defines a bounding volume hierarchy over the faces or the beams of a mesh.
+It is built with binned surface area heuristic splits, the upper levels serially and
+the independent subtrees below them in parallel. Beams are treated as rounded cones,
+i.e. as the convex hull of the spheres around their two nodes.
+
+--*/
+
+#ifndef __NMR_MESHBVH
+#define __NMR_MESHBVH
+
+#include "Common/Math/NMR_Geometry.h"
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+
+#include <memory>
+#include <vector>
+
+#define NMR_MESHBVH_BINCOUNT 16
+#define NMR_MESHBVH_MAXLEAFSIZE 4
+
+namespace NMR {
+
+	class CMesh;
+
+	enum class eMeshBVHPrimitive {
+		Faces,
+		Beams
+	};
+
+	typedef struct {
+		NOUTBOX3 m_Box;
+		nfUint32 m_nFirst;	// index of the first child for inner nodes, first primitive slot for leaves
+		nfUint32 m_nCount;	// number of primitives of a leaf, 0 for inner nodes
+	} MESHBVHNODE;
+
+	class CMeshBVH {
+	private:
+		eMeshBVHPrimitive m_ePrimitive;
+
+		// Children of an inner node are stored next to each other. The root is node 0.
+		std::vector<MESHBVHNODE> m_Nodes;
+
+		// Primitive data in leaf order: the primitive index, its corners (three per face,
+		// two per beam) and, for beams, the two radii.
+		std::vector<nfUint32> m_PrimitiveIndices;
+		std::vector<NVEC3> m_Corners;
+		std::vector<nfDouble> m_Radii;
+
+		nfUint32 cornersPerPrimitive() const;
+		nfBool primitiveClosestPoint(_In_ nfUint32 nSlot, _In_ const NVEC3D & vPoint, _Out_ NVEC3D & vClosestPoint, _Out_ nfDouble & dDistance) const;
+		nfBool primitiveRayHit(_In_ nfUint32 nSlot, _In_ const NVEC3D & vOrigin, _In_ const NVEC3D & vDirection, _Out_ nfDouble & dDistance) const;
+
+	public:
+		CMeshBVH() = delete;
+		CMeshBVH(_In_ CMesh * pMesh, _In_ eMeshBVHPrimitive ePrimitive, _In_ nfUint32 nThreadCount);
+
+		eMeshBVHPrimitive getPrimitive() const;
+		nfUint32 getPrimitiveCount() const;
+		nfUint32 getNodeCount() const;
+
+		// Appends the indices of all primitives whose bounding box overlaps the given box.
+		void findInBox(_In_ const NOUTBOX3 & oBox, _Inout_ std::vector<nfUint32> & Indices) const;
+
+		// Finds the primitive closest to vPoint. For beams, points inside a beam have distance 0
+		// and are their own closest point. Returns false if there are no primitives.
+		nfBool findClosest(_In_ const NVEC3 & vPoint, _Out_ nfUint32 & nIndex, _Out_ NVEC3 & vClosestPoint, _Out_ nfDouble & dDistance) const;
+
+		// Finds the first primitive hit by the ray within [0, dMaxDistance], measured in units of the
+		// direction vector. Beams are only hit when entering them. Returns false if nothing is hit.
+		nfBool rayCast(_In_ const NVEC3 & vOrigin, _In_ const NVEC3 & vDirection, _In_ nfDouble dMaxDistance, _Out_ nfUint32 & nIndex, _Out_ nfDouble & dDistance) const;
+
+		// Counts all primitives hit by the ray at a distance greater than 0.
+		nfUint32 countRayHits(_In_ const NVEC3 & vOrigin, _In_ const NVEC3 & vDirection) const;
+
+		nfUint64 getMemoryUsage() const;
+	};
+
+	typedef std::shared_ptr <CMeshBVH> PMeshBVH;
+
+}
+
+#endif // __NMR_MESHBVH
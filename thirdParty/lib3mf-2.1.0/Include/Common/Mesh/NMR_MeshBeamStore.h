@@ -0,0 +1,106 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshBeamStore.h defines the beam storage of a beam lattice.
+Beams are kept as structure of arrays: node indices in one contiguous array,
+radii either as one uniform value, as single precision values (if this is lossless)
+or as double precision values, and cap modes as runs of equal values.
+
+--*/
+
+#ifndef __NMR_MESHBEAMSTORE
+#define __NMR_MESHBEAMSTORE
+
+#include "Common/Mesh/NMR_MeshTypes.h"
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+
+#include <vector>
+
+namespace NMR {
+
+	enum class eMeshBeamRadiusStorage {
+		Uniform,	// all radii share one value, no per-beam storage
+		Float,		// two single precision radii per beam
+		Double		// two double precision radii per beam
+	};
+
+	typedef struct {
+		nfUint32 m_nStart;	// index of the first beam of this run
+		nfInt32 m_capMode[2];
+	} MESHBEAMCAPRUN;
+
+	class CMeshBeamStore {
+	private:
+		std::vector<nfInt32> m_NodeIndices;	// two per beam
+
+		eMeshBeamRadiusStorage m_eRadiusStorage;
+		nfDouble m_dUniformRadius;
+		std::vector<nfFloat> m_FloatRadii;	// two per beam
+		std::vector<nfDouble> m_DoubleRadii;	// two per beam
+
+		std::vector<MESHBEAMCAPRUN> m_CapModeRuns;	// sorted by m_nStart, neighbouring runs always differ
+
+		void convertRadiusStorage(_In_ eMeshBeamRadiusStorage eStorage);
+		void prepareRadiusStorage(_In_ nfUint32 nCount, _In_ const nfDouble * pRadii, _In_ nfBool bReplacesAll);
+		void appendCapModes(_In_ nfInt32 eCapMode1, _In_ nfInt32 eCapMode2);
+		size_t findCapModeRun(_In_ nfUint32 nIdx) const;
+
+	public:
+		CMeshBeamStore();
+
+		nfUint32 getCount() const;
+		void reserve(_In_ nfUint32 nCount);
+		void clear();
+
+		nfUint32 addBeam(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2, _In_ nfDouble dRadius1, _In_ nfDouble dRadius2,
+			_In_ nfInt32 eCapMode1, _In_ nfInt32 eCapMode2);
+		// Appends nCount beams. Each array holds two values per beam.
+		void addBeams(_In_ nfUint32 nCount, _In_ const nfInt32 * pNodeIndices, _In_ const nfDouble * pRadii, _In_ const nfInt32 * pCapModes);
+
+		void getBeam(_In_ nfUint32 nIdx, _Out_ MESHBEAM & beam) const;
+		void setBeam(_In_ nfUint32 nIdx, _In_ const MESHBEAM & beam);
+
+		// Node indices of all beams, two per beam
+		_Ret_maybenull_ nfInt32 * getNodeIndices();
+		_Ret_maybenull_ const nfInt32 * getNodeIndices() const;
+
+		// Copies two values per beam for the beams [nStart, nStart + nCount)
+		void getRadii(_In_ nfUint32 nStart, _In_ nfUint32 nCount, _Out_ nfDouble * pRadii) const;
+		void getCapModes(_In_ nfUint32 nStart, _In_ nfUint32 nCount, _Out_ nfInt32 * pCapModes) const;
+
+		eMeshBeamRadiusStorage getRadiusStorage() const;
+		nfBool getUniformRadius(_Out_ nfDouble & dRadius) const;
+		const std::vector<MESHBEAMCAPRUN> & getCapModeRuns() const;
+
+		nfUint64 getMemoryUsage() const;
+	};
+
+}
+
+#endif // __NMR_MESHBEAMSTORE
@@ -0,0 +1,77 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshLayoutOptimizer.h defines the class CMeshLayoutOptimizer.
+
+The class CMeshLayoutOptimizer reorders the faces and nodes of a mesh for memory
+and cache locality. Faces can be sorted along a Morton curve and reordered for a
+post-transform vertex cache (Forsyth's linear-speed algorithm); nodes can be
+renumbered in order of their first use. Geometry, orientation and all per-face
+mesh information are preserved.
+
+--*/
+
+#ifndef __NMR_MESHLAYOUTOPTIMIZER
+#define __NMR_MESHLAYOUTOPTIMIZER
+
+#include "Common/Mesh/NMR_Mesh.h" 
+#include <vector>
+
+// Size of the simulated vertex cache used for face reordering
+#define NMR_MESHLAYOUT_VERTEXCACHESIZE 32
+
+namespace NMR {
+
+	class CMeshLayoutOptimizer {
+	private:
+		nfBool m_bSpatialSort;
+		nfBool m_bReorderFaces;
+		nfBool m_bRenumberNodes;
+
+		// Sorts the faces along a Morton curve through their centroids
+		void sortFacesSpatially(_In_ CMesh * pMesh, _Inout_ std::vector<nfUint32> & FaceOrder);
+
+		// Reorders the faces greedily for a simulated LRU vertex cache
+		void reorderFacesForVertexCache(_In_ CMesh * pMesh, _Inout_ std::vector<nfUint32> & FaceOrder);
+
+		// Moves the faces and their mesh information into the given order (FaceOrder[new] = old)
+		void applyFaceOrder(_In_ CMesh * pMesh, _In_ const std::vector<nfUint32> & FaceOrder);
+
+		// Renumbers the nodes in order of first use and rotates each face to start with its lowest node
+		void renumberNodes(_In_ CMesh * pMesh);
+
+	public:
+		CMeshLayoutOptimizer() = delete;
+		CMeshLayoutOptimizer(_In_ nfBool bSpatialSort, _In_ nfBool bReorderFaces, _In_ nfBool bRenumberNodes);
+
+		void optimize(_In_ CMesh * pMesh);
+	};
+
+}
+
+#endif // __NMR_MESHLAYOUTOPTIMIZER
@@ -0,0 +1,113 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshMerger.h defines the merging of transformed mesh instances into one mesh.
+A counting pass sizes the target up front; the nodes and faces of all instances are
+then copied in chunks on several threads into disjoint ranges of the target, with the
+property resource IDs optionally remapped on the way.
+
+--*/
+
+#ifndef __NMR_MESHMERGER
+#define __NMR_MESHMERGER
+
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+#include "Common/Math/NMR_Geometry.h"
+#include "Model/Classes/NMR_ModelTypes.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+// Number of nodes or faces that one merge job copies
+#define NMR_MESHMERGER_CHUNKSIZE 65536
+
+namespace NMR {
+
+	class CMesh;
+
+	class CMeshMerger {
+	private:
+		typedef struct {
+			CMesh * m_pMesh;
+			NMATRIX3 m_mMatrix;
+			nfUint32 m_nNodeCount;
+			nfUint32 m_nFaceCount;
+			nfUint32 m_nFirstNode;
+			nfUint32 m_nFirstFace;
+			// Faces are only checked for the first instance of every mesh
+			nfBool m_bCheckFaces;
+		} MESHMERGEINSTANCE;
+
+		typedef struct {
+			nfUint32 m_nInstance;
+			nfUint32 m_nStart;
+			nfUint32 m_nCount;
+			nfBool m_bFaces;
+		} MESHMERGEJOB;
+
+		std::vector<MESHMERGEINSTANCE> m_Instances;
+		nfUint32 m_nThreadCount;
+
+		// Dense map from old to new unique resource IDs, 0 if unmapped
+		nfBool m_bRemapResourceIDs;
+		std::vector<UniqueResourceID> m_ResourceIDMap;
+
+		UniqueResourceID remapResourceID(_In_ UniqueResourceID nResourceID);
+		void checkInstances();
+		void copyNodes(_In_ CMesh * pTarget, _In_ const MESHMERGEINSTANCE & instance, _In_ nfUint32 nStart, _In_ nfUint32 nCount);
+		void copyFaces(_In_ CMesh * pTarget, _In_ const MESHMERGEINSTANCE & instance, _In_ nfUint32 nStart, _In_ nfUint32 nCount);
+		void copyBeamsAndBalls(_In_ CMesh * pTarget, _In_ const MESHMERGEINSTANCE & instance);
+
+	public:
+		CMeshMerger();
+
+		// Adds pMesh transformed by mMatrix. The same mesh may be added any number of times.
+		void addInstance(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix);
+		nfUint32 getInstanceCount();
+
+		// Number of threads used to copy nodes and faces. 0 and 1 copy serially.
+		void setThreadCount(_In_ nfUint32 nThreadCount);
+		nfUint32 getThreadCount();
+
+		// Replaces the unique resource IDs of the merged face properties and of the default
+		// properties by their mapped IDs. Throws for IDs missing in the mapping.
+		void setResourceIDMapping(_In_ const std::map<UniqueResourceID, UniqueResourceID> & Mapping);
+
+		// Appends all instances to pTarget in the order they were added. Invalid node indices and
+		// coordinates are detected before pTarget is changed. Unmapped resource IDs are reported
+		// after the merge has completed.
+		void merge(_In_ CMesh * pTarget);
+	};
+
+	typedef std::shared_ptr <CMeshMerger> PMeshMerger;
+
+}
+
+#endif // __NMR_MESHMERGER
@@ -0,0 +1,78 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshSlicer.h defines the intersection of a mesh with planes of constant Z.
+The segments of all faces crossing a plane are linked via the mesh edges they
+cross into the contour polygons of a slice. Planes are processed in parallel,
+each worker sweeping over the faces ordered by their lowest plane.
+
+--*/
+
+#ifndef __NMR_MESHSLICER
+#define __NMR_MESHSLICER
+
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+#include "Model/Classes/NMR_ModelSlice.h"
+
+#include <memory>
+#include <vector>
+
+namespace NMR {
+
+	class CMesh;
+
+	class CMeshSlicer {
+	private:
+		CMesh * m_pMesh;
+		nfFloat m_fZMin;
+		nfFloat m_fZMax;
+
+		void sliceLayers(_In_ const std::vector<nfDouble> & PlaneZ, _In_ nfUint32 nFirstLayer, _In_ nfUint32 nEndLayer,
+			_In_ const std::vector<nfUint32> & Faces, _In_ const std::vector<nfUint32> & FirstLayers, _In_ const std::vector<nfUint32> & EndLayers,
+			_In_ const std::vector<PSlice> & Slices);
+
+	public:
+		CMeshSlicer() = delete;
+		CMeshSlicer(_In_ CMesh * pMesh);
+
+		// Z range of all nodes that are used by faces. Empty meshes have a range of [0, 0].
+		nfFloat getZMin();
+		nfFloat getZMax();
+
+		// Intersects the mesh with the planes at PlaneZ, which must be strictly increasing, and adds the
+		// contours at PlaneZ[i] to Slices[i]. Nodes exactly on a plane count as above it. Contours of closed,
+		// outward oriented meshes are closed and run counterclockwise around material when seen from above.
+		void slice(_In_ const std::vector<nfDouble> & PlaneZ, _In_ const std::vector<PSlice> & Slices, _In_ nfUint32 nThreadCount);
+	};
+
+	typedef std::shared_ptr <CMeshSlicer> PMeshSlicer;
+
+}
+
+#endif // __NMR_MESHSLICER
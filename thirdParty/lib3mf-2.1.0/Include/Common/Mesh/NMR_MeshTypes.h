@@ -53,8 +53,8 @@ In addition, some constants are defined here.
 #define NMR_MESH_NODEBLOCKCOUNT 256
 #define NMR_MESH_EDGEBLOCKCOUNT 256
 #define NMR_MESH_FACEBLOCKCOUNT 256
-#define NMR_MESH_BEAMBLOCKCOUNT 256
 #define NMR_MESH_BALLBLOCKCOUNT 256
+#define NMR_MESH_BEAMCOPYBLOCKSIZE 65536
 #define NMR_MESH_NODEEDGELINKBLOCKCOUNT 256
 
 namespace NMR {
@@ -84,7 +84,6 @@ namespace NMR {
 	typedef std::shared_ptr <BEAMSET> PBEAMSET;
 
 	typedef struct MESHBEAM {
-		nfInt32 m_index;
 		nfInt32 m_nodeindices[2];
 		nfDouble m_radius[2];
 		nfInt32 m_capMode[2];
@@ -92,7 +91,6 @@ namespace NMR {
 		MESHBEAM() { 
 		};
 	} MESHBEAM;
-	typedef CPagedVector<MESHBEAM, NMR_MESH_BEAMBLOCKCOUNT> MESHBEAMS;
 
 	typedef struct MESHBALL {
 		nfInt32 m_index;
@@ -102,11 +100,6 @@ namespace NMR {
 		};
 	} MESHBALL;
 	typedef CPagedVector<MESHBALL, NMR_MESH_BALLBLOCKCOUNT> MESHBALLS;
-
-  typedef struct {
-    nfInt32 m_index;
-    NVEC2 m_position;
-  } SLICENODE;
 }
 
 #endif // __NMR_MESHTYPES
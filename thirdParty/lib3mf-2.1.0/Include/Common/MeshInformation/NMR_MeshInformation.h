@@ -57,6 +57,7 @@ namespace NMR {
 
 		_Ret_notnull_ MESHINFORMATIONFACEDATA * getFaceData(nfUint32 nFaceIndex);
 		_Ret_notnull_ MESHINFORMATIONFACEDATA * addFaceData(_In_ nfUint32 nNewFaceCount);
+		void addFaceDataRange(_In_ nfUint32 nNewFaceCount);
 		void resetFaceInformation(_In_ nfUint32 nFaceIndex);
 		void resetAllFaceInformation();
 
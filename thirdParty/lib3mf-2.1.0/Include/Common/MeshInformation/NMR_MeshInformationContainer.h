@@ -57,6 +57,8 @@ namespace NMR {
 		CMeshInformationContainer(nfUint32 nCurrentFaceCount, nfUint32 nRecordSize);
 		~CMeshInformationContainer();
 		_Ret_notnull_ MESHINFORMATIONFACEDATA * addFaceData(nfUint32 nNewFaceCount);
+		// Extends the container to nNewFaceCount zeroed records at once
+		void addFaceDataRange(nfUint32 nNewFaceCount);
 		_Ret_notnull_ MESHINFORMATIONFACEDATA * getFaceData(nfUint32 nIdx);
 
 		nfUint32 getCurrentFaceCount();
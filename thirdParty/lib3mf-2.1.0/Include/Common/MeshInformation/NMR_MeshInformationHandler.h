@@ -52,6 +52,9 @@ namespace NMR {
 
 		void addInformation(_In_ PMeshInformation pInformation);
 		void addFace(_In_ nfUint32 nNewFaceCount);
+		// Extends all informations to nNewFaceCount faces. The data of the new faces is zeroed
+		// and has to be set or invalidated by the caller.
+		void addFaceRange(_In_ nfUint32 nNewFaceCount);
 
 		CMeshInformation * getInformationIndexed(_In_ nfUint32 nIdx);
 		PMeshInformation getPInformationIndexed(_In_ nfUint32 nIdx);
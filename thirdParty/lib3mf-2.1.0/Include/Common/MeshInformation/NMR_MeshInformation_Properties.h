@@ -36,13 +36,19 @@ NMR_MeshInformation_Properties.h defines the Property Information Class.
 #include "Common/MeshInformation/NMR_MeshInformation.h"
 #include "Model/Classes/NMR_ModelTypes.h"
 #include <list>
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace NMR {
 
 	class CMeshInformation_PropertyIndexMapping {
 	private:
-		std::map<std::pair<UniqueResourceID, ModelPropertyID>, nfUint32> m_IDMap;
+		// Resource indices of every resource, indexed by PropertyID
+		std::unordered_map<UniqueResourceID, std::vector<nfUint32>> m_IDMap;
+
+		// Resource indices of the most recently mapped resource
+		UniqueResourceID m_nCachedResourceID;
+		std::vector<nfUint32> * m_pCachedIndices;
 	public:
 		CMeshInformation_PropertyIndexMapping();
 
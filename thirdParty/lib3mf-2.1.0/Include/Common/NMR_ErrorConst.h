@@ -1042,6 +1042,9 @@ Model error codes (0x8XXX)
 // SliceStack must not contain slices and slicerefs
 #define NMR_ERROR_SLICES_MIXING_SLICES_WITH_SLICEREFS 0x80C7
 
+// The slices of a split slice model part do not match its slicestacks
+#define NMR_ERROR_SLICES_SPLITMISMATCH 0x80C8
+
 // SliceStack references must not be circular
 #define NMR_ERROR_SLICES_SLICEREF_CIRCULAR 0x80CD
 
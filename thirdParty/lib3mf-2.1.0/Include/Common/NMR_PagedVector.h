@@ -110,6 +110,23 @@ namespace NMR {
 			return m_pHeadBlock[nIdx];
 		}
 
+		// Appends nCount elements and returns the index of the first one. The new
+		// elements are uninitialized and may be set concurrently through getData.
+		nfUint32 allocDataRange(_In_ nfUint32 nCount) {
+			nfUint32 nFirstIndex = m_nCount;
+			nfUint64 nNewCount = (nfUint64)m_nCount + nCount;
+			if (nNewCount > 0xffffffffULL)
+				throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+			while ((nfUint64)m_pBlocks.size() * m_nBlockSize < nNewCount) {
+				m_pHeadBlock = new T[m_nBlockSize];
+				m_pBlocks.push_back(m_pHeadBlock);
+			}
+			m_nCount = (nfUint32)nNewCount;
+
+			return nFirstIndex;
+		}
+
 		_Ret_notnull_ T * getData(_In_ nfUint32 nIdx) {
 			if (nIdx >= m_nCount)
 				throw CNMRException(NMR_ERROR_INVALIDINDEX);
@@ -0,0 +1,55 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ParallelFor.h defines a minimal worker helper that runs a number of independent
+jobs on a fixed number of threads. Exceptions thrown by a job are rethrown on the
+calling thread once all workers have finished.
+
+--*/
+
+#ifndef __NMR_PARALLELFOR
+#define __NMR_PARALLELFOR
+
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+#include <functional>
+
+namespace NMR {
+
+	// Returns the number of hardware threads, at least 1.
+	nfUint32 fnGetHardwareThreadCount();
+
+	// Calls fnJob(i) for every i in [0, nJobCount). With nThreadCount <= 1 all jobs run
+	// in order on the calling thread. Otherwise jobs are distributed dynamically over
+	// min(nThreadCount, nJobCount) worker threads; after the first failing job no new jobs
+	// are started, and the exception of the lowest failing job index is rethrown.
+	void fnParallelFor(_In_ nfUint32 nThreadCount, _In_ nfUint64 nJobCount, _In_ const std::function<void(nfUint64)> & fnJob);
+
+}
+
+#endif // __NMR_PARALLELFOR
@@ -78,6 +78,8 @@ namespace NMR {
 	struct ContentEncryptionDescriptor {
 		ContentEncryptionCbType m_fnCrypt;
 		ContentEncryptionContext m_sDekDecryptData;
+		// m_fnCrypt accepts identical input and output buffers
+		nfBool m_bInPlace = false;
 	};
 
 	class CKeyStoreAccessRight;
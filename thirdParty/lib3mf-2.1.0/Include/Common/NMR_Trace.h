@@ -0,0 +1,88 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_Trace.h defines scoped trace spans for the reader and writer stages. Spans are
+recorded into per-thread ring buffers and can be dumped as Chrome trace JSON, which
+loads into chrome://tracing and Perfetto.
+
+Tracing is compiled in only if NMR_TRACING is defined. Otherwise NMR_TRACE_SCOPE
+expands to nothing and fnTraceToChromeJSON returns an empty trace.
+
+--*/
+
+#ifndef __NMR_TRACE
+#define __NMR_TRACE
+
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+#include <string>
+
+// Number of spans kept per thread. Older spans are overwritten.
+#define NMR_TRACE_RINGBUFFERSIZE 65536
+
+namespace NMR {
+
+#ifdef NMR_TRACING
+
+	// Records the time between construction and destruction as one span of the current thread.
+	// pszName must be a string literal, only the pointer is stored.
+	class CTraceScope {
+	private:
+		const nfChar * m_pszName;
+		nfUint64 m_nStartTime;
+	public:
+		CTraceScope(_In_ const nfChar * pszName);
+		~CTraceScope();
+
+		CTraceScope(const CTraceScope &) = delete;
+		CTraceScope & operator=(const CTraceScope &) = delete;
+	};
+
+#define NMR_TRACE_CONCAT_INNER(a, b) a##b
+#define NMR_TRACE_CONCAT(a, b) NMR_TRACE_CONCAT_INNER(a, b)
+#define NMR_TRACE_SCOPE(pszName) NMR::CTraceScope NMR_TRACE_CONCAT(__nmrTraceScope, __LINE__)(pszName)
+
+#else
+
+#define NMR_TRACE_SCOPE(pszName)
+
+#endif // NMR_TRACING
+
+	// Returns true if tracing has been compiled in.
+	nfBool fnTraceIsEnabled();
+
+	// Returns all recorded spans of all threads as Chrome trace JSON. Should not be called
+	// while another thread is reading or writing.
+	std::string fnTraceToChromeJSON();
+
+	// Discards all recorded spans. Should not be called while another thread is reading or writing.
+	void fnTraceClear();
+
+}
+
+#endif // __NMR_TRACE
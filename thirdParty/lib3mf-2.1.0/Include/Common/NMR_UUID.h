@@ -36,37 +36,56 @@ NMR_UUID.h defines a datatype and functions to handle UUIDs
 #include "Common/NMR_Types.h"
 #include "Common/NMR_Local.h"
 #include <string>
-
-#ifndef _WIN32
-#include <random>
-#include <mutex>
-#endif
+#include <vector>
+#include <memory>
 
 
 namespace NMR
 {
+	// 128-bit binary value of a UUID, used as key for fast uniqueness checks
+	typedef struct {
+		nfUint64 m_nHigh;
+		nfUint64 m_nLow;
+	} UUIDKEY;
+
+	inline bool operator==(const UUIDKEY & a, const UUIDKEY & b)
+	{
+		return (a.m_nHigh == b.m_nHigh) && (a.m_nLow == b.m_nLow);
+	}
+
+	struct UUIDKEYHash {
+		size_t operator()(const UUIDKEY & key) const
+		{
+			// v4 UUIDs are random, so folding both halves is well distributed
+			return (size_t)(key.m_nHigh ^ (key.m_nLow * 0x9e3779b97f4a7c15ULL));
+		}
+	};
+
+	class CUUID;
+	typedef std::shared_ptr<CUUID> PUUID;
+
 	class CUUID {
 	private:
-#ifndef _WIN32
-		static bool S_mtwister_initialised;
-		static std::mutex S_uuid_gen_mutex;
-		static std::random_device S_rand_dev;
-		static std::mt19937 S_mtwister;
-#endif
 		std::string m_sUUID;
+		UUIDKEY m_Key;
+
+		static UUIDKEY generateKey();
 	public:
 		CUUID();
+		CUUID(const UUIDKEY & key);
 		CUUID(const nfChar* pString);
 		CUUID(const std::string & string);
 		std::string toString() const;
+		const UUIDKEY & key() const;
 
 		bool set(const nfChar* pString);
 
 		CUUID& operator=(const CUUID& uuid);
 		bool operator==(const CUUID& uuid);
-	};
 
-	typedef std::shared_ptr<CUUID> PUUID;
+		// Creates nCount new random UUIDs in one go
+		static void generate(_In_ nfUint32 nCount, _Out_ std::vector<PUUID> & UUIDs);
+	};
 }
 
 #endif // __NMR_UUID
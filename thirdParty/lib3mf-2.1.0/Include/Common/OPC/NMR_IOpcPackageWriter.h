@@ -16,6 +16,10 @@ namespace NMR {
 	class IOpcPackageWriter {
 	public:
 		virtual POpcPackagePart addPart(_In_ std::string sPath) = 0;
+		// Adds a part whose stream may be written on another thread, or returns nullptr if the
+		// part has to be added with addPart. The part is stored by writeDeferredParts.
+		virtual POpcPackagePart addDeferredPart(_In_ std::string sPath) = 0;
+		virtual void writeDeferredParts() = 0;
 		virtual void addContentType(_In_ std::string sExtension, _In_ std::string sContentType) = 0;
 		virtual void addContentType(_In_ POpcPackagePart pOpcPackagePart, _In_ std::string sContentType) = 0;
 		virtual POpcPackageRelationship addRootRelationship(_In_ std::string sType, _In_ COpcPackagePart * pTargetPart) = 0;
@@ -38,7 +38,7 @@ NMR_ExportStream_Compressed.h defines a stream to write compressed files
 #include "Common/Platform/NMR_PortableZIPWriter.h"
 #include "Libraries/zlib/zlib.h"
 
-#define EXPORTSTREAM_WRITE_BUFFER_CHUNKSIZE 1024
+#define EXPORTSTREAM_WRITE_BUFFER_CHUNKSIZE (64 * 1024)
 
 namespace NMR {
 
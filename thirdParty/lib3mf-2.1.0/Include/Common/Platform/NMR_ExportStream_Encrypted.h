@@ -40,6 +40,11 @@ to the proper callbacks that will decrypt the content before returning back to t
 #include "Common/Platform/NMR_ExportStream.h"
 #include "Common/Platform/NMR_EncryptionHeader.h"
 
+#include <vector>
+
+// Maximum number of bytes handed to the encryption callback at once
+#define NMR_EXPORTSTREAM_ENCRYPTED_BLOCKSIZE (1024 * 1024)
+
 namespace NMR {
 
 
@@ -48,6 +53,8 @@ namespace NMR {
 		PExportStream m_pEncryptedStream;
 		ContentEncryptionDescriptor m_pDecryptContext;
 		CEncryptionHeader m_header;
+		// reused for all writes
+		std::vector<nfByte> m_CipherBuffer;
 	public:
 		CExportStream_Encrypted(PExportStream pEncryptedStream, ContentEncryptionDescriptor context);
 
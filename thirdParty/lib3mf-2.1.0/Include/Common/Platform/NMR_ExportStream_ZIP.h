@@ -49,16 +49,22 @@ namespace NMR {
 	private:
 		CPortableZIPWriter * m_pZIPWriter;
 		nfUint32 m_nEntryKey;
+		// Set for deferred entries, which deflate into the entry instead of the ZIP writer
+		PPortableZIPWriterEntry m_pDeferredEntry;
 		z_stream m_pStream;
 		std::array<nfByte, ZIPEXPORTBUFFERSIZE> m_nOutBuffer;
 
 		nfBool m_bIsInitialized;
 
+		void initDeflate();
 		nfUint32 writeChunk(_In_ const nfByte * pData, nfUint32 cbCount);
+		void writeDeflatedBuffer(_In_ nfUint32 cbCompressedBytes);
 		void finishDeflate();
 	public:
 		CExportStream_ZIP() = delete;
 		CExportStream_ZIP(_In_ CPortableZIPWriter * pZIPWriter, nfUint32 nEntryKey);
+		// Stream of a deferred entry. It does not access the ZIP writer and may be written on any thread.
+		CExportStream_ZIP(_In_ PPortableZIPWriterEntry pDeferredEntry);
 		~CExportStream_ZIP();
 
 		virtual nfBool seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed);
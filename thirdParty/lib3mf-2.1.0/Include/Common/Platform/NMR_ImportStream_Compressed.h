@@ -37,8 +37,8 @@ This is a stream class for importing from a compressed object.
 #include "Common/Platform/NMR_ImportStream.h"
 #include "Libraries/zlib/zlib.h"
 
-#define IMPORTSTREAM_READ_BUFFER_CHUNKSIZE 1024
-#define IMPORTSTREAM_COMPRESSED_CHUNKSIZE 1024
+#define IMPORTSTREAM_READ_BUFFER_CHUNKSIZE (64 * 1024)
+#define IMPORTSTREAM_COMPRESSED_CHUNKSIZE (64 * 1024)
 
 namespace NMR {
 
@@ -41,6 +41,10 @@ to the proper callbacks that will decrypt the content before returning back to t
 #include "Common/Platform/NMR_EncryptionHeader.h"
 
 #include <functional>
+#include <vector>
+
+// Maximum number of bytes handed to the decryption callback at once
+#define NMR_IMPORTSTREAM_ENCRYPTED_BLOCKSIZE (1024 * 1024)
 
 namespace NMR {
 
@@ -48,6 +52,8 @@ namespace NMR {
 		PImportStream m_pEncryptedStream;
 		ContentEncryptionDescriptor m_pDecryptContext;
 		CEncryptionHeader m_header;
+		// reused for all reads that cannot be decrypted in place
+		std::vector<nfByte> m_CipherBuffer;
 	public:
 		CImportStream_Encrypted(PImportStream pEncryptedStream, ContentEncryptionDescriptor context);
 
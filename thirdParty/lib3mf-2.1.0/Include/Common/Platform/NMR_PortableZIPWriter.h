@@ -40,6 +40,7 @@ NMR_PortableZIPWriter.h defines a portable and fast writer of ZIP files
 
 #include <string>
 #include <list>
+#include <utility>
 
 namespace NMR {
 
@@ -57,6 +58,13 @@ namespace NMR {
 
 		std::list<PPortableZIPWriterEntry> m_Entries;
 		PExportStream m_pCurrentStream;
+
+		// Deferred entries and their streams, in the order they were created
+		std::list<std::pair<PPortableZIPWriterEntry, PExportStream>> m_DeferredEntries;
+
+		std::string prepareEntryName(_In_ const std::string sName);
+		void writeLocalFileHeader(_In_ const std::string & sUTF8Name, _In_ nfUint32 nCRC32, _In_ nfUint64 nCompressedSize, _In_ nfUint64 nUncompressedSize,
+			_Out_ nfUint64 & nFilePosition, _Out_ nfUint64 & nExtInfoPosition, _Out_ nfUint64 & nDataPosition);
 	public:
 		CPortableZIPWriter() = delete;
 		CPortableZIPWriter(_In_ PExportStream pExportStream, _In_ nfBool bWriteZIP64);
@@ -65,6 +73,13 @@ namespace NMR {
 		PExportStream createEntry(_In_ const std::string sName, _In_ nfTimeStamp nUnixTimeStamp);
 		void closeEntry();
 
+		// Creates an entry that is deflated into memory. The streams of several deferred entries
+		// may be written at the same time on different threads, one thread per stream.
+		PExportStream createDeferredEntry(_In_ const std::string sName, _In_ nfTimeStamp nUnixTimeStamp);
+		// Appends all deferred entries to the ZIP stream in the order they were created.
+		// Their streams must not be written anymore.
+		void writeDeferredEntries();
+
 		void writeDeflatedBuffer(_In_ nfUint32 nEntryKey, _In_ const void * pBuffer, _In_ nfUint32 cbCompressedBytes);
 		void calculateChecksum(_In_ nfUint32 nEntryKey, _In_ const void * pBuffer, _In_ nfUint32 cbUncompressedBytes);
 		nfUint64 getCurrentSize(_In_ nfUint32 nEntryKey);
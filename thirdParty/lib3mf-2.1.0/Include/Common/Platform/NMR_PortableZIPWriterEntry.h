@@ -35,6 +35,7 @@ NMR_PortableZIPWriterEntry.h defines a portable and fast writer of ZIP files
 
 #include <string>
 #include <list>
+#include <vector>
 #include "Common/NMR_Types.h"
 #include "Common/Platform/NMR_ExportStream.h"
 
@@ -51,6 +52,9 @@ namespace NMR {
 		nfUint64 m_nFilePosition;
 		nfUint64 m_nExtInfoPosition;
 		nfUint64 m_nDataPosition;
+
+		// Deflated data of a deferred entry, until it is appended to the ZIP stream
+		std::vector<nfByte> m_DeflatedData;
 	public:
 		CPortableZIPWriterEntry(_In_ const std::string sUTF8Name, _In_ nfUint16 nLastModTime, _In_ nfUint16 nLastModDate, _In_ nfUint64 nFilePosition, _In_ nfUint64 nExtInfoPosition, _In_ nfUint64 nDataPosition);
 		std::string getUTF8Name();
@@ -66,6 +70,11 @@ namespace NMR {
 		void increaseUncompressedSize(_In_ nfUint32 nUncompressedSize);
 		void calculateChecksum(_In_ const void * pBuffer, _In_ nfUint32 cbCount);
 
+		void setPositions(_In_ nfUint64 nFilePosition, _In_ nfUint64 nExtInfoPosition, _In_ nfUint64 nDataPosition);
+		void appendDeflatedData(_In_ const void * pBuffer, _In_ nfUint32 cbCompressedBytes);
+		const std::vector<nfByte> & getDeflatedData();
+		void releaseDeflatedData();
+
 	};
 
 	typedef std::shared_ptr <CPortableZIPWriterEntry> PPortableZIPWriterEntry;
@@ -62,6 +62,8 @@ namespace NMR {
 		virtual nfUint32 GetNamespaceCount() = 0;
 		virtual std::string GetNamespacePrefix(nfUint32 nIndex) = 0;
 		virtual std::string GetNamespace(nfUint32 nIndex) = 0;
+
+		virtual nfUint64 GetBytesWritten() = 0;
 	};
 
 	typedef std::shared_ptr<CXmlWriter> PXmlWriter;
@@ -68,6 +68,7 @@ namespace NMR {
 		nfUint32 m_nLineEndingCharCount;
 		nfUint32 m_nSpacesPerLayer;
 		nfUint32 m_nLayer;
+		nfUint64 m_nBytesWritten;
 
 		void writeSpaces(_In_ nfUint32 cbCount);
 		void writeData(_In_ const void * pData, _In_ nfUint32 cbLength);
@@ -99,6 +100,8 @@ namespace NMR {
 		virtual nfUint32 GetNamespaceCount();
 		virtual std::string GetNamespacePrefix(nfUint32 nIndex);
 		virtual std::string GetNamespace(nfUint32 nIndex);
+
+		virtual nfUint64 GetBytesWritten();
 	};
 
 	typedef std::shared_ptr<CXmlWriter_Native> PXmlWriter_Native;
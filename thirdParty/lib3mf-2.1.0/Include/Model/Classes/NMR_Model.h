@@ -38,6 +38,7 @@ NMR_Model.h defines the Model Class. A model is an in memory representation of t
 
 #include "Common/Math/NMR_Matrix.h" 
 #include "Common/Mesh/NMR_Mesh.h" 
+#include "Common/Mesh/NMR_MeshMerger.h"
 
 #include "Model/Classes/NMR_PackageResourceID.h"
 
@@ -103,10 +104,11 @@ namespace NMR {
 		PPackageModelPath m_pCurPath;
 		PPackageModelPath m_pPath;
 
-		std::unordered_map<std::string, PUUID> usedUUIDs;	// datastructure used to ensure that UUIDs within one model (package) are unique
+		std::unordered_map<UUIDKEY, PUUID, UUIDKEYHash> usedUUIDs;	// datastructure used to ensure that UUIDs within one model (package) are unique
 
-		// map of all UniqueResourceIDs to actual object resources of the model
-		std::map<UniqueResourceID, PModelResource> m_ResourceMap;
+		// all actual object resources of the model, indexed directly by their UniqueResourceID.
+		// The last entry is always non-empty, so the table ends at the highest registered UniqueResourceID.
+		std::vector<PModelResource> m_ResourceLookup;
 		CResourceHandler m_resourceHandler;
 	private:
 		std::vector<PModelResource> m_Resources;
@@ -173,6 +175,7 @@ namespace NMR {
 
 		// Merge all build items into one mesh
 		void mergeToMesh(_In_ CMesh * pMesh);
+		void collectMeshInstances(_In_ CMeshMerger & merger);
 
 		// Units setter/getter
 		void setUnit(_In_ eModelUnit Unit);
@@ -185,11 +188,12 @@ namespace NMR {
 		std::string getLanguage();
 
 		// General Resource Handling
-		PModelResource findResource(_In_ std::string path, ModelResourceID nID);
+		PModelResource findResource(_In_ const std::string & path, ModelResourceID nID);
 		PModelResource findResource(_In_ UniqueResourceID nID);
 		PModelResource findResource(_In_ PPackageResourceID pID);
 
-		PPackageResourceID findPackageResourceID(_In_ std::string path, ModelResourceID nID);
+		PPackageResourceID findPackageResourceID(_In_ const std::string & path, ModelResourceID nID);
+		PPackageResourceID findPackageResourceID(_In_ const PPackageModelPath & pPath, ModelResourceID nID);
 		PPackageResourceID findPackageResourceID(_In_ UniqueResourceID nID);
 		
 		nfUint32 getResourceCount();
@@ -39,6 +39,7 @@ material resource object.
 #include "Model/Classes/NMR_ModelResource.h"
 #include "Model/Classes/NMR_ModelTypes.h"
 #include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelPropertyArray.h"
 #include <vector>
 
 namespace NMR {
@@ -48,8 +49,7 @@ namespace NMR {
 
 	class CModelBaseMaterialResource : public CModelResource {
 	private:
-		std::map<ModelPropertyID, PModelBaseMaterial> m_pMaterials;
-		ModelPropertyID m_nNextPropertyID;
+		CModelPropertyArray<PModelBaseMaterial> m_pMaterials;
 
 	public:
 		CModelBaseMaterialResource() = delete;
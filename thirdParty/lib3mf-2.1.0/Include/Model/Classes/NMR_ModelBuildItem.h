@@ -89,6 +89,7 @@ namespace NMR {
 
 		// Merge the build item to the given mesh
 		void mergeToMesh(_In_ CMesh * pMesh);
+		void collectMeshInstances(_In_ CMeshMerger & merger);
 
 		// Returns a unique handle to identify the build item
 		nfUint32 getHandle();
@@ -38,6 +38,8 @@ color group resource object.
 #include "Model/Classes/NMR_ModelResource.h"
 #include "Model/Classes/NMR_ModelTypes.h"
 #include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelPropertyArray.h"
+#include <unordered_map>
 #include <vector>
 
 namespace NMR {
@@ -47,18 +49,29 @@ namespace NMR {
 
 	class CModelColorGroupResource : public CModelResource {
 	private:
-		std::map<ModelPropertyID, nfColor> m_pColors;
-		ModelPropertyID m_nNextPropertyID;
+		CModelPropertyArray<nfColor> m_pColors;
+
+		// PropertyID of the first occurrence of each color, built on demand for deduplication
+		std::unordered_map<nfColor, ModelPropertyID> m_ColorLookup;
+		nfBool m_bHasColorLookup;
+
+		void buildColorLookup();
 
 	public:
 		CModelColorGroupResource() = delete;
 		CModelColorGroupResource(_In_ const ModelResourceID sID, _In_ CModel * pModel);
 
 		nfUint32 addColor(_In_ nfColor cColor);
+		// Adds nCount colors with consecutive PropertyIDs and returns the first of them
+		nfUint32 addColors(_In_ const nfColor * pColors, _In_ nfUint32 nCount);
+		// Adds only colors that are not yet part of the group. pPropertyIDs receives the PropertyID of every input color.
+		void addColorsDeduplicated(_In_ const nfColor * pColors, _In_ nfUint32 nCount, _Out_ ModelPropertyID * pPropertyIDs);
 
 		nfUint32 getCount();
 		nfColor getColor(_In_ ModelPropertyID nPropertyID);
 		void setColor(_In_ ModelPropertyID nPropertyID, _In_ nfColor cColor);
+		// Copies all colors in ascending order of their PropertyIDs, pColors must hold getCount() entries
+		void getColors(_Out_ nfColor * pColors);
 
 		void removeColor(_In_ ModelPropertyID nPropertyID);
 		void mergeFrom(_In_ CModelColorGroupResource * pSourceMaterial);
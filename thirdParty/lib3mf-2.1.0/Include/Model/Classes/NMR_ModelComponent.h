@@ -67,6 +67,7 @@ namespace NMR {
 		void setUUID(PUUID uuid);
 
 		void mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix);
+		void collectMeshInstances(_In_ CMeshMerger & merger, _In_ const NMATRIX3 mMatrix);
 	};
 
 	typedef std::shared_ptr <CModelComponent> PModelComponent;
@@ -59,7 +59,7 @@ namespace NMR {
 		nfUint32 getComponentCount();
 		PModelComponent getComponent(_In_ nfUint32 nIdx);
 
-		void mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix) override;
+		void collectMeshInstances(_In_ CMeshMerger & merger, _In_ const NMATRIX3 mMatrix) override;
 
 		// check, if the object is a valid object description
 		nfBool isValid() override;
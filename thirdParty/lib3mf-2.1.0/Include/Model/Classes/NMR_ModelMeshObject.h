@@ -60,7 +60,7 @@ namespace NMR {
 		_Ret_notnull_ CMesh * getMesh ();
 		void setMesh (_In_ PMesh pMesh);
 
-		void mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix) override;
+		void collectMeshInstances(_In_ CMeshMerger & merger, _In_ const NMATRIX3 mMatrix) override;
 
 		void setObjectType(_In_ eModelObjectType ObjectType) override;
 
@@ -92,9 +92,12 @@ namespace NMR {
 		nfBool setObjectTypeString(_In_ std::string sTypeString, _In_ nfBool bRaiseException);
 
 		// Merge the object into a mesh object
-		virtual void mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix);
+		void mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix);
 		void mergeToMesh(_In_ CMesh * pMesh);
 
+		// Add the meshes of the object with their transforms to a merger
+		virtual void collectMeshInstances(_In_ CMeshMerger & merger, _In_ const NMATRIX3 mMatrix);
+
 		// check, if the object is a valid object description
 		virtual nfBool isValid() = 0;
 
@@ -0,0 +1,203 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ModelPropertyArray.h defines the storage of the entries of a property group resource
+(colors, base materials, tex2coords), indexed by their ModelPropertyID.
+
+PropertyIDs are handed out consecutively, so the entries are kept in a dense array.
+Removing entries leaves holes in the dense array. Once it consists mostly of holes, the
+remaining entries are moved into a sparse overflow map and the dense array restarts
+behind them.
+
+--*/
+
+#ifndef __NMR_MODELPROPERTYARRAY
+#define __NMR_MODELPROPERTYARRAY
+
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Exception.h"
+#include "Model/Classes/NMR_ModelTypes.h"
+
+#include <map>
+#include <vector>
+
+namespace NMR {
+
+	template <class T>
+	class CModelPropertyArray {
+	private:
+		// Entries with PropertyIDs m_nDenseStartID, m_nDenseStartID + 1, ...
+		std::vector<T> m_DenseEntries;
+		std::vector<nfBool> m_DenseEntryIsValid;
+		ModelPropertyID m_nDenseStartID;
+		nfUint32 m_nDenseCount;
+
+		// Entries with PropertyIDs below m_nDenseStartID
+		std::map<ModelPropertyID, T> m_SparseEntries;
+
+		ModelPropertyID m_nNextPropertyID;
+
+		void moveDenseEntriesToSparse()
+		{
+			for (size_t nIndex = 0; nIndex < m_DenseEntries.size(); nIndex++) {
+				if (m_DenseEntryIsValid[nIndex])
+					m_SparseEntries.insert(m_SparseEntries.end(), std::make_pair(m_nDenseStartID + (ModelPropertyID)nIndex, m_DenseEntries[nIndex]));
+			}
+			m_DenseEntries.clear();
+			m_DenseEntryIsValid.clear();
+			m_nDenseStartID = m_nNextPropertyID;
+			m_nDenseCount = 0;
+		}
+
+	public:
+		CModelPropertyArray()
+			: m_nDenseStartID(1), m_nDenseCount(0), m_nNextPropertyID(1)
+		{
+		}
+
+		nfUint32 getCount() const
+		{
+			return m_nDenseCount + (nfUint32)m_SparseEntries.size();
+		}
+
+		ModelPropertyID getNextPropertyID() const
+		{
+			return m_nNextPropertyID;
+		}
+
+		void reserve(_In_ nfUint32 nAdditionalCount)
+		{
+			m_DenseEntries.reserve(m_DenseEntries.size() + nAdditionalCount);
+			m_DenseEntryIsValid.reserve(m_DenseEntryIsValid.size() + nAdditionalCount);
+		}
+
+		ModelPropertyID add(_In_ const T & entry)
+		{
+			ModelPropertyID nPropertyID = m_nNextPropertyID;
+			m_DenseEntries.push_back(entry);
+			m_DenseEntryIsValid.push_back(true);
+			m_nDenseCount++;
+			m_nNextPropertyID++;
+			return nPropertyID;
+		}
+
+		// Returns nullptr if there is no entry with this PropertyID
+		T * find(_In_ ModelPropertyID nPropertyID)
+		{
+			if (nPropertyID >= m_nDenseStartID) {
+				size_t nIndex = nPropertyID - m_nDenseStartID;
+				if ((nIndex < m_DenseEntries.size()) && m_DenseEntryIsValid[nIndex])
+					return &m_DenseEntries[nIndex];
+				return nullptr;
+			}
+
+			auto iIterator = m_SparseEntries.find(nPropertyID);
+			if (iIterator != m_SparseEntries.end())
+				return &iIterator->second;
+			return nullptr;
+		}
+
+		T & get(_In_ ModelPropertyID nPropertyID)
+		{
+			T * pEntry = find(nPropertyID);
+			if (pEntry == nullptr)
+				throw CNMRException(NMR_ERROR_INVALIDINDEX);
+			return *pEntry;
+		}
+
+		void remove(_In_ ModelPropertyID nPropertyID)
+		{
+			if (nPropertyID < m_nDenseStartID) {
+				m_SparseEntries.erase(nPropertyID);
+				return;
+			}
+
+			size_t nIndex = nPropertyID - m_nDenseStartID;
+			if ((nIndex >= m_DenseEntries.size()) || !m_DenseEntryIsValid[nIndex])
+				return;
+
+			m_DenseEntries[nIndex] = T();
+			m_DenseEntryIsValid[nIndex] = false;
+			m_nDenseCount--;
+
+			// Switch to sparse storage once less than a quarter of the dense array is in use
+			if ((m_DenseEntries.size() >= 64) && (m_nDenseCount < m_DenseEntries.size() / 4))
+				moveDenseEntriesToSparse();
+		}
+
+		// True if all entries are stored in the dense array without holes.
+		// Then entry nIndex has PropertyID getFirstPropertyID() + nIndex.
+		nfBool isContiguous() const
+		{
+			return m_SparseEntries.empty() && (m_nDenseCount == m_DenseEntries.size());
+		}
+
+		ModelPropertyID getFirstPropertyID() const
+		{
+			if (!m_SparseEntries.empty())
+				return m_SparseEntries.begin()->first;
+			return m_nDenseStartID;
+		}
+
+		const T * getDenseData() const
+		{
+			return m_DenseEntries.data();
+		}
+
+		// Calls fnVisit(PropertyID, Entry) for all entries in ascending order of their PropertyIDs
+		template <typename F>
+		void forEach(F fnVisit)
+		{
+			for (auto iIterator = m_SparseEntries.begin(); iIterator != m_SparseEntries.end(); iIterator++)
+				fnVisit(iIterator->first, iIterator->second);
+
+			for (size_t nIndex = 0; nIndex < m_DenseEntries.size(); nIndex++) {
+				if (m_DenseEntryIsValid[nIndex])
+					fnVisit(m_nDenseStartID + (ModelPropertyID)nIndex, m_DenseEntries[nIndex]);
+			}
+		}
+
+		void getPropertyIDs(_Out_ std::vector<ModelPropertyID> & PropertyIDs)
+		{
+			PropertyIDs.clear();
+			PropertyIDs.reserve(getCount());
+			if (isContiguous()) {
+				for (nfUint32 nIndex = 0; nIndex < m_nDenseCount; nIndex++)
+					PropertyIDs.push_back(m_nDenseStartID + nIndex);
+			}
+			else {
+				forEach([&PropertyIDs](ModelPropertyID nPropertyID, T &) {
+					PropertyIDs.push_back(nPropertyID);
+				});
+			}
+		}
+	};
+
+}
+
+#endif // __NMR_MODELPROPERTYARRAY
@@ -0,0 +1,80 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ModelPropertyResolver.h defines the Model Property Resolver Class.
+A property resolver turns the per-triangle properties of a mesh into
+flat arrays of colors or texture coordinates. It looks up each
+referenced property resource only once.
+
+--*/
+
+#ifndef __NMR_MODELPROPERTYRESOLVER
+#define __NMR_MODELPROPERTYRESOLVER
+
+#include "Common/NMR_Types.h"
+#include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
+#include "Model/Classes/NMR_ModelTypes.h"
+
+#include <unordered_map>
+
+namespace NMR {
+
+	class CModel;
+	class CModelColorGroupResource;
+	class CModelBaseMaterialResource;
+	class CModelTexture2DGroupResource;
+
+	class CModelPropertyResolver {
+	private:
+		typedef struct {
+			CModelColorGroupResource * m_pColorGroup;
+			CModelBaseMaterialResource * m_pBaseMaterials;
+			CModelTexture2DGroupResource * m_pTexture2DGroup;
+		} RESOLVERRESOURCE;
+
+		CModel * m_pModel;
+		std::unordered_map<UniqueResourceID, RESOLVERRESOURCE> m_Resources;
+
+		const RESOLVERRESOURCE & findResource(_In_ UniqueResourceID nResourceID);
+		const MESHINFORMATION_PROPERTIES * getFaceProperties(_In_ CMeshInformation_Properties * pInformation, _In_ nfUint32 nFaceIndex);
+	public:
+		CModelPropertyResolver() = delete;
+		CModelPropertyResolver(_In_ CModel * pModel);
+
+		// Writes red, green, blue and alpha in [0,1] for the three corners of each face (12 values per face).
+		// pResourceIDs receives the color group or base material group of each face, or 0 if the face has no color.
+		void resolveColors(_In_ CMeshInformation_Properties * pInformation, _In_ nfUint32 nFaceCount, _Out_ nfFloat * pRGBAValues, _Out_ UniqueResourceID * pResourceIDs);
+
+		// Writes u and v for the three corners of each face (6 values per face).
+		// pResourceIDs receives the texture 2D group of each face, or 0 if the face is not textured.
+		void resolveTex2Coords(_In_ CMeshInformation_Properties * pInformation, _In_ nfUint32 nFaceCount, _Out_ nfDouble * pUVValues, _Out_ UniqueResourceID * pResourceIDs);
+	};
+
+}
+
+#endif // __NMR_MODELPROPERTYRESOLVER
@@ -35,7 +35,7 @@ A Model Slice represents a single slice as vertices and polygons
 #define __NMR_MODELSLICE
 
 #include "Common/NMR_Types.h"
-#include "Common/Mesh/NMR_MeshTypes.h"
+#include "Common/Math/NMR_Geometry.h"
 #include "Model/Classes/NMR_ModelResource.h"
 
 #include <vector>
@@ -43,11 +43,16 @@ A Model Slice represents a single slice as vertices and polygons
 namespace NMR {
 	class CSlice {
 	private:
-		std::vector<SLICENODE> m_Vertices;
-		std::vector<std::vector<nfUint32>> m_Polygons;
+		// Polygons are stored in compressed rows: the vertex indices of polygon p are
+		// m_PolygonIndices[m_PolygonOffsets[p] ... m_PolygonOffsets[p + 1] - 1].
+		std::vector<NVEC2> m_Vertices;
+		std::vector<nfUint32> m_PolygonOffsets;
+		std::vector<nfUint32> m_PolygonIndices;
 
 		nfDouble m_dZTop;
 
+		void checkPolygonIndices(nfUint32 nPolygonIndex, nfUint32 nCount, const nfUint32 * pIndices);
+
 	public:
 		CSlice() = delete;
 		CSlice(nfDouble dZTop);
@@ -58,12 +63,17 @@ namespace NMR {
 
 		nfUint32 addVertex(nfFloat x, nfFloat y);
 
+		void reserveVertices(nfUint32 nCount);
+
 		void getVertex(nfUint32 nIndex, nfFloat *x, nfFloat *y);
 
 		nfUint32 beginPolygon();
 
 		void addPolygonIndex(nfUint32 nPolygonIndex, nfUint32 nIndex);
 
+		// Replaces all indices of a polygon. Nothing is changed if an index is invalid.
+		void setPolygonIndices(nfUint32 nPolygonIndex, nfUint32 nCount, const nfUint32 * pIndices);
+
 		void clearPolygon(nfUint32 nPolygonIndex);
 
 		nfUint32 getPolygonCount();
@@ -72,7 +82,9 @@ namespace NMR {
 
 		void setTopZ(nfDouble dZTop);
 
-		_Ret_notnull_ SLICENODE *getNode(nfUint32 nIndex);
+		_Ret_maybenull_ const NVEC2 * getVertices();
+
+		_Ret_maybenull_ const nfUint32 * getPolygonIndices(nfUint32 nPolygonIndex);
 
 		nfUint32 getPolygonIndex(nfUint32 nPolygonIndex, nfUint32 nIndexOfIndex);
 
@@ -83,6 +95,8 @@ namespace NMR {
 		bool allPolygonsAreClosed();
 
 		bool isPolygonValid(nfUint32 nPolygonIndex);
+
+		nfUint64 getMemoryUsage();
 	};
 
 	typedef std::shared_ptr <CSlice> PSlice;
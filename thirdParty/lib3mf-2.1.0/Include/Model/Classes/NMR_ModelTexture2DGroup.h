@@ -38,6 +38,7 @@ texture2d group resource object.
 #include "Model/Classes/NMR_ModelResource.h"
 #include "Model/Classes/NMR_ModelTypes.h"
 #include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelPropertyArray.h"
 #include <vector>
 
 namespace NMR {
@@ -48,20 +49,23 @@ namespace NMR {
 	class CModelTexture2DGroupResource : public CModelResource {
 	private:
 		PModelTexture2DResource m_pTexture2D;
-		std::map<ModelPropertyID, MODELTEXTURE2DCOORDINATE> m_pUVCoordinates;
-		ModelPropertyID m_nNextPropertyID;
+		CModelPropertyArray<MODELTEXTURE2DCOORDINATE> m_pUVCoordinates;
 
 	public:
 		CModelTexture2DGroupResource() = delete;
 		CModelTexture2DGroupResource(_In_ const ModelResourceID sID, _In_ CModel * pModel, _In_ PModelTexture2DResource pTexture2D);
 
 		nfUint32 addUVCoordinate(_In_ MODELTEXTURE2DCOORDINATE UV);
+		// Adds nCount coordinates with consecutive PropertyIDs and returns the first of them
+		nfUint32 addUVCoordinates(_In_ const MODELTEXTURE2DCOORDINATE * pUVs, _In_ nfUint32 nCount);
 
 		nfUint32 getCount();
 		void removePropertyID(_In_ ModelPropertyID nPropertyID);
 		void setUVCoordinate(_In_ ModelPropertyID nPropertyID, _In_ MODELTEXTURE2DCOORDINATE sCoordinate);
 
 		MODELTEXTURE2DCOORDINATE getUVCoordinate(_In_ ModelPropertyID nPropertyID);
+		// Copies all coordinates in ascending order of their PropertyIDs, pUVs must hold getCount() entries
+		void getUVCoordinates(_Out_ MODELTEXTURE2DCOORDINATE * pUVs);
 
 		void mergeFrom(_In_ CModelTexture2DGroupResource * pSourceMaterial);
 		void buildResourceIndexMap();
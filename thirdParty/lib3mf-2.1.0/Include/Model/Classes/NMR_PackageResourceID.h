@@ -37,13 +37,13 @@ NMR_PackageResourceID.h defines the UniqueResourceID Class.
 #include <string>
 
 #include <memory>
-#include <map>
 #include <unordered_map>
 #include <vector>
 
 namespace NMR {
 
 	class CResourceHandler;
+	class CPackageResourceID;
 
 
 	class CPackageModelPath {
@@ -51,6 +51,9 @@ namespace NMR {
 		CResourceHandler* m_pResourceHandler;
 		std::string m_sPath;
 
+		// ModelResourceIDs within this path to CPackageResourceID
+		std::unordered_map<ModelResourceID, std::shared_ptr<CPackageResourceID>> m_ResourceIDs;
+
 	public:
 		CPackageModelPath(CResourceHandler* pResourceHandler, std::string sPath);
 
@@ -91,24 +94,26 @@ namespace NMR {
 	typedef std::shared_ptr<CPackageResourceID> PPackageResourceID;
 
 
-	using UniqueIDPackageIdMap = std::unordered_map<UniqueResourceID, PPackageResourceID>;
-	using UniqueIdPackageIdPair = std::pair<UniqueResourceID, PPackageResourceID>;
-
 	class CResourceHandler {
 	private:
 		// getPath-strings to ModelPaths
 		std::unordered_map<std::string, PPackageModelPath> m_PathToModelPath;
 
-		// unique IDs to CPackageResourceID
-		UniqueIDPackageIdMap m_resourceIDs;
-		std::map<std::pair<ModelResourceID, PPackageModelPath>, PPackageResourceID> m_IdAndPathToPackageResourceIDs;
+		// unique IDs to CPackageResourceID. Indexed directly by UniqueResourceID, index 0 is never used.
+		// (path, ModelResourceID) lookups go through the hash table of the respective CPackageModelPath.
+		std::vector<PPackageResourceID> m_resourceIDs;
+		UniqueResourceID m_nNextUniqueID;
 	public:
-		PPackageResourceID makePackageResourceID(std::string path, ModelResourceID id);	// this is supposed to be the only way to generate a CPackageResourceID
+		CResourceHandler();
+		~CResourceHandler();
+
+		PPackageResourceID makePackageResourceID(const std::string & path, ModelResourceID id);	// this is supposed to be the only way to generate a CPackageResourceID
 		
 		PPackageResourceID findResourceIDByUniqueID(UniqueResourceID id);
-		PPackageResourceID findResourceIDByPair(std::string path, ModelResourceID id);
+		PPackageResourceID findResourceIDByPair(const std::string & path, ModelResourceID id);
+		PPackageResourceID findResourceIDByPair(const PPackageModelPath & pModelPath, ModelResourceID id);
 
-		PPackageModelPath findPackageModelPath(std::string sPath);
+		PPackageModelPath findPackageModelPath(const std::string & sPath);
 		PPackageModelPath makePackageModelPath(std::string sPath);
 
 		void updateModelPath(PPackageResourceID pPackageResourceID, PPackageModelPath pNewPath);
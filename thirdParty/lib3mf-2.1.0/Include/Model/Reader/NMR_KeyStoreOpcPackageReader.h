@@ -53,6 +53,7 @@ namespace NMR {
 		CModelContext const & m_pContext;
 		PIOpcPackageReader m_pPackageReader;
 		std::map<std::string, POpcPackagePart> m_encryptedParts;
+		nfBool m_bPreloadEncryptedParts;
 	protected:
 		NMR::PImportStream findKeyStoreStream();
 		void parseKeyStore(NMR::PImportStream keyStoreStream);
@@ -67,6 +68,11 @@ namespace NMR {
 		virtual nfUint64 getPartSize(std::string sPath) override;
 
 		void close() override;
+
+		// If set, the raw content of encrypted parts is read into memory when the part is created.
+		// Their decrypting streams then no longer touch the package and can be consumed on any thread.
+		void setPreloadEncryptedParts(_In_ nfBool bPreload);
+		nfBool isEncryptedPart(_In_ const std::string & sURI);
 	};
 
 	using PKeyStoreOpcPackageReader = std::shared_ptr<CKeyStoreOpcPackageReader>;
@@ -48,6 +48,8 @@ namespace NMR {
 		PImportStream m_pPrintTicketStream;
 		std::string m_sPrintTicketContentType;
 		std::set<std::string> m_RelationsToRead;
+		nfUint32 m_nDecryptionThreadCount;
+		nfUint32 m_nSliceThreadCount;
 
 
 		void readFromMeshImporter(_In_ CMeshImporter * pImporter);
@@ -61,6 +63,14 @@ namespace NMR {
 
 		void addRelationToRead(_In_ std::string sRelationShipType);
 		void removeRelationToRead(_In_ std::string sRelationShipType);
+
+		// Number of threads used to decrypt independent secure parts. 0 and 1 decrypt serially.
+		void setDecryptionThreadCount(_In_ nfUint32 nThreadCount);
+		nfUint32 getDecryptionThreadCount();
+
+		// Number of threads used to read the slices of slice model parts. 0 and 1 read serially.
+		void setSliceThreadCount(_In_ nfUint32 nThreadCount);
+		nfUint32 getSliceThreadCount();
 	};
 
 	typedef std::shared_ptr <CModelReader> PModelReader;
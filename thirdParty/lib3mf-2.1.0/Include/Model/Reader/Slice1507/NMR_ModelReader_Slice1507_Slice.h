@@ -55,6 +55,8 @@ namespace NMR {
 	public:
 		CModelReaderNode_Slices1507_Slice() = delete;
 		CModelReaderNode_Slices1507_Slice(_In_ CModelSliceStack *pSliceStack, _In_ PModelWarnings pWarnings);
+		// Reads the content into an existing slice, e.g. one that has been split off its slicestack
+		CModelReaderNode_Slices1507_Slice(_In_ PSlice pSlice, _In_ PModelWarnings pWarnings);
 
 		virtual void parseXML(_In_ CXmlReader * pXMLReader);
 	};
@@ -0,0 +1,98 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ModelReader_Slice1507_SliceSplitter.h defines a splitter for slice model parts.
+It separates the content of all slices from the rest of the part, so that the
+slicestacks can be read serially while the slices are read on worker threads.
+
+--*/
+
+#ifndef __NMR_MODELREADER_SLICE1507_SLICESPLITTER
+#define __NMR_MODELREADER_SLICE1507_SLICESPLITTER
+
+#include "Common/Platform/NMR_ImportStream.h"
+#include "Common/NMR_ModelWarnings.h"
+#include "Common/3MF_ProgressMonitor.h"
+#include "Model/Classes/NMR_ModelSliceStack.h"
+
+#include <vector>
+#include <string>
+
+namespace NMR {
+
+	class CModelReader_Slice1507_SliceSplitter {
+	private:
+		typedef struct {
+			nfUint64 m_nStart;
+			nfUint64 m_nContentStart;
+			nfUint64 m_nContentEnd;
+			nfUint64 m_nEnd;
+		} SLICERANGE;
+
+		typedef struct {
+			std::string m_sName;
+			std::string m_sNameSpaces;
+			std::vector<SLICERANGE> m_Slices;
+		} SLICESTACKRANGE;
+
+		std::vector<nfByte> m_Buffer;
+		std::vector<nfByte> m_Skeleton;
+		std::vector<SLICESTACKRANGE> m_SliceStacks;
+		nfUint64 m_nSliceCount;
+		nfBool m_bIsSplit;
+
+		nfBool scanBuffer();
+		void buildSkeleton();
+		void readSliceChunk(_In_ const SLICESTACKRANGE & SliceStack, _In_ nfUint64 nFirstSlice, _In_ nfUint64 nEndSlice,
+			_In_ CModelSliceStack * pSliceStack, _In_ PModelWarnings pWarnings);
+
+	public:
+		CModelReader_Slice1507_SliceSplitter() = delete;
+
+		// Reads the whole part into memory and locates the content of all slices.
+		CModelReader_Slice1507_SliceSplitter(_In_ PImportStream pStream);
+
+		// False if the part contains no slices or cannot be split safely. In that case
+		// getSkeletonStream returns the unmodified part.
+		nfBool isSplit();
+		nfUint64 getSliceCount();
+
+		// Stream of the part with the content of all slices removed.
+		PImportStream getSkeletonStream();
+
+		// Reads the content of all slices into the slicestacks created from the skeleton,
+		// which must be passed in document order.
+		void readSlices(_In_ const std::vector<PModelSliceStack> & SliceStacks, _In_ PModelWarnings pWarnings,
+			_In_ PProgressMonitor pProgressMonitor, _In_ nfUint32 nThreadCount);
+	};
+
+	typedef std::shared_ptr <CModelReader_Slice1507_SliceSplitter> PModelReader_Slice1507_SliceSplitter;
+
+}
+
+#endif // __NMR_MODELREADER_SLICE1507_SLICESPLITTER
@@ -51,6 +51,11 @@ namespace NMR {
 		ModelResourceIndex m_nDefaultResourceIndex;
 		ModelResourceID m_nUsedResourceID;
 
+		// resource of the previous triangle, consecutive triangles mostly share it
+		ModelResourceID m_nCachedResourceID;
+		PPackageResourceID m_pCachedPackageResourceID;
+		PModelResource m_pCachedResource;
+
 		virtual void OnAttribute(_In_z_ const nfChar * pAttributeName, _In_z_ const nfChar * pAttributeValue);
 		virtual void OnNSChildElement(_In_z_ const nfChar * pChildName, _In_z_ const nfChar * pNameSpace, _In_ CXmlReader * pXMLReader);
 
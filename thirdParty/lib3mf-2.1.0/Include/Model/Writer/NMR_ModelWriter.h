@@ -45,6 +45,11 @@ namespace NMR {
 	class CModelWriter : public CModelContext{
 	private:
 		nfUint32 m_nDecimalPrecision;
+		nfBool m_bOptimizeMeshLayout;
+		nfUint32 m_nCompressionThreadCount;
+	protected:
+		// Reorders the faces and nodes of all mesh objects of the model for locality
+		void optimizeMeshLayouts();
 	public:
 		CModelWriter() = delete;
 		CModelWriter(_In_ PModel pModel);
@@ -54,6 +59,13 @@ namespace NMR {
 
 		void SetDecimalPrecision(nfUint32);
 		nfUint32 GetDecimalPrecision();
+
+		void SetOptimizeMeshLayout(nfBool bOptimizeMeshLayout);
+		nfBool GetOptimizeMeshLayout();
+
+		// Number of threads used to compress independent package parts. 0 and 1 compress serially.
+		void SetCompressionThreadCount(_In_ nfUint32 nThreadCount);
+		nfUint32 GetCompressionThreadCount();
 	};
 
 	typedef std::shared_ptr <CModelWriter> PModelWriter;
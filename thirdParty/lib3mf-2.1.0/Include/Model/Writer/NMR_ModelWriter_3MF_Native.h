@@ -41,6 +41,9 @@ using LibZ and a native XML writer implementation.
 
 #define MODELWRITER_NATIVE_BUFFERSIZE 65536
 
+#include <utility>
+#include <vector>
+
 namespace NMR {
 
 	class CModelWriter_3MF_Native : public CModelWriter_3MF {
@@ -54,6 +57,10 @@ namespace NMR {
 		virtual void releasePackage();
 
 		void addAttachments(_In_ CModel * pModel, _In_ POpcPackagePart pModelPart);
+		void copyAttachment(_In_ CModelAttachment * pAttachment, _In_ COpcPackagePart * pAttachmentPart);
+		void addAttachmentRelationships(_In_ CModelAttachment * pAttachment, _In_ POpcPackagePart pModelPart, _In_ POpcPackagePart pAttachmentPart);
+		// Compresses the deferred attachment parts concurrently and stores them in the package
+		void writeDeferredAttachments(_In_ std::vector<std::pair<PModelAttachment, POpcPackagePart>> & DeferredAttachments, _In_ POpcPackagePart pModelPart);
 
 		void addNonRootModels();
 
@@ -38,7 +38,7 @@ A model writer exports the in memory represenation into the 3MF file.
 #include "Common/NMR_Types.h" 
 #include "Common/NMR_PagedVector.h" 
 
-#include <map>
+#include <unordered_map>
 #include <memory>
 
 namespace NMR {
@@ -47,7 +47,7 @@ namespace NMR {
 	private:
 	protected:
 		ModelResourceIndex m_nCurrentIndex;
-		std::map<nfColor, ModelResourceIndex> m_IndexMap;
+		std::unordered_map<nfColor, ModelResourceIndex> m_IndexMap;
 		std::vector<nfColor> m_ColorVector;
 		ModelResourceID m_ResourceID;
 
@@ -113,7 +113,8 @@ namespace NMR {
 		__NMR_INLINE void writeFaceData_Plain(_In_ MESHFACE * pFace, _In_opt_ const nfChar * pszAdditionalString);
 		__NMR_INLINE void writeFaceData_OneProperty(_In_ MESHFACE * pFace, _In_ const ModelResourceID nPropertyID, _In_ const ModelResourceIndex nPropertyIndex, _In_opt_ const nfChar * pszAdditionalString);
 		__NMR_INLINE void writeFaceData_ThreeProperties(_In_ MESHFACE * pFace, _In_ const ModelResourceID nPropertyID, _In_ const ModelResourceIndex nPropertyIndex1, _In_ const ModelResourceIndex nPropertyIndex2, _In_ const ModelResourceIndex nPropertyIndex3, _In_opt_ const nfChar * pszAdditionalString);
-		__NMR_INLINE void writeBeamData(_In_ MESHBEAM * pBeam, _In_ nfDouble dRadius, _In_ eModelBeamLatticeCapMode eDefaultCapMode);
+		__NMR_INLINE void writeBeamData(_In_ const nfInt32 * pNodeIndices, _In_ const nfDouble * pRadii, _In_ const nfInt32 * pCapModes,
+			_In_ nfDouble dDefaultRadius, _In_ eModelBeamLatticeCapMode eDefaultCapMode);
 		__NMR_INLINE void writeBallData(_In_ MESHBALL * pBall, _In_ eModelBeamLatticeBallMode eBallMode, _In_ nfDouble dRadius);
 		__NMR_INLINE void writeRefData(_In_ INT nRefID);
 		__NMR_INLINE void writeBallRefData(_In_ INT nRefID);
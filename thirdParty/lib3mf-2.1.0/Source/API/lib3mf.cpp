@@ -42,6 +42,7 @@ Interface version: 2.1.0
 #include "NMR_Spec_Version.h"
 #include "Model/Classes/NMR_ModelConstants.h" 
 #include "Common/3MF_ProgressMonitor.h"
+#include "Common/NMR_Trace.h"
 #include <cmath>
 #include <algorithm>
 
@@ -163,6 +164,17 @@ void CWrapper::RetrieveProgressMessage (const eLib3MFProgressIdentifier eProrges
 	NMR::CProgressMonitor::GetProgressMessage(convertProgressIdentifier(eProrgessIdentifier), sProgressMessage);
 }
 
+bool CWrapper::RetrieveTrace(std::string & sTraceJSON)
+{
+	sTraceJSON = NMR::fnTraceToChromeJSON();
+	return NMR::fnTraceIsEnabled();
+}
+
+void CWrapper::ClearTrace()
+{
+	NMR::fnTraceClear();
+}
+
 sLib3MFColor CWrapper::RGBAToColor (const Lib3MF_uint8 nRed, const Lib3MF_uint8 nGreen, const Lib3MF_uint8 nBlue, const Lib3MF_uint8 nAlpha)
 {
 	sLib3MFColor s;
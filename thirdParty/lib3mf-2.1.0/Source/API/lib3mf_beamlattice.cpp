@@ -33,6 +33,10 @@ Abstract: This is a stub class definition of CBeamLattice
 
 #include "lib3mf_beamset.hpp"
 // Include custom headers here.
+#include "Common/Math/NMR_Vector.h"
+#include "Common/NMR_ParallelFor.h"
+#include <algorithm>
+#include <vector>
 
 
 using namespace Lib3MF::Impl;
@@ -148,6 +152,20 @@ void CBeamLattice::SetBallOptions (const eLib3MFBeamLatticeBallMode eBallMode, c
 	}
 }
 
+void CBeamLattice::GetBeamOptions (Lib3MF_double & dRadius, eLib3MFBeamLatticeCapMode & eCapMode)
+{
+	dRadius = m_mesh.getDefaultBeamRadius();
+	eCapMode = (eLib3MFBeamLatticeCapMode)m_mesh.getBeamLatticeCapMode();
+}
+
+void CBeamLattice::SetBeamOptions (const Lib3MF_double dRadius, const eLib3MFBeamLatticeCapMode eCapMode)
+{
+	if (dRadius <= 0.0)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	m_mesh.setDefaultBeamRadius(dRadius);
+	m_mesh.setBeamLatticeCapMode((NMR::eModelBeamLatticeCapMode)eCapMode);
+}
+
 Lib3MF_uint32 CBeamLattice::GetBeamCount ()
 {
 	return m_mesh.getBeamCount();
@@ -156,15 +174,16 @@ Lib3MF_uint32 CBeamLattice::GetBeamCount ()
 sLib3MFBeam CBeamLattice::GetBeam (const Lib3MF_uint32 nIndex)
 {
 	sLib3MFBeam beam;
-	NMR::MESHBEAM* meshBeam = m_mesh.getBeam(nIndex);
-	beam.m_CapModes[0] = (eLib3MFBeamLatticeCapMode)(meshBeam->m_capMode[0]);
-	beam.m_CapModes[1] = (eLib3MFBeamLatticeCapMode)meshBeam->m_capMode[1];
+	NMR::MESHBEAM meshBeam;
+	m_mesh.getBeam(nIndex, meshBeam);
+	beam.m_CapModes[0] = (eLib3MFBeamLatticeCapMode)(meshBeam.m_capMode[0]);
+	beam.m_CapModes[1] = (eLib3MFBeamLatticeCapMode)meshBeam.m_capMode[1];
 
-	beam.m_Indices[0] = meshBeam->m_nodeindices[0];
-	beam.m_Indices[1] = meshBeam->m_nodeindices[1];
+	beam.m_Indices[0] = meshBeam.m_nodeindices[0];
+	beam.m_Indices[1] = meshBeam.m_nodeindices[1];
 
-	beam.m_Radii[0] = meshBeam->m_radius[0];
-	beam.m_Radii[1] = meshBeam->m_radius[1];
+	beam.m_Radii[0] = meshBeam.m_radius[0];
+	beam.m_Radii[1] = meshBeam.m_radius[1];
 	return beam;
 }
 
@@ -195,8 +214,7 @@ Lib3MF_uint32 CBeamLattice::AddBeam (const sLib3MFBeam BeamInfo)
 	for (int j = 0; j < 2; j++)
 		pNodes[j] = m_mesh.getNode(BeamInfo.m_Indices[j]);
 
-	NMR::MESHBEAM * pMeshBeam = m_mesh.addBeam(pNodes[0], pNodes[1], BeamInfo.m_Radii[0], BeamInfo.m_Radii[1], (int)BeamInfo.m_CapModes[0], (int)BeamInfo.m_CapModes[1]);
-	return pMeshBeam->m_index;
+	return m_mesh.addBeam(pNodes[0], pNodes[1], BeamInfo.m_Radii[0], BeamInfo.m_Radii[1], (int)BeamInfo.m_CapModes[0], (int)BeamInfo.m_CapModes[1]);
 }
 
 void CBeamLattice::SetBeam (const Lib3MF_uint32 nIndex, const sLib3MFBeam BeamInfo)
@@ -204,15 +222,16 @@ void CBeamLattice::SetBeam (const Lib3MF_uint32 nIndex, const sLib3MFBeam BeamIn
 	if (!isBeamValid(m_mesh.getNodeCount(), BeamInfo))
 		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
 
-	NMR::MESHBEAM* meshBeam = m_mesh.getBeam(nIndex);
-	meshBeam->m_capMode[0] = (int)BeamInfo.m_CapModes[0];
-	meshBeam->m_capMode[1] = (int)BeamInfo.m_CapModes[1];
+	NMR::MESHBEAM meshBeam;
+	meshBeam.m_capMode[0] = (int)BeamInfo.m_CapModes[0];
+	meshBeam.m_capMode[1] = (int)BeamInfo.m_CapModes[1];
 
-	meshBeam->m_nodeindices[0] = BeamInfo.m_Indices[0];
-	meshBeam->m_nodeindices[1] = BeamInfo.m_Indices[1];
+	meshBeam.m_nodeindices[0] = BeamInfo.m_Indices[0];
+	meshBeam.m_nodeindices[1] = BeamInfo.m_Indices[1];
 
-	meshBeam->m_radius[0] = BeamInfo.m_Radii[0];
-	meshBeam->m_radius[1] = BeamInfo.m_Radii[1];
+	meshBeam.m_radius[0] = BeamInfo.m_Radii[0];
+	meshBeam.m_radius[1] = BeamInfo.m_Radii[1];
+	m_mesh.setBeam(nIndex, meshBeam);
 
 	// Occupied nodes may have changed, need to validate
 	m_mesh.scanOccupiedNodes();
@@ -224,20 +243,40 @@ void CBeamLattice::SetBeams(const Lib3MF_uint64 nBeamInfoBufferSize, const sLib3
 	if ((nBeamInfoBufferSize>0) && (!m_pMeshObject->isValidForBeamLattices()))
 		throw ELib3MFInterfaceException(LIB3MF_ERROR_BEAMLATTICE_INVALID_OBJECTTYPE);
 
-	m_mesh.clearBeamLatticeBeams();
+	if (nBeamInfoBufferSize > NMR_MESH_MAXBEAMCOUNT)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	if ((nBeamInfoBufferSize > 0) && (!pBeamInfoBuffer))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
 
-	const sLib3MFBeam* pBeamInfoCurrent = pBeamInfoBuffer;
-	for (Lib3MF_uint32 nIndex = 0; nIndex < nBeamInfoBufferSize; nIndex++)
+	Lib3MF_uint32 nNodeCount = m_mesh.getNodeCount();
+	for (Lib3MF_uint64 nIndex = 0; nIndex < nBeamInfoBufferSize; nIndex++)
 	{
-		if (!isBeamValid(m_mesh.getNodeCount(), *pBeamInfoCurrent))
+		if (!isBeamValid(nNodeCount, pBeamInfoBuffer[nIndex]))
 			throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	}
+
+	m_mesh.clearBeamLatticeBeams();
+
+	// Hand the beams to the mesh in blocks to bound the size of the temporary arrays
+	Lib3MF_uint32 nBeamCount = (Lib3MF_uint32)nBeamInfoBufferSize;
+	Lib3MF_uint32 nBlockSize = std::min(nBeamCount, (Lib3MF_uint32)NMR_MESH_BEAMCOPYBLOCKSIZE);
+	std::vector<NMR::nfInt32> NodeIndices(nBlockSize * 2);
+	std::vector<NMR::nfDouble> Radii(nBlockSize * 2);
+	std::vector<NMR::nfInt32> CapModes(nBlockSize * 2);
+	m_mesh.getBeamStore().reserve(nBeamCount);
 
-		NMR::MESHNODE * pNodes[2];
-		for (int j = 0; j < 2; j++)
-			pNodes[j] = m_mesh.getNode(pBeamInfoCurrent->m_Indices[j]);
-		
-		m_mesh.addBeam(pNodes[0], pNodes[1], pBeamInfoCurrent->m_Radii[0], pBeamInfoCurrent->m_Radii[1], (int)pBeamInfoCurrent->m_CapModes[0], (int)pBeamInfoCurrent->m_CapModes[1]);
-		pBeamInfoCurrent++;
+	for (Lib3MF_uint32 nStart = 0; nStart < nBeamCount; nStart += nBlockSize)
+	{
+		Lib3MF_uint32 nCount = std::min(nBlockSize, nBeamCount - nStart);
+		for (Lib3MF_uint32 nIndex = 0; nIndex < nCount; nIndex++) {
+			const sLib3MFBeam & beamInfo = pBeamInfoBuffer[nStart + nIndex];
+			for (int j = 0; j < 2; j++) {
+				NodeIndices[nIndex * 2 + j] = beamInfo.m_Indices[j];
+				Radii[nIndex * 2 + j] = beamInfo.m_Radii[j];
+				CapModes[nIndex * 2 + j] = (int)beamInfo.m_CapModes[j];
+			}
+		}
+		m_mesh.addBeams(nCount, NodeIndices.data(), Radii.data(), CapModes.data());
 	}
 
 	// Occupied nodes may have changed, need to validate
@@ -250,21 +289,30 @@ void CBeamLattice::GetBeams(Lib3MF_uint64 nBeamInfoBufferSize, Lib3MF_uint64* pB
 	if (pBeamInfoNeededCount)
 		*pBeamInfoNeededCount = beamCount;
 
-	if (nBeamInfoBufferSize >= beamCount && pBeamInfoBuffer)
+	if (nBeamInfoBufferSize >= beamCount && pBeamInfoBuffer && (beamCount > 0))
 	{
-		sLib3MFBeam* beam = pBeamInfoBuffer;
-		for (Lib3MF_uint32 i = 0; i < beamCount; i++)
-		{
-			const NMR::MESHBEAM* meshBeam = m_mesh.getBeam(i);
-			beam->m_CapModes[0] = (eLib3MFBeamLatticeCapMode)meshBeam->m_capMode[0];
-			beam->m_CapModes[1] = (eLib3MFBeamLatticeCapMode)meshBeam->m_capMode[1];
+		const NMR::CMeshBeamStore & beamStore = m_mesh.getBeamStore();
+		const NMR::nfInt32 * pNodeIndices = beamStore.getNodeIndices();
 
-			beam->m_Indices[0] = meshBeam->m_nodeindices[0];
-			beam->m_Indices[1] = meshBeam->m_nodeindices[1];
+		Lib3MF_uint32 nBlockSize = std::min(beamCount, (Lib3MF_uint32)NMR_MESH_BEAMCOPYBLOCKSIZE);
+		std::vector<NMR::nfDouble> Radii(nBlockSize * 2);
+		std::vector<NMR::nfInt32> CapModes(nBlockSize * 2);
 
-			beam->m_Radii[0] = meshBeam->m_radius[0];
-			beam->m_Radii[1] = meshBeam->m_radius[1];
-			beam++;
+		sLib3MFBeam* beam = pBeamInfoBuffer;
+		for (Lib3MF_uint32 nStart = 0; nStart < beamCount; nStart += nBlockSize)
+		{
+			Lib3MF_uint32 nCount = std::min(nBlockSize, beamCount - nStart);
+			beamStore.getRadii(nStart, nCount, Radii.data());
+			beamStore.getCapModes(nStart, nCount, CapModes.data());
+			for (Lib3MF_uint32 i = 0; i < nCount; i++)
+			{
+				for (int j = 0; j < 2; j++) {
+					beam->m_CapModes[j] = (eLib3MFBeamLatticeCapMode)CapModes[i * 2 + j];
+					beam->m_Indices[j] = pNodeIndices[(nStart + i) * 2 + j];
+					beam->m_Radii[j] = Radii[i * 2 + j];
+				}
+				beam++;
+			}
 		}
 	}
 }
@@ -484,3 +532,117 @@ IBeamSet * CBeamLattice::GetBeamSet (const Lib3MF_uint32 nIndex)
 	return new CBeamSet(m_mesh.getBeamSet(nIndex), m_pMeshObject);
 }
 
+
+void CBeamLattice::GetBeamsInBox(const sLib3MFBox Box, Lib3MF_uint64 nBeamIndicesBufferSize, Lib3MF_uint64 * pBeamIndicesNeededCount, Lib3MF_uint32 * pBeamIndicesBuffer)
+{
+	NMR::NOUTBOX3 oBox;
+	for (int j = 0; j < 3; j++) {
+		if (Box.m_MinCoordinate[j] > Box.m_MaxCoordinate[j])
+			throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+		oBox.m_min.m_fields[j] = Box.m_MinCoordinate[j];
+		oBox.m_max.m_fields[j] = Box.m_MaxCoordinate[j];
+	}
+
+	std::vector<NMR::nfUint32> Indices;
+	m_mesh.getBeamBVH()->findInBox(oBox, Indices);
+
+	if (pBeamIndicesNeededCount)
+		*pBeamIndicesNeededCount = Indices.size();
+
+	if (nBeamIndicesBufferSize >= Indices.size() && pBeamIndicesBuffer)
+		std::copy(Indices.begin(), Indices.end(), pBeamIndicesBuffer);
+}
+
+bool CBeamLattice::FindClosestBeam(const sLib3MFPosition Point, Lib3MF_uint32 & nBeamIndex, sLib3MFPosition & sClosestPoint, Lib3MF_double & dDistance)
+{
+	NMR::NVEC3 vPoint = NMR::fnVEC3_make(Point.m_Coordinates[0], Point.m_Coordinates[1], Point.m_Coordinates[2]);
+	NMR::NVEC3 vClosestPoint;
+	if (!m_mesh.getBeamBVH()->findClosest(vPoint, nBeamIndex, vClosestPoint, dDistance))
+		return false;
+
+	for (int j = 0; j < 3; j++)
+		sClosestPoint.m_Coordinates[j] = vClosestPoint.m_fields[j];
+	return true;
+}
+
+bool CBeamLattice::RayCastBeams(const sLib3MFPosition Origin, const sLib3MFPosition Direction, const Lib3MF_double dMaxDistance, Lib3MF_uint32 & nBeamIndex, Lib3MF_double & dDistance)
+{
+	NMR::NVEC3 vOrigin = NMR::fnVEC3_make(Origin.m_Coordinates[0], Origin.m_Coordinates[1], Origin.m_Coordinates[2]);
+	NMR::NVEC3 vDirection = NMR::fnVEC3_make(Direction.m_Coordinates[0], Direction.m_Coordinates[1], Direction.m_Coordinates[2]);
+	if ((vDirection.m_fields[0] == 0.0f) && (vDirection.m_fields[1] == 0.0f) && (vDirection.m_fields[2] == 0.0f))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	return m_mesh.getBeamBVH()->rayCast(vOrigin, vDirection, dMaxDistance, nBeamIndex, dDistance);
+}
+
+void CBeamLattice::GetBeamsInsideClippingMesh(Lib3MF_uint64 nBeamIndicesBufferSize, Lib3MF_uint64 * pBeamIndicesNeededCount, Lib3MF_uint32 * pBeamIndicesBuffer)
+{
+	if (!m_pAttributes->m_bHasClippingMeshID || !m_pAttributes->m_pClippingMeshUniqueID)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	NMR::CModel* pModel = m_pMeshObject->getModel();
+	NMR::CModelMeshObject * pClippingObject = dynamic_cast<NMR::CModelMeshObject*>(pModel->findObject(m_pAttributes->m_pClippingMeshUniqueID->getUniqueID()));
+	if (pClippingObject == nullptr)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	NMR::CMesh * pClippingMesh = pClippingObject->getMesh();
+	const NMR::CMeshBVH * pClippingBVH = pClippingMesh->getFaceBVH();
+
+	// A node is inside if the majority of three rays leaving it cross the surface an odd number of times.
+	// The directions are skewed to avoid running exactly along edges of axis aligned meshes.
+	const NMR::NVEC3 Directions[3] = {
+		NMR::fnVEC3_make(1.0f, 0.0123f, 0.0321f),
+		NMR::fnVEC3_make(-0.0231f, 1.0f, 0.0132f),
+		NMR::fnVEC3_make(0.0312f, -0.0213f, 1.0f) };
+
+	NMR::nfUint32 nNodeCount = m_mesh.getNodeCount();
+	NMR::nfUint32 nBeamCount = m_mesh.getBeamCount();
+	const NMR::nfInt32 * pNodeIndices = m_mesh.getBeamStore().getNodeIndices();
+	NMR::nfUint32 nThreadCount = NMR::fnGetHardwareThreadCount();
+	const NMR::nfUint32 nChunkSize = 4096;
+
+	std::vector<NMR::nfByte> NodeInside(nNodeCount, 0);
+	NMR::fnParallelFor(nThreadCount, (nNodeCount + nChunkSize - 1) / nChunkSize, [&](NMR::nfUint64 nChunk) {
+		NMR::nfUint32 nEnd = std::min((NMR::nfUint32)(nChunk + 1) * nChunkSize, nNodeCount);
+		for (NMR::nfUint32 nNode = (NMR::nfUint32)nChunk * nChunkSize; nNode < nEnd; nNode++) {
+			if (!m_mesh.isNodeOccupied(nNode))
+				continue;
+			const NMR::NVEC3 & vPosition = m_mesh.getNode(nNode)->m_position;
+			int nOddCount = 0;
+			for (int j = 0; j < 3; j++)
+				nOddCount += (pClippingBVH->countRayHits(vPosition, Directions[j]) % 2);
+			NodeInside[nNode] = (nOddCount >= 2);
+		}
+	});
+
+	// A beam is inside if both nodes are and its axis does not cross the surface
+	std::vector<NMR::nfByte> BeamInside(nBeamCount, 0);
+	NMR::fnParallelFor(nThreadCount, (nBeamCount + nChunkSize - 1) / nChunkSize, [&](NMR::nfUint64 nChunk) {
+		NMR::nfUint32 nEnd = std::min((NMR::nfUint32)(nChunk + 1) * nChunkSize, nBeamCount);
+		for (NMR::nfUint32 nBeam = (NMR::nfUint32)nChunk * nChunkSize; nBeam < nEnd; nBeam++) {
+			NMR::nfInt32 nNode1 = pNodeIndices[(size_t)nBeam * 2];
+			NMR::nfInt32 nNode2 = pNodeIndices[(size_t)nBeam * 2 + 1];
+			if (!NodeInside[nNode1] || !NodeInside[nNode2])
+				continue;
+			const NMR::NVEC3 & vPosition1 = m_mesh.getNode(nNode1)->m_position;
+			NMR::NVEC3 vAxis = NMR::fnVEC3_sub(m_mesh.getNode(nNode2)->m_position, vPosition1);
+			NMR::nfUint32 nTriangleIndex;
+			NMR::nfDouble dDistance;
+			BeamInside[nBeam] = !pClippingBVH->rayCast(vPosition1, vAxis, 1.0, nTriangleIndex, dDistance);
+		}
+	});
+
+	Lib3MF_uint64 nInsideCount = std::count(BeamInside.begin(), BeamInside.end(), 1);
+	if (pBeamIndicesNeededCount)
+		*pBeamIndicesNeededCount = nInsideCount;
+
+	if (nBeamIndicesBufferSize >= nInsideCount && pBeamIndicesBuffer) {
+		Lib3MF_uint32 * pIndex = pBeamIndicesBuffer;
+		for (NMR::nfUint32 nBeam = 0; nBeam < nBeamCount; nBeam++) {
+			if (BeamInside[nBeam]) {
+				*pIndex = nBeam;
+				pIndex++;
+			}
+		}
+	}
+}
@@ -32,6 +32,8 @@ Abstract: This is a stub class definition of CColorGroup
 #include "lib3mf_interfaceexception.hpp"
 
 // Include custom headers here.
+#include "Model/Classes/NMR_ModelConstants.h"
+#include <vector>
 
 
 using namespace Lib3MF::Impl;
@@ -109,6 +111,68 @@ sLib3MFColor CColorGroup::GetColor (const Lib3MF_uint32 nPropertyID)
 	return c;
 }
 
+Lib3MF_uint32 CColorGroup::AddColors(const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer)
+{
+	if (nColorsBufferSize > XML_3MF_MAXRESOURCEINDEX)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	if ((nColorsBufferSize > 0) && (pColorsBuffer == nullptr))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	std::vector<NMR::nfColor> Colors((size_t)nColorsBufferSize);
+	for (size_t nIndex = 0; nIndex < Colors.size(); nIndex++) {
+		const sLib3MFColor & TheColor = pColorsBuffer[nIndex];
+		Colors[nIndex] = TheColor.m_Red | (TheColor.m_Green << 8) | (TheColor.m_Blue << 16) | (TheColor.m_Alpha << 24);
+	}
+
+	return colorGroup().addColors(Colors.data(), (NMR::nfUint32)Colors.size());
+}
+
+void CColorGroup::GetColors(Lib3MF_uint64 nColorsBufferSize, Lib3MF_uint64* pColorsNeededCount, sLib3MFColor * pColorsBuffer)
+{
+	Lib3MF_uint32 nCount = colorGroup().getCount();
+
+	if (pColorsNeededCount)
+		*pColorsNeededCount = nCount;
+
+	if (nColorsBufferSize >= nCount && pColorsBuffer) {
+		std::vector<NMR::nfColor> Colors(nCount);
+		if (nCount > 0)
+			colorGroup().getColors(Colors.data());
+
+		for (Lib3MF_uint32 i = 0; i < nCount; i++) {
+			NMR::nfColor cColor = Colors[i];
+			pColorsBuffer->m_Red = (cColor) & 0xff;
+			pColorsBuffer->m_Green = (cColor >> 8) & 0xff;
+			pColorsBuffer->m_Blue = (cColor >> 16) & 0xff;
+			pColorsBuffer->m_Alpha = (cColor >> 24) & 0xff;
+			pColorsBuffer++;
+		}
+	}
+}
+
+void CColorGroup::AddColorsDeduplicated(const Lib3MF_uint64 nColorsBufferSize, const sLib3MFColor * pColorsBuffer, Lib3MF_uint64 nPropertyIDsBufferSize, Lib3MF_uint64* pPropertyIDsNeededCount, Lib3MF_uint32 * pPropertyIDsBuffer)
+{
+	if (nColorsBufferSize > XML_3MF_MAXRESOURCEINDEX)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	if ((nColorsBufferSize > 0) && (pColorsBuffer == nullptr))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	if (pPropertyIDsNeededCount)
+		*pPropertyIDsNeededCount = nColorsBufferSize;
+
+	// the bindings first query the size of PropertyIDs, nothing may be added then
+	if ((nPropertyIDsBufferSize < nColorsBufferSize) || (pPropertyIDsBuffer == nullptr))
+		return;
+
+	std::vector<NMR::nfColor> Colors((size_t)nColorsBufferSize);
+	for (size_t nIndex = 0; nIndex < Colors.size(); nIndex++) {
+		const sLib3MFColor & TheColor = pColorsBuffer[nIndex];
+		Colors[nIndex] = TheColor.m_Red | (TheColor.m_Green << 8) | (TheColor.m_Blue << 16) | (TheColor.m_Alpha << 24);
+	}
+
+	colorGroup().addColorsDeduplicated(Colors.data(), (NMR::nfUint32)Colors.size(), pPropertyIDsBuffer);
+}
+
 void CColorGroup::RemoveColor(const Lib3MF_uint32 nPropertyID)
 {
 	colorGroup().removeColor(nPropertyID);
@@ -34,7 +34,12 @@ Abstract: This is a stub class definition of CMeshObject
 // Include custom headers here.
 
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
+#include "Model/Classes/NMR_ModelPropertyResolver.h"
+#include "Common/Mesh/NMR_MeshLayoutOptimizer.h"
+#include "Common/Math/NMR_Vector.h"
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 using namespace Lib3MF::Impl;
 
@@ -108,6 +113,7 @@ void CMeshObject::SetVertex (const Lib3MF_uint32 nIndex, const sLib3MFPosition C
 	node->m_position.m_fields[0] = Coordinates.m_Coordinates[0];
 	node->m_position.m_fields[1] = Coordinates.m_Coordinates[1];
 	node->m_position.m_fields[2] = Coordinates.m_Coordinates[2];
+	mesh()->invalidateSpatialIndex();
 }
 
 sLib3MFPosition CMeshObject::GetVertex(const Lib3MF_uint32 nIndex)
@@ -162,6 +168,7 @@ void CMeshObject::SetTriangle (const Lib3MF_uint32 nIndex, const sLib3MFTriangle
 	mf->m_nodeindices[0] = Indices.m_Indices[0];
 	mf->m_nodeindices[1] = Indices.m_Indices[1];
 	mf->m_nodeindices[2] = Indices.m_Indices[2];
+	mesh()->invalidateSpatialIndex();
 }
 
 Lib3MF_uint32 CMeshObject::AddTriangle(const sLib3MFTriangle Indices)
@@ -315,6 +322,40 @@ void CMeshObject::GetAllTriangleProperties(Lib3MF_uint64 nPropertiesArrayBufferS
 	}
 }
 
+void CMeshObject::GetAllTriangleColors(Lib3MF_uint64 nRGBAValuesBufferSize, Lib3MF_uint64* pRGBAValuesNeededCount, Lib3MF_single * pRGBAValuesBuffer, Lib3MF_uint64 nResourceIDsBufferSize, Lib3MF_uint64* pResourceIDsNeededCount, Lib3MF_uint32 * pResourceIDsBuffer)
+{
+	auto pMesh = mesh();
+	uint32_t nFaceCount = pMesh->getFaceCount();
+
+	if (pRGBAValuesNeededCount)
+		*pRGBAValuesNeededCount = (Lib3MF_uint64)nFaceCount * 12;
+	if (pResourceIDsNeededCount)
+		*pResourceIDsNeededCount = nFaceCount;
+
+	if ((nRGBAValuesBufferSize >= (Lib3MF_uint64)nFaceCount * 12) && pRGBAValuesBuffer && (nResourceIDsBufferSize >= nFaceCount) && pResourceIDsBuffer)
+	{
+		NMR::CModelPropertyResolver Resolver(resource()->getModel());
+		Resolver.resolveColors(getMeshInformationProperties(), nFaceCount, pRGBAValuesBuffer, pResourceIDsBuffer);
+	}
+}
+
+void CMeshObject::GetAllTriangleTex2Coords(Lib3MF_uint64 nUVValuesBufferSize, Lib3MF_uint64* pUVValuesNeededCount, Lib3MF_double * pUVValuesBuffer, Lib3MF_uint64 nResourceIDsBufferSize, Lib3MF_uint64* pResourceIDsNeededCount, Lib3MF_uint32 * pResourceIDsBuffer)
+{
+	auto pMesh = mesh();
+	uint32_t nFaceCount = pMesh->getFaceCount();
+
+	if (pUVValuesNeededCount)
+		*pUVValuesNeededCount = (Lib3MF_uint64)nFaceCount * 6;
+	if (pResourceIDsNeededCount)
+		*pResourceIDsNeededCount = nFaceCount;
+
+	if ((nUVValuesBufferSize >= (Lib3MF_uint64)nFaceCount * 6) && pUVValuesBuffer && (nResourceIDsBufferSize >= nFaceCount) && pResourceIDsBuffer)
+	{
+		NMR::CModelPropertyResolver Resolver(resource()->getModel());
+		Resolver.resolveTex2Coords(getMeshInformationProperties(), nFaceCount, pUVValuesBuffer, pResourceIDsBuffer);
+	}
+}
+
 void CMeshObject::ClearAllProperties()
 {
 	mesh()->clearMeshInformationHandler();
@@ -364,6 +405,54 @@ void CMeshObject::SetGeometry(const Lib3MF_uint64 nVerticesBufferSize, const sLi
 	}
 }
 
+void CMeshObject::OptimizeLayout(const bool bSpatialSort, const bool bReorderTriangles, const bool bRenumberVertices)
+{
+	NMR::CMeshLayoutOptimizer Optimizer(bSpatialSort, bReorderTriangles, bRenumberVertices);
+	Optimizer.optimize(mesh());
+}
+
+void CMeshObject::GetTrianglesInBox(const sLib3MFBox Box, Lib3MF_uint64 nTriangleIndicesBufferSize, Lib3MF_uint64* pTriangleIndicesNeededCount, Lib3MF_uint32 * pTriangleIndicesBuffer)
+{
+	NMR::NOUTBOX3 oBox;
+	for (int j = 0; j < 3; j++) {
+		if (Box.m_MinCoordinate[j] > Box.m_MaxCoordinate[j])
+			throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+		oBox.m_min.m_fields[j] = Box.m_MinCoordinate[j];
+		oBox.m_max.m_fields[j] = Box.m_MaxCoordinate[j];
+	}
+
+	std::vector<NMR::nfUint32> Indices;
+	mesh()->getFaceBVH()->findInBox(oBox, Indices);
+
+	if (pTriangleIndicesNeededCount)
+		*pTriangleIndicesNeededCount = Indices.size();
+
+	if (nTriangleIndicesBufferSize >= Indices.size() && pTriangleIndicesBuffer)
+		std::copy(Indices.begin(), Indices.end(), pTriangleIndicesBuffer);
+}
+
+bool CMeshObject::FindClosestTriangle(const sLib3MFPosition Point, Lib3MF_uint32 & nTriangleIndex, sLib3MFPosition & sClosestPoint, Lib3MF_double & dDistance)
+{
+	NMR::NVEC3 vPoint = NMR::fnVEC3_make(Point.m_Coordinates[0], Point.m_Coordinates[1], Point.m_Coordinates[2]);
+	NMR::NVEC3 vClosestPoint;
+	if (!mesh()->getFaceBVH()->findClosest(vPoint, nTriangleIndex, vClosestPoint, dDistance))
+		return false;
+
+	for (int j = 0; j < 3; j++)
+		sClosestPoint.m_Coordinates[j] = vClosestPoint.m_fields[j];
+	return true;
+}
+
+bool CMeshObject::RayCastTriangles(const sLib3MFPosition Origin, const sLib3MFPosition Direction, const Lib3MF_double dMaxDistance, Lib3MF_uint32 & nTriangleIndex, Lib3MF_double & dDistance)
+{
+	NMR::NVEC3 vOrigin = NMR::fnVEC3_make(Origin.m_Coordinates[0], Origin.m_Coordinates[1], Origin.m_Coordinates[2]);
+	NMR::NVEC3 vDirection = NMR::fnVEC3_make(Direction.m_Coordinates[0], Direction.m_Coordinates[1], Direction.m_Coordinates[2]);
+	if ((vDirection.m_fields[0] == 0.0f) && (vDirection.m_fields[1] == 0.0f) && (vDirection.m_fields[2] == 0.0f))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	return mesh()->getFaceBVH()->rayCast(vOrigin, vDirection, dMaxDistance, nTriangleIndex, dDistance);
+}
+
 bool CMeshObject::IsManifoldAndOriented ()
 {
 	return meshObject()->isManifoldAndOriented();
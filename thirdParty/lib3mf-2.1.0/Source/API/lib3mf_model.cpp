@@ -64,6 +64,9 @@ Abstract: This is a stub class definition of CModel
 
 // Include custom headers here.
 #include "Model/Classes/NMR_ModelMeshObject.h"
+#include "Common/Mesh/NMR_MeshSlicer.h"
+#include "Common/Mesh/NMR_MeshMerger.h"
+#include "Common/NMR_ParallelFor.h"
 #include "Model/Classes/NMR_ModelComponentsObject.h"
 #include "Common/Platform/NMR_ImportStream_Unique_Memory.h"
 #include "Model/Classes/NMR_ModelColorGroup.h"
@@ -72,6 +75,9 @@ Abstract: This is a stub class definition of CModel
 #include "Common/NMR_SecureContentTypes.h"
 #include "lib3mf_utils.hpp"
 
+#include <cmath>
+#include <limits>
+
 using namespace Lib3MF::Impl;
 
 /*************************************************************************************************************************
@@ -423,10 +429,6 @@ ISliceStackIterator * CModel::GetSliceStacks()
 
 IModel * CModel::MergeToModel ()
 {
-	// Create merged mesh
-	NMR::PMesh pMesh = std::make_shared<NMR::CMesh>();
-	model().mergeToMesh(pMesh.get());
-
 	auto pOutModel = std::unique_ptr<CModel>(new CModel());
 
 	// Copy relevant resources to new model
@@ -443,7 +445,13 @@ IModel * CModel::MergeToModel ()
 	newModel.mergeMultiPropertyGroups(&model(), oldToNewUniqueResourceIDs);
 	newModel.mergeMetaData(&model());
 
-	pMesh->patchMeshInformationResources(oldToNewUniqueResourceIDs);
+	// Create merged mesh, with the property resources pointing into the new model
+	NMR::PMesh pMesh = std::make_shared<NMR::CMesh>();
+	NMR::CMeshMerger merger;
+	merger.setThreadCount(NMR::fnGetHardwareThreadCount());
+	merger.setResourceIDMapping(oldToNewUniqueResourceIDs);
+	model().collectMeshInstances(merger);
+	merger.merge(pMesh.get());
 
 	newModel.setUnit(model().getUnit());
 	newModel.setLanguage(model().getLanguage());
@@ -486,6 +494,79 @@ ISliceStack * CModel::AddSliceStack(const Lib3MF_double dZBottom)
 	return new CSliceStack(pNewResource);
 }
 
+// Slices the mesh at PlaneZ into a new slicestack whose slices end at SliceTops
+static NMR::PModelSliceStack fnSliceMeshObject(NMR::CModel & model, NMR::CMeshSlicer & slicer, const NMR::nfDouble dZBottom,
+	const std::vector<NMR::nfDouble> & SliceTops, const std::vector<NMR::nfDouble> & PlaneZ)
+{
+	// Validate before creating the stack, as its resource ID is registered with the model on construction
+	NMR::nfDouble dPreviousZ = dZBottom;
+	for (NMR::nfDouble dZTop : SliceTops) {
+		if (!(dZTop > dPreviousZ))
+			throw NMR::CNMRException(NMR_ERROR_SLICES_Z_NOTINCREASING);
+		dPreviousZ = dZTop;
+	}
+
+	NMR::PModelSliceStack pSliceStack = std::make_shared<NMR::CModelSliceStack>(model.generateResourceID(), &model, dZBottom);
+
+	std::vector<NMR::PSlice> Slices;
+	Slices.reserve(SliceTops.size());
+	for (NMR::nfDouble dZTop : SliceTops)
+		Slices.push_back(pSliceStack->AddSlice(dZTop));
+
+	slicer.slice(PlaneZ, Slices, NMR::fnGetHardwareThreadCount());
+	return pSliceStack;
+}
+
+ISliceStack * CModel::AddSliceStackFromMeshObject(IMeshObject* pMeshObject, const Lib3MF_double dLayerHeight)
+{
+	if (!pMeshObject)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	NMR::CModelMeshObject * pModelMeshObject = dynamic_cast<NMR::CModelMeshObject*>(model().findObject(pMeshObject->GetResourceID()));
+	if (pModelMeshObject == nullptr)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_RESOURCENOTFOUND);
+	if (!(dLayerHeight > 0.0))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	NMR::CMeshSlicer slicer(pModelMeshObject->getMesh());
+	NMR::nfDouble dZBottom = slicer.getZMin();
+	NMR::nfDouble dLayerCount = std::ceil((slicer.getZMax() - dZBottom) / dLayerHeight);
+	if (dLayerCount > (NMR::nfDouble)std::numeric_limits<NMR::nfUint32>::max())
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	// Each layer is sampled at its middle, away from nodes at multiples of the layer height
+	NMR::nfUint32 nLayerCount = (NMR::nfUint32)dLayerCount;
+	std::vector<NMR::nfDouble> SliceTops(nLayerCount);
+	std::vector<NMR::nfDouble> PlaneZ(nLayerCount);
+	for (NMR::nfUint32 nLayer = 0; nLayer < nLayerCount; nLayer++) {
+		SliceTops[nLayer] = dZBottom + (nLayer + 1) * dLayerHeight;
+		PlaneZ[nLayer] = dZBottom + (nLayer + 0.5) * dLayerHeight;
+	}
+
+	NMR::PModelSliceStack pSliceStack = fnSliceMeshObject(model(), slicer, dZBottom, SliceTops, PlaneZ);
+	model().addResource(pSliceStack);
+	return new CSliceStack(pSliceStack);
+}
+
+ISliceStack * CModel::AddSliceStackFromMeshObjectAtHeights(IMeshObject* pMeshObject, const Lib3MF_double dZBottom, const Lib3MF_uint64 nZValuesBufferSize, const Lib3MF_double * pZValuesBuffer)
+{
+	if (!pMeshObject)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	if ((nZValuesBufferSize > 0) && (!pZValuesBuffer))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	if (nZValuesBufferSize > std::numeric_limits<NMR::nfUint32>::max())
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	NMR::CModelMeshObject * pModelMeshObject = dynamic_cast<NMR::CModelMeshObject*>(model().findObject(pMeshObject->GetResourceID()));
+	if (pModelMeshObject == nullptr)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_RESOURCENOTFOUND);
+
+	std::vector<NMR::nfDouble> ZValues(pZValuesBuffer, pZValuesBuffer + nZValuesBufferSize);
+	NMR::CMeshSlicer slicer(pModelMeshObject->getMesh());
+
+	NMR::PModelSliceStack pSliceStack = fnSliceMeshObject(model(), slicer, dZBottom, ZValues, ZValues);
+	model().addResource(pSliceStack);
+	return new CSliceStack(pSliceStack);
+}
+
 
 ITexture2D * CModel::AddTexture2DFromAttachment (IAttachment* pTextureAttachment)
 {
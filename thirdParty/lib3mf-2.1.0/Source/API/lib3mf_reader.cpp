@@ -34,6 +34,7 @@ Abstract: This is a stub class definition of CReader
 #include "lib3mf_interfaceexception.hpp"
 #include "lib3mf_accessright.hpp"
 #include "lib3mf_contentencryptionparams.hpp"
+#include "lib3mf_statistics.hpp"
 #include "Common/Platform/NMR_Platform.h"
 #include "Common/Platform/NMR_ImportStream_Shared_Memory.h"
 #include "Common/Platform/NMR_ImportStream_Callback.h"
@@ -51,6 +52,7 @@ using namespace Lib3MF::Impl;
 CReader::CReader(std::string sReaderClass, NMR::PModel model)
 {
 	m_pReader = nullptr;
+	m_bInPlaceDecryption = false;
 
 	// Create specified writer instance
 	if (sReaderClass.compare("3mf") == 0) {
@@ -225,6 +227,38 @@ void Lib3MF::Impl::CReader::SetContentEncryptionCallback(const Lib3MF::ContentEn
 			throw ELib3MFInterfaceException(LIB3MF_ERROR_CALCULATIONABORTED);
 		return (NMR::nfUint64)result;
 	};
+	descriptor.m_bInPlace = m_bInPlaceDecryption;
 	reader().secureContext()->setDekCtx(descriptor);
 }
 
+void Lib3MF::Impl::CReader::SetInPlaceDecryption(const bool bInPlace) {
+	m_bInPlaceDecryption = bInPlace;
+
+	NMR::PSecureContext const & secureContext = reader().secureContext();
+	if (secureContext->hasDekCtx()) {
+		NMR::ContentEncryptionDescriptor descriptor = secureContext->getDekCtx();
+		descriptor.m_bInPlace = bInPlace;
+		secureContext->setDekCtx(descriptor);
+	}
+}
+
+void Lib3MF::Impl::CReader::SetDecryptionThreadCount(const Lib3MF_uint32 nThreadCount) {
+	reader().setDecryptionThreadCount(nThreadCount);
+}
+
+Lib3MF_uint32 Lib3MF::Impl::CReader::GetDecryptionThreadCount() {
+	return reader().getDecryptionThreadCount();
+}
+
+void Lib3MF::Impl::CReader::SetSliceThreadCount(const Lib3MF_uint32 nThreadCount) {
+	reader().setSliceThreadCount(nThreadCount);
+}
+
+Lib3MF_uint32 Lib3MF::Impl::CReader::GetSliceThreadCount() {
+	return reader().getSliceThreadCount();
+}
+
+IStatistics * Lib3MF::Impl::CReader::GetStatistics() {
+	return new CStatistics(*reader().monitor());
+}
+
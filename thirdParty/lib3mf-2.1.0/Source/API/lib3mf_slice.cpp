@@ -32,6 +32,7 @@ Abstract: This is a stub class definition of CSlice
 #include "lib3mf_interfaceexception.hpp"
 
 // Include custom headers here.
+#include <algorithm>
 
 
 using namespace Lib3MF::Impl;
@@ -49,6 +50,7 @@ CSlice::CSlice(NMR::PSlice pSlice)
 void CSlice::SetVertices (const Lib3MF_uint64 nVerticesBufferSize, const sLib3MFPosition2D * pVerticesBuffer)
 {
 	m_pSlice->Clear();
+	m_pSlice->reserveVertices(NMR::nfUint32(nVerticesBufferSize));
 	for (Lib3MF_uint64 index = 0; index < nVerticesBufferSize; index++) {
 		m_pSlice->addVertex(pVerticesBuffer->m_Coordinates[0], pVerticesBuffer->m_Coordinates[1]);
 		pVerticesBuffer++;
@@ -63,11 +65,11 @@ void CSlice::GetVertices (Lib3MF_uint64 nVerticesBufferSize, Lib3MF_uint64* pVer
 
 	if (nVerticesBufferSize >= vertexCount && pVerticesBuffer)
 	{
+		const NMR::NVEC2 * pVertices = m_pSlice->getVertices();
 		for (Lib3MF_uint32 i = 0; i < vertexCount; i++)
 		{
-			const NMR::SLICENODE* node = m_pSlice->getNode(i);
-			pVerticesBuffer[i].m_Coordinates[0] = node->m_position.m_fields[0];
-			pVerticesBuffer[i].m_Coordinates[1] = node->m_position.m_fields[1];
+			pVerticesBuffer[i].m_Coordinates[0] = pVertices[i].m_fields[0];
+			pVerticesBuffer[i].m_Coordinates[1] = pVertices[i].m_fields[1];
 		}
 	}
 }
@@ -91,10 +93,10 @@ Lib3MF_uint64 CSlice::GetPolygonCount ()
 
 void CSlice::SetPolygonIndices (const Lib3MF_uint64 nIndex, const Lib3MF_uint64 nIndicesBufferSize, const Lib3MF_uint32 * pIndicesBuffer)
 {
-	m_pSlice->clearPolygon(NMR::nfUint32(nIndex));
+	if (NMR::nfUint32(nIndicesBufferSize) != nIndicesBufferSize)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
 
-	for (Lib3MF_uint64 i=0; i< nIndicesBufferSize; i++)
-		m_pSlice->addPolygonIndex(NMR::nfUint32(nIndex), pIndicesBuffer[i]);
+	m_pSlice->setPolygonIndices(NMR::nfUint32(nIndex), NMR::nfUint32(nIndicesBufferSize), pIndicesBuffer);
 }
 
 void CSlice::GetPolygonIndices (const Lib3MF_uint64 nIndex, Lib3MF_uint64 nIndicesBufferSize, Lib3MF_uint64* pIndicesNeededCount, Lib3MF_uint32 * pIndicesBuffer)
@@ -105,10 +107,8 @@ void CSlice::GetPolygonIndices (const Lib3MF_uint64 nIndex, Lib3MF_uint64 nIndic
 
 	if (nIndicesBufferSize >= indexCount && pIndicesBuffer)
 	{
-		for (Lib3MF_uint32 i = 0; i < indexCount; i++)
-		{
-			pIndicesBuffer[i] = m_pSlice->getPolygonIndex(NMR::nfUint32(nIndex), i);
-		}
+		const NMR::nfUint32 * pIndices = m_pSlice->getPolygonIndices(NMR::nfUint32(nIndex));
+		std::copy(pIndices, pIndices + indexCount, pIndicesBuffer);
 	}
 
 }
@@ -0,0 +1,119 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium (Original Author)
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract: This is a stub class definition of CStatistics
+
+*/
+
+#include "lib3mf_statistics.hpp"
+#include "lib3mf_interfaceexception.hpp"
+
+// Include custom headers here.
+#include <iomanip>
+#include <sstream>
+
+using namespace Lib3MF::Impl;
+
+static const char * fnStatisticsCounterName(const eLib3MFStatisticsCounter eCounter, bool & bIsBytes)
+{
+	bIsBytes = false;
+	switch (eCounter) {
+	case eLib3MFStatisticsCounter::PackageBytes: bIsBytes = true; return "Package bytes";
+	case eLib3MFStatisticsCounter::XMLBytes: bIsBytes = true; return "XML bytes";
+	case eLib3MFStatisticsCounter::AttachmentBytes: bIsBytes = true; return "Attachment bytes";
+	case eLib3MFStatisticsCounter::Nodes: return "Nodes";
+	case eLib3MFStatisticsCounter::Triangles: return "Triangles";
+	case eLib3MFStatisticsCounter::Beams: return "Beams";
+	case eLib3MFStatisticsCounter::Slices: return "Slices";
+	case eLib3MFStatisticsCounter::ProgressCallbacks: return "Progress callbacks";
+	default: throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	}
+}
+
+/*************************************************************************************************************************
+ Class definition of CStatistics 
+**************************************************************************************************************************/
+
+CStatistics::CStatistics(NMR::CProgressMonitor & monitor)
+{
+	monitor.GetStatistics(m_Statistics);
+}
+
+Lib3MF_double CStatistics::GetTotalDuration()
+{
+	return m_Statistics.m_dTotalDuration;
+}
+
+Lib3MF_double CStatistics::GetPhaseDuration(const eLib3MFProgressIdentifier eIdentifier)
+{
+	int nPhase = (int)eIdentifier;
+	if ((nPhase < 0) || (nPhase >= NMR::PROGRESS_PHASECOUNT))
+		return 0.0;
+	return m_Statistics.m_dPhaseDurations[nPhase];
+}
+
+Lib3MF_uint64 CStatistics::GetCounter(const eLib3MFStatisticsCounter eCounter)
+{
+	int nCounter = (int)eCounter;
+	if ((nCounter < 0) || (nCounter >= NMR::PROGRESS_COUNTERCOUNT))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	return m_Statistics.m_nCounters[nCounter];
+}
+
+Lib3MF_double CStatistics::GetThroughput(const eLib3MFStatisticsCounter eCounter)
+{
+	Lib3MF_uint64 nValue = GetCounter(eCounter);
+	if (m_Statistics.m_dTotalDuration <= 0.0)
+		return 0.0;
+	return nValue / m_Statistics.m_dTotalDuration;
+}
+
+std::string CStatistics::GetSummary()
+{
+	std::ostringstream summary;
+	summary << std::fixed << std::setprecision(6) << "Total: " << m_Statistics.m_dTotalDuration << " s\n";
+
+	for (int nPhase = 0; nPhase < NMR::PROGRESS_PHASECOUNT; nPhase++) {
+		if (m_Statistics.m_dPhaseDurations[nPhase] <= 0.0)
+			continue;
+		std::string sPhaseName;
+		NMR::CProgressMonitor::GetProgressMessage((NMR::ProgressIdentifier)nPhase, sPhaseName);
+		summary << sPhaseName << ": " << std::setprecision(6) << m_Statistics.m_dPhaseDurations[nPhase] << " s\n";
+	}
+
+	for (int nCounter = 0; nCounter < NMR::PROGRESS_COUNTERCOUNT; nCounter++) {
+		bool bIsBytes;
+		eLib3MFStatisticsCounter eCounter = (eLib3MFStatisticsCounter)nCounter;
+		const char * pszName = fnStatisticsCounterName(eCounter, bIsBytes);
+		summary << pszName << ": " << m_Statistics.m_nCounters[nCounter];
+		if (bIsBytes)
+			summary << " (" << std::setprecision(2) << GetThroughput(eCounter) / (1024.0 * 1024.0) << " MB/s)\n";
+		else
+			summary << " (" << std::setprecision(0) << GetThroughput(eCounter) << " /s)\n";
+	}
+
+	return summary.str();
+}
@@ -33,6 +33,8 @@ Abstract: This is a stub class definition of CTexture2DGroup
 
 // Include custom headers here.
 #include "lib3mf_texture2d.hpp"
+#include "Model/Classes/NMR_ModelConstants.h"
+#include <vector>
 
 using namespace Lib3MF::Impl;
 
@@ -99,6 +101,42 @@ sLib3MFTex2Coord CTexture2DGroup::GetTex2Coord (const Lib3MF_uint32 nPropertyID)
 	return sLib3MFTex2Coord({ coord.m_dU, coord.m_dV});
 }
 
+Lib3MF_uint32 CTexture2DGroup::AddTex2Coords(const Lib3MF_uint64 nUVCoordinatesBufferSize, const sLib3MFTex2Coord * pUVCoordinatesBuffer)
+{
+	if (nUVCoordinatesBufferSize > XML_3MF_MAXRESOURCEINDEX)
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+	if ((nUVCoordinatesBufferSize > 0) && (pUVCoordinatesBuffer == nullptr))
+		throw ELib3MFInterfaceException(LIB3MF_ERROR_INVALIDPARAM);
+
+	std::vector<NMR::MODELTEXTURE2DCOORDINATE> UVCoordinates((size_t)nUVCoordinatesBufferSize);
+	for (size_t nIndex = 0; nIndex < UVCoordinates.size(); nIndex++) {
+		UVCoordinates[nIndex].m_dU = pUVCoordinatesBuffer[nIndex].m_U;
+		UVCoordinates[nIndex].m_dV = pUVCoordinatesBuffer[nIndex].m_V;
+	}
+
+	return texture2DGroup().addUVCoordinates(UVCoordinates.data(), (NMR::nfUint32)UVCoordinates.size());
+}
+
+void CTexture2DGroup::GetTex2Coords(Lib3MF_uint64 nUVCoordinatesBufferSize, Lib3MF_uint64* pUVCoordinatesNeededCount, sLib3MFTex2Coord * pUVCoordinatesBuffer)
+{
+	Lib3MF_uint32 nCount = texture2DGroup().getCount();
+
+	if (pUVCoordinatesNeededCount)
+		*pUVCoordinatesNeededCount = nCount;
+
+	if (nUVCoordinatesBufferSize >= nCount && pUVCoordinatesBuffer) {
+		std::vector<NMR::MODELTEXTURE2DCOORDINATE> UVCoordinates(nCount);
+		if (nCount > 0)
+			texture2DGroup().getUVCoordinates(UVCoordinates.data());
+
+		for (Lib3MF_uint32 i = 0; i < nCount; i++) {
+			pUVCoordinatesBuffer->m_U = UVCoordinates[i].m_dU;
+			pUVCoordinatesBuffer->m_V = UVCoordinates[i].m_dV;
+			pUVCoordinatesBuffer++;
+		}
+	}
+}
+
 void CTexture2DGroup::RemoveTex2Coord(const Lib3MF_uint32 nPropertyID)
 {
 	texture2DGroup().removePropertyID(nPropertyID);
@@ -34,6 +34,7 @@ Abstract: This is a stub class definition of CWriter
 #include "lib3mf_interfaceexception.hpp"
 #include "lib3mf_accessright.hpp"
 #include "lib3mf_contentencryptionparams.hpp"
+#include "lib3mf_statistics.hpp"
 #include "Common/Platform/NMR_Platform.h"
 #include "Common/Platform/NMR_ExportStream_Callback.h"
 #include "Common/Platform/NMR_ExportStream_Memory.h"
@@ -192,6 +193,26 @@ void CWriter::SetDecimalPrecision(const Lib3MF_uint32 nDecimalPrecision)
 	m_pWriter->SetDecimalPrecision(nDecimalPrecision);
 }
 
+bool CWriter::GetOptimizeMeshLayout()
+{
+	return m_pWriter->GetOptimizeMeshLayout();
+}
+
+void CWriter::SetOptimizeMeshLayout(const bool bOptimizeMeshLayout)
+{
+	m_pWriter->SetOptimizeMeshLayout(bOptimizeMeshLayout);
+}
+
+void CWriter::SetCompressionThreadCount(const Lib3MF_uint32 nThreadCount)
+{
+	m_pWriter->SetCompressionThreadCount(nThreadCount);
+}
+
+Lib3MF_uint32 CWriter::GetCompressionThreadCount()
+{
+	return m_pWriter->GetCompressionThreadCount();
+}
+
 void Lib3MF::Impl::CWriter::AddKeyWrappingCallback(const std::string & sConsumerID, const Lib3MF::KeyWrappingCallback pTheCallback, const Lib3MF_pvoid pUserData){
 	NMR::KeyWrappingDescriptor descriptor;
 	descriptor.m_sKekDecryptData.m_pUserData = pUserData;
@@ -266,4 +287,7 @@ std::string CWriter::GetWarning(const Lib3MF_uint32 nIndex, Lib3MF_uint32 & nErr
 
 Lib3MF_uint32 CWriter::GetWarningCount() {
 	return writer().warnings()->getWarningCount();
-}
\ No newline at end of file
+}
+IStatistics * CWriter::GetStatistics() {
+	return new CStatistics(*writer().monitor());
+}
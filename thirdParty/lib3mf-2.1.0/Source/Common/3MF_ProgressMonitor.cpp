@@ -43,6 +43,45 @@ NMR::CProgressMonitor::CProgressMonitor()
 	m_dProgress = 0;
 	m_dProgressMax = 1;
 	m_eProgressIdentifier = ProgressIdentifier::PROGRESS_QUERYCANCELED;
+	m_nReportedPhases = 0;
+	m_bReportPending = false;
+	m_bCancelPending = false;
+	m_bTiming = false;
+	for (int nPhase = 0; nPhase < PROGRESS_PHASECOUNT; nPhase++)
+		m_dPhaseDurations[nPhase] = 0.0;
+	for (int nCounter = 0; nCounter < PROGRESS_COUNTERCOUNT; nCounter++)
+		m_nCounters[nCounter] = 0;
+}
+
+bool NMR::CProgressMonitor::reportIsDue(ProgressIdentifier identifier)
+{
+	// The first report of every phase and the final report are always passed on
+	nfUint32 nPhaseBit = 1u << identifier;
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if ((identifier != ProgressIdentifier::PROGRESS_DONE) && ((m_nReportedPhases & nPhaseBit) == nPhaseBit) &&
+		(now - m_LastCallbackTime < std::chrono::milliseconds(PROGRESS_CALLBACKINTERVAL))) {
+		m_bReportPending = true;
+		return false;
+	}
+
+	m_nReportedPhases |= nPhaseBit;
+	m_LastCallbackTime = now;
+	m_bReportPending = false;
+	return true;
+}
+
+bool NMR::CProgressMonitor::callProgressCallback(ProgressIdentifier identifier, bool throwIfCancelled)
+{
+	int nProgress = (int)(100 * m_dProgress / m_dProgressMax);
+	m_lastCallbackResult = m_progressCallback(nProgress, identifier, m_userData);
+	m_nCounters[PROGRESSCOUNTER_CALLBACKS]++;
+
+	// A cancellation that could not be thrown is thrown by the next query
+	m_bCancelPending = m_bCancelPending || m_lastCallbackResult;
+	if (throwIfCancelled && m_bCancelPending)
+		throw CNMRException(NMR_USERABORTED);
+
+	return m_lastCallbackResult;
 }
 
 bool NMR::CProgressMonitor::QueryCancelled(bool throwIfCancelled)
@@ -51,15 +90,7 @@ bool NMR::CProgressMonitor::QueryCancelled(bool throwIfCancelled)
 	{
 		std::unique_lock<std::mutex> lock(m_callbackMutex, std::try_to_lock);
 		if (lock) // If another progress callback is happening right _now_, just drop this one
-		{
-			int nProgress = (int)(100 * m_dProgress / m_dProgressMax);
-			m_lastCallbackResult = m_progressCallback(nProgress, ProgressIdentifier::PROGRESS_QUERYCANCELED, m_userData);
-
-			if (throwIfCancelled && m_lastCallbackResult)
-				throw CNMRException(NMR_USERABORTED);
-
-			return m_lastCallbackResult;
-		}
+			return callProgressCallback(ProgressIdentifier::PROGRESS_QUERYCANCELED, throwIfCancelled);
 	}
 	return false;
 }
@@ -69,15 +100,13 @@ bool NMR::CProgressMonitor::ReportProgressAndQueryCancelled(bool throwIfCancelle
 	if (m_progressCallback)
 	{
 		std::unique_lock<std::mutex> lock(m_callbackMutex, std::try_to_lock);
+		ProgressIdentifier eProgressIdentifier = m_eProgressIdentifier;
 		if (lock) // If another progress callback is happening right _now_, just drop this one
 		{
-			int nProgress = (int)(100 * m_dProgress / m_dProgressMax);
-			m_lastCallbackResult = m_progressCallback(nProgress, m_eProgressIdentifier, m_userData);
-
-			if (throwIfCancelled && m_lastCallbackResult)
+			if (reportIsDue(eProgressIdentifier))
+				return callProgressCallback(eProgressIdentifier, throwIfCancelled);
+			if (throwIfCancelled && m_bCancelPending)
 				throw CNMRException(NMR_USERABORTED);
-
-			return m_lastCallbackResult;
 		}
 	}
 	return false;
@@ -90,7 +119,66 @@ bool NMR::CProgressMonitor::WasAborted()
 
 void NMR::CProgressMonitor::SetProgressIdentifier(ProgressIdentifier identifier)
 {
+	if (identifier == m_eProgressIdentifier)
+		return;
+
+	// Pass on the last report of the finished phase, if it was dropped
+	if (m_progressCallback)
+	{
+		std::unique_lock<std::mutex> lock(m_callbackMutex, std::try_to_lock);
+		if (lock && m_bReportPending) {
+			m_bReportPending = false;
+			callProgressCallback(m_eProgressIdentifier, false);
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_statisticsMutex);
+
+	if (m_bTiming) {
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if ((m_eProgressIdentifier >= 0) && (m_eProgressIdentifier < PROGRESS_PHASECOUNT))
+			m_dPhaseDurations[m_eProgressIdentifier] += std::chrono::duration<double>(now - m_PhaseStartTime).count();
+		m_PhaseStartTime = now;
+		m_bTiming = (identifier != ProgressIdentifier::PROGRESS_DONE);
+	}
+	m_eProgressIdentifier = identifier;
+}
+
+void NMR::CProgressMonitor::StartStatistics(ProgressIdentifier identifier)
+{
+	std::lock_guard<std::mutex> lock(m_statisticsMutex);
+	for (int nPhase = 0; nPhase < PROGRESS_PHASECOUNT; nPhase++)
+		m_dPhaseDurations[nPhase] = 0.0;
+	for (int nCounter = 0; nCounter < PROGRESS_COUNTERCOUNT; nCounter++)
+		m_nCounters[nCounter] = 0;
+
 	m_eProgressIdentifier = identifier;
+	m_nReportedPhases = 0;
+	m_bReportPending = false;
+	m_bCancelPending = false;
+	m_PhaseStartTime = std::chrono::steady_clock::now();
+	m_bTiming = (identifier != ProgressIdentifier::PROGRESS_DONE);
+}
+
+void NMR::CProgressMonitor::AddToCounter(ProgressCounter counter, nfUint64 nValue)
+{
+	if ((counter < 0) || (counter >= PROGRESS_COUNTERCOUNT))
+		throw CNMRException(NMR_ERROR_INVALIDPARAM);
+	m_nCounters[counter] += nValue;
+}
+
+void NMR::CProgressMonitor::GetStatistics(PROGRESSSTATISTICS & statistics)
+{
+	std::lock_guard<std::mutex> lock(m_statisticsMutex);
+	statistics.m_dTotalDuration = 0.0;
+	for (int nPhase = 0; nPhase < PROGRESS_PHASECOUNT; nPhase++) {
+		statistics.m_dPhaseDurations[nPhase] = m_dPhaseDurations[nPhase];
+		if (m_bTiming && (nPhase == m_eProgressIdentifier))
+			statistics.m_dPhaseDurations[nPhase] += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_PhaseStartTime).count();
+		statistics.m_dTotalDuration += statistics.m_dPhaseDurations[nPhase];
+	}
+	for (int nCounter = 0; nCounter < PROGRESS_COUNTERCOUNT; nCounter++)
+		statistics.m_nCounters[nCounter] = m_nCounters[nCounter];
 }
 
 void NMR::CProgressMonitor::SetMaxProgress(double dProgressMax)
@@ -120,6 +208,10 @@ void NMR::CProgressMonitor::SetProgressCallback(Lib3MFProgressCallback callback,
 	m_progressCallback = callback;
 	m_userData = userData;
 	m_lastCallbackResult = true;
+	m_nReportedPhases = 0;
+	m_bReportPending = false;
+	m_bCancelPending = false;
+	m_LastCallbackTime = std::chrono::steady_clock::time_point();
 }
 
 void NMR::CProgressMonitor::ClearProgressCallback()
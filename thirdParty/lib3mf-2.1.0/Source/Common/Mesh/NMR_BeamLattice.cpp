@@ -37,12 +37,14 @@ namespace NMR {
 	CBeamLattice::CBeamLattice(_In_ MESHNODES &nodes) : m_Nodes(nodes)
 	{ 
 		m_dMinLength = 0.0001;
+		m_dDefaultRadius = 1.0;
+		m_eCapMode = eModelBeamLatticeCapMode::MODELBEAMLATTICECAPMODE_SPHERE;
 		m_eBallMode = eModelBeamLatticeBallMode::MODELBEAMLATTICEBALLMODE_NONE;
 		m_dDefaultBallRadius = 0.0;
 	}
 
 	void CBeamLattice::clearBeams() {
-		m_Beams.clearAllData();
+		m_Beams.clear();
 		m_pBeamSets.clear();
 		m_OccupiedNodes.clear();
 	}
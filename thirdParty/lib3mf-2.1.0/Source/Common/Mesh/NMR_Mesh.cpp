@@ -40,10 +40,13 @@ structure.
 --*/
 
 #include "Common/Mesh/NMR_Mesh.h"
+#include "Common/Mesh/NMR_MeshMerger.h"
 #include "Common/Math/NMR_Matrix.h" 
 #include "Common/NMR_Exception.h" 
+#include "Common/NMR_ParallelFor.h"
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
 #include <cmath>
+#include <algorithm>
 
 namespace NMR {
 
@@ -70,81 +73,9 @@ namespace NMR {
 		if (!pMesh)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
-		nfInt32 nIdx, nNodeCount, nFaceCount, nBeamCount, nBallCount, j;
-		MESHNODE * pNode;
-		MESHFACE * pFace;
-		MESHBEAM * pBeam;
-		MESHBALL * pBall;
-		MESHNODE * pFaceNodes[3];
-		MESHNODE * pBeamNodes[2];
-		MESHNODE * pBallNode;
-
-		// Copy Mesh Information
-		CMeshInformationHandler * pOtherMeshInformationHandler = pMesh->getMeshInformationHandler();
-		if (pOtherMeshInformationHandler) {
-			createMeshInformationHandler();
-			m_pMeshInformationHandler->addInfoTableFrom(pOtherMeshInformationHandler, getFaceCount ());
-		}
-
-		nNodeCount = pMesh->getNodeCount();
-		nFaceCount = pMesh->getFaceCount();
-		nBeamCount = pMesh->getBeamCount();
-		nBallCount = pMesh->getBallCount();
-
-		if (nNodeCount > 0) {
-			std::vector<MESHNODE *> aNewNodes;
-			aNewNodes.resize(nNodeCount);
-
-			for (nIdx = 0; nIdx < nNodeCount; nIdx++) {
-				pNode = pMesh->getNode(nIdx);
-				NVEC3 vPosition = fnMATRIX3_apply(mMatrix, pNode->m_position);
-				aNewNodes[nIdx] = addNode(vPosition);
-			}
-
-			if (nFaceCount > 0) {
-				if (m_pMeshInformationHandler && pOtherMeshInformationHandler) {
-					m_pMeshInformationHandler->cloneDefaultInfosFrom(pOtherMeshInformationHandler);
-				}
-
-				for (nIdx = 0; nIdx < nFaceCount; nIdx++) {
-					pFace = pMesh->getFace(nIdx);
-					for (j = 0; j < 3; j++) {
-						if ((pFace->m_nodeindices[j] < 0) || (pFace->m_nodeindices[j] >= nNodeCount))
-							throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
-
-						pFaceNodes[j] = aNewNodes[pFace->m_nodeindices[j]];
-					}
-
-					MESHFACE * pNewFace = addFace(pFaceNodes[0], pFaceNodes[1], pFaceNodes[2]);
-					if (m_pMeshInformationHandler && pOtherMeshInformationHandler) {
-						m_pMeshInformationHandler->cloneFaceInfosFrom(pNewFace->m_index, pOtherMeshInformationHandler, pFace->m_index);
-					}
-				}
-			}
-			if (nBeamCount > 0) {
-				for (nIdx = 0; nIdx < nBeamCount; nIdx++) {
-					pBeam = pMesh->getBeam(nIdx);
-					for (j = 0; j < 2; j++) {
-						if ((pBeam->m_nodeindices[j] < 0) || (pBeam->m_nodeindices[j] >= nNodeCount))
-							throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
-
-						pBeamNodes[j] = aNewNodes[pBeam->m_nodeindices[j]];
-					}
-					addBeam(pBeamNodes[0], pBeamNodes[1], pBeam->m_radius[0], pBeam->m_radius[1], pBeam->m_capMode[0], pBeam->m_capMode[1]);
-				}
-			}
-			if (nBallCount > 0) {
-				for (nIdx = 0; nIdx < nBallCount; nIdx++) {
-					pBall = pMesh->getBall(nIdx);
-					if ((pBall->m_nodeindex < 0) || (pBall->m_nodeindex >= nNodeCount))
-						throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
-
-					pBallNode = aNewNodes[pBall->m_nodeindex];
-					addBall(pBallNode, pBall->m_radius);
-				}
-			}
-
-		}
+		CMeshMerger merger;
+		merger.addInstance(pMesh, mMatrix);
+		merger.merge(this);
 	}
 
 	void CMesh::addToMesh(_In_opt_ CMesh * pMesh)
@@ -214,6 +145,28 @@ namespace NMR {
 		return pNode;
 	}
 
+	nfUint32 CMesh::allocNodes(_In_ nfUint32 nCount)
+	{
+		if ((nfUint64)getNodeCount() + nCount > NMR_MESH_MAXNODECOUNT)
+			throw CNMRException(NMR_ERROR_TOOMANYNODES);
+
+		return m_Nodes.allocDataRange(nCount);
+	}
+
+	nfUint32 CMesh::allocFaces(_In_ nfUint32 nCount)
+	{
+		if ((nfUint64)getFaceCount() + nCount > NMR_MESH_MAXFACECOUNT)
+			throw CNMRException(NMR_ERROR_TOOMANYFACES);
+
+		nfUint32 nFirstIndex = m_Faces.allocDataRange(nCount);
+		if (m_pMeshInformationHandler)
+			m_pMeshInformationHandler->addFaceRange(getFaceCount());
+
+		m_pFaceBVH.reset();
+
+		return nFirstIndex;
+	}
+
 	_Ret_notnull_ MESHFACE * CMesh::addFace(_In_ MESHNODE * pNode1, _In_ MESHNODE * pNode2, _In_ MESHNODE * pNode3)
 	{
 		if ((!pNode1) || (!pNode2) || (!pNode3))
@@ -239,6 +192,8 @@ namespace NMR {
 		if (m_pMeshInformationHandler)
 			m_pMeshInformationHandler->addFace(getFaceCount());
 
+		m_pFaceBVH.reset();
+
 		return pFace;
 	}
 	
@@ -264,10 +219,12 @@ namespace NMR {
 		if (m_pMeshInformationHandler)
 			m_pMeshInformationHandler->addFace(getFaceCount());
 
+		m_pFaceBVH.reset();
+
 		return pFace;
 	}
 
-	_Ret_notnull_ MESHBEAM * CMesh::addBeam(_In_ MESHNODE * pNode1, _In_ MESHNODE * pNode2,
+	nfUint32 CMesh::addBeam(_In_ MESHNODE * pNode1, _In_ MESHNODE * pNode2,
 		_In_ nfDouble dRadius1, _In_ nfDouble dRadius2,
 		_In_ nfInt32 eCapMode1, _In_ nfInt32 eCapMode2)
 	{
@@ -277,27 +234,42 @@ namespace NMR {
 		if (pNode1 == pNode2)
 			throw CNMRException(NMR_ERROR_DUPLICATENODE);
 
-		MESHBEAM * pBeam;
 		nfUint32 nBeamCount = getBeamCount();
 
 		if (nBeamCount >= NMR_MESH_MAXBEAMCOUNT)
 			throw CNMRException(NMR_ERROR_TOOMANYBEAMS);
 
-		nfUint32 nNewIndex;
+		nfUint32 nNewIndex = m_BeamLattice.m_Beams.addBeam(pNode1->m_index, pNode2->m_index, dRadius1, dRadius2, eCapMode1, eCapMode2);
 
-		pBeam = m_BeamLattice.m_Beams.allocData(nNewIndex);
-		pBeam->m_nodeindices[0] = pNode1->m_index;
-		pBeam->m_nodeindices[1] = pNode2->m_index;
-		pBeam->m_index = nNewIndex;
-		pBeam->m_radius[0] = dRadius1;
-		pBeam->m_radius[1] = dRadius2;
+		m_BeamLattice.m_OccupiedNodes.insert({ pNode1->m_index, pNode2->m_index });
+		m_pBeamBVH.reset();
 
-		pBeam->m_capMode[0] = eCapMode1;
-		pBeam->m_capMode[1] = eCapMode2;
+		return nNewIndex;
+	}
 
-		m_BeamLattice.m_OccupiedNodes.insert({ pNode1->m_index, pNode2->m_index });
+	void CMesh::addBeams(_In_ nfUint32 nCount, _In_ const nfInt32 * pNodeIndices, _In_ const nfDouble * pRadii, _In_ const nfInt32 * pCapModes)
+	{
+		if (nCount == 0)
+			return;
+		if ((!pNodeIndices) || (!pRadii) || (!pCapModes))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
-		return pBeam;
+		if ((nfUint64)getBeamCount() + nCount > NMR_MESH_MAXBEAMCOUNT)
+			throw CNMRException(NMR_ERROR_TOOMANYBEAMS);
+
+		nfInt32 nNodeCount = (nfInt32)getNodeCount();
+		for (nfUint32 nIdx = 0; nIdx < nCount; nIdx++) {
+			nfInt32 nNodeIndex1 = pNodeIndices[nIdx * 2];
+			nfInt32 nNodeIndex2 = pNodeIndices[nIdx * 2 + 1];
+			if ((nNodeIndex1 < 0) || (nNodeIndex1 >= nNodeCount) || (nNodeIndex2 < 0) || (nNodeIndex2 >= nNodeCount))
+				throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
+			if (nNodeIndex1 == nNodeIndex2)
+				throw CNMRException(NMR_ERROR_DUPLICATENODE);
+		}
+
+		m_BeamLattice.m_Beams.addBeams(nCount, pNodeIndices, pRadii, pCapModes);
+		m_BeamLattice.m_OccupiedNodes.insert(pNodeIndices, pNodeIndices + (size_t)nCount * 2);
+		m_pBeamBVH.reset();
 	}
 
 	PBEAMSET CMesh::addBeamSet()
@@ -377,9 +349,20 @@ namespace NMR {
 		return m_Faces.getData(nIdx);
 	}
 
-	_Ret_notnull_ MESHBEAM * CMesh::getBeam(_In_ nfUint32 nIdx)
+	void CMesh::getBeam(_In_ nfUint32 nIdx, _Out_ MESHBEAM & beam)
 	{
-		return m_BeamLattice.m_Beams.getData(nIdx);
+		m_BeamLattice.m_Beams.getBeam(nIdx, beam);
+	}
+
+	void CMesh::setBeam(_In_ nfUint32 nIdx, _In_ const MESHBEAM & beam)
+	{
+		m_BeamLattice.m_Beams.setBeam(nIdx, beam);
+		m_pBeamBVH.reset();
+	}
+
+	CMeshBeamStore & CMesh::getBeamStore()
+	{
+		return m_BeamLattice.m_Beams;
 	}
 
 	_Ret_notnull_ PBEAMSET CMesh::getBeamSet(_In_ nfUint32 nIdx)
@@ -411,9 +394,14 @@ namespace NMR {
 		return m_BeamLattice.m_dMinLength;
 	}
 
+	void CMesh::setDefaultBeamRadius(nfDouble dRadius)
+	{
+		m_BeamLattice.m_dDefaultRadius = dRadius;
+	}
+
 	nfDouble CMesh::getDefaultBeamRadius()
 	{
-		return 1.0;
+		return m_BeamLattice.m_dDefaultRadius;
 	}
 
 	void CMesh::setDefaultBallRadius(nfDouble dDefaultBallRadius)
@@ -442,9 +430,14 @@ namespace NMR {
 		return m_BeamLattice.m_eBallMode;
 	}
 
+	void CMesh::setBeamLatticeCapMode(eModelBeamLatticeCapMode eCapMode)
+	{
+		m_BeamLattice.m_eCapMode = eCapMode;
+	}
+
 	eModelBeamLatticeCapMode CMesh::getBeamLatticeCapMode()
 	{
-		return eModelBeamLatticeCapMode::MODELBEAMLATTICECAPMODE_SPHERE;
+		return m_BeamLattice.m_eCapMode;
 	}
 
 	nfBool CMesh::checkSanity()
@@ -487,13 +480,14 @@ namespace NMR {
 				return false;
 		}
 
+		const nfInt32 * pBeamNodeIndices = m_BeamLattice.m_Beams.getNodeIndices();
 		for (nIdx = 0; nIdx < nBeamCount; nIdx++) {
-			MESHBEAM * beam = getBeam(nIdx);
+			const nfInt32 * beamNodeIndices = &pBeamNodeIndices[nIdx * 2];
 			for (j = 0; j < 2; j++)
-				if ((beam->m_nodeindices[j] < 0) || (((nfUint32)beam->m_nodeindices[j]) >= nNodeCount))
+				if ((beamNodeIndices[j] < 0) || (((nfUint32)beamNodeIndices[j]) >= nNodeCount))
 					return false;
 
-			if (beam->m_nodeindices[0] == beam->m_nodeindices[1])
+			if (beamNodeIndices[0] == beamNodeIndices[1])
 				return false;
 		}
 
@@ -511,14 +505,17 @@ namespace NMR {
 		m_Faces.clearAllData();
 		m_Nodes.clearAllData();
 		clearBeamLattice();
+		invalidateSpatialIndex();
 	}
 	
 	void CMesh::clearBeamLattice() {
 		m_BeamLattice.clear();
+		m_pBeamBVH.reset();
 	}
 
 	void CMesh::clearBeamLatticeBeams() {
 		m_BeamLattice.clearBeams();
+		m_pBeamBVH.reset();
 	}
 
 	void CMesh::clearBeamLatticeBalls() {
@@ -528,11 +525,9 @@ namespace NMR {
 	void CMesh::scanOccupiedNodes() {
 		m_BeamLattice.m_OccupiedNodes.clear();
 
-		nfUint32 beamCount = m_BeamLattice.m_Beams.getCount();
-		for (nfUint32 iBeam = 0; iBeam < beamCount; iBeam++) {
-			MESHBEAM * meshBeam = getBeam(iBeam);
-			m_BeamLattice.m_OccupiedNodes.insert({ meshBeam->m_nodeindices[0], meshBeam->m_nodeindices[1] });
-		}
+		const nfInt32 * pNodeIndices = m_BeamLattice.m_Beams.getNodeIndices();
+		if (pNodeIndices)
+			m_BeamLattice.m_OccupiedNodes.insert(pNodeIndices, pNodeIndices + (size_t)m_BeamLattice.m_Beams.getCount() * 2);
 	}
 
 	void CMesh::validateBeamLatticeBalls() {
@@ -610,4 +605,24 @@ namespace NMR {
 			}
 		}
 	}
+
+	_Ret_notnull_ CMeshBVH * CMesh::getFaceBVH()
+	{
+		if (!m_pFaceBVH)
+			m_pFaceBVH = std::make_shared<CMeshBVH>(this, eMeshBVHPrimitive::Faces, fnGetHardwareThreadCount());
+		return m_pFaceBVH.get();
+	}
+
+	_Ret_notnull_ CMeshBVH * CMesh::getBeamBVH()
+	{
+		if (!m_pBeamBVH)
+			m_pBeamBVH = std::make_shared<CMeshBVH>(this, eMeshBVHPrimitive::Beams, fnGetHardwareThreadCount());
+		return m_pBeamBVH.get();
+	}
+
+	void CMesh::invalidateSpatialIndex()
+	{
+		m_pFaceBVH.reset();
+		m_pBeamBVH.reset();
+	}
 }
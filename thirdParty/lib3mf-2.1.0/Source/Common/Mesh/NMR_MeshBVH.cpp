@@ -0,0 +1,829 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshBVH.cpp implements a bounding volume hierarchy over the faces or the beams of a mesh.
+
+--*/
+
+#include "Common/Mesh/NMR_MeshBVH.h"
+#include "Common/Mesh/NMR_Mesh.h"
+#include "Common/Math/NMR_Vector.h"
+#include "Common/NMR_Exception.h"
+#include "Common/NMR_ParallelFor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+#define NMR_MESHBVH_CHUNKSIZE 16384
+
+namespace NMR {
+
+	typedef struct {
+		NOUTBOX3 m_Box;
+		NVEC3 m_vCentroid;
+	} MESHBVHBUILDPRIMITIVE;
+
+	typedef struct {
+		nfUint32 m_nNode;
+		nfUint32 m_nBegin;
+		nfUint32 m_nEnd;
+	} MESHBVHBUILDTASK;
+
+	// Double precision helpers, the vector functions of NMR_Vector.h are single precision
+	static NVEC3D fnVEC3D_make(_In_ nfDouble dX, _In_ nfDouble dY, _In_ nfDouble dZ)
+	{
+		NVEC3D vResult;
+		vResult.m_fields[0] = dX;
+		vResult.m_fields[1] = dY;
+		vResult.m_fields[2] = dZ;
+		return vResult;
+	}
+
+	static NVEC3D fnVEC3D_fromVEC3(_In_ const NVEC3 & vVector)
+	{
+		return fnVEC3D_make(vVector.m_fields[0], vVector.m_fields[1], vVector.m_fields[2]);
+	}
+
+	static NVEC3D fnVEC3D_sub(_In_ const NVEC3D & vMinuend, _In_ const NVEC3D & vSubtrahend)
+	{
+		return fnVEC3D_make(vMinuend.m_fields[0] - vSubtrahend.m_fields[0], vMinuend.m_fields[1] - vSubtrahend.m_fields[1], vMinuend.m_fields[2] - vSubtrahend.m_fields[2]);
+	}
+
+	static NVEC3D fnVEC3D_combine(_In_ const NVEC3D & vVector1, _In_ const NVEC3D & vVector2, _In_ nfDouble dFactor2)
+	{
+		return fnVEC3D_make(vVector1.m_fields[0] + vVector2.m_fields[0] * dFactor2, vVector1.m_fields[1] + vVector2.m_fields[1] * dFactor2, vVector1.m_fields[2] + vVector2.m_fields[2] * dFactor2);
+	}
+
+	static nfDouble fnVEC3D_dot(_In_ const NVEC3D & vVector1, _In_ const NVEC3D & vVector2)
+	{
+		return vVector1.m_fields[0] * vVector2.m_fields[0] + vVector1.m_fields[1] * vVector2.m_fields[1] + vVector1.m_fields[2] * vVector2.m_fields[2];
+	}
+
+	static NVEC3D fnVEC3D_cross(_In_ const NVEC3D & vVector1, _In_ const NVEC3D & vVector2)
+	{
+		return fnVEC3D_make(vVector1.m_fields[1] * vVector2.m_fields[2] - vVector1.m_fields[2] * vVector2.m_fields[1],
+			vVector1.m_fields[2] * vVector2.m_fields[0] - vVector1.m_fields[0] * vVector2.m_fields[2],
+			vVector1.m_fields[0] * vVector2.m_fields[1] - vVector1.m_fields[1] * vVector2.m_fields[0]);
+	}
+
+	static nfDouble fnBoxHalfArea(_In_ const NOUTBOX3 & oBox)
+	{
+		nfDouble dX = (nfDouble)oBox.m_max.m_fields[0] - oBox.m_min.m_fields[0];
+		nfDouble dY = (nfDouble)oBox.m_max.m_fields[1] - oBox.m_min.m_fields[1];
+		nfDouble dZ = (nfDouble)oBox.m_max.m_fields[2] - oBox.m_min.m_fields[2];
+		if ((dX < 0) || (dY < 0) || (dZ < 0))
+			return 0.0;
+		return dX * dY + dY * dZ + dZ * dX;
+	}
+
+	static nfBool fnBoxesOverlap(_In_ const NOUTBOX3 & oBox1, _In_ const NOUTBOX3 & oBox2)
+	{
+		for (nfUint32 j = 0; j < 3; j++) {
+			if ((oBox1.m_min.m_fields[j] > oBox2.m_max.m_fields[j]) || (oBox2.m_min.m_fields[j] > oBox1.m_max.m_fields[j]))
+				return false;
+		}
+		return true;
+	}
+
+	static nfDouble fnBoxDistanceSquared(_In_ const NOUTBOX3 & oBox, _In_ const NVEC3D & vPoint)
+	{
+		nfDouble dResult = 0.0;
+		for (nfUint32 j = 0; j < 3; j++) {
+			nfDouble dDelta = 0.0;
+			if (vPoint.m_fields[j] < oBox.m_min.m_fields[j])
+				dDelta = oBox.m_min.m_fields[j] - vPoint.m_fields[j];
+			else if (vPoint.m_fields[j] > oBox.m_max.m_fields[j])
+				dDelta = vPoint.m_fields[j] - oBox.m_max.m_fields[j];
+			dResult += dDelta * dDelta;
+		}
+		return dResult;
+	}
+
+	// Slab test. Returns the entry distance of the ray into the box, or false if it misses [0, dMaxDistance].
+	static nfBool fnRayHitsBox(_In_ const NOUTBOX3 & oBox, _In_ const NVEC3D & vOrigin, _In_ const NVEC3D & vInvDirection, _In_ nfDouble dMaxDistance, _Out_ nfDouble & dEntry)
+	{
+		nfDouble dNear = 0.0;
+		nfDouble dFar = dMaxDistance;
+		for (nfUint32 j = 0; j < 3; j++) {
+			nfDouble dT1 = (oBox.m_min.m_fields[j] - vOrigin.m_fields[j]) * vInvDirection.m_fields[j];
+			nfDouble dT2 = (oBox.m_max.m_fields[j] - vOrigin.m_fields[j]) * vInvDirection.m_fields[j];
+			if (dT1 > dT2)
+				std::swap(dT1, dT2);
+			// NaN occurs for a ray in the plane of a slab and is ignored by these comparisons
+			if (dT1 > dNear)
+				dNear = dT1;
+			if (dT2 < dFar)
+				dFar = dT2;
+			if (dNear > dFar)
+				return false;
+		}
+		dEntry = dNear;
+		return true;
+	}
+
+	static NVEC3D fnClosestPointOnTriangle(_In_ const NVEC3D & vPoint, _In_ const NVEC3D & vA, _In_ const NVEC3D & vB, _In_ const NVEC3D & vC)
+	{
+		NVEC3D vAB = fnVEC3D_sub(vB, vA);
+		NVEC3D vAC = fnVEC3D_sub(vC, vA);
+		NVEC3D vAP = fnVEC3D_sub(vPoint, vA);
+		nfDouble d1 = fnVEC3D_dot(vAB, vAP);
+		nfDouble d2 = fnVEC3D_dot(vAC, vAP);
+		if ((d1 <= 0) && (d2 <= 0))
+			return vA;
+
+		NVEC3D vBP = fnVEC3D_sub(vPoint, vB);
+		nfDouble d3 = fnVEC3D_dot(vAB, vBP);
+		nfDouble d4 = fnVEC3D_dot(vAC, vBP);
+		if ((d3 >= 0) && (d4 <= d3))
+			return vB;
+
+		nfDouble dVC = d1 * d4 - d3 * d2;
+		if ((dVC <= 0) && (d1 >= 0) && (d3 <= 0))
+			return fnVEC3D_combine(vA, vAB, d1 / (d1 - d3));
+
+		NVEC3D vCP = fnVEC3D_sub(vPoint, vC);
+		nfDouble d5 = fnVEC3D_dot(vAB, vCP);
+		nfDouble d6 = fnVEC3D_dot(vAC, vCP);
+		if ((d6 >= 0) && (d5 <= d6))
+			return vC;
+
+		nfDouble dVB = d5 * d2 - d1 * d6;
+		if ((dVB <= 0) && (d2 >= 0) && (d6 <= 0))
+			return fnVEC3D_combine(vA, vAC, d2 / (d2 - d6));
+
+		nfDouble dVA = d3 * d6 - d5 * d4;
+		if ((dVA <= 0) && ((d4 - d3) >= 0) && ((d5 - d6) >= 0))
+			return fnVEC3D_combine(vB, fnVEC3D_sub(vC, vB), (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+		nfDouble dSum = dVA + dVB + dVC;
+		if (dSum <= 0)
+			return vA;
+		return fnVEC3D_combine(fnVEC3D_combine(vA, vAB, dVB / dSum), vAC, dVC / dSum);
+	}
+
+	// Moeller-Trumbore, both orientations
+	static nfBool fnRayHitsTriangle(_In_ const NVEC3D & vOrigin, _In_ const NVEC3D & vDirection, _In_ const NVEC3D & vA, _In_ const NVEC3D & vB, _In_ const NVEC3D & vC, _Out_ nfDouble & dDistance)
+	{
+		NVEC3D vE1 = fnVEC3D_sub(vB, vA);
+		NVEC3D vE2 = fnVEC3D_sub(vC, vA);
+		NVEC3D vP = fnVEC3D_cross(vDirection, vE2);
+		nfDouble dDet = fnVEC3D_dot(vE1, vP);
+		if (dDet == 0.0)
+			return false;
+
+		nfDouble dInvDet = 1.0 / dDet;
+		NVEC3D vT = fnVEC3D_sub(vOrigin, vA);
+		nfDouble dU = fnVEC3D_dot(vT, vP) * dInvDet;
+		if ((dU < 0.0) || (dU > 1.0))
+			return false;
+
+		NVEC3D vQ = fnVEC3D_cross(vT, vE1);
+		nfDouble dV = fnVEC3D_dot(vDirection, vQ) * dInvDet;
+		if ((dV < 0.0) || (dU + dV > 1.0))
+			return false;
+
+		dDistance = fnVEC3D_dot(vE2, vQ) * dInvDet;
+		return true;
+	}
+
+	static nfBool fnRayEntersSphere(_In_ const NVEC3D & vOrigin, _In_ const NVEC3D & vDirection, _In_ const NVEC3D & vCenter, _In_ nfDouble dRadius, _Out_ nfDouble & dDistance)
+	{
+		NVEC3D vOC = fnVEC3D_sub(vOrigin, vCenter);
+		nfDouble dB = fnVEC3D_dot(vOC, vDirection);
+		nfDouble dH = dB * dB - fnVEC3D_dot(vOC, vOC) + dRadius * dRadius;
+		if (dH < 0.0)
+			return false;
+		dDistance = -dB - sqrt(dH);
+		return true;
+	}
+
+	static void fnClosestPointOnSphere(_In_ const NVEC3D & vPoint, _In_ const NVEC3D & vCenter, _In_ nfDouble dRadius, _Out_ NVEC3D & vClosestPoint, _Out_ nfDouble & dDistance)
+	{
+		NVEC3D vDelta = fnVEC3D_sub(vPoint, vCenter);
+		nfDouble dLength = sqrt(fnVEC3D_dot(vDelta, vDelta));
+		if (dLength <= dRadius) {
+			vClosestPoint = vPoint;
+			dDistance = 0.0;
+		}
+		else {
+			vClosestPoint = fnVEC3D_combine(vCenter, vDelta, dRadius / dLength);
+			dDistance = dLength - dRadius;
+		}
+	}
+
+	// Closest point on the rounded cone around the segment AB with radii dRadiusA and dRadiusB
+	static void fnClosestPointOnRoundedCone(_In_ const NVEC3D & vPoint, _In_ const NVEC3D & vA, _In_ const NVEC3D & vB, _In_ nfDouble dRadiusA, _In_ nfDouble dRadiusB,
+		_Out_ NVEC3D & vClosestPoint, _Out_ nfDouble & dDistance)
+	{
+		NVEC3D vBA = fnVEC3D_sub(vB, vA);
+		nfDouble dLength = sqrt(fnVEC3D_dot(vBA, vBA));
+		nfDouble dRadiusDelta = dRadiusA - dRadiusB;
+		if (dLength <= fabs(dRadiusDelta)) {
+			// one sphere contains the other
+			if (dRadiusA >= dRadiusB)
+				fnClosestPointOnSphere(vPoint, vA, dRadiusA, vClosestPoint, dDistance);
+			else
+				fnClosestPointOnSphere(vPoint, vB, dRadiusB, vClosestPoint, dDistance);
+			return;
+		}
+
+		// Work in the plane spanned by the axis and the point: s along the axis, x away from it
+		NVEC3D vAxis = fnVEC3D_combine(fnVEC3D_make(0.0, 0.0, 0.0), vBA, 1.0 / dLength);
+		NVEC3D vPA = fnVEC3D_sub(vPoint, vA);
+		nfDouble dS = fnVEC3D_dot(vPA, vAxis);
+		NVEC3D vRadial = fnVEC3D_combine(vPA, vAxis, -dS);
+		nfDouble dX = sqrt(fnVEC3D_dot(vRadial, vRadial));
+
+		// The cone surface touches both spheres along the line with normal (sin, cos)
+		nfDouble dSin = dRadiusDelta / dLength;
+		nfDouble dCos = sqrt(1.0 - dSin * dSin);
+		nfDouble dAlongSurface = (dS - dRadiusA * dSin) * dCos - (dX - dRadiusA * dCos) * dSin;
+		if (dAlongSurface <= 0.0) {
+			fnClosestPointOnSphere(vPoint, vA, dRadiusA, vClosestPoint, dDistance);
+			return;
+		}
+		if (dAlongSurface >= dLength * dCos) {
+			fnClosestPointOnSphere(vPoint, vB, dRadiusB, vClosestPoint, dDistance);
+			return;
+		}
+
+		nfDouble dSurfaceDistance = dS * dSin + dX * dCos - dRadiusA;
+		if (dSurfaceDistance <= 0.0) {
+			vClosestPoint = vPoint;
+			dDistance = 0.0;
+			return;
+		}
+
+		// dX > 0 here, as points on the axis are inside
+		NVEC3D vClosest = fnVEC3D_combine(vA, vAxis, dS - dSurfaceDistance * dSin);
+		vClosestPoint = fnVEC3D_combine(vClosest, vRadial, (dX - dSurfaceDistance * dCos) / dX);
+		dDistance = dSurfaceDistance;
+	}
+
+	// Entry of a normalized ray into the rounded cone around AB, following the analytic solution of
+	// the intersection with the cone tangent to both spheres, and with the spheres themselves.
+	static nfBool fnRayEntersRoundedCone(_In_ const NVEC3D & vOrigin, _In_ const NVEC3D & vDirection, _In_ const NVEC3D & vA, _In_ const NVEC3D & vB,
+		_In_ nfDouble dRadiusA, _In_ nfDouble dRadiusB, _Out_ nfDouble & dDistance)
+	{
+		NVEC3D vBA = fnVEC3D_sub(vB, vA);
+		NVEC3D vOA = fnVEC3D_sub(vOrigin, vA);
+		nfDouble dRadiusDelta = dRadiusA - dRadiusB;
+		nfDouble m0 = fnVEC3D_dot(vBA, vBA);
+		nfDouble d2 = m0 - dRadiusDelta * dRadiusDelta;
+		if (d2 <= 0.0) {
+			// one sphere contains the other
+			if (dRadiusA >= dRadiusB)
+				return fnRayEntersSphere(vOrigin, vDirection, vA, dRadiusA, dDistance);
+			return fnRayEntersSphere(vOrigin, vDirection, vB, dRadiusB, dDistance);
+		}
+
+		nfDouble m1 = fnVEC3D_dot(vBA, vOA);
+		nfDouble m2 = fnVEC3D_dot(vBA, vDirection);
+		nfDouble m3 = fnVEC3D_dot(vDirection, vOA);
+		nfDouble m5 = fnVEC3D_dot(vOA, vOA);
+
+		// body
+		nfDouble k2 = d2 - m2 * m2;
+		nfDouble k1 = d2 * m3 - m1 * m2 + m2 * dRadiusDelta * dRadiusA;
+		nfDouble k0 = d2 * m5 - m1 * m1 + m1 * dRadiusDelta * dRadiusA * 2.0 - m0 * dRadiusA * dRadiusA;
+		nfDouble h = k1 * k1 - k0 * k2;
+		if (k2 != 0.0) {
+			if (h < 0.0)
+				return false;
+			nfDouble dT = (-sqrt(h) - k1) / k2;
+			nfDouble dY = m1 - dRadiusA * dRadiusDelta + dT * m2;
+			if ((dY > 0.0) && (dY < d2)) {
+				dDistance = dT;
+				return true;
+			}
+		}
+
+		// caps
+		nfBool bHit = false;
+		nfDouble dT;
+		if (fnRayEntersSphere(vOrigin, vDirection, vA, dRadiusA, dT)) {
+			dDistance = dT;
+			bHit = true;
+		}
+		if (fnRayEntersSphere(vOrigin, vDirection, vB, dRadiusB, dT)) {
+			if ((!bHit) || (dT < dDistance))
+				dDistance = dT;
+			bHit = true;
+		}
+		return bHit;
+	}
+
+	class CMeshBVHBuilder {
+	private:
+		const std::vector<MESHBVHBUILDPRIMITIVE> & m_Primitives;
+		std::vector<nfUint32> & m_References;
+
+	public:
+		CMeshBVHBuilder(_In_ const std::vector<MESHBVHBUILDPRIMITIVE> & Primitives, _In_ std::vector<nfUint32> & References)
+			: m_Primitives(Primitives), m_References(References)
+		{
+		}
+
+		// Sets up the node for the references [nBegin, nEnd). Returns true if it was split into two children,
+		// which are appended to Nodes, with the first one covering [nBegin, nMiddle).
+		nfBool splitNode(_Inout_ std::vector<MESHBVHNODE> & Nodes, _In_ nfUint32 nNode, _In_ nfUint32 nBegin, _In_ nfUint32 nEnd, _Out_ nfUint32 & nMiddle)
+		{
+			NOUTBOX3 oBox, oCentroidBox;
+			fnOutboxInitialize(oBox);
+			fnOutboxInitialize(oCentroidBox);
+			for (nfUint32 nIndex = nBegin; nIndex < nEnd; nIndex++) {
+				const MESHBVHBUILDPRIMITIVE & primitive = m_Primitives[m_References[nIndex]];
+				fnOutboxMergeVector(oBox, primitive.m_Box.m_min);
+				fnOutboxMergeVector(oBox, primitive.m_Box.m_max);
+				fnOutboxMergeVector(oCentroidBox, primitive.m_vCentroid);
+			}
+
+			MESHBVHNODE & node = Nodes[nNode];
+			node.m_Box = oBox;
+			node.m_nFirst = nBegin;
+			node.m_nCount = nEnd - nBegin;
+			nMiddle = nBegin;
+			if (nEnd - nBegin <= NMR_MESHBVH_MAXLEAFSIZE)
+				return false;
+
+			// Binned surface area heuristic over all three axes
+			nfDouble dBestCost = std::numeric_limits<nfDouble>::max();
+			nfInt32 nBestAxis = -1;
+			nfUint32 nBestBin = 0;
+			for (nfUint32 nAxis = 0; nAxis < 3; nAxis++) {
+				nfDouble dMin = oCentroidBox.m_min.m_fields[nAxis];
+				nfDouble dExtent = (nfDouble)oCentroidBox.m_max.m_fields[nAxis] - dMin;
+				if (dExtent <= 0.0)
+					continue;
+				nfDouble dScale = NMR_MESHBVH_BINCOUNT / dExtent;
+
+				NOUTBOX3 BinBoxes[NMR_MESHBVH_BINCOUNT];
+				nfUint32 BinCounts[NMR_MESHBVH_BINCOUNT];
+				for (nfUint32 nBin = 0; nBin < NMR_MESHBVH_BINCOUNT; nBin++) {
+					fnOutboxInitialize(BinBoxes[nBin]);
+					BinCounts[nBin] = 0;
+				}
+				for (nfUint32 nIndex = nBegin; nIndex < nEnd; nIndex++) {
+					const MESHBVHBUILDPRIMITIVE & primitive = m_Primitives[m_References[nIndex]];
+					nfUint32 nBin = std::min((nfUint32)((primitive.m_vCentroid.m_fields[nAxis] - dMin) * dScale), (nfUint32)(NMR_MESHBVH_BINCOUNT - 1));
+					fnOutboxMergeVector(BinBoxes[nBin], primitive.m_Box.m_min);
+					fnOutboxMergeVector(BinBoxes[nBin], primitive.m_Box.m_max);
+					BinCounts[nBin]++;
+				}
+
+				nfDouble RightCosts[NMR_MESHBVH_BINCOUNT];
+				NOUTBOX3 oRightBox;
+				fnOutboxInitialize(oRightBox);
+				nfUint32 nRightCount = 0;
+				for (nfUint32 nBin = NMR_MESHBVH_BINCOUNT - 1; nBin > 0; nBin--) {
+					fnOutboxMergeOutbox(oRightBox, BinBoxes[nBin]);
+					nRightCount += BinCounts[nBin];
+					RightCosts[nBin] = (nRightCount > 0) ? nRightCount * fnBoxHalfArea(oRightBox) : -1.0;
+				}
+
+				NOUTBOX3 oLeftBox;
+				fnOutboxInitialize(oLeftBox);
+				nfUint32 nLeftCount = 0;
+				for (nfUint32 nBin = 0; nBin + 1 < NMR_MESHBVH_BINCOUNT; nBin++) {
+					fnOutboxMergeOutbox(oLeftBox, BinBoxes[nBin]);
+					nLeftCount += BinCounts[nBin];
+					if ((nLeftCount == 0) || (RightCosts[nBin + 1] < 0.0))
+						continue;
+					nfDouble dCost = nLeftCount * fnBoxHalfArea(oLeftBox) + RightCosts[nBin + 1];
+					if (dCost < dBestCost) {
+						dBestCost = dCost;
+						nBestAxis = nAxis;
+						nBestBin = nBin;
+					}
+				}
+			}
+
+			if (nBestAxis < 0) {
+				// All centroids coincide
+				return false;
+			}
+
+			nfDouble dMin = oCentroidBox.m_min.m_fields[nBestAxis];
+			nfDouble dScale = NMR_MESHBVH_BINCOUNT / ((nfDouble)oCentroidBox.m_max.m_fields[nBestAxis] - dMin);
+			auto iMiddle = std::partition(m_References.begin() + nBegin, m_References.begin() + nEnd, [&](nfUint32 nReference) {
+				nfUint32 nBin = std::min((nfUint32)((m_Primitives[nReference].m_vCentroid.m_fields[nBestAxis] - dMin) * dScale), (nfUint32)(NMR_MESHBVH_BINCOUNT - 1));
+				return nBin <= nBestBin;
+			});
+			nMiddle = (nfUint32)(iMiddle - m_References.begin());
+			if ((nMiddle == nBegin) || (nMiddle == nEnd)) {
+				nMiddle = nBegin;
+				return false;
+			}
+
+			nfUint32 nFirstChild = (nfUint32)Nodes.size();
+			Nodes.resize(Nodes.size() + 2);
+			Nodes[nNode].m_nFirst = nFirstChild;
+			Nodes[nNode].m_nCount = 0;
+			return true;
+		}
+
+		void buildSubtree(_Inout_ std::vector<MESHBVHNODE> & Nodes, _In_ nfUint32 nNode, _In_ nfUint32 nBegin, _In_ nfUint32 nEnd)
+		{
+			std::vector<MESHBVHBUILDTASK> Stack;
+			Stack.push_back({ nNode, nBegin, nEnd });
+			while (!Stack.empty()) {
+				MESHBVHBUILDTASK task = Stack.back();
+				Stack.pop_back();
+
+				nfUint32 nMiddle;
+				if (splitNode(Nodes, task.m_nNode, task.m_nBegin, task.m_nEnd, nMiddle)) {
+					nfUint32 nFirstChild = Nodes[task.m_nNode].m_nFirst;
+					Stack.push_back({ nFirstChild + 1, nMiddle, task.m_nEnd });
+					Stack.push_back({ nFirstChild, task.m_nBegin, nMiddle });
+				}
+			}
+		}
+	};
+
+	CMeshBVH::CMeshBVH(_In_ CMesh * pMesh, _In_ eMeshBVHPrimitive ePrimitive, _In_ nfUint32 nThreadCount)
+	{
+		if (!pMesh)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		m_ePrimitive = ePrimitive;
+
+		nfUint32 nCornerCount = cornersPerPrimitive();
+		nfUint32 nPrimitiveCount = (ePrimitive == eMeshBVHPrimitive::Faces) ? pMesh->getFaceCount() : pMesh->getBeamCount();
+		if (nPrimitiveCount == 0)
+			return;
+
+		// Gather corners, radii and bounds of all primitives
+		std::vector<NVEC3> Corners((size_t)nPrimitiveCount * nCornerCount);
+		std::vector<nfDouble> Radii;
+		std::vector<MESHBVHBUILDPRIMITIVE> Primitives(nPrimitiveCount);
+		const nfInt32 * pBeamNodeIndices = nullptr;
+		if (ePrimitive == eMeshBVHPrimitive::Beams) {
+			Radii.resize((size_t)nPrimitiveCount * 2);
+			pBeamNodeIndices = pMesh->getBeamStore().getNodeIndices();
+		}
+
+		nfUint64 nChunkCount = (nPrimitiveCount + NMR_MESHBVH_CHUNKSIZE - 1) / NMR_MESHBVH_CHUNKSIZE;
+		fnParallelFor(nThreadCount, nChunkCount, [&](nfUint64 nChunk) {
+			nfUint32 nStart = (nfUint32)(nChunk * NMR_MESHBVH_CHUNKSIZE);
+			nfUint32 nEnd = std::min(nStart + NMR_MESHBVH_CHUNKSIZE, nPrimitiveCount);
+			if (ePrimitive == eMeshBVHPrimitive::Beams)
+				pMesh->getBeamStore().getRadii(nStart, nEnd - nStart, &Radii[(size_t)nStart * 2]);
+
+			for (nfUint32 nIndex = nStart; nIndex < nEnd; nIndex++) {
+				MESHBVHBUILDPRIMITIVE & primitive = Primitives[nIndex];
+				fnOutboxInitialize(primitive.m_Box);
+				for (nfUint32 j = 0; j < nCornerCount; j++) {
+					nfInt32 nNodeIndex = (ePrimitive == eMeshBVHPrimitive::Faces) ? pMesh->getFace(nIndex)->m_nodeindices[j] : pBeamNodeIndices[(size_t)nIndex * 2 + j];
+					NVEC3 vCorner = pMesh->getNode(nNodeIndex)->m_position;
+					Corners[(size_t)nIndex * nCornerCount + j] = vCorner;
+
+					nfFloat fRadius = 0.0f;
+					if (ePrimitive == eMeshBVHPrimitive::Beams) {
+						// round outwards, the radii are double precision
+						fRadius = std::nextafter((nfFloat)Radii[(size_t)nIndex * 2 + j], std::numeric_limits<nfFloat>::max());
+					}
+					fnOutboxMergeVector(primitive.m_Box, fnVEC3_make(vCorner.m_fields[0] - fRadius, vCorner.m_fields[1] - fRadius, vCorner.m_fields[2] - fRadius));
+					fnOutboxMergeVector(primitive.m_Box, fnVEC3_make(vCorner.m_fields[0] + fRadius, vCorner.m_fields[1] + fRadius, vCorner.m_fields[2] + fRadius));
+				}
+				for (nfUint32 j = 0; j < 3; j++)
+					primitive.m_vCentroid.m_fields[j] = (primitive.m_Box.m_min.m_fields[j] + primitive.m_Box.m_max.m_fields[j]) * 0.5f;
+			}
+		});
+
+		std::vector<nfUint32> References(nPrimitiveCount);
+		for (nfUint32 nIndex = 0; nIndex < nPrimitiveCount; nIndex++)
+			References[nIndex] = nIndex;
+		CMeshBVHBuilder builder(Primitives, References);
+
+		// Split the upper levels serially until there are enough independent subtrees for all threads
+		m_Nodes.reserve((size_t)nPrimitiveCount * 2 / NMR_MESHBVH_MAXLEAFSIZE + 1);
+		m_Nodes.resize(1);
+		std::deque<MESHBVHBUILDTASK> Subtrees;
+		Subtrees.push_back({ 0, 0, nPrimitiveCount });
+		size_t nTargetSubtreeCount = (nThreadCount > 1) ? (size_t)nThreadCount * 4 : 1;
+		while ((!Subtrees.empty()) && (Subtrees.size() < nTargetSubtreeCount)) {
+			MESHBVHBUILDTASK task = Subtrees.front();
+			Subtrees.pop_front();
+			nfUint32 nMiddle;
+			if (builder.splitNode(m_Nodes, task.m_nNode, task.m_nBegin, task.m_nEnd, nMiddle)) {
+				nfUint32 nFirstChild = m_Nodes[task.m_nNode].m_nFirst;
+				Subtrees.push_back({ nFirstChild, task.m_nBegin, nMiddle });
+				Subtrees.push_back({ nFirstChild + 1, nMiddle, task.m_nEnd });
+			}
+		}
+
+		// Build the subtrees in parallel into separate node arrays, the local root is node 0
+		std::vector<std::vector<MESHBVHNODE>> SubtreeNodes(Subtrees.size());
+		fnParallelFor(nThreadCount, Subtrees.size(), [&](nfUint64 nSubtree) {
+			const MESHBVHBUILDTASK & task = Subtrees[(size_t)nSubtree];
+			std::vector<MESHBVHNODE> & Nodes = SubtreeNodes[(size_t)nSubtree];
+			Nodes.resize(1);
+			builder.buildSubtree(Nodes, 0, task.m_nBegin, task.m_nEnd);
+		});
+
+		// Append the subtrees, local node i > 0 is stored at nBase + i - 1
+		for (size_t nSubtree = 0; nSubtree < Subtrees.size(); nSubtree++) {
+			std::vector<MESHBVHNODE> & Nodes = SubtreeNodes[nSubtree];
+			nfUint32 nBase = (nfUint32)m_Nodes.size();
+			for (MESHBVHNODE & node : Nodes) {
+				if (node.m_nCount == 0)
+					node.m_nFirst = nBase + node.m_nFirst - 1;
+			}
+			m_Nodes[Subtrees[nSubtree].m_nNode] = Nodes[0];
+			m_Nodes.insert(m_Nodes.end(), Nodes.begin() + 1, Nodes.end());
+			std::vector<MESHBVHNODE>().swap(Nodes);
+		}
+		m_Nodes.shrink_to_fit();
+
+		// Store the primitive data in leaf order
+		m_PrimitiveIndices.swap(References);
+		m_Corners.resize(Corners.size());
+		if (ePrimitive == eMeshBVHPrimitive::Beams)
+			m_Radii.resize(Radii.size());
+		fnParallelFor(nThreadCount, nChunkCount, [&](nfUint64 nChunk) {
+			nfUint32 nStart = (nfUint32)(nChunk * NMR_MESHBVH_CHUNKSIZE);
+			nfUint32 nEnd = std::min(nStart + NMR_MESHBVH_CHUNKSIZE, nPrimitiveCount);
+			for (nfUint32 nSlot = nStart; nSlot < nEnd; nSlot++) {
+				size_t nPrimitive = m_PrimitiveIndices[nSlot];
+				for (nfUint32 j = 0; j < nCornerCount; j++)
+					m_Corners[(size_t)nSlot * nCornerCount + j] = Corners[nPrimitive * nCornerCount + j];
+				if (ePrimitive == eMeshBVHPrimitive::Beams) {
+					m_Radii[(size_t)nSlot * 2] = Radii[nPrimitive * 2];
+					m_Radii[(size_t)nSlot * 2 + 1] = Radii[nPrimitive * 2 + 1];
+				}
+			}
+		});
+	}
+
+	nfUint32 CMeshBVH::cornersPerPrimitive() const
+	{
+		return (m_ePrimitive == eMeshBVHPrimitive::Faces) ? 3 : 2;
+	}
+
+	eMeshBVHPrimitive CMeshBVH::getPrimitive() const
+	{
+		return m_ePrimitive;
+	}
+
+	nfUint32 CMeshBVH::getPrimitiveCount() const
+	{
+		return (nfUint32)m_PrimitiveIndices.size();
+	}
+
+	nfUint32 CMeshBVH::getNodeCount() const
+	{
+		return (nfUint32)m_Nodes.size();
+	}
+
+	nfBool CMeshBVH::primitiveClosestPoint(_In_ nfUint32 nSlot, _In_ const NVEC3D & vPoint, _Out_ NVEC3D & vClosestPoint, _Out_ nfDouble & dDistance) const
+	{
+		if (m_ePrimitive == eMeshBVHPrimitive::Faces) {
+			const NVEC3 * pCorners = &m_Corners[(size_t)nSlot * 3];
+			vClosestPoint = fnClosestPointOnTriangle(vPoint, fnVEC3D_fromVEC3(pCorners[0]), fnVEC3D_fromVEC3(pCorners[1]), fnVEC3D_fromVEC3(pCorners[2]));
+			NVEC3D vDelta = fnVEC3D_sub(vPoint, vClosestPoint);
+			dDistance = sqrt(fnVEC3D_dot(vDelta, vDelta));
+		}
+		else {
+			const NVEC3 * pCorners = &m_Corners[(size_t)nSlot * 2];
+			fnClosestPointOnRoundedCone(vPoint, fnVEC3D_fromVEC3(pCorners[0]), fnVEC3D_fromVEC3(pCorners[1]), m_Radii[(size_t)nSlot * 2], m_Radii[(size_t)nSlot * 2 + 1],
+				vClosestPoint, dDistance);
+		}
+		return true;
+	}
+
+	nfBool CMeshBVH::primitiveRayHit(_In_ nfUint32 nSlot, _In_ const NVEC3D & vOrigin, _In_ const NVEC3D & vDirection, _Out_ nfDouble & dDistance) const
+	{
+		if (m_ePrimitive == eMeshBVHPrimitive::Faces) {
+			const NVEC3 * pCorners = &m_Corners[(size_t)nSlot * 3];
+			return fnRayHitsTriangle(vOrigin, vDirection, fnVEC3D_fromVEC3(pCorners[0]), fnVEC3D_fromVEC3(pCorners[1]), fnVEC3D_fromVEC3(pCorners[2]), dDistance);
+		}
+		else {
+			const NVEC3 * pCorners = &m_Corners[(size_t)nSlot * 2];
+			return fnRayEntersRoundedCone(vOrigin, vDirection, fnVEC3D_fromVEC3(pCorners[0]), fnVEC3D_fromVEC3(pCorners[1]),
+				m_Radii[(size_t)nSlot * 2], m_Radii[(size_t)nSlot * 2 + 1], dDistance);
+		}
+	}
+
+	void CMeshBVH::findInBox(_In_ const NOUTBOX3 & oBox, _Inout_ std::vector<nfUint32> & Indices) const
+	{
+		if (m_Nodes.empty())
+			return;
+
+		nfUint32 nCornerCount = cornersPerPrimitive();
+		std::vector<nfUint32> Stack;
+		Stack.push_back(0);
+		while (!Stack.empty()) {
+			const MESHBVHNODE & node = m_Nodes[Stack.back()];
+			Stack.pop_back();
+			if (!fnBoxesOverlap(node.m_Box, oBox))
+				continue;
+
+			if (node.m_nCount == 0) {
+				Stack.push_back(node.m_nFirst + 1);
+				Stack.push_back(node.m_nFirst);
+				continue;
+			}
+
+			for (nfUint32 nSlot = node.m_nFirst; nSlot < node.m_nFirst + node.m_nCount; nSlot++) {
+				NOUTBOX3 oPrimitiveBox;
+				fnOutboxInitialize(oPrimitiveBox);
+				for (nfUint32 j = 0; j < nCornerCount; j++) {
+					const NVEC3 & vCorner = m_Corners[(size_t)nSlot * nCornerCount + j];
+					nfFloat fRadius = (m_ePrimitive == eMeshBVHPrimitive::Beams) ? (nfFloat)m_Radii[(size_t)nSlot * 2 + j] : 0.0f;
+					fnOutboxMergeVector(oPrimitiveBox, fnVEC3_make(vCorner.m_fields[0] - fRadius, vCorner.m_fields[1] - fRadius, vCorner.m_fields[2] - fRadius));
+					fnOutboxMergeVector(oPrimitiveBox, fnVEC3_make(vCorner.m_fields[0] + fRadius, vCorner.m_fields[1] + fRadius, vCorner.m_fields[2] + fRadius));
+				}
+				if (fnBoxesOverlap(oPrimitiveBox, oBox))
+					Indices.push_back(m_PrimitiveIndices[nSlot]);
+			}
+		}
+	}
+
+	nfBool CMeshBVH::findClosest(_In_ const NVEC3 & vPoint, _Out_ nfUint32 & nIndex, _Out_ NVEC3 & vClosestPoint, _Out_ nfDouble & dDistance) const
+	{
+		if (m_Nodes.empty())
+			return false;
+
+		NVEC3D vQuery = fnVEC3D_fromVEC3(vPoint);
+		nfDouble dBestDistance = std::numeric_limits<nfDouble>::max();
+		nfUint32 nBestSlot = 0;
+		NVEC3D vBestPoint = vQuery;
+
+		// Entries are (node, squared distance to its box), the nearer child is visited first
+		std::vector<std::pair<nfUint32, nfDouble>> Stack;
+		Stack.push_back(std::make_pair(0, fnBoxDistanceSquared(m_Nodes[0].m_Box, vQuery)));
+		while (!Stack.empty()) {
+			std::pair<nfUint32, nfDouble> entry = Stack.back();
+			Stack.pop_back();
+			if (entry.second >= dBestDistance * dBestDistance)
+				continue;
+
+			const MESHBVHNODE & node = m_Nodes[entry.first];
+			if (node.m_nCount == 0) {
+				nfDouble dDistance1 = fnBoxDistanceSquared(m_Nodes[node.m_nFirst].m_Box, vQuery);
+				nfDouble dDistance2 = fnBoxDistanceSquared(m_Nodes[node.m_nFirst + 1].m_Box, vQuery);
+				if (dDistance1 <= dDistance2) {
+					Stack.push_back(std::make_pair(node.m_nFirst + 1, dDistance2));
+					Stack.push_back(std::make_pair(node.m_nFirst, dDistance1));
+				}
+				else {
+					Stack.push_back(std::make_pair(node.m_nFirst, dDistance1));
+					Stack.push_back(std::make_pair(node.m_nFirst + 1, dDistance2));
+				}
+				continue;
+			}
+
+			for (nfUint32 nSlot = node.m_nFirst; nSlot < node.m_nFirst + node.m_nCount; nSlot++) {
+				NVEC3D vCandidate;
+				nfDouble dCandidateDistance;
+				primitiveClosestPoint(nSlot, vQuery, vCandidate, dCandidateDistance);
+				if (dCandidateDistance < dBestDistance) {
+					dBestDistance = dCandidateDistance;
+					nBestSlot = nSlot;
+					vBestPoint = vCandidate;
+				}
+			}
+			if (dBestDistance == 0.0)
+				break;
+		}
+
+		nIndex = m_PrimitiveIndices[nBestSlot];
+		vClosestPoint = fnVEC3_make((nfFloat)vBestPoint.m_fields[0], (nfFloat)vBestPoint.m_fields[1], (nfFloat)vBestPoint.m_fields[2]);
+		dDistance = dBestDistance;
+		return true;
+	}
+
+	nfBool CMeshBVH::rayCast(_In_ const NVEC3 & vOrigin, _In_ const NVEC3 & vDirection, _In_ nfDouble dMaxDistance, _Out_ nfUint32 & nIndex, _Out_ nfDouble & dDistance) const
+	{
+		NVEC3D vRayDirection = fnVEC3D_fromVEC3(vDirection);
+		nfDouble dLength = sqrt(fnVEC3D_dot(vRayDirection, vRayDirection));
+		if (dLength == 0.0)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if (m_Nodes.empty())
+			return false;
+
+		// Work with a normalized direction and convert the distances back at the end
+		vRayDirection = fnVEC3D_combine(fnVEC3D_make(0.0, 0.0, 0.0), vRayDirection, 1.0 / dLength);
+		NVEC3D vRayOrigin = fnVEC3D_fromVEC3(vOrigin);
+		NVEC3D vInvDirection = fnVEC3D_make(1.0 / vRayDirection.m_fields[0], 1.0 / vRayDirection.m_fields[1], 1.0 / vRayDirection.m_fields[2]);
+		nfDouble dBestDistance = dMaxDistance * dLength;
+		nfBool bHit = false;
+		nfUint32 nBestSlot = 0;
+
+		std::vector<std::pair<nfUint32, nfDouble>> Stack;
+		nfDouble dEntry;
+		if (fnRayHitsBox(m_Nodes[0].m_Box, vRayOrigin, vInvDirection, dBestDistance, dEntry))
+			Stack.push_back(std::make_pair(0, dEntry));
+		while (!Stack.empty()) {
+			std::pair<nfUint32, nfDouble> entry = Stack.back();
+			Stack.pop_back();
+			if (entry.second > dBestDistance)
+				continue;
+
+			const MESHBVHNODE & node = m_Nodes[entry.first];
+			if (node.m_nCount == 0) {
+				nfDouble dEntry1, dEntry2;
+				nfBool bHit1 = fnRayHitsBox(m_Nodes[node.m_nFirst].m_Box, vRayOrigin, vInvDirection, dBestDistance, dEntry1);
+				nfBool bHit2 = fnRayHitsBox(m_Nodes[node.m_nFirst + 1].m_Box, vRayOrigin, vInvDirection, dBestDistance, dEntry2);
+				if (bHit1 && bHit2 && (dEntry2 < dEntry1)) {
+					Stack.push_back(std::make_pair(node.m_nFirst, dEntry1));
+					Stack.push_back(std::make_pair(node.m_nFirst + 1, dEntry2));
+				}
+				else {
+					if (bHit2)
+						Stack.push_back(std::make_pair(node.m_nFirst + 1, dEntry2));
+					if (bHit1)
+						Stack.push_back(std::make_pair(node.m_nFirst, dEntry1));
+				}
+				continue;
+			}
+
+			for (nfUint32 nSlot = node.m_nFirst; nSlot < node.m_nFirst + node.m_nCount; nSlot++) {
+				nfDouble dHitDistance;
+				if (primitiveRayHit(nSlot, vRayOrigin, vRayDirection, dHitDistance) && (dHitDistance >= 0.0) && (dHitDistance <= dBestDistance)) {
+					dBestDistance = dHitDistance;
+					nBestSlot = nSlot;
+					bHit = true;
+				}
+			}
+		}
+
+		if (bHit) {
+			nIndex = m_PrimitiveIndices[nBestSlot];
+			dDistance = dBestDistance / dLength;
+		}
+		return bHit;
+	}
+
+	nfUint32 CMeshBVH::countRayHits(_In_ const NVEC3 & vOrigin, _In_ const NVEC3 & vDirection) const
+	{
+		NVEC3D vRayDirection = fnVEC3D_fromVEC3(vDirection);
+		if (fnVEC3D_dot(vRayDirection, vRayDirection) == 0.0)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if (m_Nodes.empty())
+			return 0;
+
+		NVEC3D vRayOrigin = fnVEC3D_fromVEC3(vOrigin);
+		NVEC3D vInvDirection = fnVEC3D_make(1.0 / vRayDirection.m_fields[0], 1.0 / vRayDirection.m_fields[1], 1.0 / vRayDirection.m_fields[2]);
+		nfUint32 nHitCount = 0;
+
+		std::vector<nfUint32> Stack;
+		Stack.push_back(0);
+		while (!Stack.empty()) {
+			const MESHBVHNODE & node = m_Nodes[Stack.back()];
+			Stack.pop_back();
+			nfDouble dEntry;
+			if (!fnRayHitsBox(node.m_Box, vRayOrigin, vInvDirection, std::numeric_limits<nfDouble>::max(), dEntry))
+				continue;
+
+			if (node.m_nCount == 0) {
+				Stack.push_back(node.m_nFirst + 1);
+				Stack.push_back(node.m_nFirst);
+				continue;
+			}
+
+			for (nfUint32 nSlot = node.m_nFirst; nSlot < node.m_nFirst + node.m_nCount; nSlot++) {
+				nfDouble dHitDistance;
+				if (primitiveRayHit(nSlot, vRayOrigin, vRayDirection, dHitDistance) && (dHitDistance > 0.0))
+					nHitCount++;
+			}
+		}
+		return nHitCount;
+	}
+
+	nfUint64 CMeshBVH::getMemoryUsage() const
+	{
+		return sizeof(CMeshBVH)
+			+ m_Nodes.capacity() * sizeof(MESHBVHNODE)
+			+ m_PrimitiveIndices.capacity() * sizeof(nfUint32)
+			+ m_Corners.capacity() * sizeof(NVEC3)
+			+ m_Radii.capacity() * sizeof(nfDouble);
+	}
+
+}
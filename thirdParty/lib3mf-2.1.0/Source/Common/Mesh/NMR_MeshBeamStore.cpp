@@ -0,0 +1,335 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshBeamStore.cpp implements the beam storage of a beam lattice.
+
+--*/
+
+#include "Common/Mesh/NMR_MeshBeamStore.h"
+#include "Common/NMR_Exception.h"
+
+#include <algorithm>
+
+namespace NMR {
+
+	static nfBool fnIsFloatExact(_In_ nfDouble dValue)
+	{
+		return (nfDouble)(nfFloat)dValue == dValue;
+	}
+
+	// Grows geometrically, but reserves exactly for a bulk insert into an empty vector
+	template <typename T> static void fnReserveForAppend(_In_ std::vector<T> & values, _In_ size_t nAppendCount)
+	{
+		size_t nNeeded = values.size() + nAppendCount;
+		if (values.capacity() < nNeeded)
+			values.reserve(std::max(nNeeded, values.capacity() * 2));
+	}
+
+	CMeshBeamStore::CMeshBeamStore()
+	{
+		m_eRadiusStorage = eMeshBeamRadiusStorage::Uniform;
+		m_dUniformRadius = 0.0;
+	}
+
+	nfUint32 CMeshBeamStore::getCount() const
+	{
+		return (nfUint32)(m_NodeIndices.size() / 2);
+	}
+
+	void CMeshBeamStore::reserve(_In_ nfUint32 nCount)
+	{
+		m_NodeIndices.reserve((size_t)nCount * 2);
+		if (m_eRadiusStorage == eMeshBeamRadiusStorage::Float)
+			m_FloatRadii.reserve((size_t)nCount * 2);
+		if (m_eRadiusStorage == eMeshBeamRadiusStorage::Double)
+			m_DoubleRadii.reserve((size_t)nCount * 2);
+	}
+
+	void CMeshBeamStore::clear()
+	{
+		std::vector<nfInt32>().swap(m_NodeIndices);
+		std::vector<nfFloat>().swap(m_FloatRadii);
+		std::vector<nfDouble>().swap(m_DoubleRadii);
+		m_CapModeRuns.clear();
+		m_eRadiusStorage = eMeshBeamRadiusStorage::Uniform;
+		m_dUniformRadius = 0.0;
+	}
+
+	void CMeshBeamStore::convertRadiusStorage(_In_ eMeshBeamRadiusStorage eStorage)
+	{
+		if (eStorage == m_eRadiusStorage)
+			return;
+
+		size_t nValueCount = m_NodeIndices.size();
+		switch (eStorage) {
+		case eMeshBeamRadiusStorage::Float:
+			if (m_eRadiusStorage != eMeshBeamRadiusStorage::Uniform)
+				throw CNMRException(NMR_ERROR_INVALIDPARAM);
+			m_FloatRadii.assign(nValueCount, (nfFloat)m_dUniformRadius);
+			break;
+		case eMeshBeamRadiusStorage::Double:
+			if (m_eRadiusStorage == eMeshBeamRadiusStorage::Uniform) {
+				m_DoubleRadii.assign(nValueCount, m_dUniformRadius);
+			}
+			else {
+				m_DoubleRadii.assign(m_FloatRadii.begin(), m_FloatRadii.end());
+				std::vector<nfFloat>().swap(m_FloatRadii);
+			}
+			break;
+		default:
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		}
+		m_eRadiusStorage = eStorage;
+	}
+
+	// Switches to a more precise storage if the given radii (two per beam) cannot be held by the current one.
+	// bReplacesAll states that these radii replace all existing ones, so the uniform value can be chosen freely.
+	void CMeshBeamStore::prepareRadiusStorage(_In_ nfUint32 nCount, _In_ const nfDouble * pRadii, _In_ nfBool bReplacesAll)
+	{
+		if (nCount == 0)
+			return;
+		size_t nValueCount = (size_t)nCount * 2;
+
+		if (m_eRadiusStorage == eMeshBeamRadiusStorage::Uniform) {
+			nfDouble dUniformRadius = bReplacesAll ? pRadii[0] : m_dUniformRadius;
+			if (std::all_of(pRadii, pRadii + nValueCount, [dUniformRadius](nfDouble dRadius) { return dRadius == dUniformRadius; })) {
+				m_dUniformRadius = dUniformRadius;
+				return;
+			}
+
+			nfBool bFloatExact = (bReplacesAll || fnIsFloatExact(m_dUniformRadius)) && std::all_of(pRadii, pRadii + nValueCount, fnIsFloatExact);
+			convertRadiusStorage(bFloatExact ? eMeshBeamRadiusStorage::Float : eMeshBeamRadiusStorage::Double);
+		}
+		else if (m_eRadiusStorage == eMeshBeamRadiusStorage::Float) {
+			if (!std::all_of(pRadii, pRadii + nValueCount, fnIsFloatExact))
+				convertRadiusStorage(eMeshBeamRadiusStorage::Double);
+		}
+	}
+
+	void CMeshBeamStore::appendCapModes(_In_ nfInt32 eCapMode1, _In_ nfInt32 eCapMode2)
+	{
+		if (!m_CapModeRuns.empty()) {
+			const MESHBEAMCAPRUN & lastRun = m_CapModeRuns.back();
+			if ((lastRun.m_capMode[0] == eCapMode1) && (lastRun.m_capMode[1] == eCapMode2))
+				return;
+		}
+
+		MESHBEAMCAPRUN run;
+		run.m_nStart = getCount();
+		run.m_capMode[0] = eCapMode1;
+		run.m_capMode[1] = eCapMode2;
+		m_CapModeRuns.push_back(run);
+	}
+
+	size_t CMeshBeamStore::findCapModeRun(_In_ nfUint32 nIdx) const
+	{
+		auto iRun = std::upper_bound(m_CapModeRuns.begin(), m_CapModeRuns.end(), nIdx,
+			[](nfUint32 nIndex, const MESHBEAMCAPRUN & run) { return nIndex < run.m_nStart; });
+		if (iRun == m_CapModeRuns.begin())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		return (size_t)(iRun - m_CapModeRuns.begin()) - 1;
+	}
+
+	nfUint32 CMeshBeamStore::addBeam(_In_ nfInt32 nNodeIndex1, _In_ nfInt32 nNodeIndex2, _In_ nfDouble dRadius1, _In_ nfDouble dRadius2,
+		_In_ nfInt32 eCapMode1, _In_ nfInt32 eCapMode2)
+	{
+		nfInt32 nodeIndices[2] = { nNodeIndex1, nNodeIndex2 };
+		nfDouble radii[2] = { dRadius1, dRadius2 };
+		nfInt32 capModes[2] = { eCapMode1, eCapMode2 };
+		nfUint32 nNewIndex = getCount();
+		addBeams(1, nodeIndices, radii, capModes);
+		return nNewIndex;
+	}
+
+	void CMeshBeamStore::addBeams(_In_ nfUint32 nCount, _In_ const nfInt32 * pNodeIndices, _In_ const nfDouble * pRadii, _In_ const nfInt32 * pCapModes)
+	{
+		if (nCount == 0)
+			return;
+		if ((!pNodeIndices) || (!pRadii) || (!pCapModes))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		size_t nValueCount = (size_t)nCount * 2;
+		prepareRadiusStorage(nCount, pRadii, getCount() == 0);
+		if (m_eRadiusStorage == eMeshBeamRadiusStorage::Float) {
+			fnReserveForAppend(m_FloatRadii, nValueCount);
+			for (size_t nValue = 0; nValue < nValueCount; nValue++)
+				m_FloatRadii.push_back((nfFloat)pRadii[nValue]);
+		}
+		else if (m_eRadiusStorage == eMeshBeamRadiusStorage::Double) {
+			m_DoubleRadii.insert(m_DoubleRadii.end(), pRadii, pRadii + nValueCount);
+		}
+
+		fnReserveForAppend(m_NodeIndices, nValueCount);
+		for (nfUint32 nBeam = 0; nBeam < nCount; nBeam++) {
+			appendCapModes(pCapModes[nBeam * 2], pCapModes[nBeam * 2 + 1]);
+			m_NodeIndices.push_back(pNodeIndices[nBeam * 2]);
+			m_NodeIndices.push_back(pNodeIndices[nBeam * 2 + 1]);
+		}
+	}
+
+	void CMeshBeamStore::getBeam(_In_ nfUint32 nIdx, _Out_ MESHBEAM & beam) const
+	{
+		if (nIdx >= getCount())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+		beam.m_nodeindices[0] = m_NodeIndices[nIdx * 2];
+		beam.m_nodeindices[1] = m_NodeIndices[nIdx * 2 + 1];
+		getRadii(nIdx, 1, beam.m_radius);
+		const MESHBEAMCAPRUN & run = m_CapModeRuns[findCapModeRun(nIdx)];
+		beam.m_capMode[0] = run.m_capMode[0];
+		beam.m_capMode[1] = run.m_capMode[1];
+	}
+
+	void CMeshBeamStore::setBeam(_In_ nfUint32 nIdx, _In_ const MESHBEAM & beam)
+	{
+		if (nIdx >= getCount())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+		m_NodeIndices[nIdx * 2] = beam.m_nodeindices[0];
+		m_NodeIndices[nIdx * 2 + 1] = beam.m_nodeindices[1];
+
+		prepareRadiusStorage(1, beam.m_radius, getCount() == 1);
+		for (nfUint32 j = 0; j < 2; j++) {
+			if (m_eRadiusStorage == eMeshBeamRadiusStorage::Float)
+				m_FloatRadii[nIdx * 2 + j] = (nfFloat)beam.m_radius[j];
+			else if (m_eRadiusStorage == eMeshBeamRadiusStorage::Double)
+				m_DoubleRadii[nIdx * 2 + j] = beam.m_radius[j];
+		}
+
+		size_t nRun = findCapModeRun(nIdx);
+		MESHBEAMCAPRUN oldRun = m_CapModeRuns[nRun];
+		if ((oldRun.m_capMode[0] == beam.m_capMode[0]) && (oldRun.m_capMode[1] == beam.m_capMode[1]))
+			return;
+
+		// Split the run around nIdx and merge equal neighbours again
+		nfUint32 nRunEnd = (nRun + 1 < m_CapModeRuns.size()) ? m_CapModeRuns[nRun + 1].m_nStart : getCount();
+		std::vector<MESHBEAMCAPRUN> newRuns;
+		if (nIdx > oldRun.m_nStart)
+			newRuns.push_back(oldRun);
+		MESHBEAMCAPRUN beamRun;
+		beamRun.m_nStart = nIdx;
+		beamRun.m_capMode[0] = beam.m_capMode[0];
+		beamRun.m_capMode[1] = beam.m_capMode[1];
+		newRuns.push_back(beamRun);
+		if (nIdx + 1 < nRunEnd) {
+			MESHBEAMCAPRUN tailRun = oldRun;
+			tailRun.m_nStart = nIdx + 1;
+			newRuns.push_back(tailRun);
+		}
+
+		m_CapModeRuns.erase(m_CapModeRuns.begin() + nRun);
+		m_CapModeRuns.insert(m_CapModeRuns.begin() + nRun, newRuns.begin(), newRuns.end());
+
+		size_t nFirst = (nRun > 0) ? nRun : 1;
+		size_t nLast = std::min(nRun + newRuns.size() + 1, m_CapModeRuns.size());
+		for (size_t nIndex = nLast; nIndex-- > nFirst;) {
+			const MESHBEAMCAPRUN & run = m_CapModeRuns[nIndex];
+			const MESHBEAMCAPRUN & previousRun = m_CapModeRuns[nIndex - 1];
+			if ((run.m_capMode[0] == previousRun.m_capMode[0]) && (run.m_capMode[1] == previousRun.m_capMode[1]))
+				m_CapModeRuns.erase(m_CapModeRuns.begin() + nIndex);
+		}
+	}
+
+	_Ret_maybenull_ nfInt32 * CMeshBeamStore::getNodeIndices()
+	{
+		return m_NodeIndices.empty() ? nullptr : m_NodeIndices.data();
+	}
+
+	_Ret_maybenull_ const nfInt32 * CMeshBeamStore::getNodeIndices() const
+	{
+		return m_NodeIndices.empty() ? nullptr : m_NodeIndices.data();
+	}
+
+	void CMeshBeamStore::getRadii(_In_ nfUint32 nStart, _In_ nfUint32 nCount, _Out_ nfDouble * pRadii) const
+	{
+		if ((nfUint64)nStart + nCount > getCount())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		if (nCount == 0)
+			return;
+		if (!pRadii)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		size_t nFirst = (size_t)nStart * 2;
+		size_t nValueCount = (size_t)nCount * 2;
+		switch (m_eRadiusStorage) {
+		case eMeshBeamRadiusStorage::Uniform:
+			std::fill(pRadii, pRadii + nValueCount, m_dUniformRadius);
+			break;
+		case eMeshBeamRadiusStorage::Float:
+			std::copy(m_FloatRadii.begin() + nFirst, m_FloatRadii.begin() + nFirst + nValueCount, pRadii);
+			break;
+		case eMeshBeamRadiusStorage::Double:
+			std::copy(m_DoubleRadii.begin() + nFirst, m_DoubleRadii.begin() + nFirst + nValueCount, pRadii);
+			break;
+		}
+	}
+
+	void CMeshBeamStore::getCapModes(_In_ nfUint32 nStart, _In_ nfUint32 nCount, _Out_ nfInt32 * pCapModes) const
+	{
+		if ((nfUint64)nStart + nCount > getCount())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		if (nCount == 0)
+			return;
+		if (!pCapModes)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		size_t nRun = findCapModeRun(nStart);
+		for (nfUint32 nIdx = nStart; nIdx < nStart + nCount; nIdx++) {
+			while ((nRun + 1 < m_CapModeRuns.size()) && (m_CapModeRuns[nRun + 1].m_nStart <= nIdx))
+				nRun++;
+			*(pCapModes++) = m_CapModeRuns[nRun].m_capMode[0];
+			*(pCapModes++) = m_CapModeRuns[nRun].m_capMode[1];
+		}
+	}
+
+	eMeshBeamRadiusStorage CMeshBeamStore::getRadiusStorage() const
+	{
+		return m_eRadiusStorage;
+	}
+
+	nfBool CMeshBeamStore::getUniformRadius(_Out_ nfDouble & dRadius) const
+	{
+		dRadius = m_dUniformRadius;
+		return m_eRadiusStorage == eMeshBeamRadiusStorage::Uniform;
+	}
+
+	const std::vector<MESHBEAMCAPRUN> & CMeshBeamStore::getCapModeRuns() const
+	{
+		return m_CapModeRuns;
+	}
+
+	nfUint64 CMeshBeamStore::getMemoryUsage() const
+	{
+		return sizeof(CMeshBeamStore)
+			+ m_NodeIndices.capacity() * sizeof(nfInt32)
+			+ m_FloatRadii.capacity() * sizeof(nfFloat)
+			+ m_DoubleRadii.capacity() * sizeof(nfDouble)
+			+ m_CapModeRuns.capacity() * sizeof(MESHBEAMCAPRUN);
+	}
+
+}
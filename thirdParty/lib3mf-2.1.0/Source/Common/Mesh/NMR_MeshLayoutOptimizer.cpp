@@ -0,0 +1,379 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshLayoutOptimizer.cpp implements the class CMeshLayoutOptimizer.
+
+The face reordering follows Tom Forsyth's "Linear-Speed Vertex Cache Optimisation":
+every node gets a score from its position in a simulated LRU cache and from the
+number of faces still using it, and the face with the highest node score sum
+among the faces touching the cache is emitted next.
+
+--*/
+
+#include "Common/Mesh/NMR_MeshLayoutOptimizer.h" 
+#include "Common/NMR_Exception.h" 
+
+#include <algorithm>
+#include <cmath>
+
+namespace NMR {
+
+	const nfFloat MESHLAYOUT_CACHEDECAYPOWER = 1.5f;
+	const nfFloat MESHLAYOUT_LASTFACESCORE = 0.75f;
+	const nfFloat MESHLAYOUT_VALENCEBOOSTSCALE = 2.0f;
+	const nfFloat MESHLAYOUT_VALENCEBOOSTPOWER = 0.5f;
+
+	// Spreads the lower 21 bits of a value to every third bit of a 64 bit code
+	static nfUint64 fnMortonExpandBits(_In_ nfUint64 nValue)
+	{
+		nValue &= 0x1fffff;
+		nValue = (nValue | (nValue << 32)) & 0x1f00000000ffffULL;
+		nValue = (nValue | (nValue << 16)) & 0x1f0000ff0000ffULL;
+		nValue = (nValue | (nValue << 8)) & 0x100f00f00f00f00fULL;
+		nValue = (nValue | (nValue << 4)) & 0x10c30c30c30c30c3ULL;
+		nValue = (nValue | (nValue << 2)) & 0x1249249249249249ULL;
+		return nValue;
+	}
+
+	static nfFloat fnVertexScore(_In_ nfInt32 nCachePosition, _In_ nfUint32 nRemainingFaces)
+	{
+		if (nRemainingFaces == 0)
+			return -1.0f;
+
+		nfFloat fScore = 0.0f;
+		if (nCachePosition >= 0) {
+			if (nCachePosition < 3) {
+				// the nodes of the last face are penalized to avoid strips
+				fScore = MESHLAYOUT_LASTFACESCORE;
+			}
+			else {
+				nfFloat fScaler = 1.0f / (NMR_MESHLAYOUT_VERTEXCACHESIZE - 3);
+				fScore = std::pow(1.0f - (nCachePosition - 3) * fScaler, MESHLAYOUT_CACHEDECAYPOWER);
+			}
+		}
+
+		// nodes with few remaining faces are preferred to get rid of them quickly
+		fScore += MESHLAYOUT_VALENCEBOOSTSCALE * std::pow((nfFloat)nRemainingFaces, -MESHLAYOUT_VALENCEBOOSTPOWER);
+		return fScore;
+	}
+
+	CMeshLayoutOptimizer::CMeshLayoutOptimizer(_In_ nfBool bSpatialSort, _In_ nfBool bReorderFaces, _In_ nfBool bRenumberNodes)
+		: m_bSpatialSort(bSpatialSort), m_bReorderFaces(bReorderFaces), m_bRenumberNodes(bRenumberNodes)
+	{
+	}
+
+	void CMeshLayoutOptimizer::optimize(_In_ CMesh * pMesh)
+	{
+		if (pMesh == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		nfUint32 nFaceCount = pMesh->getFaceCount();
+		if (m_bSpatialSort || m_bReorderFaces) {
+			std::vector<nfUint32> FaceOrder(nFaceCount);
+			for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++)
+				FaceOrder[nIndex] = nIndex;
+
+			if (m_bSpatialSort)
+				sortFacesSpatially(pMesh, FaceOrder);
+			if (m_bReorderFaces)
+				reorderFacesForVertexCache(pMesh, FaceOrder);
+
+			applyFaceOrder(pMesh, FaceOrder);
+		}
+
+		if (m_bRenumberNodes)
+			renumberNodes(pMesh);
+
+		pMesh->invalidateSpatialIndex();
+	}
+
+	void CMeshLayoutOptimizer::sortFacesSpatially(_In_ CMesh * pMesh, _Inout_ std::vector<nfUint32> & FaceOrder)
+	{
+		nfUint32 nFaceCount = (nfUint32)FaceOrder.size();
+		if (nFaceCount < 2)
+			return;
+
+		std::vector<NVEC3> Centroids(nFaceCount);
+		NVEC3 vMin = { { NMR_MESH_MAXCOORDINATE, NMR_MESH_MAXCOORDINATE, NMR_MESH_MAXCOORDINATE } };
+		NVEC3 vMax = { { -NMR_MESH_MAXCOORDINATE, -NMR_MESH_MAXCOORDINATE, -NMR_MESH_MAXCOORDINATE } };
+
+		for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++) {
+			MESHFACE * pFace = pMesh->getFace(FaceOrder[nIndex]);
+			const NVEC3 & vPosition1 = pMesh->getNode(pFace->m_nodeindices[0])->m_position;
+			const NVEC3 & vPosition2 = pMesh->getNode(pFace->m_nodeindices[1])->m_position;
+			const NVEC3 & vPosition3 = pMesh->getNode(pFace->m_nodeindices[2])->m_position;
+
+			NVEC3 & vCentroid = Centroids[nIndex];
+			for (nfUint32 j = 0; j < 3; j++) {
+				vCentroid.m_fields[j] = (vPosition1.m_fields[j] + vPosition2.m_fields[j] + vPosition3.m_fields[j]) / 3.0f;
+				vMin.m_fields[j] = std::min(vMin.m_fields[j], vCentroid.m_fields[j]);
+				vMax.m_fields[j] = std::max(vMax.m_fields[j], vCentroid.m_fields[j]);
+			}
+		}
+
+		nfFloat fScale[3];
+		for (nfUint32 j = 0; j < 3; j++) {
+			nfFloat fExtent = vMax.m_fields[j] - vMin.m_fields[j];
+			fScale[j] = (fExtent > 0.0f) ? (nfFloat)0x1fffff / fExtent : 0.0f;
+		}
+
+		std::vector<std::pair<nfUint64, nfUint32>> Codes(nFaceCount);
+		for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++) {
+			nfUint64 nCode = 0;
+			for (nfUint32 j = 0; j < 3; j++) {
+				nfUint64 nCell = (nfUint64)((Centroids[nIndex].m_fields[j] - vMin.m_fields[j]) * fScale[j]);
+				nCode |= fnMortonExpandBits(nCell) << j;
+			}
+			Codes[nIndex] = std::make_pair(nCode, FaceOrder[nIndex]);
+		}
+
+		std::sort(Codes.begin(), Codes.end());
+		for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++)
+			FaceOrder[nIndex] = Codes[nIndex].second;
+	}
+
+	void CMeshLayoutOptimizer::reorderFacesForVertexCache(_In_ CMesh * pMesh, _Inout_ std::vector<nfUint32> & FaceOrder)
+	{
+		nfUint32 nFaceCount = (nfUint32)FaceOrder.size();
+		nfUint32 nNodeCount = pMesh->getNodeCount();
+		if (nFaceCount < 2)
+			return;
+
+		// Node indices of the faces in input order
+		std::vector<nfUint32> FaceNodes((size_t)nFaceCount * 3);
+		for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++) {
+			MESHFACE * pFace = pMesh->getFace(FaceOrder[nIndex]);
+			for (nfUint32 j = 0; j < 3; j++)
+				FaceNodes[(size_t)nIndex * 3 + j] = (nfUint32)pFace->m_nodeindices[j];
+		}
+
+		// Compressed node-to-face adjacency. The first RemainingFaces entries of each
+		// node's range are the faces that have not been emitted yet.
+		std::vector<nfUint32> AdjacencyOffsets((size_t)nNodeCount + 1, 0);
+		for (nfUint32 nNodeIndex : FaceNodes)
+			AdjacencyOffsets[(size_t)nNodeIndex + 1]++;
+		for (nfUint32 nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++)
+			AdjacencyOffsets[(size_t)nNodeIndex + 1] += AdjacencyOffsets[nNodeIndex];
+
+		std::vector<nfUint32> RemainingFaces(nNodeCount, 0);
+		std::vector<nfUint32> AdjacentFaces(FaceNodes.size());
+		for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++) {
+			for (nfUint32 j = 0; j < 3; j++) {
+				nfUint32 nNodeIndex = FaceNodes[(size_t)nIndex * 3 + j];
+				AdjacentFaces[AdjacencyOffsets[nNodeIndex] + RemainingFaces[nNodeIndex]] = nIndex;
+				RemainingFaces[nNodeIndex]++;
+			}
+		}
+
+		std::vector<nfFloat> NodeScores(nNodeCount);
+		for (nfUint32 nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++)
+			NodeScores[nNodeIndex] = fnVertexScore(-1, RemainingFaces[nNodeIndex]);
+
+		std::vector<nfFloat> FaceScores(nFaceCount);
+		for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++) {
+			const nfUint32 * pNodes = &FaceNodes[(size_t)nIndex * 3];
+			FaceScores[nIndex] = NodeScores[pNodes[0]] + NodeScores[pNodes[1]] + NodeScores[pNodes[2]];
+		}
+
+		std::vector<nfBool> FaceEmitted(nFaceCount, false);
+		std::vector<nfUint32> Cache;
+		std::vector<nfUint32> NewCache;
+		Cache.reserve(NMR_MESHLAYOUT_VERTEXCACHESIZE + 3);
+		NewCache.reserve(NMR_MESHLAYOUT_VERTEXCACHESIZE + 3);
+
+		std::vector<nfUint32> NewFaceOrder;
+		NewFaceOrder.reserve(nFaceCount);
+
+		nfUint32 nInputCursor = 0;
+		nfInt64 nBestFace = -1;
+
+		while (NewFaceOrder.size() < nFaceCount) {
+			// If the cache holds no candidate, continue with the next face of the input order,
+			// which keeps the locality of a preceding spatial sort.
+			if (nBestFace < 0) {
+				while (FaceEmitted[nInputCursor])
+					nInputCursor++;
+				nBestFace = nInputCursor;
+			}
+
+			nfUint32 nFace = (nfUint32)nBestFace;
+			FaceEmitted[nFace] = true;
+			NewFaceOrder.push_back(FaceOrder[nFace]);
+
+			// Remove the face from the adjacency of its nodes
+			const nfUint32 * pNodes = &FaceNodes[(size_t)nFace * 3];
+			for (nfUint32 j = 0; j < 3; j++) {
+				nfUint32 nNodeIndex = pNodes[j];
+				nfUint32 * pAdjacent = &AdjacentFaces[AdjacencyOffsets[nNodeIndex]];
+				nfUint32 nRemaining = RemainingFaces[nNodeIndex];
+				for (nfUint32 k = 0; k < nRemaining; k++) {
+					if (pAdjacent[k] == nFace) {
+						std::swap(pAdjacent[k], pAdjacent[nRemaining - 1]);
+						break;
+					}
+				}
+				RemainingFaces[nNodeIndex]--;
+			}
+
+			// Move the nodes of the face to the front of the LRU cache
+			NewCache.clear();
+			NewCache.insert(NewCache.end(), pNodes, pNodes + 3);
+			for (nfUint32 nNodeIndex : Cache) {
+				if ((nNodeIndex != pNodes[0]) && (nNodeIndex != pNodes[1]) && (nNodeIndex != pNodes[2]))
+					NewCache.push_back(nNodeIndex);
+			}
+			std::swap(Cache, NewCache);
+
+			// Update the scores of all touched nodes and their remaining faces
+			for (nfUint32 nPosition = 0; nPosition < (nfUint32)Cache.size(); nPosition++) {
+				nfUint32 nNodeIndex = Cache[nPosition];
+				nfInt32 nCachePosition = (nPosition < NMR_MESHLAYOUT_VERTEXCACHESIZE) ? (nfInt32)nPosition : -1;
+
+				nfFloat fNewScore = fnVertexScore(nCachePosition, RemainingFaces[nNodeIndex]);
+				nfFloat fDelta = fNewScore - NodeScores[nNodeIndex];
+				NodeScores[nNodeIndex] = fNewScore;
+
+				const nfUint32 * pAdjacent = &AdjacentFaces[AdjacencyOffsets[nNodeIndex]];
+				for (nfUint32 k = 0; k < RemainingFaces[nNodeIndex]; k++)
+					FaceScores[pAdjacent[k]] += fDelta;
+			}
+
+			if (Cache.size() > NMR_MESHLAYOUT_VERTEXCACHESIZE)
+				Cache.resize(NMR_MESHLAYOUT_VERTEXCACHESIZE);
+
+			// The next face is the best scored face touching the cache
+			nBestFace = -1;
+			nfFloat fBestScore = -1.0f;
+			for (nfUint32 nNodeIndex : Cache) {
+				const nfUint32 * pAdjacent = &AdjacentFaces[AdjacencyOffsets[nNodeIndex]];
+				for (nfUint32 k = 0; k < RemainingFaces[nNodeIndex]; k++) {
+					if (FaceScores[pAdjacent[k]] > fBestScore) {
+						fBestScore = FaceScores[pAdjacent[k]];
+						nBestFace = pAdjacent[k];
+					}
+				}
+			}
+		}
+
+		FaceOrder.swap(NewFaceOrder);
+	}
+
+	void CMeshLayoutOptimizer::applyFaceOrder(_In_ CMesh * pMesh, _In_ const std::vector<nfUint32> & FaceOrder)
+	{
+		nfUint32 nFaceCount = (nfUint32)FaceOrder.size();
+
+		std::vector<MESHFACE> Faces(nFaceCount);
+		for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++)
+			Faces[nIndex] = *pMesh->getFace(FaceOrder[nIndex]);
+		for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++) {
+			MESHFACE * pFace = pMesh->getFace(nIndex);
+			for (nfUint32 j = 0; j < 3; j++)
+				pFace->m_nodeindices[j] = Faces[nIndex].m_nodeindices[j];
+		}
+
+		CMeshInformationHandler * pInformationHandler = pMesh->getMeshInformationHandler();
+		if (pInformationHandler == nullptr)
+			return;
+
+		nfUint32 nInformationCount = pInformationHandler->getInformationCount();
+		for (nfUint32 nInformationIndex = 0; nInformationIndex < nInformationCount; nInformationIndex++) {
+			CMeshInformation * pInformation = pInformationHandler->getInformationIndexed(nInformationIndex);
+
+			PMeshInformation pReordered = pInformation->cloneInstance(nFaceCount);
+			for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++)
+				pReordered->cloneFaceInfosFrom(nIndex, pInformation, FaceOrder[nIndex]);
+			for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++)
+				pInformation->cloneFaceInfosFrom(nIndex, pReordered.get(), nIndex);
+		}
+	}
+
+	void CMeshLayoutOptimizer::renumberNodes(_In_ CMesh * pMesh)
+	{
+		nfUint32 nNodeCount = pMesh->getNodeCount();
+		nfUint32 nFaceCount = pMesh->getFaceCount();
+
+		// Assign new indices in order of first use; nodes that are not used by any face
+		// (e.g. beam lattice nodes) keep their relative order at the end.
+		std::vector<nfInt32> NodeMap(nNodeCount, -1);
+		nfInt32 nNextIndex = 0;
+		for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++) {
+			MESHFACE * pFace = pMesh->getFace(nIndex);
+			for (nfUint32 j = 0; j < 3; j++) {
+				nfInt32 & nNewIndex = NodeMap[pFace->m_nodeindices[j]];
+				if (nNewIndex < 0)
+					nNewIndex = nNextIndex++;
+			}
+		}
+		for (nfUint32 nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++) {
+			if (NodeMap[nNodeIndex] < 0)
+				NodeMap[nNodeIndex] = nNextIndex++;
+		}
+
+		std::vector<NVEC3> Positions(nNodeCount);
+		for (nfUint32 nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++)
+			Positions[NodeMap[nNodeIndex]] = pMesh->getNode(nNodeIndex)->m_position;
+		for (nfUint32 nNodeIndex = 0; nNodeIndex < nNodeCount; nNodeIndex++)
+			pMesh->getNode(nNodeIndex)->m_position = Positions[nNodeIndex];
+
+		CMeshInformationHandler * pInformationHandler = pMesh->getMeshInformationHandler();
+		for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++) {
+			MESHFACE * pFace = pMesh->getFace(nIndex);
+			nfInt32 nNodes[3];
+			for (nfUint32 j = 0; j < 3; j++)
+				nNodes[j] = NodeMap[pFace->m_nodeindices[j]];
+
+			// Rotate the face to start at its lowest node, which keeps the orientation
+			nfUint32 nFirst = 0;
+			if (nNodes[1] < nNodes[nFirst])
+				nFirst = 1;
+			if (nNodes[2] < nNodes[nFirst])
+				nFirst = 2;
+
+			for (nfUint32 j = 0; j < 3; j++)
+				pFace->m_nodeindices[j] = nNodes[(nFirst + j) % 3];
+
+			if ((nFirst != 0) && (pInformationHandler != nullptr))
+				pInformationHandler->permuteNodeInformation(nIndex, nFirst, (nFirst + 1) % 3, (nFirst + 2) % 3);
+		}
+
+		nfUint32 nBeamCount = pMesh->getBeamCount();
+		nfInt32 * pBeamNodeIndices = pMesh->getBeamStore().getNodeIndices();
+		for (nfUint32 nIndex = 0; nIndex < nBeamCount * 2; nIndex++)
+			pBeamNodeIndices[nIndex] = NodeMap[pBeamNodeIndices[nIndex]];
+
+		nfUint32 nBallCount = pMesh->getBallCount();
+		for (nfUint32 nIndex = 0; nIndex < nBallCount; nIndex++) {
+			MESHBALL * pBall = pMesh->getBall(nIndex);
+			pBall->m_nodeindex = NodeMap[pBall->m_nodeindex];
+		}
+
+		if (nBeamCount > 0)
+			pMesh->scanOccupiedNodes();
+	}
+
+}
@@ -0,0 +1,373 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshMerger.cpp implements the merging of transformed mesh instances into one mesh.
+
+--*/
+
+#include "Common/Mesh/NMR_MeshMerger.h"
+#include "Common/Mesh/NMR_Mesh.h"
+#include "Common/Math/NMR_Matrix.h"
+#include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
+#include "Common/NMR_Exception.h"
+#include "Common/NMR_ParallelFor.h"
+#include "Common/NMR_Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+
+namespace NMR {
+
+	CMeshMerger::CMeshMerger()
+		: m_nThreadCount(1), m_bRemapResourceIDs(false)
+	{
+	}
+
+	void CMeshMerger::addInstance(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix)
+	{
+		if (!pMesh)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		MESHMERGEINSTANCE instance;
+		instance.m_pMesh = pMesh;
+		instance.m_mMatrix = mMatrix;
+		instance.m_nNodeCount = 0;
+		instance.m_nFaceCount = 0;
+		instance.m_nFirstNode = 0;
+		instance.m_nFirstFace = 0;
+		instance.m_bCheckFaces = false;
+		m_Instances.push_back(instance);
+	}
+
+	nfUint32 CMeshMerger::getInstanceCount()
+	{
+		return (nfUint32)m_Instances.size();
+	}
+
+	void CMeshMerger::setThreadCount(_In_ nfUint32 nThreadCount)
+	{
+		m_nThreadCount = nThreadCount;
+	}
+
+	nfUint32 CMeshMerger::getThreadCount()
+	{
+		return m_nThreadCount;
+	}
+
+	void CMeshMerger::setResourceIDMapping(_In_ const std::map<UniqueResourceID, UniqueResourceID> & Mapping)
+	{
+		m_ResourceIDMap.clear();
+		if (!Mapping.empty())
+			m_ResourceIDMap.resize((size_t)Mapping.rbegin()->first + 1, 0);
+		for (auto iIterator = Mapping.begin(); iIterator != Mapping.end(); iIterator++)
+			m_ResourceIDMap[iIterator->first] = iIterator->second;
+		m_bRemapResourceIDs = true;
+	}
+
+	UniqueResourceID CMeshMerger::remapResourceID(_In_ UniqueResourceID nResourceID)
+	{
+		if (nResourceID >= m_ResourceIDMap.size())
+			return 0;
+		return m_ResourceIDMap[nResourceID];
+	}
+
+	// Checks the faces of every distinct mesh once, and the transformed nodes of every instance
+	// against the coordinate limit, using the bounding box of its mesh where possible.
+	void CMeshMerger::checkInstances()
+	{
+		std::map<CMesh *, nfUint32> MeshIndices;
+		std::vector<MESHMERGEINSTANCE *> DistinctInstances;
+		for (auto & instance : m_Instances) {
+			instance.m_bCheckFaces = MeshIndices.insert(std::make_pair(instance.m_pMesh, (nfUint32)DistinctInstances.size())).second;
+			if (instance.m_bCheckFaces)
+				DistinctInstances.push_back(&instance);
+		}
+
+		std::vector<NOUTBOX3> Boxes(DistinctInstances.size());
+		fnParallelFor(m_nThreadCount, DistinctInstances.size(), [&](nfUint64 nJob) {
+			const MESHMERGEINSTANCE & instance = *DistinctInstances[(size_t)nJob];
+			CMesh * pMesh = instance.m_pMesh;
+
+			NOUTBOX3 & box = Boxes[(size_t)nJob];
+			for (nfUint32 j = 0; j < 3; j++) {
+				box.m_min.m_fields[j] = 0.0f;
+				box.m_max.m_fields[j] = 0.0f;
+			}
+			for (nfUint32 nIndex = 0; nIndex < instance.m_nNodeCount; nIndex++) {
+				const NVEC3 & vPosition = pMesh->getNode(nIndex)->m_position;
+				for (nfUint32 j = 0; j < 3; j++) {
+					if ((nIndex == 0) || (vPosition.m_fields[j] < box.m_min.m_fields[j]))
+						box.m_min.m_fields[j] = vPosition.m_fields[j];
+					if ((nIndex == 0) || (vPosition.m_fields[j] > box.m_max.m_fields[j]))
+						box.m_max.m_fields[j] = vPosition.m_fields[j];
+				}
+			}
+
+			nfInt32 nNodeCount = (nfInt32)instance.m_nNodeCount;
+			for (nfUint32 nIndex = 0; nIndex < instance.m_nFaceCount; nIndex++) {
+				const MESHFACE * pFace = pMesh->getFace(nIndex);
+				for (nfUint32 j = 0; j < 3; j++)
+					if ((pFace->m_nodeindices[j] < 0) || (pFace->m_nodeindices[j] >= nNodeCount))
+						throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
+				if ((pFace->m_nodeindices[0] == pFace->m_nodeindices[1]) || (pFace->m_nodeindices[0] == pFace->m_nodeindices[2]) ||
+					(pFace->m_nodeindices[1] == pFace->m_nodeindices[2]))
+					throw CNMRException(NMR_ERROR_DUPLICATENODE);
+			}
+		});
+
+		for (auto & instance : m_Instances) {
+			if (instance.m_nNodeCount == 0)
+				continue;
+
+			// The transformed box corners bound all transformed nodes
+			const NOUTBOX3 & box = Boxes[MeshIndices[instance.m_pMesh]];
+			nfDouble dMaxCoordinate = 0.0;
+			for (nfUint32 nCorner = 0; nCorner < 8; nCorner++) {
+				nfDouble vCorner[3];
+				for (nfUint32 j = 0; j < 3; j++)
+					vCorner[j] = (nCorner & (1 << j)) ? box.m_max.m_fields[j] : box.m_min.m_fields[j];
+				for (nfUint32 i = 0; i < 3; i++) {
+					const nfFloat * pRow = instance.m_mMatrix.m_fields[i];
+					nfDouble dValue = pRow[0] * vCorner[0] + pRow[1] * vCorner[1] + pRow[2] * vCorner[2] + pRow[3];
+					dMaxCoordinate = std::max(dMaxCoordinate, std::fabs(dValue));
+				}
+			}
+			if (dMaxCoordinate < NMR_MESH_MAXCOORDINATE * 0.999)
+				continue;
+
+			for (nfUint32 nIndex = 0; nIndex < instance.m_nNodeCount; nIndex++) {
+				NVEC3 vPosition = fnMATRIX3_apply(instance.m_mMatrix, instance.m_pMesh->getNode(nIndex)->m_position);
+				for (nfUint32 j = 0; j < 3; j++)
+					if (std::fabs(vPosition.m_fields[j]) > NMR_MESH_MAXCOORDINATE)
+						throw CNMRException(NMR_ERROR_INVALIDCOORDINATES);
+			}
+		}
+	}
+
+	void CMeshMerger::copyNodes(_In_ CMesh * pTarget, _In_ const MESHMERGEINSTANCE & instance, _In_ nfUint32 nStart, _In_ nfUint32 nCount)
+	{
+		// Same arithmetic as fnMATRIX3_apply, with the matrix kept in locals
+		const NMATRIX3 & mMatrix = instance.m_mMatrix;
+		const nfFloat m00 = mMatrix.m_fields[0][0], m01 = mMatrix.m_fields[0][1], m02 = mMatrix.m_fields[0][2], m03 = mMatrix.m_fields[0][3];
+		const nfFloat m10 = mMatrix.m_fields[1][0], m11 = mMatrix.m_fields[1][1], m12 = mMatrix.m_fields[1][2], m13 = mMatrix.m_fields[1][3];
+		const nfFloat m20 = mMatrix.m_fields[2][0], m21 = mMatrix.m_fields[2][1], m22 = mMatrix.m_fields[2][2], m23 = mMatrix.m_fields[2][3];
+
+		for (nfUint32 nIndex = nStart; nIndex < nStart + nCount; nIndex++) {
+			const NVEC3 & vSource = instance.m_pMesh->getNode(nIndex)->m_position;
+			nfFloat fX = vSource.m_fields[0], fY = vSource.m_fields[1], fZ = vSource.m_fields[2];
+
+			nfUint32 nNodeIndex = instance.m_nFirstNode + nIndex;
+			MESHNODE * pNode = pTarget->getNode(nNodeIndex);
+			pNode->m_index = (nfInt32)nNodeIndex;
+			pNode->m_position.m_fields[0] = m00 * fX + m01 * fY + m02 * fZ + m03;
+			pNode->m_position.m_fields[1] = m10 * fX + m11 * fY + m12 * fZ + m13;
+			pNode->m_position.m_fields[2] = m20 * fX + m21 * fY + m22 * fZ + m23;
+		}
+	}
+
+	void CMeshMerger::copyFaces(_In_ CMesh * pTarget, _In_ const MESHMERGEINSTANCE & instance, _In_ nfUint32 nStart, _In_ nfUint32 nCount)
+	{
+		// Pairs of target and source information of the same type; the source may be missing
+		std::vector<std::pair<CMeshInformation *, CMeshInformation *>> Informations;
+		CMeshInformationHandler * pTargetHandler = pTarget->getMeshInformationHandler();
+		CMeshInformationHandler * pSourceHandler = instance.m_pMesh->getMeshInformationHandler();
+		if (pTargetHandler) {
+			for (nfInt32 eType = emiAbstract; eType < emiLastType; eType++) {
+				CMeshInformation * pInformation = pTargetHandler->getInformationByType(0, (eMeshInformationType)eType);
+				if (pInformation) {
+					CMeshInformation * pSourceInformation = pSourceHandler ? pSourceHandler->getInformationByType(0, (eMeshInformationType)eType) : nullptr;
+					Informations.push_back(std::make_pair(pInformation, pSourceInformation));
+				}
+			}
+		}
+
+		nfInt32 nNodeOffset = (nfInt32)instance.m_nFirstNode;
+		nfBool bUnmappedResourceID = false;
+		for (nfUint32 nIndex = nStart; nIndex < nStart + nCount; nIndex++) {
+			const MESHFACE * pSource = instance.m_pMesh->getFace(nIndex);
+
+			nfUint32 nFaceIndex = instance.m_nFirstFace + nIndex;
+			MESHFACE * pFace = pTarget->getFace(nFaceIndex);
+			pFace->m_index = (nfInt32)nFaceIndex;
+			for (nfUint32 j = 0; j < 3; j++)
+				pFace->m_nodeindices[j] = pSource->m_nodeindices[j] + nNodeOffset;
+
+			for (auto & information : Informations) {
+				if (information.second) {
+					information.first->cloneFaceInfosFrom(nFaceIndex, information.second, nIndex);
+					if (m_bRemapResourceIDs && (information.first->getType() == emiProperties)) {
+						MESHINFORMATION_PROPERTIES * pData = (MESHINFORMATION_PROPERTIES *)information.first->getFaceData(nFaceIndex);
+						if (pData->m_nUniqueResourceID != 0) {
+							UniqueResourceID nNewResourceID = remapResourceID(pData->m_nUniqueResourceID);
+							if (nNewResourceID != 0)
+								pData->m_nUniqueResourceID = nNewResourceID;
+							else
+								bUnmappedResourceID = true;
+						}
+					}
+				}
+				else {
+					information.first->invalidateFace(information.first->getFaceData(nFaceIndex));
+				}
+			}
+		}
+
+		if (bUnmappedResourceID)
+			throw CNMRException(NMR_ERROR_UNKNOWNMODELRESOURCE);
+	}
+
+	void CMeshMerger::copyBeamsAndBalls(_In_ CMesh * pTarget, _In_ const MESHMERGEINSTANCE & instance)
+	{
+		CMesh * pMesh = instance.m_pMesh;
+		nfInt32 nNodeCount = (nfInt32)instance.m_nNodeCount;
+		nfInt32 nNodeOffset = (nfInt32)instance.m_nFirstNode;
+
+		nfUint32 nBeamCount = pMesh->getBeamCount();
+		if (nBeamCount > 0) {
+			// Copy the beams in blocks to bound the size of the temporary arrays
+			CMeshBeamStore & otherBeams = pMesh->getBeamStore();
+			const nfInt32 * pOtherNodeIndices = otherBeams.getNodeIndices();
+			nfUint32 nBlockSize = std::min(nBeamCount, (nfUint32)NMR_MESH_BEAMCOPYBLOCKSIZE);
+			std::vector<nfInt32> NodeIndices(nBlockSize * 2);
+			std::vector<nfDouble> Radii(nBlockSize * 2);
+			std::vector<nfInt32> CapModes(nBlockSize * 2);
+
+			for (nfUint32 nStart = 0; nStart < nBeamCount; nStart += nBlockSize) {
+				nfUint32 nCount = std::min(nBlockSize, nBeamCount - nStart);
+				for (nfUint32 nValue = 0; nValue < nCount * 2; nValue++) {
+					nfInt32 nNodeIndex = pOtherNodeIndices[nStart * 2 + nValue];
+					if ((nNodeIndex < 0) || (nNodeIndex >= nNodeCount))
+						throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
+					NodeIndices[nValue] = nNodeIndex + nNodeOffset;
+				}
+				otherBeams.getRadii(nStart, nCount, Radii.data());
+				otherBeams.getCapModes(nStart, nCount, CapModes.data());
+				pTarget->addBeams(nCount, NodeIndices.data(), Radii.data(), CapModes.data());
+			}
+		}
+
+		nfUint32 nBallCount = pMesh->getBallCount();
+		for (nfUint32 nIndex = 0; nIndex < nBallCount; nIndex++) {
+			MESHBALL * pBall = pMesh->getBall(nIndex);
+			if ((pBall->m_nodeindex < 0) || (pBall->m_nodeindex >= nNodeCount))
+				throw CNMRException(NMR_ERROR_INVALIDNODEINDEX);
+			pTarget->addBall(pTarget->getNode(pBall->m_nodeindex + nNodeOffset), pBall->m_radius);
+		}
+	}
+
+	void CMeshMerger::merge(_In_ CMesh * pTarget)
+	{
+		NMR_TRACE_SCOPE("CMeshMerger::merge");
+
+		if (!pTarget)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		// Counting pass. Faces, beams and balls of meshes without nodes are ignored.
+		nfUint64 nNodeCount = pTarget->getNodeCount();
+		nfUint64 nFaceCount = pTarget->getFaceCount();
+		for (auto & instance : m_Instances) {
+			instance.m_nNodeCount = instance.m_pMesh->getNodeCount();
+			instance.m_nFaceCount = (instance.m_nNodeCount > 0) ? instance.m_pMesh->getFaceCount() : 0;
+			instance.m_nFirstNode = (nfUint32)nNodeCount;
+			instance.m_nFirstFace = (nfUint32)nFaceCount;
+			nNodeCount += instance.m_nNodeCount;
+			nFaceCount += instance.m_nFaceCount;
+			if (nNodeCount > NMR_MESH_MAXNODECOUNT)
+				throw CNMRException(NMR_ERROR_TOOMANYNODES);
+			if (nFaceCount > NMR_MESH_MAXFACECOUNT)
+				throw CNMRException(NMR_ERROR_TOOMANYFACES);
+		}
+
+		checkInstances();
+
+		for (auto & instance : m_Instances) {
+			CMeshInformationHandler * pOtherHandler = instance.m_pMesh->getMeshInformationHandler();
+			if (pOtherHandler)
+				pTarget->createMeshInformationHandler()->addInfoTableFrom(pOtherHandler, pTarget->getFaceCount());
+		}
+		for (auto & instance : m_Instances) {
+			CMeshInformationHandler * pOtherHandler = instance.m_pMesh->getMeshInformationHandler();
+			if (pOtherHandler && (instance.m_nFaceCount > 0))
+				pTarget->getMeshInformationHandler()->cloneDefaultInfosFrom(pOtherHandler);
+		}
+
+		pTarget->allocNodes((nfUint32)(nNodeCount - pTarget->getNodeCount()));
+		pTarget->allocFaces((nfUint32)(nFaceCount - pTarget->getFaceCount()));
+
+		std::vector<MESHMERGEJOB> Jobs;
+		for (nfUint32 nInstance = 0; nInstance < (nfUint32)m_Instances.size(); nInstance++) {
+			const MESHMERGEINSTANCE & instance = m_Instances[nInstance];
+			for (nfUint32 nStart = 0; nStart < instance.m_nNodeCount; nStart += NMR_MESHMERGER_CHUNKSIZE)
+				Jobs.push_back({ nInstance, nStart, std::min((nfUint32)NMR_MESHMERGER_CHUNKSIZE, instance.m_nNodeCount - nStart), false });
+			for (nfUint32 nStart = 0; nStart < instance.m_nFaceCount; nStart += NMR_MESHMERGER_CHUNKSIZE)
+				Jobs.push_back({ nInstance, nStart, std::min((nfUint32)NMR_MESHMERGER_CHUNKSIZE, instance.m_nFaceCount - nStart), true });
+		}
+
+		// All chunks are copied even if resource IDs are missing in the mapping, so that the
+		// target is complete when the error is reported
+		std::atomic<nfBool> bUnmappedResourceID(false);
+		fnParallelFor(m_nThreadCount, Jobs.size(), [&](nfUint64 nJob) {
+			const MESHMERGEJOB & job = Jobs[(size_t)nJob];
+			const MESHMERGEINSTANCE & instance = m_Instances[job.m_nInstance];
+			if (!job.m_bFaces) {
+				copyNodes(pTarget, instance, job.m_nStart, job.m_nCount);
+				return;
+			}
+			try {
+				copyFaces(pTarget, instance, job.m_nStart, job.m_nCount);
+			}
+			catch (CNMRException & e) {
+				if (e.getErrorCode() != NMR_ERROR_UNKNOWNMODELRESOURCE)
+					throw;
+				bUnmappedResourceID = true;
+			}
+		});
+
+		for (auto & instance : m_Instances)
+			if (instance.m_nNodeCount > 0)
+				copyBeamsAndBalls(pTarget, instance);
+
+		if (m_bRemapResourceIDs && pTarget->getMeshInformationHandler()) {
+			CMeshInformation * pProperties = pTarget->getMeshInformationHandler()->getInformationByType(0, emiProperties);
+			MESHINFORMATION_PROPERTIES * pDefaultData = pProperties ? (MESHINFORMATION_PROPERTIES *)pProperties->getDefaultData() : nullptr;
+			if (pDefaultData && (pDefaultData->m_nUniqueResourceID != 0)) {
+				UniqueResourceID nNewResourceID = remapResourceID(pDefaultData->m_nUniqueResourceID);
+				if (nNewResourceID != 0)
+					pDefaultData->m_nUniqueResourceID = nNewResourceID;
+				else
+					bUnmappedResourceID = true;
+			}
+		}
+
+		if (bUnmappedResourceID)
+			throw CNMRException(NMR_ERROR_UNKNOWNMODELRESOURCE);
+	}
+
+}
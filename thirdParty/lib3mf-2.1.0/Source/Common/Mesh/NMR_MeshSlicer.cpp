@@ -0,0 +1,351 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_MeshSlicer.cpp implements the intersection of a mesh with planes of constant Z.
+
+--*/
+
+#include "Common/Mesh/NMR_MeshSlicer.h"
+#include "Common/Mesh/NMR_Mesh.h"
+#include "Common/NMR_Exception.h"
+#include "Common/NMR_ParallelFor.h"
+
+#include <algorithm>
+
+#define NMR_MESHSLICER_FACECHUNKSIZE 65536
+#define NMR_MESHSLICER_JOBSPERTHREAD 4
+
+namespace NMR {
+
+	// A face crossing a plane contributes one segment. It starts where the face boundary
+	// goes down through the plane and ends where it goes up, which orients the contours of
+	// outward facing faces counterclockwise around the material.
+	typedef struct {
+		nfUint64 m_nStartEdge;
+		nfUint64 m_nEndEdge;
+		NVEC2 m_vStart;
+		NVEC2 m_vEnd;
+	} MESHSLICERSEGMENT;
+
+	// Key of the undirected edge between two nodes
+	static nfUint64 fnMeshSlicerEdgeKey(_In_ nfInt32 nNode1, _In_ nfInt32 nNode2)
+	{
+		nfUint64 nLow = (nfUint32)std::min(nNode1, nNode2);
+		nfUint64 nHigh = (nfUint32)std::max(nNode1, nNode2);
+		return (nHigh << 32) | nLow;
+	}
+
+	// Always interpolates from the node below to the node above, so that both faces of an edge
+	// compute exactly the same crossing
+	static NVEC2 fnMeshSlicerCrossing(_In_ const NVEC3 & vBelow, _In_ const NVEC3 & vAbove, _In_ nfDouble dZ)
+	{
+		nfDouble dT = (dZ - vBelow.m_values.z) / ((nfDouble)vAbove.m_values.z - vBelow.m_values.z);
+		NVEC2 vCrossing;
+		vCrossing.m_values.x = (nfFloat)(vBelow.m_values.x + (vAbove.m_values.x - (nfDouble)vBelow.m_values.x) * dT);
+		vCrossing.m_values.y = (nfFloat)(vBelow.m_values.y + (vAbove.m_values.y - (nfDouble)vBelow.m_values.y) * dT);
+		return vCrossing;
+	}
+
+	static nfBool fnMeshSlicerSamePoint(_In_ const NVEC2 & vA, _In_ const NVEC2 & vB)
+	{
+		return (vA.m_values.x == vB.m_values.x) && (vA.m_values.y == vB.m_values.y);
+	}
+
+	static void fnMeshSlicerAddPolygon(_In_ CSlice * pSlice, _Inout_ std::vector<NVEC2> & Points, _In_ nfBool bIsClosed)
+	{
+		// Nodes on the plane yield segments of zero length
+		size_t nCount = 0;
+		for (size_t nIndex = 0; nIndex < Points.size(); nIndex++) {
+			if ((nCount == 0) || !fnMeshSlicerSamePoint(Points[nCount - 1], Points[nIndex]))
+				Points[nCount++] = Points[nIndex];
+		}
+		if (bIsClosed && (nCount > 1) && fnMeshSlicerSamePoint(Points[0], Points[nCount - 1]))
+			nCount--;
+		if (nCount < (bIsClosed ? 3u : 2u))
+			return;
+
+		nfUint32 nFirstVertex = pSlice->getVertexCount();
+		nfUint32 nPolygon = pSlice->beginPolygon();
+		for (size_t nIndex = 0; nIndex < nCount; nIndex++)
+			pSlice->addPolygonIndex(nPolygon, pSlice->addVertex(Points[nIndex].m_values.x, Points[nIndex].m_values.y));
+		if (bIsClosed)
+			pSlice->addPolygonIndex(nPolygon, nFirstVertex);
+	}
+
+	// Links the segments of one plane at the edges they share and adds the resulting polygons to pSlice.
+	// Open chains, which only occur in meshes that are not closed, are traced from their first segment.
+	static void fnMeshSlicerLinkSegments(_In_ const std::vector<MESHSLICERSEGMENT> & Segments, _In_ CSlice * pSlice,
+		_Inout_ std::vector<nfUint32> & Order, _Inout_ std::vector<nfUint64> & EndEdges, _Inout_ std::vector<nfBool> & Used, _Inout_ std::vector<NVEC2> & Points)
+	{
+		nfUint32 nSegmentCount = (nfUint32)Segments.size();
+
+		// Sorting by both edges makes the result independent of the order in which faces were visited
+		Order.resize(nSegmentCount);
+		for (nfUint32 nIndex = 0; nIndex < nSegmentCount; nIndex++)
+			Order[nIndex] = nIndex;
+		std::sort(Order.begin(), Order.end(), [&](nfUint32 nA, nfUint32 nB) {
+			if (Segments[nA].m_nStartEdge != Segments[nB].m_nStartEdge)
+				return Segments[nA].m_nStartEdge < Segments[nB].m_nStartEdge;
+			return Segments[nA].m_nEndEdge < Segments[nB].m_nEndEdge;
+		});
+
+		EndEdges.resize(nSegmentCount);
+		for (nfUint32 nIndex = 0; nIndex < nSegmentCount; nIndex++)
+			EndEdges[nIndex] = Segments[nIndex].m_nEndEdge;
+		std::sort(EndEdges.begin(), EndEdges.end());
+
+		Used.assign(nSegmentCount, false);
+
+		auto fnFindSuccessor = [&](nfUint64 nEdge) -> nfUint32 {
+			auto iOrder = std::lower_bound(Order.begin(), Order.end(), nEdge, [&](nfUint32 nSegment, nfUint64 nKey) {
+				return Segments[nSegment].m_nStartEdge < nKey;
+			});
+			for (; (iOrder != Order.end()) && (Segments[*iOrder].m_nStartEdge == nEdge); iOrder++) {
+				if (!Used[*iOrder])
+					return *iOrder;
+			}
+			return nSegmentCount;
+		};
+
+		auto fnTrace = [&](nfUint32 nFirstSegment) {
+			Points.clear();
+			nfUint64 nFirstEdge = Segments[nFirstSegment].m_nStartEdge;
+			nfUint32 nSegment = nFirstSegment;
+			nfBool bIsClosed = false;
+			while (true) {
+				Used[nSegment] = true;
+				Points.push_back(Segments[nSegment].m_vStart);
+
+				nfUint64 nEdge = Segments[nSegment].m_nEndEdge;
+				if (nEdge == nFirstEdge) {
+					bIsClosed = true;
+					break;
+				}
+				nfUint32 nNextSegment = fnFindSuccessor(nEdge);
+				if (nNextSegment == nSegmentCount) {
+					Points.push_back(Segments[nSegment].m_vEnd);
+					break;
+				}
+				nSegment = nNextSegment;
+			}
+			fnMeshSlicerAddPolygon(pSlice, Points, bIsClosed);
+		};
+
+		for (nfUint32 nSegment : Order) {
+			if (!Used[nSegment] && !std::binary_search(EndEdges.begin(), EndEdges.end(), Segments[nSegment].m_nStartEdge))
+				fnTrace(nSegment);
+		}
+		for (nfUint32 nSegment : Order) {
+			if (!Used[nSegment])
+				fnTrace(nSegment);
+		}
+	}
+
+	CMeshSlicer::CMeshSlicer(_In_ CMesh * pMesh)
+		: m_pMesh(pMesh), m_fZMin(0.0f), m_fZMax(0.0f)
+	{
+		if (!pMesh)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		nfUint32 nFaceCount = pMesh->getFaceCount();
+		for (nfUint32 nFace = 0; nFace < nFaceCount; nFace++) {
+			MESHFACE * pFace = pMesh->getFace(nFace);
+			for (nfUint32 j = 0; j < 3; j++) {
+				nfFloat fZ = pMesh->getNode(pFace->m_nodeindices[j])->m_position.m_values.z;
+				if ((nFace == 0) && (j == 0)) {
+					m_fZMin = fZ;
+					m_fZMax = fZ;
+				}
+				m_fZMin = std::min(m_fZMin, fZ);
+				m_fZMax = std::max(m_fZMax, fZ);
+			}
+		}
+	}
+
+	nfFloat CMeshSlicer::getZMin()
+	{
+		return m_fZMin;
+	}
+
+	nfFloat CMeshSlicer::getZMax()
+	{
+		return m_fZMax;
+	}
+
+	void CMeshSlicer::slice(_In_ const std::vector<nfDouble> & PlaneZ, _In_ const std::vector<PSlice> & Slices, _In_ nfUint32 nThreadCount)
+	{
+		if (PlaneZ.size() != Slices.size())
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		for (size_t nLayer = 0; nLayer < PlaneZ.size(); nLayer++) {
+			if (!Slices[nLayer])
+				throw CNMRException(NMR_ERROR_INVALIDPARAM);
+			if ((nLayer > 0) && !(PlaneZ[nLayer - 1] < PlaneZ[nLayer]))
+				throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		}
+
+		nfUint32 nFaceCount = m_pMesh->getFaceCount();
+		nfUint32 nLayerCount = (nfUint32)PlaneZ.size();
+		if ((nFaceCount == 0) || (nLayerCount == 0))
+			return;
+
+		nThreadCount = std::max(nThreadCount, 1u);
+		nfUint32 nJobCount = std::min(nLayerCount, nThreadCount * NMR_MESHSLICER_JOBSPERTHREAD);
+		nfUint32 nLayersPerJob = (nLayerCount + nJobCount - 1) / nJobCount;
+		nJobCount = (nLayerCount + nLayersPerJob - 1) / nLayersPerJob;
+		nfUint64 nChunkCount = ((nfUint64)nFaceCount + NMR_MESHSLICER_FACECHUNKSIZE - 1) / NMR_MESHSLICER_FACECHUNKSIZE;
+
+		// Face f crosses the planes [FirstLayers[f], EndLayers[f]), i.e. all planes with zmin < z <= zmax
+		std::vector<nfUint32> FirstLayers(nFaceCount);
+		std::vector<nfUint32> EndLayers(nFaceCount);
+		std::vector<nfUint64> ChunkJobOffsets((size_t)(nChunkCount * nJobCount), 0);
+		fnParallelFor(nThreadCount, nChunkCount, [&](nfUint64 nChunk) {
+			nfUint32 nBegin = (nfUint32)(nChunk * NMR_MESHSLICER_FACECHUNKSIZE);
+			nfUint32 nEnd = (nfUint32)std::min((nfUint64)nFaceCount, (nChunk + 1) * NMR_MESHSLICER_FACECHUNKSIZE);
+			nfUint64 * pJobCounts = &ChunkJobOffsets[(size_t)(nChunk * nJobCount)];
+			for (nfUint32 nFace = nBegin; nFace < nEnd; nFace++) {
+				MESHFACE * pFace = m_pMesh->getFace(nFace);
+				FirstLayers[nFace] = 0;
+				EndLayers[nFace] = 0;
+				if ((pFace->m_nodeindices[0] == pFace->m_nodeindices[1]) || (pFace->m_nodeindices[1] == pFace->m_nodeindices[2]) ||
+					(pFace->m_nodeindices[2] == pFace->m_nodeindices[0]))
+					continue;
+
+				nfFloat fZ0 = m_pMesh->getNode(pFace->m_nodeindices[0])->m_position.m_values.z;
+				nfFloat fZ1 = m_pMesh->getNode(pFace->m_nodeindices[1])->m_position.m_values.z;
+				nfFloat fZ2 = m_pMesh->getNode(pFace->m_nodeindices[2])->m_position.m_values.z;
+				nfDouble dZMin = std::min(fZ0, std::min(fZ1, fZ2));
+				nfDouble dZMax = std::max(fZ0, std::max(fZ1, fZ2));
+				nfUint32 nFirstLayer = (nfUint32)(std::upper_bound(PlaneZ.begin(), PlaneZ.end(), dZMin) - PlaneZ.begin());
+				nfUint32 nEndLayer = (nfUint32)(std::upper_bound(PlaneZ.begin() + nFirstLayer, PlaneZ.end(), dZMax) - PlaneZ.begin());
+				if (nFirstLayer >= nEndLayer)
+					continue;
+
+				FirstLayers[nFace] = nFirstLayer;
+				EndLayers[nFace] = nEndLayer;
+				for (nfUint32 nJob = nFirstLayer / nLayersPerJob; nJob <= (nEndLayer - 1) / nLayersPerJob; nJob++)
+					pJobCounts[nJob]++;
+			}
+		});
+
+		// Each job gets the faces crossing any of its planes, in face order
+		std::vector<nfUint64> JobOffsets(nJobCount + 1);
+		nfUint64 nOffset = 0;
+		for (nfUint32 nJob = 0; nJob < nJobCount; nJob++) {
+			JobOffsets[nJob] = nOffset;
+			for (nfUint64 nChunk = 0; nChunk < nChunkCount; nChunk++) {
+				nfUint64 & nChunkJobOffset = ChunkJobOffsets[(size_t)(nChunk * nJobCount + nJob)];
+				nfUint64 nCount = nChunkJobOffset;
+				nChunkJobOffset = nOffset;
+				nOffset += nCount;
+			}
+		}
+		JobOffsets[nJobCount] = nOffset;
+
+		std::vector<nfUint32> JobFaces((size_t)nOffset);
+		fnParallelFor(nThreadCount, nChunkCount, [&](nfUint64 nChunk) {
+			nfUint32 nBegin = (nfUint32)(nChunk * NMR_MESHSLICER_FACECHUNKSIZE);
+			nfUint32 nEnd = (nfUint32)std::min((nfUint64)nFaceCount, (nChunk + 1) * NMR_MESHSLICER_FACECHUNKSIZE);
+			nfUint64 * pJobOffsets = &ChunkJobOffsets[(size_t)(nChunk * nJobCount)];
+			for (nfUint32 nFace = nBegin; nFace < nEnd; nFace++) {
+				if (FirstLayers[nFace] >= EndLayers[nFace])
+					continue;
+				for (nfUint32 nJob = FirstLayers[nFace] / nLayersPerJob; nJob <= (EndLayers[nFace] - 1) / nLayersPerJob; nJob++)
+					JobFaces[(size_t)(pJobOffsets[nJob]++)] = nFace;
+			}
+		});
+
+		fnParallelFor(nThreadCount, nJobCount, [&](nfUint64 nJob) {
+			nfUint32 nFirstLayer = (nfUint32)nJob * nLayersPerJob;
+			nfUint32 nEndLayer = std::min(nLayerCount, nFirstLayer + nLayersPerJob);
+			std::vector<nfUint32> Faces(JobFaces.begin() + (size_t)JobOffsets[(size_t)nJob], JobFaces.begin() + (size_t)JobOffsets[(size_t)nJob + 1]);
+			sliceLayers(PlaneZ, nFirstLayer, nEndLayer, Faces, FirstLayers, EndLayers, Slices);
+		});
+	}
+
+	void CMeshSlicer::sliceLayers(_In_ const std::vector<nfDouble> & PlaneZ, _In_ nfUint32 nFirstLayer, _In_ nfUint32 nEndLayer,
+		_In_ const std::vector<nfUint32> & Faces, _In_ const std::vector<nfUint32> & FirstLayers, _In_ const std::vector<nfUint32> & EndLayers,
+		_In_ const std::vector<PSlice> & Slices)
+	{
+		// Counting sort of the faces by the first plane of this job they cross
+		nfUint32 nLayerCount = nEndLayer - nFirstLayer;
+		std::vector<nfUint32> LayerStarts(nLayerCount + 1, 0);
+		for (nfUint32 nFace : Faces)
+			LayerStarts[std::max(FirstLayers[nFace], nFirstLayer) - nFirstLayer + 1]++;
+		for (nfUint32 nLayer = 0; nLayer < nLayerCount; nLayer++)
+			LayerStarts[nLayer + 1] += LayerStarts[nLayer];
+
+		std::vector<nfUint32> SortedFaces(Faces.size());
+		std::vector<nfUint32> Positions(LayerStarts.begin(), LayerStarts.end() - 1);
+		for (nfUint32 nFace : Faces)
+			SortedFaces[Positions[std::max(FirstLayers[nFace], nFirstLayer) - nFirstLayer]++] = nFace;
+
+		std::vector<nfUint32> ActiveFaces;
+		std::vector<MESHSLICERSEGMENT> Segments;
+		std::vector<nfUint32> Order;
+		std::vector<nfUint64> EndEdges;
+		std::vector<nfBool> Used;
+		std::vector<NVEC2> Points;
+
+		for (nfUint32 nLayer = nFirstLayer; nLayer < nEndLayer; nLayer++) {
+			// Sweep: drop the faces below this plane and add the ones starting at it
+			ActiveFaces.erase(std::remove_if(ActiveFaces.begin(), ActiveFaces.end(), [&](nfUint32 nFace) {
+				return EndLayers[nFace] <= nLayer;
+			}), ActiveFaces.end());
+			ActiveFaces.insert(ActiveFaces.end(), SortedFaces.begin() + LayerStarts[nLayer - nFirstLayer], SortedFaces.begin() + LayerStarts[nLayer - nFirstLayer + 1]);
+
+			nfDouble dZ = PlaneZ[nLayer];
+			Segments.resize(ActiveFaces.size());
+			for (size_t nIndex = 0; nIndex < ActiveFaces.size(); nIndex++) {
+				MESHFACE * pFace = m_pMesh->getFace(ActiveFaces[nIndex]);
+				const NVEC3 * pPositions[3];
+				nfBool bBelow[3];
+				for (nfUint32 j = 0; j < 3; j++) {
+					pPositions[j] = &m_pMesh->getNode(pFace->m_nodeindices[j])->m_position;
+					bBelow[j] = pPositions[j]->m_values.z < dZ;
+				}
+
+				// Every face of the sweep has exactly one edge going down and one going up through the plane
+				MESHSLICERSEGMENT & Segment = Segments[nIndex];
+				for (nfUint32 j = 0; j < 3; j++) {
+					nfUint32 k = (j + 1) % 3;
+					if (bBelow[j] && !bBelow[k]) {
+						Segment.m_nEndEdge = fnMeshSlicerEdgeKey(pFace->m_nodeindices[j], pFace->m_nodeindices[k]);
+						Segment.m_vEnd = fnMeshSlicerCrossing(*pPositions[j], *pPositions[k], dZ);
+					}
+					else if (!bBelow[j] && bBelow[k]) {
+						Segment.m_nStartEdge = fnMeshSlicerEdgeKey(pFace->m_nodeindices[j], pFace->m_nodeindices[k]);
+						Segment.m_vStart = fnMeshSlicerCrossing(*pPositions[k], *pPositions[j], dZ);
+					}
+				}
+			}
+
+			fnMeshSlicerLinkSegments(Segments, Slices[nLayer].get(), Order, EndEdges, Used, Points);
+		}
+	}
+
+}
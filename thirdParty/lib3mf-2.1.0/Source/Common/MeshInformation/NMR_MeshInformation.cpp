@@ -63,6 +63,11 @@ namespace NMR {
 		return m_pContainer->addFaceData(nNewFaceCount);
 	}
 
+	void CMeshInformation::addFaceDataRange(_In_ nfUint32 nNewFaceCount)
+	{
+		m_pContainer->addFaceDataRange(nNewFaceCount);
+	}
+
 	void CMeshInformation::resetAllFaceInformation()
 	{
 		nfUint32 nCount = m_pContainer->getCurrentFaceCount();
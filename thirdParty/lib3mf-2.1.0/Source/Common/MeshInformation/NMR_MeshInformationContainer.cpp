@@ -35,6 +35,7 @@ information state of a complete mesh structure.
 #include "Common/MeshInformation/NMR_MeshInformationContainer.h" 
 #include "Common/NMR_Exception.h" 
 #include <cmath>
+#include <algorithm>
 
 namespace NMR {
 
@@ -95,6 +96,23 @@ namespace NMR {
 		return result;
 	}
 
+	void CMeshInformationContainer::addFaceDataRange(nfUint32 nNewFaceCount)
+	{
+		if (m_nRecordSize == 0)
+			throw CNMRException(NMR_ERROR_INVALIDRECORDSIZE);
+		if (nNewFaceCount < m_nFaceCount)
+			throw CNMRException(NMR_ERROR_MESHINFORMATIONCOUNTMISMATCH);
+
+		nfUint32 nPageSize = m_nRecordSize * MESHINFORMATIONCOUNTER_BUFFERSIZE;
+		while ((nfUint64)m_DataBlocks.size() * MESHINFORMATIONCOUNTER_BUFFERSIZE < nNewFaceCount) {
+			m_CurrentDataBlock = new MESHINFORMATIONFACEDATA[nPageSize];
+			std::fill(m_CurrentDataBlock, m_CurrentDataBlock + nPageSize, (MESHINFORMATIONFACEDATA)0);
+			m_DataBlocks.push_back(m_CurrentDataBlock);
+		}
+
+		m_nFaceCount = nNewFaceCount;
+	}
+
 	_Ret_notnull_ MESHINFORMATIONFACEDATA * CMeshInformationContainer::getFaceData(nfUint32 nIdx)
 	{
 		if (nIdx >= m_nFaceCount)
@@ -78,6 +78,12 @@ namespace NMR {
 		}
 	}
 
+	void CMeshInformationHandler::addFaceRange(_In_ nfUint32 nNewFaceCount)
+	{
+		for (auto pInformation : m_pInformations)
+			pInformation->addFaceDataRange(nNewFaceCount);
+	}
+
 	CMeshInformation * CMeshInformationHandler::getInformationIndexed(_In_ nfUint32 nIdx)
 	{
 		if (nIdx >= (nfUint32)m_pInformations.size())
@@ -35,10 +35,14 @@ NMR_MeshInformation_Properties.cpp implements the Texture Mesh Information Class
 #include "Common/Math/NMR_Vector.h"
 #include <cmath>
 
+// Marks PropertyIDs that have not been registered
+#define MESHINFORMATION_UNMAPPEDPROPERTYINDEX 0xFFFFFFFF
+
 namespace NMR {
 
 
 	CMeshInformation_PropertyIndexMapping::CMeshInformation_PropertyIndexMapping()
+		: m_nCachedResourceID(0), m_pCachedIndices(nullptr)
 	{
 	}
 
@@ -47,7 +51,13 @@ namespace NMR {
 		if (nUniqueResourceID == 0)
 			throw CNMRException(NMR_ERROR_INVALIDPROPERTYRESOURCEID);
 
-		m_IDMap.insert(std::make_pair(std::make_pair(nUniqueResourceID, nPropertyID), nResourceIndex));
+		std::vector<nfUint32> & Indices = m_IDMap[nUniqueResourceID];
+		if (nPropertyID >= Indices.size())
+			Indices.resize((size_t)nPropertyID + 1, MESHINFORMATION_UNMAPPEDPROPERTYINDEX);
+
+		// the first registration of a PropertyID wins
+		if (Indices[nPropertyID] == MESHINFORMATION_UNMAPPEDPROPERTYINDEX)
+			Indices[nPropertyID] = nResourceIndex;
 
 		return nResourceIndex;
 	}
@@ -58,11 +68,18 @@ namespace NMR {
 		if (nUniqueResourceID == 0)
 			throw CNMRException(NMR_ERROR_INVALIDPROPERTYRESOURCEID);
 
-		auto iIterator = m_IDMap.find(std::make_pair(nUniqueResourceID, nPropertyID));
-		if (iIterator == m_IDMap.end())
+		if ((m_pCachedIndices == nullptr) || (m_nCachedResourceID != nUniqueResourceID)) {
+			auto iIterator = m_IDMap.find(nUniqueResourceID);
+			if (iIterator == m_IDMap.end())
+				throw CNMRException(NMR_ERROR_PROPERTYIDNOTFOUND);
+			m_nCachedResourceID = nUniqueResourceID;
+			m_pCachedIndices = &iIterator->second;
+		}
+
+		if ((nPropertyID >= m_pCachedIndices->size()) || ((*m_pCachedIndices)[nPropertyID] == MESHINFORMATION_UNMAPPEDPROPERTYINDEX))
 			throw CNMRException(NMR_ERROR_PROPERTYIDNOTFOUND);
 
-		return iIterator->second;
+		return (*m_pCachedIndices)[nPropertyID];
 	}
 
 
@@ -119,7 +136,7 @@ namespace NMR {
 	{
 		MESHINFORMATION_PROPERTIES * pTargetDefaultData = (MESHINFORMATION_PROPERTIES*)getDefaultData();
 		if (!pTargetDefaultData) {
-			setDefaultData((MESHINFORMATIONFACEDATA*)new MESHINFORMATION_PROPERTIES);
+			setDefaultData((MESHINFORMATIONFACEDATA*)new MESHINFORMATION_PROPERTIES());
 			pTargetDefaultData = (MESHINFORMATION_PROPERTIES*)getDefaultData();
 		}
 		MESHINFORMATION_PROPERTIES * pSourceDefaultData = (MESHINFORMATION_PROPERTIES*)pOtherInformation->getDefaultData();
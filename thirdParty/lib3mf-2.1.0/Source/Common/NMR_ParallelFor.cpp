@@ -0,0 +1,103 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ParallelFor.cpp implements a minimal worker helper for independent jobs.
+
+--*/
+
+#include "Common/NMR_ParallelFor.h"
+#include "Common/NMR_Exception.h"
+
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace NMR {
+
+	nfUint32 fnGetHardwareThreadCount()
+	{
+		nfUint32 nCount = (nfUint32)std::thread::hardware_concurrency();
+		return (nCount > 0) ? nCount : 1;
+	}
+
+	void fnParallelFor(_In_ nfUint32 nThreadCount, _In_ nfUint64 nJobCount, _In_ const std::function<void(nfUint64)> & fnJob)
+	{
+		if (!fnJob)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		if ((nThreadCount <= 1) || (nJobCount <= 1)) {
+			for (nfUint64 nIndex = 0; nIndex < nJobCount; nIndex++)
+				fnJob(nIndex);
+			return;
+		}
+
+		if ((nfUint64)nThreadCount > nJobCount)
+			nThreadCount = (nfUint32)nJobCount;
+
+		std::atomic<nfUint64> nNextJob(0);
+		std::atomic<bool> bFailed(false);
+		std::vector<std::exception_ptr> Exceptions((size_t)nJobCount);
+
+		auto fnWorker = [&]() {
+			while (!bFailed.load()) {
+				nfUint64 nIndex = nNextJob.fetch_add(1);
+				if (nIndex >= nJobCount)
+					break;
+				try {
+					fnJob(nIndex);
+				}
+				catch (...) {
+					Exceptions[(size_t)nIndex] = std::current_exception();
+					bFailed.store(true);
+				}
+			}
+		};
+
+		// The calling thread acts as one of the workers
+		std::vector<std::thread> Workers;
+		Workers.reserve(nThreadCount - 1);
+		try {
+			for (nfUint32 nThread = 1; nThread < nThreadCount; nThread++)
+				Workers.push_back(std::thread(fnWorker));
+		}
+		catch (...) {
+			// Thread creation failed: continue with the workers we have
+		}
+		fnWorker();
+
+		for (auto & Worker : Workers)
+			Worker.join();
+
+		for (auto & pException : Exceptions) {
+			if (pException)
+				std::rethrow_exception(pException);
+		}
+	}
+
+}
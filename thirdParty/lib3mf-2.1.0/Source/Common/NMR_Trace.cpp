@@ -0,0 +1,210 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_Trace.cpp implements the per-thread trace buffers and the Chrome trace export.
+
+--*/
+
+#include "Common/NMR_Trace.h"
+
+#ifdef NMR_TRACING
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#endif
+
+namespace NMR {
+
+#ifdef NMR_TRACING
+
+	typedef struct {
+		const nfChar * m_pszName;
+		nfUint64 m_nStartTime;
+		nfUint64 m_nDuration;
+	} TRACESPAN;
+
+	// Ring buffer of one thread. Only the owning thread writes; buffers of finished
+	// threads are handed to the next new thread so the memory stays bounded.
+	class CTraceBuffer {
+	public:
+		nfUint32 m_nThreadIndex;
+		std::vector<TRACESPAN> m_Spans;
+		std::atomic<nfUint64> m_nWriteCount;
+
+		CTraceBuffer(_In_ nfUint32 nThreadIndex)
+			: m_nThreadIndex(nThreadIndex), m_Spans(NMR_TRACE_RINGBUFFERSIZE), m_nWriteCount(0)
+		{
+		}
+	};
+
+	typedef std::shared_ptr<CTraceBuffer> PTraceBuffer;
+
+	class CTraceRegistry {
+	public:
+		std::mutex m_Mutex;
+		std::vector<PTraceBuffer> m_Buffers;
+		std::vector<PTraceBuffer> m_FreeBuffers;
+		std::chrono::steady_clock::time_point m_Epoch;
+
+		CTraceRegistry()
+			: m_Epoch(std::chrono::steady_clock::now())
+		{
+		}
+	};
+
+	static CTraceRegistry & fnTraceRegistry()
+	{
+		static CTraceRegistry registry;
+		return registry;
+	}
+
+	class CTraceThreadBuffer {
+	public:
+		PTraceBuffer m_pBuffer;
+
+		CTraceThreadBuffer()
+		{
+			CTraceRegistry & registry = fnTraceRegistry();
+			std::lock_guard<std::mutex> lock(registry.m_Mutex);
+			if (!registry.m_FreeBuffers.empty()) {
+				m_pBuffer = registry.m_FreeBuffers.back();
+				registry.m_FreeBuffers.pop_back();
+			}
+			else {
+				m_pBuffer = std::make_shared<CTraceBuffer>((nfUint32)registry.m_Buffers.size() + 1);
+				registry.m_Buffers.push_back(m_pBuffer);
+			}
+		}
+
+		~CTraceThreadBuffer()
+		{
+			CTraceRegistry & registry = fnTraceRegistry();
+			std::lock_guard<std::mutex> lock(registry.m_Mutex);
+			registry.m_FreeBuffers.push_back(m_pBuffer);
+		}
+	};
+
+	static nfUint64 fnTraceNow()
+	{
+		return (nfUint64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - fnTraceRegistry().m_Epoch).count();
+	}
+
+	CTraceScope::CTraceScope(_In_ const nfChar * pszName)
+		: m_pszName(pszName), m_nStartTime(fnTraceNow())
+	{
+	}
+
+	CTraceScope::~CTraceScope()
+	{
+		static thread_local CTraceThreadBuffer threadBuffer;
+		CTraceBuffer & buffer = *threadBuffer.m_pBuffer;
+
+		nfUint64 nWriteCount = buffer.m_nWriteCount.load(std::memory_order_relaxed);
+		TRACESPAN & span = buffer.m_Spans[nWriteCount % NMR_TRACE_RINGBUFFERSIZE];
+		span.m_pszName = m_pszName;
+		span.m_nStartTime = m_nStartTime;
+		span.m_nDuration = fnTraceNow() - m_nStartTime;
+		buffer.m_nWriteCount.store(nWriteCount + 1, std::memory_order_release);
+	}
+
+	static void fnWriteJSONString(_In_ std::stringstream & sStream, _In_ const nfChar * pszString)
+	{
+		sStream << '"';
+		for (const nfChar * pChar = pszString; *pChar != 0; pChar++) {
+			if ((*pChar == '"') || (*pChar == '\\'))
+				sStream << '\\';
+			sStream << *pChar;
+		}
+		sStream << '"';
+	}
+
+	nfBool fnTraceIsEnabled()
+	{
+		return true;
+	}
+
+	std::string fnTraceToChromeJSON()
+	{
+		CTraceRegistry & registry = fnTraceRegistry();
+		std::lock_guard<std::mutex> lock(registry.m_Mutex);
+
+		std::stringstream sStream;
+		sStream << "{\"traceEvents\":[";
+		nfBool bFirst = true;
+		for (auto pBuffer : registry.m_Buffers) {
+			nfUint64 nWriteCount = pBuffer->m_nWriteCount.load(std::memory_order_acquire);
+			nfUint64 nFirst = (nWriteCount > NMR_TRACE_RINGBUFFERSIZE) ? (nWriteCount - NMR_TRACE_RINGBUFFERSIZE) : 0;
+			for (nfUint64 nIndex = nFirst; nIndex < nWriteCount; nIndex++) {
+				const TRACESPAN & span = pBuffer->m_Spans[nIndex % NMR_TRACE_RINGBUFFERSIZE];
+				if (!bFirst)
+					sStream << ",";
+				bFirst = false;
+
+				// Chrome trace timestamps are microseconds
+				sStream << "{\"name\":";
+				fnWriteJSONString(sStream, span.m_pszName);
+				sStream << ",\"ph\":\"X\",\"ts\":" << (span.m_nStartTime / 1000) << "." << ((span.m_nStartTime % 1000) / 100)
+					<< ",\"dur\":" << (span.m_nDuration / 1000) << "." << ((span.m_nDuration % 1000) / 100)
+					<< ",\"pid\":1,\"tid\":" << pBuffer->m_nThreadIndex << "}";
+			}
+		}
+		sStream << "],\"displayTimeUnit\":\"ms\"}";
+		return sStream.str();
+	}
+
+	void fnTraceClear()
+	{
+		CTraceRegistry & registry = fnTraceRegistry();
+		std::lock_guard<std::mutex> lock(registry.m_Mutex);
+		for (auto pBuffer : registry.m_Buffers)
+			pBuffer->m_nWriteCount.store(0, std::memory_order_release);
+	}
+
+#else
+
+	nfBool fnTraceIsEnabled()
+	{
+		return false;
+	}
+
+	std::string fnTraceToChromeJSON()
+	{
+		return "{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}";
+	}
+
+	void fnTraceClear()
+	{
+	}
+
+#endif // NMR_TRACING
+
+}
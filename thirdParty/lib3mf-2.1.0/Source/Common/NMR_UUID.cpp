@@ -39,62 +39,78 @@ NMR_UUID.cpp implements a datatype and functions to handle UUIDs
 
 #ifdef _WIN32
 #include <objbase.h>
-#include <iomanip>
 #else
 #include <ctime>
+#include <functional>
+#include <random>
+#include <thread>
 #endif
 
 namespace NMR
 {
 #ifndef _WIN32
-	bool CUUID::S_mtwister_initialised = false;
-	std::mutex CUUID::S_uuid_gen_mutex;
-	std::random_device CUUID::S_rand_dev;
-	std::mt19937 CUUID::S_mtwister;
+	// Every thread owns a Mersenne Twister, seeded once from std::random_device,
+	// so that UUIDs can be created concurrently without any locking.
+	static std::mt19937 & threadUUIDGenerator()
+	{
+		thread_local std::mt19937 s_Generator = []() {
+			std::random_device RandomDevice;
+			uint32_t nCurrentTime = static_cast<uint32_t>(time(nullptr));
+			uint32_t nThreadHash = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+			uint32_t SeedData[std::mt19937::state_size];
+			for (size_t i = 0; i < std::mt19937::state_size; ++i)
+				SeedData[i] = RandomDevice() ^ nCurrentTime ^ nThreadHash;
+
+			std::seed_seq SeedSequence(std::begin(SeedData), std::end(SeedData));
+			return std::mt19937(SeedSequence);
+		}();
+		return s_Generator;
+	}
 #endif
 
-	CUUID::CUUID()
+	UUIDKEY CUUID::generateKey()
 	{
+		UUIDKEY Key;
 #ifdef _WIN32
 		GUID guid;
 		if (CoCreateGuid(&guid) != S_OK)
 			throw CNMRException(NMR_ERROR_UUIDGENERATIONFAILED);
-		LPOLESTR str; 
-		if (StringFromCLSID(guid, &str) != S_OK)
-			throw CNMRException(NMR_ERROR_UUIDGENERATIONFAILED);
-		set(fnUTF16toUTF8(str).c_str());
+		Key.m_nHigh = ((nfUint64)guid.Data1 << 32) | ((nfUint64)guid.Data2 << 16) | (nfUint64)guid.Data3;
+		Key.m_nLow = 0;
+		for (int i = 0; i < 8; i++)
+			Key.m_nLow = (Key.m_nLow << 8) | guid.Data4[i];
 #else
-		std::lock_guard<std::mutex> l_lock(S_uuid_gen_mutex);
-		if (!S_mtwister_initialised)
-		{
-			// Prepare seed data
-			uint32_t l_seed_data[std::mt19937::state_size];
-			uint32_t l_cur_time = static_cast<uint32_t>(time(nullptr));
-			for (size_t i = 0; i < std::mt19937::state_size; ++i)
-			{
-				l_seed_data[i] = S_rand_dev() ^ l_cur_time;
-			}
+		std::mt19937 & Generator = threadUUIDGenerator();
+		Key.m_nHigh = ((nfUint64)Generator() << 32) | (nfUint64)Generator();
+		Key.m_nLow = ((nfUint64)Generator() << 32) | (nfUint64)Generator();
 
-			// Init Mersenne Twister pseudo-random generator
-			std::seed_seq l_seed_seq(std::begin(l_seed_data), std::end(l_seed_data));
-			S_mtwister.seed(l_seed_seq);
+		// generation of a v4 UUID according to https://tools.ietf.org/html/rfc4122#section-4.4
+		Key.m_nHigh = (Key.m_nHigh & 0xffffffffffff0fffULL) | 0x0000000000004000ULL; // set version 4
+		Key.m_nLow = (Key.m_nLow & 0x3fffffffffffffffULL) | 0x8000000000000000ULL; // set variant 10xx
+#endif
+		return Key;
+	}
 
-			S_mtwister_initialised = true;
-		}
+	CUUID::CUUID()
+		: CUUID(generateKey())
+	{
+	}
 
-		// generation of a v4 UUID according to https://tools.ietf.org/html/rfc4122#section-4.4
-		std::uniform_int_distribution<std::mt19937::result_type> distHexaDec(0, 15);
-		std::uniform_int_distribution<std::mt19937::result_type> dist4(0, 4);
+	CUUID::CUUID(const UUIDKEY & key)
+		: m_Key(key)
+	{
 		const nfChar* hexaDec = "0123456789abcdef";
-		nfChar string[33];
-		for (int i = 0; i < 32; i++)
-			string[i] = hexaDec[distHexaDec(S_mtwister)];
-		string[12] = hexaDec[4]; // set version 4
-		string[16] = hexaDec[8 + dist4(S_mtwister)];
-		string[32] = 0;
-
-		set(string);
-#endif
+		nfChar string[37];
+		nfUint32 nPosition = 0;
+		for (int i = 0; i < 32; i++) {
+			if ((i == 8) || (i == 12) || (i == 16) || (i == 20))
+				string[nPosition++] = '-';
+			nfUint64 nHalf = (i < 16) ? key.m_nHigh : key.m_nLow;
+			string[nPosition++] = hexaDec[(nHalf >> (60 - 4 * (i % 16))) & 0xf];
+		}
+		string[36] = 0;
+		m_sUUID = string;
 	}
 
 	CUUID::CUUID(const nfChar* pString)
@@ -106,12 +122,25 @@ namespace NMR
 	{
 		set(string.c_str());
 	}
+
+	void CUUID::generate(_In_ nfUint32 nCount, _Out_ std::vector<PUUID> & UUIDs)
+	{
+		UUIDs.clear();
+		UUIDs.reserve(nCount);
+		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++)
+			UUIDs.push_back(std::make_shared<CUUID>(generateKey()));
+	}
 	
 	std::string CUUID::toString() const
 	{
 		return m_sUUID;
 	}
 
+	const UUIDKEY & CUUID::key() const
+	{
+		return m_Key;
+	}
+
 	bool InValid(char c)
 	{
 		return !(((c >= '0') && (c <= '9'))
@@ -130,6 +159,14 @@ namespace NMR
 			throw CNMRException(NMR_ERROR_ILLFORMATUUID);
 		}
 		m_sUUID = str.substr(0, 8) + '-' + str.substr(8, 4) + '-' + str.substr(12, 4) + '-' + str.substr(16, 4) + '-' + str.substr(20, 12);
+
+		m_Key.m_nHigh = 0;
+		m_Key.m_nLow = 0;
+		for (int i = 0; i < 32; i++) {
+			nfUint64 nDigit = (str[i] <= '9') ? (str[i] - '0') : (str[i] - 'a' + 10);
+			nfUint64 & nHalf = (i < 16) ? m_Key.m_nHigh : m_Key.m_nLow;
+			nHalf = (nHalf << 4) | nDigit;
+		}
 		return true;
 	}
 
@@ -138,6 +175,7 @@ namespace NMR
 		if (&uuid == this)
 			return *this;
 		m_sUUID = uuid.m_sUUID;
+		m_Key = uuid.m_Key;
 		return *this;
 	}
 
@@ -145,7 +183,7 @@ namespace NMR
 	{
 		if (&uuid == this)
 			return true;
-		return m_sUUID == uuid.m_sUUID;
+		return m_Key == uuid.m_Key;
 	}
 
 }
@@ -36,6 +36,7 @@ NMR_OpcPackageReader.cpp defines an OPC Package reader in a portable way.
 #include "Common/Platform/NMR_ImportStream_ZIP.h" 
 #include "Common/NMR_Exception.h" 
 #include "Common/NMR_StringUtils.h" 
+#include "Common/NMR_Trace.h"
 
 #include "Model/Classes/NMR_ModelConstants.h"
 
@@ -106,6 +107,8 @@ namespace NMR {
 	COpcPackageReader::COpcPackageReader(_In_ PImportStream pImportStream, _In_ PModelWarnings pWarnings, _In_ PProgressMonitor pProgressMonitor)
 		: m_pWarnings(pWarnings), m_pProgressMonitor(pProgressMonitor)
 	{
+		NMR_TRACE_SCOPE("COpcPackageReader::COpcPackageReader");
+
 		if (!pImportStream)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
@@ -323,6 +326,8 @@ namespace NMR {
 
 	POpcPackagePart COpcPackageReader::createPart(_In_ std::string sPath)
 	{
+		NMR_TRACE_SCOPE("COpcPackageReader::createPart");
+
 		std::string sRealPath = fnRemoveLeadingPathDelimiter (sPath);
 		auto iPartIterator = m_Parts.find(sRealPath);
 		if (iPartIterator != m_Parts.end()) {
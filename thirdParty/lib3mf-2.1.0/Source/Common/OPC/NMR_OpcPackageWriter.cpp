@@ -70,6 +70,22 @@ namespace NMR {
 		return pPart;
 	}
 
+	POpcPackagePart COpcPackageWriter::addDeferredPart(_In_ std::string sPath)
+	{
+		sPath = fnRemoveLeadingPathDelimiter(sPath);
+
+		PExportStream pStream = m_pZIPWriter->createDeferredEntry(sPath, fnGetUnixTime());
+		POpcPackagePart pPart = std::make_shared<COpcPackagePart>(sPath, pStream);
+		m_Parts.push_back(pPart);
+
+		return pPart;
+	}
+
+	void COpcPackageWriter::writeDeferredParts()
+	{
+		m_pZIPWriter->writeDeferredEntries();
+	}
+
 	void COpcPackageWriter::addContentType(_In_ std::string sExtension, _In_ std::string sContentType)
 	{
 		m_DefaultContentTypes.insert(std::make_pair(sExtension, sContentType));
@@ -38,14 +38,24 @@ namespace NMR {
 	nfUint64 CExportStream_Encrypted::writeBuffer(const void * pBuffer, nfUint64 cbTotalBytesToWrite)
 	{
 		nfUint64 encryptedBytes = 0;
-		if (cbTotalBytesToWrite > 0) {
-			std::vector<nfByte> encryptBuffer(cbTotalBytesToWrite, 0);
-			encryptedBytes = m_pDecryptContext.m_fnCrypt(cbTotalBytesToWrite, (const nfByte *)pBuffer, encryptBuffer.data(), m_pDecryptContext.m_sDekDecryptData);
-			if (encryptedBytes > 0) {
-				auto writtenBytes = m_pEncryptedStream->writeBuffer(encryptBuffer.data(), encryptedBytes);
-				if (encryptedBytes != writtenBytes)
+		while (encryptedBytes < cbTotalBytesToWrite) {
+			nfUint64 blockSize = cbTotalBytesToWrite - encryptedBytes;
+			if (blockSize > NMR_EXPORTSTREAM_ENCRYPTED_BLOCKSIZE)
+				blockSize = NMR_EXPORTSTREAM_ENCRYPTED_BLOCKSIZE;
+			if (m_CipherBuffer.size() < blockSize)
+				m_CipherBuffer.resize((size_t)blockSize);
+
+			const nfByte * pPlain = (const nfByte *)pBuffer + encryptedBytes;
+			nfUint64 blockEncrypted = m_pDecryptContext.m_fnCrypt(blockSize, pPlain, m_CipherBuffer.data(), m_pDecryptContext.m_sDekDecryptData);
+			if (blockEncrypted > 0) {
+				auto writtenBytes = m_pEncryptedStream->writeBuffer(m_CipherBuffer.data(), blockEncrypted);
+				if (blockEncrypted != writtenBytes)
 					throw CNMRException(NMR_ERROR_CALCULATIONTERMINATED);
 			}
+			encryptedBytes += blockEncrypted;
+
+			if (blockEncrypted < blockSize)
+				break;
 		}
 		return encryptedBytes;
 	}
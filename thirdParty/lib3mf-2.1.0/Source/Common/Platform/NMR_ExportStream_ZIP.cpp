@@ -32,6 +32,7 @@ NMR_PortableZIPWriter.cpp implements a portable stream to write into ZIP files
 
 #include "Common/Platform/NMR_ExportStream_ZIP.h"
 #include "Common/NMR_Exception.h"
+#include "Common/NMR_Trace.h"
  
 namespace NMR {
 
@@ -47,6 +48,25 @@ namespace NMR {
 		m_pZIPWriter = pZIPWriter;
 		m_nEntryKey = nEntryKey;
 
+		initDeflate();
+	}
+
+	CExportStream_ZIP::CExportStream_ZIP(_In_ PPortableZIPWriterEntry pDeferredEntry)
+	{
+		m_bIsInitialized = false;
+
+		if (pDeferredEntry.get() == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		m_pZIPWriter = nullptr;
+		m_nEntryKey = 0;
+		m_pDeferredEntry = pDeferredEntry;
+
+		initDeflate();
+	}
+
+	void CExportStream_ZIP::initDeflate()
+	{
 		m_pStream.next_in = nullptr;
 		m_pStream.avail_in = 0;
 		m_pStream.total_in = 0;
@@ -103,11 +123,15 @@ namespace NMR {
 
 	nfUint64 CExportStream_ZIP::getPosition()
 	{
+		if (m_pDeferredEntry.get() != nullptr)
+			return m_pDeferredEntry->getUncompressedSize();
 		return m_pZIPWriter->getCurrentSize(m_nEntryKey);
 	}
 
 	nfUint64 CExportStream_ZIP::writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite)
 	{
+		NMR_TRACE_SCOPE("CExportStream_ZIP::writeBuffer");
+
 		if (!m_bIsInitialized)
 			throw CNMRException(NMR_ERROR_ZIPALREADYFINISHED);
 
@@ -138,7 +162,12 @@ namespace NMR {
 		m_pStream.next_in = (Bytef *) pData;
 		m_pStream.avail_in = cbCount;
 
-		m_pZIPWriter->calculateChecksum(m_nEntryKey, pData, cbCount);
+		if (m_pDeferredEntry.get() != nullptr) {
+			m_pDeferredEntry->calculateChecksum(pData, cbCount);
+			m_pDeferredEntry->increaseUncompressedSize(cbCount);
+		}
+		else
+			m_pZIPWriter->calculateChecksum(m_nEntryKey, pData, cbCount);
 
 		while (m_pStream.avail_in > 0) {
 			nfInt32 nResult = deflate(&m_pStream, 0);
@@ -146,7 +175,7 @@ namespace NMR {
 				throw CNMRException(NMR_ERROR_COULDNOTDEFLATE);
 
 			if (m_pStream.avail_out == 0) {
-				m_pZIPWriter->writeDeflatedBuffer(m_nEntryKey, &m_nOutBuffer[0], ZIPEXPORTBUFFERSIZE);
+				writeDeflatedBuffer(ZIPEXPORTBUFFERSIZE);
 
 				m_pStream.next_out = &m_nOutBuffer[0];
 				m_pStream.avail_out = ZIPEXPORTBUFFERSIZE;
@@ -158,6 +187,14 @@ namespace NMR {
 	}
 
 
+	void CExportStream_ZIP::writeDeflatedBuffer(_In_ nfUint32 cbCompressedBytes)
+	{
+		if (m_pDeferredEntry.get() != nullptr)
+			m_pDeferredEntry->appendDeflatedData(&m_nOutBuffer[0], cbCompressedBytes);
+		else
+			m_pZIPWriter->writeDeflatedBuffer(m_nEntryKey, &m_nOutBuffer[0], cbCompressedBytes);
+	}
+
 	void CExportStream_ZIP::finishDeflate()
 	{
 		if (!m_bIsInitialized)
@@ -173,7 +210,7 @@ namespace NMR {
 				throw CNMRException(NMR_ERROR_COULDNOTDEFLATE);
 
 			if ((nResult != Z_STREAM_END) && (m_pStream.avail_out == 0)) {
-				m_pZIPWriter->writeDeflatedBuffer(m_nEntryKey, &m_nOutBuffer[0], ZIPEXPORTBUFFERSIZE);
+				writeDeflatedBuffer(ZIPEXPORTBUFFERSIZE);
 
 				m_pStream.next_out = &m_nOutBuffer[0];
 				m_pStream.avail_out = ZIPEXPORTBUFFERSIZE;
@@ -183,7 +220,7 @@ namespace NMR {
 		}
 
 		if (m_pStream.avail_out < ZIPEXPORTBUFFERSIZE) {
-			m_pZIPWriter->writeDeflatedBuffer(m_nEntryKey, &m_nOutBuffer[0], ZIPEXPORTBUFFERSIZE - m_pStream.avail_out);
+			writeDeflatedBuffer(ZIPEXPORTBUFFERSIZE - m_pStream.avail_out);
 		}
 
 		deflateEnd(&m_pStream);
@@ -101,10 +101,8 @@ namespace NMR {
 			throw CNMRException(NMR_ERROR_COULDNOTINFLATE);
 		}
 		if (m_strm.avail_out == 0) {
-			nfBool reachedEndOfBuffer = m_strm.avail_in == 0;
-			if (reachedEndOfBuffer && ret != Z_STREAM_END) {
-				throw CNMRException(NMR_ERROR_COULDNOTINFLATE);
-			}
+			// the input chunk may be used up exactly when the output is full;
+			// the next read continues with a new chunk
 			return cbTotalBytesToRead;
 		}
 
@@ -132,6 +130,7 @@ namespace NMR {
 			bytesRead = readBuffer(&m_decompressedBuffer[currentPosition], chunkSize, false);
 			currentPosition += bytesRead;
 		} while (chunkSize == bytesRead);
+		m_decompressedBuffer.resize(currentPosition);
 		return std::make_shared<CImportStream_Shared_Memory>(m_decompressedBuffer.data(), m_decompressedBuffer.size());
 	}
 
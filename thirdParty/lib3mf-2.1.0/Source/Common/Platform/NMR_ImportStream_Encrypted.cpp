@@ -60,14 +60,32 @@ namespace NMR {
 	}
 
 	nfUint64 CImportStream_Encrypted::readBuffer(nfByte * pBuffer, nfUint64 cbTotalBytesToRead, nfBool bNeedsToReadAll) {
-		std::vector<nfByte> decBuffer(cbTotalBytesToRead, 0);
-		nfUint64 bytesRead = m_pEncryptedStream->readBuffer(decBuffer.data(), cbTotalBytesToRead, bNeedsToReadAll);
-		if (bytesRead > 0) {
-			nfUint64 decryted = m_pDecryptContext.m_fnCrypt(bytesRead, decBuffer.data(), pBuffer, m_pDecryptContext.m_sDekDecryptData);
-			if (decryted != bytesRead)
-				throw CNMRException(NMR_ERROR_CALCULATIONTERMINATED);
+		nfUint64 totalBytesRead = 0;
+		while (totalBytesRead < cbTotalBytesToRead) {
+			nfUint64 blockSize = cbTotalBytesToRead - totalBytesRead;
+			if (blockSize > NMR_IMPORTSTREAM_ENCRYPTED_BLOCKSIZE)
+				blockSize = NMR_IMPORTSTREAM_ENCRYPTED_BLOCKSIZE;
+
+			nfByte * pPlain = pBuffer + totalBytesRead;
+			nfByte * pCipher = pPlain;
+			if (!m_pDecryptContext.m_bInPlace) {
+				if (m_CipherBuffer.size() < blockSize)
+					m_CipherBuffer.resize((size_t)blockSize);
+				pCipher = m_CipherBuffer.data();
+			}
+
+			nfUint64 bytesRead = m_pEncryptedStream->readBuffer(pCipher, blockSize, bNeedsToReadAll);
+			if (bytesRead > 0) {
+				nfUint64 decryted = m_pDecryptContext.m_fnCrypt(bytesRead, pCipher, pPlain, m_pDecryptContext.m_sDekDecryptData);
+				if (decryted != bytesRead)
+					throw CNMRException(NMR_ERROR_CALCULATIONTERMINATED);
+			}
+			totalBytesRead += bytesRead;
+
+			if (bytesRead < blockSize)
+				break;
 		}
-		return bytesRead;
+		return totalBytesRead;
 	}
 
 	nfUint64 CImportStream_Encrypted::retrieveSize() {
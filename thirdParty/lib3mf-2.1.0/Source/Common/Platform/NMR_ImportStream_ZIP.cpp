@@ -35,6 +35,7 @@ This is a stream class for importing from a libZIP object.
 #include "Common/Platform/NMR_ImportStream_Unique_Memory.h"
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_Exception_Windows.h"
+#include "Common/NMR_Trace.h"
 #include <math.h>
 #include <vector>
 
@@ -78,6 +79,8 @@ namespace NMR {
 
 	nfUint64 CImportStream_ZIP::readBuffer(_In_ nfByte * pBuffer, _In_ nfUint64 cbTotalBytesToRead, nfBool bNeedsToReadAll)
 	{
+		NMR_TRACE_SCOPE("CImportStream_ZIP::readBuffer");
+
 		nfUint64 cbBytesLeft = cbTotalBytesToRead;
 		nfUint64 cbBytesRead = 0;
 
@@ -69,24 +69,19 @@ namespace NMR {
 			writeDirectory();
 	}
 
-	PExportStream CPortableZIPWriter::createEntry(_In_ const std::string sName, _In_ nfTimeStamp nUnixTimeStamp)
+	std::string CPortableZIPWriter::prepareEntryName(_In_ const std::string sName)
 	{
-		if (m_bIsFinished)
-			throw CNMRException(NMR_ERROR_ZIPALREADYFINISHED);
-		// Finish old entry state
-		closeEntry();
-
-		// Initialize new entry state
-		m_nCurrentEntryKey = m_nNextEntryKey;
-		m_nNextEntryKey++;
-		if (m_nNextEntryKey >= ZIPFILEMAXENTRIES)
-			throw CNMRException(NMR_ERROR_ZIPENTRYOVERFLOW);
-
 		// Convert Name to UTF8
 		std::string sFilteredName = fnRemoveLeadingPathDelimiter(sName);
 		std::string sUTF8Name = sFilteredName;
 		if (sUTF8Name.length() > ZIPFILEMAXFILENAMELENGTH)
 			throw CNMRException(NMR_ERRORINVALIDZIPNAME);
+		return sUTF8Name;
+	}
+
+	void CPortableZIPWriter::writeLocalFileHeader(_In_ const std::string & sUTF8Name, _In_ nfUint32 nCRC32, _In_ nfUint64 nCompressedSize, _In_ nfUint64 nUncompressedSize,
+		_Out_ nfUint64 & nFilePosition, _Out_ nfUint64 & nExtInfoPosition, _Out_ nfUint64 & nDataPosition)
+	{
 		nfUint32 nNameLength = (nfUint32)sUTF8Name.length();
 
 		// Convert Timestamp to File Date
@@ -102,7 +97,7 @@ namespace NMR {
 		LocalHeader.m_nCompressionMethod = ZIPFILECOMPRESSION_DEFLATED;
 		LocalHeader.m_nLastModTime = nLastModTime;
 		LocalHeader.m_nLastModDate = nLastModDate;
-		LocalHeader.m_nCRC32 = 0;
+		LocalHeader.m_nCRC32 = nCRC32;
 		LocalHeader.m_nCompressedSize = 0;
 		LocalHeader.m_nUnCompressedSize = 0;
 		LocalHeader.m_nFileNameLength = nNameLength;
@@ -112,14 +107,28 @@ namespace NMR {
 			LocalHeader.m_nExtraFieldLength += sizeof(ZIP64EXTRAINFORMATIONFIELD);
 		}
 
+		// Sizes are only known up front for deferred entries
+		if ((nCompressedSize > 0) || (nUncompressedSize > 0)) {
+			if (m_bWriteZIP64) {
+				LocalHeader.m_nCompressedSize = 0xFFFFFFFF;
+				LocalHeader.m_nUnCompressedSize = 0xFFFFFFFF;
+			}
+			else {
+				if ((nCompressedSize > ZIPFILEMAXIMUMSIZENON64) || (nUncompressedSize > ZIPFILEMAXIMUMSIZENON64))
+					throw CNMRException(NMR_ERROR_ZIPENTRYNON64_TOOLARGE);
+				LocalHeader.m_nCompressedSize = (nfUint32)nCompressedSize;
+				LocalHeader.m_nUnCompressedSize = (nfUint32)nUncompressedSize;
+			}
+		}
+
 		ZIP64EXTRAINFORMATIONFIELD zip64ExtraInformation;
 		zip64ExtraInformation.m_nTag = ZIPFILEDATAZIP64EXTENDEDINFORMATIONEXTRAFIELD;
 		zip64ExtraInformation.m_nFieldSize = sizeof(ZIP64EXTRAINFORMATIONFIELD) - 4;
-		zip64ExtraInformation.m_nCompressedSize = 0;
-		zip64ExtraInformation.m_nUncompressedSize = 0;
+		zip64ExtraInformation.m_nCompressedSize = nCompressedSize;
+		zip64ExtraInformation.m_nUncompressedSize = nUncompressedSize;
 
 		// Write data to ZIP stream
-		nfUint64 nFilePosition = m_pExportStream->getPosition();
+		nFilePosition = m_pExportStream->getPosition();
 		
 		// prepare byte-buffer for big-endian machines
 		if (isBigEndian()) {
@@ -127,7 +136,7 @@ namespace NMR {
 		}
 		m_pExportStream->writeBuffer(&LocalHeader, sizeof(LocalHeader));
 		m_pExportStream->writeBuffer(sUTF8Name.c_str(), nNameLength);
-		nfUint64 nExtInfoPosition = m_pExportStream->getPosition();
+		nExtInfoPosition = m_pExportStream->getPosition();
 		if (m_bWriteZIP64) {
 			// prepare byte-buffer for big-endian machines
 			if (isBigEndian()) {
@@ -136,10 +145,29 @@ namespace NMR {
 			m_pExportStream->writeBuffer(&zip64ExtraInformation, sizeof(zip64ExtraInformation));
 		}
 
-		nfUint64 nDataPosition = m_pExportStream->getPosition();
+		nDataPosition = m_pExportStream->getPosition();
+	}
+
+	PExportStream CPortableZIPWriter::createEntry(_In_ const std::string sName, _In_ nfTimeStamp nUnixTimeStamp)
+	{
+		if (m_bIsFinished)
+			throw CNMRException(NMR_ERROR_ZIPALREADYFINISHED);
+		// Finish old entry state
+		closeEntry();
+
+		// Initialize new entry state
+		m_nCurrentEntryKey = m_nNextEntryKey;
+		m_nNextEntryKey++;
+		if (m_nNextEntryKey >= ZIPFILEMAXENTRIES)
+			throw CNMRException(NMR_ERROR_ZIPENTRYOVERFLOW);
+
+		std::string sUTF8Name = prepareEntryName(sName);
+
+		nfUint64 nFilePosition, nExtInfoPosition, nDataPosition;
+		writeLocalFileHeader(sUTF8Name, 0, 0, 0, nFilePosition, nExtInfoPosition, nDataPosition);
 
 		// create list entry
-		m_pCurrentEntry = std::make_shared<CPortableZIPWriterEntry>(sUTF8Name, nLastModTime, nLastModDate, nFilePosition, nExtInfoPosition, nDataPosition);
+		m_pCurrentEntry = std::make_shared<CPortableZIPWriterEntry>(sUTF8Name, 0, 0, nFilePosition, nExtInfoPosition, nDataPosition);
 		m_Entries.push_back(m_pCurrentEntry);
 
 		// Return new ZIP Entry stream
@@ -147,6 +175,57 @@ namespace NMR {
 		return m_pCurrentStream;
 	}
 
+	PExportStream CPortableZIPWriter::createDeferredEntry(_In_ const std::string sName, _In_ nfTimeStamp nUnixTimeStamp)
+	{
+		if (m_bIsFinished)
+			throw CNMRException(NMR_ERROR_ZIPALREADYFINISHED);
+
+		// Deferred entries count towards the entry limit as well
+		m_nNextEntryKey++;
+		if (m_nNextEntryKey >= ZIPFILEMAXENTRIES)
+			throw CNMRException(NMR_ERROR_ZIPENTRYOVERFLOW);
+
+		std::string sUTF8Name = prepareEntryName(sName);
+
+		PPortableZIPWriterEntry pEntry = std::make_shared<CPortableZIPWriterEntry>(sUTF8Name, 0, 0, 0, 0, 0);
+		PExportStream pStream = std::make_shared<CExportStream_ZIP>(pEntry);
+		m_DeferredEntries.push_back(std::make_pair(pEntry, pStream));
+		return pStream;
+	}
+
+	void CPortableZIPWriter::writeDeferredEntries()
+	{
+		if (m_bIsFinished)
+			throw CNMRException(NMR_ERROR_ZIPALREADYFINISHED);
+
+		if (m_DeferredEntries.empty())
+			return;
+
+		// The deferred entries are appended after the current entry
+		closeEntry();
+
+		while (!m_DeferredEntries.empty()) {
+			PPortableZIPWriterEntry pEntry = m_DeferredEntries.front().first;
+			CExportStream_ZIP * pZipStream = dynamic_cast<CExportStream_ZIP *>(m_DeferredEntries.front().second.get());
+			if (pZipStream == nullptr)
+				throw CNMRException(NMR_ERROR_NOEXPORTSTREAM);
+			pZipStream->flushZIPStream();
+
+			nfUint64 nFilePosition, nExtInfoPosition, nDataPosition;
+			writeLocalFileHeader(pEntry->getUTF8Name(), pEntry->getCRC32(), pEntry->getCompressedSize(), pEntry->getUncompressedSize(),
+				nFilePosition, nExtInfoPosition, nDataPosition);
+			pEntry->setPositions(nFilePosition, nExtInfoPosition, nDataPosition);
+
+			const std::vector<nfByte> & DeflatedData = pEntry->getDeflatedData();
+			if (!DeflatedData.empty())
+				m_pExportStream->writeBuffer(DeflatedData.data(), DeflatedData.size());
+			pEntry->releaseDeflatedData();
+
+			m_Entries.push_back(pEntry);
+			m_DeferredEntries.pop_front();
+		}
+	}
+
 	void CPortableZIPWriter::closeEntry()
 	{
 		if (m_bIsFinished)
@@ -257,6 +336,7 @@ namespace NMR {
 
 	void CPortableZIPWriter::writeDirectory()
 	{
+		writeDeferredEntries();
 		closeEntry();
 
 		nfUint64 nCentralDirStartPos = m_pExportStream->getPosition();
@@ -293,8 +373,8 @@ namespace NMR {
 				DirectoryHeader.m_nRelativeOffsetOfLocalHeader = 0xFFFFFFFF;
 			}
 			else {
-				if ((m_pCurrentEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
-					(m_pCurrentEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
+				if ((pEntry->getCompressedSize() > ZIPFILEMAXIMUMSIZENON64) ||
+					(pEntry->getUncompressedSize() > ZIPFILEMAXIMUMSIZENON64))
 					throw CNMRException(NMR_ERROR_ZIPENTRYNON64_TOOLARGE);
 				DirectoryHeader.m_nCompressedSize = (nfUint32)pEntry->getCompressedSize();
 				DirectoryHeader.m_nUnCompressedSize = (nfUint32)pEntry->getUncompressedSize();
@@ -111,4 +111,28 @@ namespace NMR {
 		m_nCRC32 = crc32(m_nCRC32, (Bytef*) pBuffer, cbCount);
 	}
 
+	void CPortableZIPWriterEntry::setPositions(_In_ nfUint64 nFilePosition, _In_ nfUint64 nExtInfoPosition, _In_ nfUint64 nDataPosition)
+	{
+		m_nFilePosition = nFilePosition;
+		m_nExtInfoPosition = nExtInfoPosition;
+		m_nDataPosition = nDataPosition;
+	}
+
+	void CPortableZIPWriterEntry::appendDeflatedData(_In_ const void * pBuffer, _In_ nfUint32 cbCompressedBytes)
+	{
+		const nfByte * pBytes = (const nfByte *)pBuffer;
+		m_DeflatedData.insert(m_DeflatedData.end(), pBytes, pBytes + cbCompressedBytes);
+		m_nCompressedSize += cbCompressedBytes;
+	}
+
+	const std::vector<nfByte> & CPortableZIPWriterEntry::getDeflatedData()
+	{
+		return m_DeflatedData;
+	}
+
+	void CPortableZIPWriterEntry::releaseDeflatedData()
+	{
+		std::vector<nfByte>().swap(m_DeflatedData);
+	}
+
 }
@@ -438,6 +438,7 @@ namespace NMR {
 
 		// Update Progress
 		m_pProgressMonitor->IncrementProgress(double(cbBytesRead));
+		m_pProgressMonitor->AddToCounter(PROGRESSCOUNTER_XMLBYTES, cbBytesRead);
 
 		// Reset Entity parser
 		m_nCurrentEntityCount = 0;
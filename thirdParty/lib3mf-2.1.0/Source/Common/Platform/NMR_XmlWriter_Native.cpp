@@ -57,6 +57,7 @@ namespace NMR {
 
 		m_nSpacesPerLayer = 1;
 		m_nLayer = 0;
+		m_nBytesWritten = 0;
 
 		m_SpacingBuffer.fill(NATIVEXMLSPACING);
 		m_bElementIsOpen = false;
@@ -211,6 +212,7 @@ namespace NMR {
 		if (pData == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		m_pExportStream->writeBuffer(pData, cbLength);
+		m_nBytesWritten += cbLength;
 	}
 
 	void CXmlWriter_Native::writeUTF8(_In_ const nfChar * pszString, _In_ nfBool bNewLine)
@@ -378,4 +380,9 @@ namespace NMR {
 			iter++;
 		return iter->first;
 	}
+
+	nfUint64 CXmlWriter_Native::GetBytesWritten()
+	{
+		return m_nBytesWritten;
+	}
 }
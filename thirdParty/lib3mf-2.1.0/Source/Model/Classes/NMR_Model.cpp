@@ -53,6 +53,7 @@ A model is an in memory representation of the 3MF file.
 #include "Common/MeshInformation/NMR_MeshInformation.h"
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
 #include "Common/NMR_Exception.h"
+#include "Common/NMR_ParallelFor.h"
 #include <sstream>
 #include <memory>
 #include <random>
@@ -139,9 +140,17 @@ namespace NMR {
 
 	// Merge all build items into one mesh
 	void CModel::mergeToMesh(_In_ CMesh * pMesh)
+	{
+		CMeshMerger merger;
+		merger.setThreadCount(fnGetHardwareThreadCount());
+		collectMeshInstances(merger);
+		merger.merge(pMesh);
+	}
+
+	void CModel::collectMeshInstances(_In_ CMeshMerger & merger)
 	{
 		for (auto iIterator = m_BuildItems.begin(); iIterator != m_BuildItems.end(); iIterator++) {
-			(*iIterator)->mergeToMesh(pMesh);
+			(*iIterator)->collectMeshInstances(merger);
 		}
 	}
 
@@ -208,7 +217,7 @@ namespace NMR {
 	}
 
 	// General Resource Handling
-	PModelResource CModel::findResource(_In_ std::string path, ModelResourceID nID)
+	PModelResource CModel::findResource(_In_ const std::string & path, ModelResourceID nID)
 	{
 		PPackageResourceID pID = m_resourceHandler.findResourceIDByPair(path, nID);
 		if (pID.get())
@@ -230,17 +239,20 @@ namespace NMR {
 	{
 		UniqueResourceID uID = pID->getUniqueID();
 
-		auto iIterator = m_ResourceMap.find(uID);
-		if (iIterator != m_ResourceMap.end()) {
-			return iIterator->second;
+		if (uID < m_ResourceLookup.size()) {
+			return m_ResourceLookup[uID];
 		}
 		return nullptr;
 	}
 
-	PPackageResourceID CModel::findPackageResourceID(_In_ std::string path, ModelResourceID nID)
+	PPackageResourceID CModel::findPackageResourceID(_In_ const std::string & path, ModelResourceID nID)
 	{
 		return m_resourceHandler.findResourceIDByPair(path, nID);
 	}
+	PPackageResourceID CModel::findPackageResourceID(_In_ const PPackageModelPath & pPath, ModelResourceID nID)
+	{
+		return m_resourceHandler.findResourceIDByPair(pPath, nID);
+	}
 	PPackageResourceID CModel::findPackageResourceID(_In_ UniqueResourceID nID)
 	{
 		return m_resourceHandler.findResourceIDByUniqueID(nID);
@@ -270,12 +282,13 @@ namespace NMR {
 
 		// Check if ID already exists
 		UniqueResourceID nID = pResource->getPackageResourceID()->getUniqueID();
-		auto iIterator = m_ResourceMap.find(nID);
-		if (iIterator != m_ResourceMap.end())
+		if ((nID < m_ResourceLookup.size()) && m_ResourceLookup[nID].get())
 			throw CNMRException(NMR_ERROR_DUPLICATEMODELRESOURCE);
 
 		// Add ID to objects
-		m_ResourceMap.insert(std::make_pair(nID, pResource));
+		if (nID >= m_ResourceLookup.size())
+			m_ResourceLookup.resize(nID + 1);
+		m_ResourceLookup[nID] = pResource;
 		m_Resources.push_back(pResource);
 
 		// Create correct lookup table
@@ -372,22 +385,16 @@ namespace NMR {
 	void CModel::unRegisterUUID(PUUID pUUID)
 	{
 		if (pUUID.get()) {
-			usedUUIDs.erase(pUUID->toString());
+			usedUUIDs.erase(pUUID->key());
 		}
 	}
 
 	void CModel::registerUUID(PUUID pUUID)
 	{
 		if (pUUID.get()) {
-			std::string value = pUUID->toString();
-
-			auto it = usedUUIDs.find(value);
-			if (it != usedUUIDs.end()) {
+			if (!usedUUIDs.insert(std::make_pair(pUUID->key(), pUUID)).second) {
 				throw CNMRException(NMR_ERROR_UUID_NOT_UNIQUE);
 			}
-			else {
-				usedUUIDs[value] = pUUID;
-			}
 		}
 	}
 
@@ -396,26 +403,31 @@ namespace NMR {
 	ModelResourceID CModel::generateResourceID()
 	{
 		// TODO: is this truly safe?
-		auto iIterator = m_ResourceMap.rbegin();
-		if (iIterator != m_ResourceMap.rend())
-			return iIterator->first + 1;
+		// the lookup table ends at the highest UniqueResourceID in use
+		if (!m_ResourceLookup.empty())
+			return (ModelResourceID)m_ResourceLookup.size();
 		else
 			return 1;
 	}
 
 	void CModel::updateUniqueResourceID(UniqueResourceID nOldID, UniqueResourceID nNewID)
 	{
-		if (m_ResourceMap.find(nNewID) != m_ResourceMap.end()) {
+		if ((nNewID < m_ResourceLookup.size()) && m_ResourceLookup[nNewID].get()) {
 			throw CNMRException(NMR_ERROR_DUPLICATEMODELRESOURCE);
 		}
 		else
 		{
-			auto iIterator = m_ResourceMap.find(nOldID);
-			if (iIterator == m_ResourceMap.end()) {
+			if ((nOldID >= m_ResourceLookup.size()) || (!m_ResourceLookup[nOldID].get())) {
 				throw CNMRException(NMR_ERROR_INVALIDMODELRESOURCE);
 			}
-			m_ResourceMap.insert(std::make_pair<>(nNewID, iIterator->second));
-			m_ResourceMap.erase(m_ResourceMap.find(nOldID));
+			if (nNewID >= m_ResourceLookup.size())
+				m_ResourceLookup.resize(nNewID + 1);
+			m_ResourceLookup[nNewID] = m_ResourceLookup[nOldID];
+			m_ResourceLookup[nOldID] = nullptr;
+
+			// keep the table trimmed to the highest UniqueResourceID in use
+			while (!m_ResourceLookup.empty() && !m_ResourceLookup.back().get())
+				m_ResourceLookup.pop_back();
 		}
 	}
 
@@ -543,7 +555,7 @@ namespace NMR {
 		m_BaseMaterialLookup.clear();
 		m_ColorGroupLookup.clear();
 		m_BuildItems.clear();
-		m_ResourceMap.clear();
+		m_ResourceLookup.clear();
 		m_Resources.clear();
 		m_TextureLookup.clear();
 		m_SliceStackLookup.clear();
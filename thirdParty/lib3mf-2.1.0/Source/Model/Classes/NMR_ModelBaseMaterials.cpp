@@ -41,21 +41,16 @@ namespace NMR {
 	CModelBaseMaterialResource::CModelBaseMaterialResource(_In_ const ModelResourceID sID, _In_ CModel * pModel)
 		: CModelResource(sID, pModel)
 	{
-		m_nNextPropertyID = 1;
 	}
 
 	nfUint32 CModelBaseMaterialResource::addBaseMaterial(_In_ const std::string sName, _In_ nfColor cDisplayColor)
 	{
-		nfUint32 nID = m_nNextPropertyID;
 		if (getCount() >= XML_3MF_MAXRESOURCEINDEX) {
 			throw CNMRException(NMR_ERROR_TOOMANYMATERIALS);
 		}
 
-		m_pMaterials.insert(
-			std::make_pair(nID, std::make_shared<CModelBaseMaterial>(sName, cDisplayColor, nID))
-		);
-
-		m_nNextPropertyID++;
+		nfUint32 nID = m_pMaterials.getNextPropertyID();
+		m_pMaterials.add(std::make_shared<CModelBaseMaterial>(sName, cDisplayColor, nID));
 
 		clearResourceIndexMap();
 
@@ -64,23 +59,17 @@ namespace NMR {
 
 	nfUint32 CModelBaseMaterialResource::getCount()
 	{
-		return (nfUint32)m_pMaterials.size();
+		return m_pMaterials.getCount();
 	}
 
 	PModelBaseMaterial CModelBaseMaterialResource::getBaseMaterial(_In_ nfUint32 nPropertyID)
 	{
-		auto iIterator = m_pMaterials.find(nPropertyID);
-		if (iIterator != m_pMaterials.end()) {
-			return iIterator->second;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		return m_pMaterials.get(nPropertyID);
 	}
 
 	void CModelBaseMaterialResource::removeMaterial(_In_ nfUint32 nPropertyID)
 	{
-		m_pMaterials.erase(nPropertyID);
+		m_pMaterials.remove(nPropertyID);
 		clearResourceIndexMap();
 	}
 
@@ -103,14 +92,7 @@ namespace NMR {
 
 	void CModelBaseMaterialResource::buildResourceIndexMap()
 	{
-		m_ResourceIndexMap.clear();
-		m_ResourceIndexMap.reserve(m_pMaterials.size());
-
-		auto iIterator = m_pMaterials.begin();
-		while (iIterator != m_pMaterials.end()) {
-			m_ResourceIndexMap.push_back(iIterator->first);
-			iIterator++;
-		}
+		m_pMaterials.getPropertyIDs(m_ResourceIndexMap);
 
 		m_bHasResourceIndexMap = true;
 	}
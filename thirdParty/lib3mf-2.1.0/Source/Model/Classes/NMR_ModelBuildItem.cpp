@@ -139,6 +139,11 @@ namespace NMR {
 		m_pObject->mergeToMesh(pMesh, m_mTransform);
 	}
 
+	void CModelBuildItem::collectMeshInstances(_In_ CMeshMerger & merger)
+	{
+		m_pObject->collectMeshInstances(merger, m_mTransform);
+	}
+
 	nfUint32 CModelBuildItem::getHandle()
 	{
 		return m_nHandle;
@@ -39,57 +39,107 @@ A color group is an in memory representation of the 3MF color groups node.
 namespace NMR {
 
 	CModelColorGroupResource::CModelColorGroupResource(_In_ const ModelResourceID sID, _In_ CModel * pModel)
-		: CModelResource(sID, pModel)
+		: CModelResource(sID, pModel), m_bHasColorLookup(false)
 	{
-		m_nNextPropertyID = 1;
+	}
+
+	void CModelColorGroupResource::buildColorLookup()
+	{
+		m_ColorLookup.clear();
+		m_ColorLookup.reserve(getCount());
+		m_pColors.forEach([this](ModelPropertyID nPropertyID, nfColor & cColor) {
+			m_ColorLookup.insert(std::make_pair(cColor, nPropertyID));
+		});
+		m_bHasColorLookup = true;
 	}
 
 	nfUint32 CModelColorGroupResource::addColor( _In_ nfColor cColor)
 	{
-		nfUint32 nID = m_nNextPropertyID;
 		if (getCount() >= XML_3MF_MAXRESOURCEINDEX) {
 			throw CNMRException(NMR_ERROR_TOOMANYCOLORS);
 		}
 
-		m_pColors.insert(std::make_pair(nID, cColor));
-
-		m_nNextPropertyID++;
+		nfUint32 nID = m_pColors.add(cColor);
+		if (m_bHasColorLookup)
+			m_ColorLookup.insert(std::make_pair(cColor, nID));
 
 		clearResourceIndexMap();
 
 		return nID;
 	}
 
+	nfUint32 CModelColorGroupResource::addColors(_In_ const nfColor * pColors, _In_ nfUint32 nCount)
+	{
+		if ((nCount > 0) && (pColors == nullptr))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if ((nfUint64)getCount() + nCount > XML_3MF_MAXRESOURCEINDEX) {
+			throw CNMRException(NMR_ERROR_TOOMANYCOLORS);
+		}
+
+		nfUint32 nFirstID = m_pColors.getNextPropertyID();
+		m_pColors.reserve(nCount);
+		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
+			nfUint32 nID = m_pColors.add(pColors[nIndex]);
+			if (m_bHasColorLookup)
+				m_ColorLookup.insert(std::make_pair(pColors[nIndex], nID));
+		}
+
+		clearResourceIndexMap();
+
+		return nFirstID;
+	}
+
+	void CModelColorGroupResource::addColorsDeduplicated(_In_ const nfColor * pColors, _In_ nfUint32 nCount, _Out_ ModelPropertyID * pPropertyIDs)
+	{
+		if ((nCount > 0) && ((pColors == nullptr) || (pPropertyIDs == nullptr)))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		if (!m_bHasColorLookup)
+			buildColorLookup();
+
+		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
+			auto iIterator = m_ColorLookup.find(pColors[nIndex]);
+			if (iIterator != m_ColorLookup.end()) {
+				pPropertyIDs[nIndex] = iIterator->second;
+			}
+			else {
+				// addColor keeps the lookup up to date
+				pPropertyIDs[nIndex] = addColor(pColors[nIndex]);
+			}
+		}
+	}
+
 	nfUint32 CModelColorGroupResource::getCount()
 	{
-		return (nfUint32)m_pColors.size();
+		return m_pColors.getCount();
 	}
 
 	nfColor CModelColorGroupResource::getColor(_In_ ModelPropertyID nPropertyID)
 	{
-		auto iIterator = m_pColors.find(nPropertyID);
-		if (iIterator != m_pColors.end()) {
-			return iIterator->second;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		return m_pColors.get(nPropertyID);
 	}
 
 	void CModelColorGroupResource::setColor(_In_ ModelPropertyID nPropertyID, _In_ nfColor cColor)
 	{
-		auto iIterator = m_pColors.find(nPropertyID);
-		if (iIterator != m_pColors.end()) {
-			iIterator->second = cColor;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		m_pColors.get(nPropertyID) = cColor;
+		m_bHasColorLookup = false;
+	}
+
+	void CModelColorGroupResource::getColors(_Out_ nfColor * pColors)
+	{
+		if (pColors == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		m_pColors.forEach([&pColors](ModelPropertyID, nfColor & cColor) {
+			*pColors = cColor;
+			pColors++;
+		});
 	}
 
 	void CModelColorGroupResource::removeColor(_In_ ModelPropertyID nPropertyID)
 	{
-		m_pColors.erase(nPropertyID);
+		m_pColors.remove(nPropertyID);
+		m_bHasColorLookup = false;
 		clearResourceIndexMap();
 	}
 
@@ -98,28 +148,16 @@ namespace NMR {
 		if (pSourceColorGroup == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		
-		nfUint32 nCount = pSourceColorGroup->getCount();
-
-		pSourceColorGroup->buildResourceIndexMap();
-		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
-			ModelPropertyID nPropertyID;
-			pSourceColorGroup->mapResourceIndexToPropertyID(nIndex, nPropertyID);
-			nfColor color = pSourceColorGroup->getColor(nPropertyID);
-			addColor(color);
+		std::vector<nfColor> Colors(pSourceColorGroup->getCount());
+		if (!Colors.empty()) {
+			pSourceColorGroup->getColors(Colors.data());
+			addColors(Colors.data(), (nfUint32)Colors.size());
 		}
-		clearResourceIndexMap();
 	}
 
 	void CModelColorGroupResource::buildResourceIndexMap()
 	{
-		m_ResourceIndexMap.clear();
-		m_ResourceIndexMap.reserve(m_pColors.size());
-
-		auto iIterator = m_pColors.begin();
-		while (iIterator != m_pColors.end()) {
-			m_ResourceIndexMap.push_back(iIterator->first);
-			iIterator++;
-		}
+		m_pColors.getPropertyIDs(m_ResourceIndexMap);
 
 		m_bHasResourceIndexMap = true;
 	}
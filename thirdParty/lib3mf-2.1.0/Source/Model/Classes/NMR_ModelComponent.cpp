@@ -110,4 +110,10 @@ namespace NMR {
 		m_pObject->mergeToMesh(pMesh, mLocalMatrix);
 	}
 
+	void CModelComponent::collectMeshInstances(_In_ CMeshMerger & merger, _In_ const NMATRIX3 mMatrix)
+	{
+		NMATRIX3 mLocalMatrix = fnMATRIX3_multiply(mMatrix, m_mTransform);
+		m_pObject->collectMeshInstances(merger, mLocalMatrix);
+	}
+
 }
@@ -78,11 +78,10 @@ namespace NMR {
 		return m_Components[nIdx];
 	}
 
-	void CModelComponentsObject::mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix)
+	void CModelComponentsObject::collectMeshInstances(_In_ CMeshMerger & merger, _In_ const NMATRIX3 mMatrix)
 	{
-		__NMRASSERT(pMesh);
 		for (auto iIterator = m_Components.begin(); iIterator != m_Components.end(); iIterator++)
-			(*iIterator)->mergeToMesh(pMesh, mMatrix);
+			(*iIterator)->collectMeshInstances(merger, mMatrix);
 	}
 
 	nfBool CModelComponentsObject::isValid()
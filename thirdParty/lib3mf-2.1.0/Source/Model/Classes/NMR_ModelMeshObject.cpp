@@ -72,10 +72,9 @@ namespace NMR {
 		m_pMesh = pMesh;
 	}
 
-	void CModelMeshObject::mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix)
+	void CModelMeshObject::collectMeshInstances(_In_ CMeshMerger & merger, _In_ const NMATRIX3 mMatrix)
 	{
-		__NMRASSERT(pMesh);
-		pMesh->mergeMesh(m_pMesh.get(), mMatrix);
+		merger.addInstance(m_pMesh.get(), mMatrix);
 	}
 
 	void CModelMeshObject::setObjectType(_In_ eModelObjectType ObjectType)
@@ -50,6 +50,13 @@ namespace NMR {
 	}
 
 	void CModelObject::mergeToMesh(_In_ CMesh * pMesh, _In_ const NMATRIX3 mMatrix)
+	{
+		CMeshMerger merger;
+		collectMeshInstances(merger, mMatrix);
+		merger.merge(pMesh);
+	}
+
+	void CModelObject::collectMeshInstances(_In_ CMeshMerger & merger, _In_ const NMATRIX3 mMatrix)
 	{
 		// empty on purpose, to be implemented by child classes
 	}
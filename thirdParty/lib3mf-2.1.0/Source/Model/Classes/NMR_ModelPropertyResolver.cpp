@@ -0,0 +1,147 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ModelPropertyResolver.cpp implements the Model Property Resolver Class.
+
+--*/
+
+#include "Model/Classes/NMR_ModelPropertyResolver.h"
+#include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelColorGroup.h"
+#include "Model/Classes/NMR_ModelBaseMaterials.h"
+#include "Model/Classes/NMR_ModelTexture2DGroup.h"
+#include "Common/NMR_Exception.h"
+
+namespace NMR {
+
+	CModelPropertyResolver::CModelPropertyResolver(_In_ CModel * pModel)
+	{
+		if (pModel == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		m_pModel = pModel;
+	}
+
+	const CModelPropertyResolver::RESOLVERRESOURCE & CModelPropertyResolver::findResource(_In_ UniqueResourceID nResourceID)
+	{
+		auto iIterator = m_Resources.find(nResourceID);
+		if (iIterator != m_Resources.end())
+			return iIterator->second;
+
+		RESOLVERRESOURCE Resource;
+		Resource.m_pColorGroup = nullptr;
+		Resource.m_pBaseMaterials = nullptr;
+		Resource.m_pTexture2DGroup = nullptr;
+
+		if (nResourceID != 0) {
+			CModelResource * pResource = m_pModel->findResource(nResourceID).get();
+			Resource.m_pColorGroup = dynamic_cast<CModelColorGroupResource *>(pResource);
+			Resource.m_pBaseMaterials = dynamic_cast<CModelBaseMaterialResource *>(pResource);
+			Resource.m_pTexture2DGroup = dynamic_cast<CModelTexture2DGroupResource *>(pResource);
+		}
+
+		return m_Resources.insert(std::make_pair(nResourceID, Resource)).first->second;
+	}
+
+	const MESHINFORMATION_PROPERTIES * CModelPropertyResolver::getFaceProperties(_In_ CMeshInformation_Properties * pInformation, _In_ nfUint32 nFaceIndex)
+	{
+		const MESHINFORMATION_PROPERTIES * pFaceData = (const MESHINFORMATION_PROPERTIES *)pInformation->getFaceData(nFaceIndex);
+		if ((pFaceData != nullptr) && (pFaceData->m_nUniqueResourceID != 0))
+			return pFaceData;
+
+		// faces without a property take the property of the object
+		return (const MESHINFORMATION_PROPERTIES *)pInformation->getDefaultData();
+	}
+
+	void CModelPropertyResolver::resolveColors(_In_ CMeshInformation_Properties * pInformation, _In_ nfUint32 nFaceCount, _Out_ nfFloat * pRGBAValues, _Out_ UniqueResourceID * pResourceIDs)
+	{
+		if ((nFaceCount > 0) && ((pRGBAValues == nullptr) || (pResourceIDs == nullptr)))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		for (nfUint32 nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
+			nfFloat * pFaceRGBA = &pRGBAValues[nFaceIndex * 12];
+			nfColor Colors[3] = { 0, 0, 0 };
+			UniqueResourceID nResourceID = 0;
+
+			const MESHINFORMATION_PROPERTIES * pFaceData = (pInformation != nullptr) ? getFaceProperties(pInformation, nFaceIndex) : nullptr;
+			if (pFaceData != nullptr) {
+				const RESOLVERRESOURCE & Resource = findResource(pFaceData->m_nUniqueResourceID);
+				if (Resource.m_pColorGroup != nullptr) {
+					for (nfUint32 j = 0; j < 3; j++)
+						Colors[j] = Resource.m_pColorGroup->getColor(pFaceData->m_nPropertyIDs[j]);
+					nResourceID = pFaceData->m_nUniqueResourceID;
+				}
+				else if (Resource.m_pBaseMaterials != nullptr) {
+					// base materials apply to the whole face
+					Colors[0] = Resource.m_pBaseMaterials->getBaseMaterial(pFaceData->m_nPropertyIDs[0])->getDisplayColor();
+					Colors[1] = Colors[0];
+					Colors[2] = Colors[0];
+					nResourceID = pFaceData->m_nUniqueResourceID;
+				}
+			}
+
+			for (nfUint32 j = 0; j < 3; j++) {
+				pFaceRGBA[j * 4 + 0] = (nfFloat)(Colors[j] & 0xff) / 255.0f;
+				pFaceRGBA[j * 4 + 1] = (nfFloat)((Colors[j] >> 8) & 0xff) / 255.0f;
+				pFaceRGBA[j * 4 + 2] = (nfFloat)((Colors[j] >> 16) & 0xff) / 255.0f;
+				pFaceRGBA[j * 4 + 3] = (nfFloat)((Colors[j] >> 24) & 0xff) / 255.0f;
+			}
+			pResourceIDs[nFaceIndex] = nResourceID;
+		}
+	}
+
+	void CModelPropertyResolver::resolveTex2Coords(_In_ CMeshInformation_Properties * pInformation, _In_ nfUint32 nFaceCount, _Out_ nfDouble * pUVValues, _Out_ UniqueResourceID * pResourceIDs)
+	{
+		if ((nFaceCount > 0) && ((pUVValues == nullptr) || (pResourceIDs == nullptr)))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		for (nfUint32 nFaceIndex = 0; nFaceIndex < nFaceCount; nFaceIndex++) {
+			nfDouble * pFaceUV = &pUVValues[nFaceIndex * 6];
+			UniqueResourceID nResourceID = 0;
+
+			const MESHINFORMATION_PROPERTIES * pFaceData = (pInformation != nullptr) ? getFaceProperties(pInformation, nFaceIndex) : nullptr;
+			if (pFaceData != nullptr) {
+				const RESOLVERRESOURCE & Resource = findResource(pFaceData->m_nUniqueResourceID);
+				if (Resource.m_pTexture2DGroup != nullptr) {
+					for (nfUint32 j = 0; j < 3; j++) {
+						MODELTEXTURE2DCOORDINATE UV = Resource.m_pTexture2DGroup->getUVCoordinate(pFaceData->m_nPropertyIDs[j]);
+						pFaceUV[j * 2 + 0] = UV.m_dU;
+						pFaceUV[j * 2 + 1] = UV.m_dV;
+					}
+					nResourceID = pFaceData->m_nUniqueResourceID;
+				}
+			}
+
+			if (nResourceID == 0) {
+				for (nfUint32 j = 0; j < 6; j++)
+					pFaceUV[j] = 0.0;
+			}
+			pResourceIDs[nFaceIndex] = nResourceID;
+		}
+	}
+
+}
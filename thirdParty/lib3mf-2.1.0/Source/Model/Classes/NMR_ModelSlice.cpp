@@ -34,17 +34,21 @@ A Model Slice represents a single slice as vertices and polygons
 #include "Model/Classes/NMR_ModelSlice.h"
 #include "Common/NMR_Exception.h"
 
+#include <algorithm>
+
 namespace NMR {
 	CSlice::CSlice(nfDouble dZTop)
 	{
 		m_dZTop = dZTop;
+		m_PolygonOffsets.push_back(0);
 	}
 
 	CSlice::CSlice(CSlice& other)
 	{
 		m_dZTop = other.m_dZTop;
 		m_Vertices = other.m_Vertices;
-		m_Polygons = other.m_Polygons;
+		m_PolygonOffsets = other.m_PolygonOffsets;
+		m_PolygonIndices = other.m_PolygonIndices;
 	}
 
 	CSlice::~CSlice()
@@ -53,28 +57,30 @@ namespace NMR {
 
 	nfUint32 CSlice::beginPolygon()
 	{
-		m_Polygons.push_back(std::vector<nfUint32>());
-		return (nfUint32)m_Polygons.size() - 1;
+		m_PolygonOffsets.push_back((nfUint32)m_PolygonIndices.size());
+		return (nfUint32)m_PolygonOffsets.size() - 2;
 	}
 
 	void CSlice::Clear()
 	{
-		m_Polygons.clear();
+		m_PolygonOffsets.resize(1);
+		m_PolygonIndices.clear();
 		m_Vertices.clear();
 	}
 
 	nfUint32 CSlice::addVertex(nfFloat x, nfFloat y)
 	{
-		SLICENODE cNode;
-
-		cNode.m_position.m_fields[0] = x;
-		cNode.m_position.m_fields[1] = y;
+		NVEC2 vVertex;
+		vVertex.m_fields[0] = x;
+		vVertex.m_fields[1] = y;
+		m_Vertices.push_back(vVertex);
 
-		cNode.m_index = (nfUint32)m_Vertices.size();
-
-		m_Vertices.push_back(cNode);
+		return (nfUint32)m_Vertices.size() - 1;
+	}
 
-		return cNode.m_index;
+	void CSlice::reserveVertices(nfUint32 nCount)
+	{
+		m_Vertices.reserve(nCount);
 	}
 
 	void CSlice::getVertex(nfUint32 nIndex, nfFloat *x, nfFloat *y)
@@ -82,35 +88,66 @@ namespace NMR {
 		if (nIndex >= m_Vertices.size())
 			throw CNMRException(NMR_ERROR_INVALIDINDEX);
 
-		*x = m_Vertices[nIndex].m_position.m_values.x;
-		*y = m_Vertices[nIndex].m_position.m_values.y;
+		*x = m_Vertices[nIndex].m_values.x;
+		*y = m_Vertices[nIndex].m_values.y;
 	}
 
 	void CSlice::clearPolygon(nfUint32 nPolygonIndex)
 	{
-		if (nPolygonIndex >= m_Polygons.size())
+		setPolygonIndices(nPolygonIndex, 0, nullptr);
+	}
+
+	void CSlice::checkPolygonIndices(nfUint32 nPolygonIndex, nfUint32 nCount, const nfUint32 * pIndices)
+	{
+		if (nPolygonIndex >= getPolygonCount())
 			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		m_Polygons[nPolygonIndex].clear();
+
+		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
+			if (pIndices[nIndex] >= m_Vertices.size())
+				throw CNMRException(NMR_ERROR_INVALID_SLICESEGMENT_VERTEXINDEX);
+			if ((nIndex > 0) && (pIndices[nIndex - 1] == pIndices[nIndex]))
+				throw CNMRException(NMR_ERROR_INVALID_SLICESEGMENT_VERTEXINDEX);
+		}
 	}
 
 	void CSlice::addPolygonIndex(nfUint32 nPolygonIndex, nfUint32 nIndex)
 	{
-		if (nPolygonIndex >= m_Polygons.size())
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+		checkPolygonIndices(nPolygonIndex, 1, &nIndex);
 
-		if (nIndex >= m_Vertices.size())
+		nfUint32 nEnd = m_PolygonOffsets[nPolygonIndex + 1];
+		if ((nEnd > m_PolygonOffsets[nPolygonIndex]) && (m_PolygonIndices[nEnd - 1] == nIndex))
 			throw CNMRException(NMR_ERROR_INVALID_SLICESEGMENT_VERTEXINDEX);
 
-		if (m_Polygons[nPolygonIndex].size() > 0) {
-			if (m_Polygons[nPolygonIndex][m_Polygons[nPolygonIndex].size()-1] == nIndex)
-				throw CNMRException(NMR_ERROR_INVALID_SLICESEGMENT_VERTEXINDEX);
+		// Appending to the last polygon is the common case, all others have to shift their successors
+		m_PolygonIndices.insert(m_PolygonIndices.begin() + nEnd, nIndex);
+		for (size_t nPolygon = nPolygonIndex + 1; nPolygon < m_PolygonOffsets.size(); nPolygon++)
+			m_PolygonOffsets[nPolygon]++;
+	}
+
+	void CSlice::setPolygonIndices(nfUint32 nPolygonIndex, nfUint32 nCount, const nfUint32 * pIndices)
+	{
+		if ((nCount > 0) && (!pIndices))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		checkPolygonIndices(nPolygonIndex, nCount, pIndices);
+
+		nfUint32 nBegin = m_PolygonOffsets[nPolygonIndex];
+		nfUint32 nEnd = m_PolygonOffsets[nPolygonIndex + 1];
+		nfUint32 nOldCount = nEnd - nBegin;
+		if (nCount > nOldCount)
+			m_PolygonIndices.insert(m_PolygonIndices.begin() + nEnd, nCount - nOldCount, 0);
+		else
+			m_PolygonIndices.erase(m_PolygonIndices.begin() + nBegin + nCount, m_PolygonIndices.begin() + nEnd);
+		std::copy(pIndices, pIndices + nCount, m_PolygonIndices.begin() + nBegin);
+
+		if (nCount != nOldCount) {
+			for (size_t nPolygon = nPolygonIndex + 1; nPolygon < m_PolygonOffsets.size(); nPolygon++)
+				m_PolygonOffsets[nPolygon] = m_PolygonOffsets[nPolygon] + nCount - nOldCount;
 		}
-		m_Polygons[nPolygonIndex].push_back(nIndex);
 	}
 
 	nfUint32 CSlice::getPolygonCount()
 	{
-		return (nfUint32)m_Polygons.size();
+		return (nfUint32)m_PolygonOffsets.size() - 1;
 	}
 
 	nfDouble CSlice::getTopZ()
@@ -123,9 +160,17 @@ namespace NMR {
 		m_dZTop = dZTop;
 	}
 
-	_Ret_notnull_ SLICENODE *CSlice::getNode(nfUint32 nIndex)
+	_Ret_maybenull_ const NVEC2 * CSlice::getVertices()
 	{
-		return &m_Vertices[nIndex];
+		return m_Vertices.data();
+	}
+
+	_Ret_maybenull_ const nfUint32 * CSlice::getPolygonIndices(nfUint32 nPolygonIndex)
+	{
+		if (nPolygonIndex >= getPolygonCount())
+			throw CNMRException(NMR_ERROR_INVALIDINDEX);
+
+		return m_PolygonIndices.data() + m_PolygonOffsets[nPolygonIndex];
 	}
 
 	nfUint32 CSlice::getVertexCount()
@@ -135,9 +180,11 @@ namespace NMR {
 
 	bool CSlice::allPolygonsAreClosed()
 	{
-		for (auto polygon : m_Polygons) {
-			if (polygon.size() > 1) {
-				if (*polygon.begin() != *polygon.rbegin()) {
+		for (size_t nPolygon = 0; nPolygon + 1 < m_PolygonOffsets.size(); nPolygon++) {
+			nfUint32 nBegin = m_PolygonOffsets[nPolygon];
+			nfUint32 nEnd = m_PolygonOffsets[nPolygon + 1];
+			if (nEnd - nBegin > 1) {
+				if (m_PolygonIndices[nBegin] != m_PolygonIndices[nEnd - 1]) {
 					return false;
 				}
 			}
@@ -147,33 +194,37 @@ namespace NMR {
 
 	bool CSlice::isPolygonValid(nfUint32 nPolygonIndex)
 	{
-		if (nPolygonIndex >= m_Polygons.size())
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		if (m_Polygons[nPolygonIndex].size() > 2)
+		nfUint32 nCount = getPolygonIndexCount(nPolygonIndex);
+		if (nCount > 2)
 			return true;
-		if (m_Polygons[nPolygonIndex].size() <= 1)
+		if (nCount <= 1)
 			return false;
 		// closed polygon must have 3 points or more.
-		return m_Polygons[nPolygonIndex][0] != m_Polygons[nPolygonIndex][1];
+		const nfUint32 * pIndices = getPolygonIndices(nPolygonIndex);
+		return pIndices[0] != pIndices[1];
 	}
 
 	nfUint32 CSlice::getPolygonIndex(nfUint32 nPolygonIndex, nfUint32 nIndexOfIndex)
 	{
-		if (nPolygonIndex >= m_Polygons.size())
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-
-		if (nIndexOfIndex >= m_Polygons[nPolygonIndex].size())
+		if (nIndexOfIndex >= getPolygonIndexCount(nPolygonIndex))
 			throw CNMRException(NMR_ERROR_INVALIDINDEX);
 
-		return m_Polygons[nPolygonIndex][nIndexOfIndex];
+		return m_PolygonIndices[m_PolygonOffsets[nPolygonIndex] + nIndexOfIndex];
 	}
 
 	nfUint32 CSlice::getPolygonIndexCount(nfUint32 nPolygonIndex)
 	{
-		if (nPolygonIndex >= m_Polygons.size())
+		if (nPolygonIndex >= getPolygonCount())
 			throw CNMRException(NMR_ERROR_INVALIDINDEX);
 
-		return (nfUint32)m_Polygons[nPolygonIndex].size();
+		return m_PolygonOffsets[nPolygonIndex + 1] - m_PolygonOffsets[nPolygonIndex];
 	}
-}
 
+	nfUint64 CSlice::getMemoryUsage()
+	{
+		return sizeof(CSlice)
+			+ m_Vertices.capacity() * sizeof(NVEC2)
+			+ m_PolygonOffsets.capacity() * sizeof(nfUint32)
+			+ m_PolygonIndices.capacity() * sizeof(nfUint32);
+	}
+}
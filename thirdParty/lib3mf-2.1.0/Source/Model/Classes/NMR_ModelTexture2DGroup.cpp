@@ -42,7 +42,6 @@ namespace NMR {
 		_In_ CModel * pModel, _In_ PModelTexture2DResource pTexture2D)
 		: CModelResource(sID, pModel)
 	{
-		m_nNextPropertyID = 1;
 		if (!pTexture2D.get())
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		m_pTexture2D = pTexture2D;
@@ -50,51 +49,65 @@ namespace NMR {
 
 	nfUint32 CModelTexture2DGroupResource::addUVCoordinate(_In_ MODELTEXTURE2DCOORDINATE UV)
 	{
-		nfUint32 nID = m_nNextPropertyID;
 		if (getCount() >= XML_3MF_MAXRESOURCEINDEX) {
 			throw CNMRException(NMR_ERROR_TOOMANYCOLORS);
 		}
 
-		m_pUVCoordinates.insert(std::make_pair(nID, UV));
-
-		m_nNextPropertyID++;
+		nfUint32 nID = m_pUVCoordinates.add(UV);
 
 		clearResourceIndexMap();
 
 		return nID;
 	}
 
+	nfUint32 CModelTexture2DGroupResource::addUVCoordinates(_In_ const MODELTEXTURE2DCOORDINATE * pUVs, _In_ nfUint32 nCount)
+	{
+		if ((nCount > 0) && (pUVs == nullptr))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if ((nfUint64)getCount() + nCount > XML_3MF_MAXRESOURCEINDEX) {
+			throw CNMRException(NMR_ERROR_TOOMANYCOLORS);
+		}
+
+		nfUint32 nFirstID = m_pUVCoordinates.getNextPropertyID();
+		m_pUVCoordinates.reserve(nCount);
+		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++)
+			m_pUVCoordinates.add(pUVs[nIndex]);
+
+		clearResourceIndexMap();
+
+		return nFirstID;
+	}
+
 	nfUint32 CModelTexture2DGroupResource::getCount()
 	{
-		return (nfUint32)m_pUVCoordinates.size();
+		return m_pUVCoordinates.getCount();
 	}
 
 	void CModelTexture2DGroupResource::setUVCoordinate(_In_ ModelPropertyID nPropertyID, _In_ MODELTEXTURE2DCOORDINATE sCoordinate)
 	{
-		auto iIterator = m_pUVCoordinates.find(nPropertyID);
-		if (iIterator != m_pUVCoordinates.end()) {
-			iIterator->second = sCoordinate;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		m_pUVCoordinates.get(nPropertyID) = sCoordinate;
 	}
 
 	void CModelTexture2DGroupResource::removePropertyID(_In_ ModelPropertyID nPropertyID)
 	{
-		m_pUVCoordinates.erase(nPropertyID);
+		m_pUVCoordinates.remove(nPropertyID);
 		clearResourceIndexMap();
 	}
 
 	MODELTEXTURE2DCOORDINATE CModelTexture2DGroupResource::getUVCoordinate(_In_ ModelPropertyID nPropertyID)
 	{
-		auto iIterator = m_pUVCoordinates.find(nPropertyID);
-		if (iIterator != m_pUVCoordinates.end()) {
-			return iIterator->second;
-		}
-		else {
-			throw CNMRException(NMR_ERROR_INVALIDINDEX);
-		}
+		return m_pUVCoordinates.get(nPropertyID);
+	}
+
+	void CModelTexture2DGroupResource::getUVCoordinates(_Out_ MODELTEXTURE2DCOORDINATE * pUVs)
+	{
+		if (pUVs == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		m_pUVCoordinates.forEach([&pUVs](ModelPropertyID, MODELTEXTURE2DCOORDINATE & UV) {
+			*pUVs = UV;
+			pUVs++;
+		});
 	}
 
 	void CModelTexture2DGroupResource::mergeFrom(_In_ CModelTexture2DGroupResource * pSourceTexture2DGroup)
@@ -102,28 +115,16 @@ namespace NMR {
 		if (pSourceTexture2DGroup == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		
-		nfUint32 nCount = pSourceTexture2DGroup->getCount();
-		pSourceTexture2DGroup->buildResourceIndexMap();
-
-		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
-			ModelPropertyID nPropertyID;
-			pSourceTexture2DGroup->mapResourceIndexToPropertyID(nIndex, nPropertyID);
-			MODELTEXTURE2DCOORDINATE UVCoordinate = pSourceTexture2DGroup->getUVCoordinate(nPropertyID);
-			addUVCoordinate(UVCoordinate);
+		std::vector<MODELTEXTURE2DCOORDINATE> UVCoordinates(pSourceTexture2DGroup->getCount());
+		if (!UVCoordinates.empty()) {
+			pSourceTexture2DGroup->getUVCoordinates(UVCoordinates.data());
+			addUVCoordinates(UVCoordinates.data(), (nfUint32)UVCoordinates.size());
 		}
-		clearResourceIndexMap();
 	}
 
 	void CModelTexture2DGroupResource::buildResourceIndexMap()
 	{
-		m_ResourceIndexMap.clear();
-		m_ResourceIndexMap.reserve(m_pUVCoordinates.size());
-
-		auto iIterator = m_pUVCoordinates.begin();
-		while (iIterator != m_pUVCoordinates.end()) {
-			m_ResourceIndexMap.push_back(iIterator->first);
-			iIterator++;
-		}
+		m_pUVCoordinates.getPropertyIDs(m_ResourceIndexMap);
 
 		m_bHasResourceIndexMap = true;
 	}
@@ -97,6 +97,17 @@ namespace NMR {
 		return m_uniqueID;
 	}
 
+	CResourceHandler::CResourceHandler()
+		: m_nNextUniqueID(1)
+	{
+	}
+
+	CResourceHandler::~CResourceHandler()
+	{
+		// model paths and package resource IDs reference each other
+		clear();
+	}
+
 	PPackageModelPath CResourceHandler::makePackageModelPath(std::string sPath)
 	{
 		if (findPackageModelPath(sPath)) {
@@ -117,7 +128,7 @@ namespace NMR {
 		return vctPModelPaths;
 	}
 
-	PPackageModelPath CResourceHandler::findPackageModelPath(std::string sPath)
+	PPackageModelPath CResourceHandler::findPackageModelPath(const std::string & sPath)
 	{
 		auto it = m_PathToModelPath.find(sPath);
 		if (it != m_PathToModelPath.end())
@@ -128,48 +139,51 @@ namespace NMR {
 	}
 
 	// this is supposed to be the only way to generate a CPackageResourceID
-	PPackageResourceID CResourceHandler::makePackageResourceID(std::string path, ModelResourceID id)
+	PPackageResourceID CResourceHandler::makePackageResourceID(const std::string & path, ModelResourceID id)
 	{
 		PPackageModelPath pModelPath = findPackageModelPath(path);
 		if (!pModelPath) {
 			pModelPath = makePackageModelPath(path);
 		}
-		// This can be optimized
-		if (findResourceIDByPair(pModelPath->getPath(), id))
+
+		if (findResourceIDByPair(pModelPath, id))
 			throw CNMRException(NMR_ERROR_DUPLICATERESOURCEID);
 
 		PPackageResourceID pPackageResourceID = std::make_shared<CPackageResourceID>(this, pModelPath, id);
-		UniqueIDPackageIdMap::const_iterator biggestId = std::max_element(m_resourceIDs.begin(), m_resourceIDs.end(), [](const UniqueIdPackageIdPair & v1, const UniqueIdPackageIdPair v2) {
-			return v1.first < v2.first;
-		});
-		if (biggestId != m_resourceIDs.end()) {
-			pPackageResourceID->setUniqueID(int(biggestId->first) + 1);
-		} else {
-			pPackageResourceID->setUniqueID(1);
-		}
 
+		// Unique IDs are handed out in increasing order, so the lookup table only ever grows at its end
+		UniqueResourceID nUniqueID = m_nNextUniqueID++;
+		pPackageResourceID->setUniqueID(nUniqueID);
+		if (m_resourceIDs.size() <= nUniqueID)
+			m_resourceIDs.resize(nUniqueID + 1);
+		m_resourceIDs[nUniqueID] = pPackageResourceID;
+
+		pModelPath->m_ResourceIDs.insert(std::make_pair(id, pPackageResourceID));
 
-		m_resourceIDs.insert(std::make_pair(pPackageResourceID->getUniqueID(), pPackageResourceID));
-		m_IdAndPathToPackageResourceIDs.insert(std::make_pair(std::make_pair(id, pModelPath), pPackageResourceID));
 		return pPackageResourceID;
 	}
 
 	PPackageResourceID CResourceHandler::findResourceIDByUniqueID(UniqueResourceID id)
 	{
-		auto it = m_resourceIDs.find(id);
-		if (it != m_resourceIDs.end())
-		{
-			return it->second;
-		}
+		if (id < m_resourceIDs.size())
+			return m_resourceIDs[id];
 		return nullptr;
 	}
-	
-	PPackageResourceID CResourceHandler::findResourceIDByPair(std::string path, ModelResourceID id)
+
+	PPackageResourceID CResourceHandler::findResourceIDByPair(const std::string & path, ModelResourceID id)
 	{
 		PPackageModelPath pModelPath = findPackageModelPath(path);
 		if (pModelPath) {
-			auto it = m_IdAndPathToPackageResourceIDs.find(std::make_pair(id, pModelPath));
-			if (it != m_IdAndPathToPackageResourceIDs.end())
+			return findResourceIDByPair(pModelPath, id);
+		}
+		return nullptr;
+	}
+
+	PPackageResourceID CResourceHandler::findResourceIDByPair(const PPackageModelPath & pModelPath, ModelResourceID id)
+	{
+		if (pModelPath) {
+			auto it = pModelPath->m_ResourceIDs.find(id);
+			if (it != pModelPath->m_ResourceIDs.end())
 			{
 				return it->second;
 			}
@@ -182,52 +196,49 @@ namespace NMR {
 		if (pPackageResourceID == nullptr || pNewPath == nullptr) {
 			throw CNMRException(NMR_ERROR_INVALIDPOINTER);
 		}
-
 		PPackageModelPath pOldPath = pPackageResourceID->m_pModelPath;
-
 		if (pNewPath == pOldPath) {
 			return;
 		}
 
-		auto itOld = m_IdAndPathToPackageResourceIDs.find(std::make_pair(pPackageResourceID->m_id, pOldPath));
-		if (itOld == m_IdAndPathToPackageResourceIDs.end())
+		auto itOld = pOldPath->m_ResourceIDs.find(pPackageResourceID->m_id);
+		if (itOld == pOldPath->m_ResourceIDs.end())
 		{
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		}
-
-		auto itNew = m_IdAndPathToPackageResourceIDs.find(std::make_pair(pPackageResourceID->m_id, pNewPath));
-		if (itNew != m_IdAndPathToPackageResourceIDs.end())
+		if (pNewPath->m_ResourceIDs.find(pPackageResourceID->m_id) != pNewPath->m_ResourceIDs.end())
 		{
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		}
-
-		m_IdAndPathToPackageResourceIDs.erase(itOld); 
+		pOldPath->m_ResourceIDs.erase(itOld); 
 		//what if idOld was the last one standing pointint to PackageModelPath?
-		
 		pPackageResourceID->m_pModelPath = pNewPath;
-		m_IdAndPathToPackageResourceIDs.insert(std::make_pair(std::make_pair(pPackageResourceID->m_id, pNewPath), pPackageResourceID));
+		pNewPath->m_ResourceIDs.insert(std::make_pair(pPackageResourceID->m_id, pPackageResourceID));
 	}
 
 	void CResourceHandler::removePackageResourceID(PPackageResourceID pPackageResourceID)
 	{
-		auto it = m_IdAndPathToPackageResourceIDs.find(std::make_pair(pPackageResourceID->m_id, pPackageResourceID->getPackageModelPath()));
-		if (it == m_IdAndPathToPackageResourceIDs.end())
+		PPackageModelPath pModelPath = pPackageResourceID->getPackageModelPath();
+		auto it = pModelPath->m_ResourceIDs.find(pPackageResourceID->m_id);
+		if (it == pModelPath->m_ResourceIDs.end())
 		{
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		}
-
-		auto itID = m_resourceIDs.find(pPackageResourceID->m_uniqueID);
-		if (itID == m_resourceIDs.end())
+		UniqueResourceID nUniqueID = pPackageResourceID->m_uniqueID;
+		if ((nUniqueID >= m_resourceIDs.size()) || (m_resourceIDs[nUniqueID] != pPackageResourceID))
 		{
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 		}
-		m_IdAndPathToPackageResourceIDs.erase(it);
-		m_resourceIDs.erase(itID);
+		pModelPath->m_ResourceIDs.erase(it);
+		m_resourceIDs[nUniqueID] = nullptr;
 	}
 
 	void CResourceHandler::clear() {
 		m_resourceIDs.clear();
-		m_IdAndPathToPackageResourceIDs.clear();
+		m_nNextUniqueID = 1;
+		for (auto pModelPathPair : m_PathToModelPath) {
+			pModelPathPair.second->m_ResourceIDs.clear();
+		}
 	}
 
 }
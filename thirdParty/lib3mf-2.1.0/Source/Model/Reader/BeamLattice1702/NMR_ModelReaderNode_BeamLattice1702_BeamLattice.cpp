@@ -44,6 +44,7 @@ NMR_ModelReaderNode_BeamLattice1702_BeamLattice.cpp covers the official 3MF beam
 #include "Common/NMR_StringUtils.h"
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_Exception_Windows.h"
+#include "Common/NMR_Trace.h"
 #include <cmath>
 
 namespace NMR {
@@ -66,6 +67,8 @@ namespace NMR {
 
 	void CModelReaderNode_BeamLattice1702_BeamLattice::parseXML(_In_ CXmlReader * pXMLReader)
 	{
+		NMR_TRACE_SCOPE("CModelReaderNode_BeamLattice1702_BeamLattice::parseXML");
+
 		// Parse name
 		parseName(pXMLReader);
 
@@ -109,6 +112,7 @@ namespace NMR {
 			if ( std::isnan(dValue) || (dValue <= 0) || (dValue > XML_3MF_MAXIMUMCOORDINATEVALUE) )
 				throw CNMRException(NMR_ERROR_BEAMLATTICEINVALIDATTRIBUTE);
 			m_dDefaultRadius = dValue;
+			m_pMesh->setDefaultBeamRadius(dValue);
 		}
 		else if ( (strcmp(pAttributeName, XML_3MF_ATTRIBUTE_BEAMLATTICE_MINLENGTH) == 0) ||
 			(strcmp(pAttributeName, XML_3MF_ATTRIBUTE_BEAMLATTICE_PRECISION) == 0) )	// legacy
@@ -144,6 +148,7 @@ namespace NMR {
 		}
 		else if (strcmp(pAttributeName, XML_3MF_ATTRIBUTE_BEAMLATTICE_CAPMODE) == 0) {
 			m_eDefaultCapMode = stringToCapMode(pAttributeValue);
+			m_pMesh->setBeamLatticeCapMode(m_eDefaultCapMode);
 		}
 		else if (strcmp(pAttributeName, XML_3MF_ATTRIBUTE_BEAMLATTICE_BALLMODE) == 0) {
 			m_pMesh->setBeamLatticeBallMode(stringToBallMode(pAttributeValue));
@@ -54,7 +54,7 @@ NMR_KeyStoreOpcPackageReader.cpp defines an OPC Package reader in a portable way
 
 namespace NMR {
 	CKeyStoreOpcPackageReader::CKeyStoreOpcPackageReader(PImportStream pImportStream, CModelContext const & context)
-		:m_pContext(context)
+		:m_pContext(context), m_bPreloadEncryptedParts(false)
 	{
 		if (!context.isComplete())
 			throw CNMRException(NMR_ERROR_INVALIDPOINTER);
@@ -91,8 +91,12 @@ namespace NMR {
 				ContentEncryptionDescriptor p = secureContext->getDekCtx();
 				p.m_sDekDecryptData.m_sParams = params;
 
+				PImportStream cipherStream = pPart->getImportStream();
+				if (m_bPreloadEncryptedParts)
+					cipherStream = cipherStream->copyToMemory();
+
 				PImportStream stream;
-				PImportStream decryptStream = std::make_shared<CImportStream_Encrypted>(pPart->getImportStream(), p);
+				PImportStream decryptStream = std::make_shared<CImportStream_Encrypted>(cipherStream, p);
 				if (params->isCompressed()) {
 					PImportStream decompressStream = std::make_shared<CImportStream_Compressed>(decryptStream);
 					stream = decompressStream;
@@ -116,6 +120,14 @@ namespace NMR {
 		checkAuthenticatedTags();
 	}
 
+	void CKeyStoreOpcPackageReader::setPreloadEncryptedParts(_In_ nfBool bPreload) {
+		m_bPreloadEncryptedParts = bPreload;
+	}
+
+	nfBool CKeyStoreOpcPackageReader::isEncryptedPart(_In_ const std::string & sURI) {
+		return m_encryptedParts.find(sURI) != m_encryptedParts.end();
+	}
+
 	NMR::PImportStream CKeyStoreOpcPackageReader::findKeyStoreStream() {
 		COpcPackageRelationship * pKeyStoreRelation = m_pPackageReader->findRootRelation(PACKAGE_KEYSTORE_RELATIONSHIP_TYPE, true);
 		if (pKeyStoreRelation != nullptr) {
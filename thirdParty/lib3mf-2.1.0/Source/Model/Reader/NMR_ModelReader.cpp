@@ -43,7 +43,7 @@ A model reader reads in a model file and generates an in-memory representation o
 namespace NMR {
 
 	CModelReader::CModelReader(_In_ PModel pModel)
-		:CModelContext(pModel)
+		:CModelContext(pModel), m_nDecryptionThreadCount(0), m_nSliceThreadCount(0)
 	{
 	}
 
@@ -82,4 +82,24 @@ namespace NMR {
 		m_RelationsToRead.erase(sRelationShipType);
 	}
 
+	void CModelReader::setDecryptionThreadCount(_In_ nfUint32 nThreadCount)
+	{
+		m_nDecryptionThreadCount = nThreadCount;
+	}
+
+	nfUint32 CModelReader::getDecryptionThreadCount()
+	{
+		return m_nDecryptionThreadCount;
+	}
+
+	void CModelReader::setSliceThreadCount(_In_ nfUint32 nThreadCount)
+	{
+		m_nSliceThreadCount = nThreadCount;
+	}
+
+	nfUint32 CModelReader::getSliceThreadCount()
+	{
+		return m_nSliceThreadCount;
+	}
+
 }
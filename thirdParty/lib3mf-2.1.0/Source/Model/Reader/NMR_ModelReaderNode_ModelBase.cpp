@@ -43,6 +43,7 @@ A model reader node is an abstract base class for all XML nodes of a 3MF Model S
 #include "Common/3MF_ProgressMonitor.h"
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_StringUtils.h"
+#include "Common/NMR_Trace.h"
 
 #include <iostream>
 #include <sstream>
@@ -94,6 +95,8 @@ namespace NMR {
 
 	void CModelReaderNode_ModelBase::parseXML(_In_ CXmlReader * pXMLReader)
 	{
+		NMR_TRACE_SCOPE("CModelReaderNode_ModelBase::parseXML");
+
 		// Parse name
 		parseName(pXMLReader);
 
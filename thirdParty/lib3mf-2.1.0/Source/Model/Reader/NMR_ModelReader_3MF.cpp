@@ -45,9 +45,11 @@ NMR_ModelReader_3MF.cpp implements the Model Reader Class for
 #include "Model/Classes/NMR_ModelAttachment.h" 
 
 #include "Model/Reader/Slice1507/NMR_ModelReader_Slice1507_SliceRefModel.h"
+#include "Model/Reader/Slice1507/NMR_ModelReader_Slice1507_SliceSplitter.h"
 #include "Model/Reader/NMR_ModelReader_InstructionElement.h"
 
 #include "Common/3MF_ProgressMonitor.h"
+#include "Common/NMR_Trace.h"
 
 namespace NMR {
 
@@ -57,7 +59,7 @@ namespace NMR {
 		// empty on purpose
 	}
 
-	void readProductionAttachmentModels(_In_ PModel pModel, _In_ PModelWarnings pWarnings, _In_ PProgressMonitor pProgressMonitor)
+	void readProductionAttachmentModels(_In_ PModel pModel, _In_ PModelWarnings pWarnings, _In_ PProgressMonitor pProgressMonitor, _In_ nfUint32 nSliceThreadCount)
 	{
 		nfUint32 prodAttCount = pModel->getProductionAttachmentCount();
 		for (nfInt32 i = prodAttCount-1; i >=0; i--)
@@ -71,6 +73,15 @@ namespace NMR {
 			std::string sPath = pProdAttachment->getPathURI();
 			PImportStream pSubModelStream = pProdAttachment->getStream();
 
+			// With multiple threads, the content of the slices is removed from the part first
+			// and read in parallel once its slicestacks exist
+			PModelReader_Slice1507_SliceSplitter pSliceSplitter;
+			nfUint32 nResourceCount = pModel->getResourceCount();
+			if (nSliceThreadCount > 1) {
+				pSliceSplitter = std::make_shared<CModelReader_Slice1507_SliceSplitter>(pSubModelStream);
+				pSubModelStream = pSliceSplitter->getSkeletonStream();
+			}
+
 			// Create XML Reader
 			PXmlReader pXMLReader = fnCreateXMLReaderInstance(pSubModelStream, pProgressMonitor);
 
@@ -112,17 +123,30 @@ namespace NMR {
 						throw CNMRException(NMR_ERROR_BUILDITEMNOTFOUND);
 				}
 			}
+
+			if (pSliceSplitter && pSliceSplitter->isSplit()) {
+				std::vector<PModelSliceStack> SliceStacks;
+				for (nfUint32 nIndex = nResourceCount; nIndex < pModel->getResourceCount(); nIndex++) {
+					PModelSliceStack pSliceStack = std::dynamic_pointer_cast<CModelSliceStack>(pModel->getResource(nIndex));
+					if (pSliceStack && (pSliceStack->OwnPath() == sPath))
+						SliceStacks.push_back(pSliceStack);
+				}
+				pSliceSplitter->readSlices(SliceStacks, pWarnings, pProgressMonitor, nSliceThreadCount);
+			}
 		}
 	}
 
 
 	void CModelReader_3MF::readStream(_In_ PImportStream pStream)
 	{
+		NMR_TRACE_SCOPE("CModelReader_3MF::readStream");
+
 		__NMRASSERT(pStream != nullptr);
 
 		nfBool bHasModel = false;
 
-		monitor()->SetProgressIdentifier(ProgressIdentifier::PROGRESS_READSTREAM);
+		monitor()->StartStatistics(ProgressIdentifier::PROGRESS_READSTREAM);
+		monitor()->AddToCounter(PROGRESSCOUNTER_PACKAGEBYTES, pStream->retrieveSize());
 
 		monitor()->SetProgressIdentifier(ProgressIdentifier::PROGRESS_EXTRACTOPCPACKAGE);
 		
@@ -130,7 +154,7 @@ namespace NMR {
 		PImportStream pModelStream = extract3MFOPCPackage(pStream);
 		
 		// before reading the root model, read the other models in the file
-		readProductionAttachmentModels(model(), warnings(), monitor());
+		readProductionAttachmentModels(model(), warnings(), monitor(), getSliceThreadCount());
 
 		monitor()->SetProgressIdentifier(ProgressIdentifier::PROGRESS_READROOTMODEL);
 		monitor()->ReportProgressAndQueryCancelled(true);
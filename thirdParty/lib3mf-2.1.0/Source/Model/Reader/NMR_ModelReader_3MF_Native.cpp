@@ -41,9 +41,14 @@ It uses libzip and irrxml to parse the OPC package.
 #include "Common/NMR_Exception.h" 
 #include "Common/NMR_Exception_Windows.h"
 #include "Common/NMR_StringUtils.h"
+#include "Common/NMR_ParallelFor.h"
 #include "Common/Platform/NMR_Platform.h"
+#include "Common/NMR_Trace.h"
 #include "Model/Reader/NMR_ModelReader_InstructionElement.h"
 
+#include <set>
+#include <vector>
+
 namespace NMR {
 
 	CModelReader_3MF_Native::CModelReader_3MF_Native(_In_ PModel pModel)
@@ -56,7 +61,10 @@ namespace NMR {
 
 	PImportStream CModelReader_3MF_Native::extract3MFOPCPackage(_In_ PImportStream pPackageStream)
 	{
+		NMR_TRACE_SCOPE("CModelReader_3MF_Native::extract3MFOPCPackage");
+
 		m_pPackageReader = std::make_shared<CKeyStoreOpcPackageReader>(pPackageStream, *this);
+		m_pPackageReader->setPreloadEncryptedParts(getDecryptionThreadCount() > 1);
 
 		COpcPackageRelationship * pModelRelation = m_pPackageReader->findRootRelation(PACKAGE_START_PART_RELATIONSHIP_TYPE, true);
 		if (pModelRelation == nullptr)
@@ -95,6 +103,7 @@ namespace NMR {
 			PImportStream pThumbnailStream = pThumbnailPart->getImportStream()->copyToMemory();
 			model()->addPackageThumbnail()->setStream(pThumbnailStream);
 			monitor()->IncrementProgress((double)pThumbnailStream->retrieveSize());
+			monitor()->AddToCounter(PROGRESSCOUNTER_ATTACHMENTBYTES, pThumbnailStream->retrieveSize());
 			monitor()->ReportProgressAndQueryCancelled(true);
 		}
 		
@@ -110,6 +119,8 @@ namespace NMR {
 
 	void CModelReader_3MF_Native::extractTexturesFromRelationships(_In_ std::string& sTargetPartURIDir, _In_ COpcPackagePart * pModelPart)
 	{
+		NMR_TRACE_SCOPE("CModelReader_3MF_Native::extractTexturesFromRelationships");
+
 		if (pModelPart == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
@@ -145,6 +156,7 @@ namespace NMR {
 					addTextureAttachment(sURI, pMemoryStream);
 
 					monitor()->IncrementProgress((double)pMemoryStream->retrieveSize());
+					monitor()->AddToCounter(PROGRESSCOUNTER_ATTACHMENTBYTES, pMemoryStream->retrieveSize());
 					monitor()->ReportProgressAndQueryCancelled(true);
 				}
 			}
@@ -154,6 +166,8 @@ namespace NMR {
 
 	void CModelReader_3MF_Native::extractCustomDataFromRelationships(_In_ std::string& sTargetPartURIDir, _In_ COpcPackagePart * pModelPart)
 	{
+		NMR_TRACE_SCOPE("CModelReader_3MF_Native::extractCustomDataFromRelationships");
+
 		if (pModelPart == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
@@ -184,6 +198,7 @@ namespace NMR {
 					model()->addAttachment(sURI, sRelationShipType, pMemoryStream);
 
 					monitor()->IncrementProgress((double)pMemoryStream->retrieveSize());
+					monitor()->AddToCounter(PROGRESSCOUNTER_ATTACHMENTBYTES, pMemoryStream->retrieveSize());
 					monitor()->ReportProgressAndQueryCancelled(true);
 				}
 				catch (CNMRException &e) {
@@ -207,11 +222,23 @@ namespace NMR {
 	
 	void CModelReader_3MF_Native::extractModelDataFromRelationships(_In_ std::string& sTargetPartURIDir, _In_ COpcPackagePart * pModelPart)
 	{
+		NMR_TRACE_SCOPE("CModelReader_3MF_Native::extractModelDataFromRelationships");
+
 		if (pModelPart == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
 		std::multimap<std::string, POpcPackageRelationship>& RelationShips = pModelPart->getRelationShips();
 
+		struct sProductionPart {
+			std::string m_sURI;
+			std::string m_sRelationShipType;
+			POpcPackagePart m_pPart;
+			PImportStream m_pMemoryStream;
+		};
+		std::vector<sProductionPart> ProductionParts;
+		std::vector<size_t> EncryptedPartIndices;
+		std::set<std::string> NewURIs;
+
 		for (auto iIterator = RelationShips.begin(); iIterator != RelationShips.end(); iIterator++) {
 			auto theRelationShip = iIterator->second;
 
@@ -222,22 +249,44 @@ namespace NMR {
 				if (!fnStartsWithPathDelimiter(sURI))
 					sURI = sTargetPartURIDir + sURI;
 
-				POpcPackagePart pPart = m_pPackageReader->createPart(sURI);
+				sProductionPart ProductionPart;
+				ProductionPart.m_sURI = sURI;
+				ProductionPart.m_sRelationShipType = sRelationShipType;
+				ProductionPart.m_pPart = m_pPackageReader->createPart(sURI);
 
-				// first, check if this attachment already is in model
-				PModelAttachment pModelAttachment = model()->findProductionModelAttachment(sURI);
-				if (pModelAttachment) {
-					// this attachment is already read
-					model()->addProductionAttachment(sURI, sRelationShipType, pModelAttachment->getStream(), false);
-				}
-				else {
-					// this is the first time this attachment is read
-					PImportStream pAttachmentStream = pPart->getImportStream();
-					PImportStream pMemoryStream = pAttachmentStream->copyToMemory();
-					if (pMemoryStream->retrieveSize() == 0)
-						warnings()->addException(CNMRException(NMR_ERROR_IMPORTSTREAMISEMPTY), mrwMissingMandatoryValue);
-					model()->addProductionAttachment(sURI, sRelationShipType, pMemoryStream, true);
+				// Encrypted parts read for the first time can be decrypted independently of the package
+				if (!model()->findProductionModelAttachment(sURI) && NewURIs.insert(sURI).second) {
+					if (m_pPackageReader->isEncryptedPart(ProductionPart.m_pPart->getURI()))
+						EncryptedPartIndices.push_back(ProductionParts.size());
 				}
+				ProductionParts.push_back(ProductionPart);
+			}
+		}
+
+		// Decrypt and decompress secure parts on the worker threads. Content encryption callbacks
+		// of different parts may run concurrently; the callbacks of one part stay on one thread.
+		if ((getDecryptionThreadCount() > 1) && (EncryptedPartIndices.size() > 1)) {
+			fnParallelFor(getDecryptionThreadCount(), EncryptedPartIndices.size(), [&](nfUint64 nIndex) {
+				sProductionPart & ProductionPart = ProductionParts[EncryptedPartIndices[(size_t)nIndex]];
+				ProductionPart.m_pMemoryStream = ProductionPart.m_pPart->getImportStream()->copyToMemory();
+			});
+		}
+
+		for (auto & ProductionPart : ProductionParts) {
+			// first, check if this attachment already is in model
+			PModelAttachment pModelAttachment = model()->findProductionModelAttachment(ProductionPart.m_sURI);
+			if (pModelAttachment) {
+				// this attachment is already read
+				model()->addProductionAttachment(ProductionPart.m_sURI, ProductionPart.m_sRelationShipType, pModelAttachment->getStream(), false);
+			}
+			else {
+				// this is the first time this attachment is read
+				PImportStream pMemoryStream = ProductionPart.m_pMemoryStream;
+				if (!pMemoryStream)
+					pMemoryStream = ProductionPart.m_pPart->getImportStream()->copyToMemory();
+				if (pMemoryStream->retrieveSize() == 0)
+					warnings()->addException(CNMRException(NMR_ERROR_IMPORTSTREAMISEMPTY), mrwMissingMandatoryValue);
+				model()->addProductionAttachment(ProductionPart.m_sURI, ProductionPart.m_sRelationShipType, pMemoryStream, true);
 			}
 		}
 	}
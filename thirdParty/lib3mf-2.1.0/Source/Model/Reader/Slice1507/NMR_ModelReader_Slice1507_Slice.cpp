@@ -65,6 +65,14 @@ namespace NMR {
 		m_bHasZTop = false;
 	}
 
+	CModelReaderNode_Slices1507_Slice::CModelReaderNode_Slices1507_Slice(_In_ PSlice pSlice, _In_ PModelWarnings pWarnings) : CModelReaderNode(pWarnings) {
+		if (!pSlice)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		m_pSliceStack = nullptr;
+		m_Slice = pSlice;
+		m_bHasZTop = false;
+	}
+
 	void CModelReaderNode_Slices1507_Slice::parseXML(_In_ CXmlReader * pXMLReader) {
 		// Parse name
 		parseName(pXMLReader);
@@ -72,7 +80,8 @@ namespace NMR {
 		// Parse attribute
 		parseAttributes(pXMLReader);
 
-		m_Slice = m_pSliceStack->AddSlice(m_TopZ);
+		if (!m_Slice)
+			m_Slice = m_pSliceStack->AddSlice(m_TopZ);
 
 		// Parse Content
 		parseContent(pXMLReader);
@@ -0,0 +1,531 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ModelReader_Slice1507_SliceSplitter.cpp implements a splitter for slice model parts.
+A light-weight scan of the raw UTF-8 document locates the slices of all slicestacks.
+Their content is removed from the document, and read afterwards in chunks of
+slices, each chunk with its own XML reader.
+
+--*/
+
+#include "Model/Reader/Slice1507/NMR_ModelReader_Slice1507_SliceSplitter.h"
+#include "Model/Reader/Slice1507/NMR_ModelReader_Slice1507_Slice.h"
+#include "Model/Reader/NMR_ModelReaderNode.h"
+#include "Model/Classes/NMR_ModelConstants.h"
+#include "Model/Classes/NMR_ModelConstants_Slices.h"
+#include "Common/Platform/NMR_ImportStream_Shared_Memory.h"
+#include "Common/Platform/NMR_Platform.h"
+#include "Common/NMR_ParallelFor.h"
+#include "Common/NMR_Exception.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+// Number of slices that are read by one XML reader instance
+#define NMR_SLICESPLITTER_CHUNKSIZE PROGRESS_READSLICESUPDATE
+
+namespace NMR {
+
+	namespace {
+
+		typedef enum {
+			eskDocument,
+			eskOther,
+			eskModel,
+			eskResources,
+			eskSliceStack,
+			eskSlice
+		} eSplitterElementKind;
+
+		typedef struct {
+			std::string m_sPrefix;
+			std::string m_sURI;
+			std::string m_sDeclaration;
+		} SPLITTERNAMESPACE;
+
+		typedef struct {
+			nfUint64 m_nNameStart;
+			nfUint64 m_nNameLength;
+			eSplitterElementKind m_Kind;
+			std::vector<SPLITTERNAMESPACE> m_NameSpaces;
+		} SPLITTERELEMENT;
+
+		inline nfBool fnIsXMLWhiteSpace(_In_ nfChar cChar)
+		{
+			return (cChar == ' ') || (cChar == '\t') || (cChar == '\r') || (cChar == '\n');
+		}
+
+		inline nfBool fnMatches(_In_ const nfChar * pBuffer, _In_ nfUint64 nSize, _In_ nfUint64 nPosition, _In_z_ const nfChar * pszString)
+		{
+			nfUint64 nLength = strlen(pszString);
+			return (nPosition + nLength <= nSize) && (memcmp(pBuffer + nPosition, pszString, nLength) == 0);
+		}
+
+		// Moves behind the next occurrence of pszString.
+		nfBool fnSkipBehind(_In_ const nfChar * pBuffer, _In_ nfUint64 nSize, _Inout_ nfUint64 & nPosition, _In_z_ const nfChar * pszString)
+		{
+			const nfChar * pEnd = pBuffer + nSize;
+			const nfChar * pFound = std::search(pBuffer + nPosition, pEnd, pszString, pszString + strlen(pszString));
+			if (pFound == pEnd)
+				return false;
+			nPosition = (pFound - pBuffer) + strlen(pszString);
+			return true;
+		}
+
+		nfBool fnResolveNameSpace(_In_ const std::vector<SPLITTERELEMENT> & Elements, _In_ const SPLITTERELEMENT & Element,
+			_In_ const std::string & sPrefix, _Out_ std::string & sURI)
+		{
+			for (auto & NameSpace : Element.m_NameSpaces) {
+				if (NameSpace.m_sPrefix == sPrefix) {
+					sURI = NameSpace.m_sURI;
+					return true;
+				}
+			}
+			for (auto iElement = Elements.rbegin(); iElement != Elements.rend(); iElement++) {
+				for (auto & NameSpace : iElement->m_NameSpaces) {
+					if (NameSpace.m_sPrefix == sPrefix) {
+						sURI = NameSpace.m_sURI;
+						return true;
+					}
+				}
+			}
+			sURI = "";
+			return sPrefix.empty();
+		}
+
+		// Reads the content of a chunk of slices into the existing slices of a slicestack.
+		class CModelReaderNode_Slice1507_SliceChunk : public CModelReaderNode {
+		private:
+			CModelSliceStack * m_pSliceStack;
+			nfUint32 m_nNextSlice;
+			nfUint32 m_nEndSlice;
+
+		protected:
+			virtual void OnNSChildElement(_In_z_ const nfChar * pChildName, _In_z_ const nfChar * pNameSpace, _In_ CXmlReader * pXMLReader)
+			{
+				if (strcmp(pChildName, XML_3MF_ELEMENT_SLICE) == 0) {
+					if (m_nNextSlice >= m_nEndSlice)
+						throw CNMRException(NMR_ERROR_SLICES_SPLITMISMATCH);
+
+					PModelReaderNode_Slices1507_Slice pXMLNode = std::make_shared<CModelReaderNode_Slices1507_Slice>(m_pSliceStack->getSlice(m_nNextSlice), m_pWarnings);
+					pXMLNode->parseXML(pXMLReader);
+					m_nNextSlice++;
+				}
+			}
+
+		public:
+			CModelReaderNode_Slice1507_SliceChunk(_In_ CModelSliceStack * pSliceStack, _In_ nfUint32 nFirstSlice, _In_ nfUint32 nEndSlice, _In_ PModelWarnings pWarnings)
+				: CModelReaderNode(pWarnings), m_pSliceStack(pSliceStack), m_nNextSlice(nFirstSlice), m_nEndSlice(nEndSlice)
+			{
+			}
+
+			virtual void parseXML(_In_ CXmlReader * pXMLReader)
+			{
+				parseName(pXMLReader);
+				// The native XML reader registers namespaces while it visits the attributes
+				parseAttributes(pXMLReader);
+				parseContent(pXMLReader);
+
+				if (m_nNextSlice != m_nEndSlice)
+					throw CNMRException(NMR_ERROR_SLICES_SPLITMISMATCH);
+			}
+		};
+
+	}
+
+	CModelReader_Slice1507_SliceSplitter::CModelReader_Slice1507_SliceSplitter(_In_ PImportStream pStream)
+		: m_nSliceCount(0), m_bIsSplit(false)
+	{
+		if (!pStream)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		nfUint64 nSize = pStream->retrieveSize();
+		pStream->seekPosition(0, true);
+		m_Buffer.resize((size_t)nSize);
+		if (nSize > 0)
+			pStream->readBuffer(m_Buffer.data(), nSize, true);
+
+		m_bIsSplit = scanBuffer();
+		if (m_bIsSplit)
+			buildSkeleton();
+		else {
+			m_SliceStacks.clear();
+			m_nSliceCount = 0;
+		}
+	}
+
+	nfBool CModelReader_Slice1507_SliceSplitter::scanBuffer()
+	{
+		const nfChar * pBuffer = (const nfChar *)m_Buffer.data();
+		nfUint64 nSize = m_Buffer.size();
+
+		// Only UTF-8 documents can be split byte-wise
+		for (nfUint64 nIndex = 0; nIndex < std::min(nSize, (nfUint64)4); nIndex++) {
+			nfByte cByte = (nfByte)pBuffer[nIndex];
+			if ((cByte == 0) || (cByte == 0xFE) || (cByte == 0xFF))
+				return false;
+		}
+
+		std::vector<SPLITTERELEMENT> Elements;
+		nfUint64 nPosition = 0;
+		while (nPosition < nSize) {
+			const nfChar * pTag = (const nfChar *)memchr(pBuffer + nPosition, '<', (size_t)(nSize - nPosition));
+			if (!pTag)
+				break;
+
+			nfUint64 nTagStart = pTag - pBuffer;
+			nPosition = nTagStart + 1;
+			if (nPosition >= nSize)
+				return false;
+
+			// Processing instructions and comments are kept as they are
+			if (pBuffer[nPosition] == '?') {
+				if (!fnSkipBehind(pBuffer, nSize, nPosition, "?>"))
+					return false;
+				continue;
+			}
+			if (pBuffer[nPosition] == '!') {
+				// CDATA sections and document type declarations are not supported by the splitter
+				if (!fnMatches(pBuffer, nSize, nPosition, "!--"))
+					return false;
+				if (!fnSkipBehind(pBuffer, nSize, nPosition, "-->"))
+					return false;
+				continue;
+			}
+
+			// End tag
+			if (pBuffer[nPosition] == '/') {
+				nPosition++;
+				nfUint64 nNameStart = nPosition;
+				while ((nPosition < nSize) && (pBuffer[nPosition] != '>') && !fnIsXMLWhiteSpace(pBuffer[nPosition]))
+					nPosition++;
+				nfUint64 nNameLength = nPosition - nNameStart;
+				while ((nPosition < nSize) && fnIsXMLWhiteSpace(pBuffer[nPosition]))
+					nPosition++;
+				if ((nPosition >= nSize) || (pBuffer[nPosition] != '>'))
+					return false;
+				nPosition++;
+
+				if (Elements.empty())
+					return false;
+				SPLITTERELEMENT & Element = Elements.back();
+				if ((Element.m_nNameLength != nNameLength) || (memcmp(pBuffer + Element.m_nNameStart, pBuffer + nNameStart, (size_t)nNameLength) != 0))
+					return false;
+
+				if (Element.m_Kind == eskSlice) {
+					SLICERANGE & Range = m_SliceStacks.back().m_Slices.back();
+					Range.m_nContentEnd = nTagStart;
+					Range.m_nEnd = nPosition;
+				}
+				Elements.pop_back();
+				continue;
+			}
+
+			// Start tag
+			SPLITTERELEMENT Element;
+			Element.m_nNameStart = nPosition;
+			while ((nPosition < nSize) && (pBuffer[nPosition] != '>') && (pBuffer[nPosition] != '/') && !fnIsXMLWhiteSpace(pBuffer[nPosition]))
+				nPosition++;
+			Element.m_nNameLength = nPosition - Element.m_nNameStart;
+			if (Element.m_nNameLength == 0)
+				return false;
+
+			nfBool bIsEmptyElement = false;
+			while (true) {
+				while ((nPosition < nSize) && fnIsXMLWhiteSpace(pBuffer[nPosition]))
+					nPosition++;
+				if (nPosition >= nSize)
+					return false;
+
+				if (pBuffer[nPosition] == '>') {
+					nPosition++;
+					break;
+				}
+				if (pBuffer[nPosition] == '/') {
+					if (!fnMatches(pBuffer, nSize, nPosition, "/>"))
+						return false;
+					nPosition += 2;
+					bIsEmptyElement = true;
+					break;
+				}
+
+				nfUint64 nAttributeStart = nPosition;
+				while ((nPosition < nSize) && (pBuffer[nPosition] != '=') && (pBuffer[nPosition] != '>') && (pBuffer[nPosition] != '/') && !fnIsXMLWhiteSpace(pBuffer[nPosition]))
+					nPosition++;
+				nfUint64 nAttributeNameLength = nPosition - nAttributeStart;
+				while ((nPosition < nSize) && fnIsXMLWhiteSpace(pBuffer[nPosition]))
+					nPosition++;
+				if ((nAttributeNameLength == 0) || (nPosition >= nSize) || (pBuffer[nPosition] != '='))
+					return false;
+				nPosition++;
+				while ((nPosition < nSize) && fnIsXMLWhiteSpace(pBuffer[nPosition]))
+					nPosition++;
+				if ((nPosition >= nSize) || ((pBuffer[nPosition] != '"') && (pBuffer[nPosition] != '\'')))
+					return false;
+
+				nfUint64 nValueStart = nPosition + 1;
+				const nfChar * pQuote = (const nfChar *)memchr(pBuffer + nValueStart, pBuffer[nPosition], (size_t)(nSize - nValueStart));
+				if (!pQuote)
+					return false;
+				nfUint64 nValueEnd = pQuote - pBuffer;
+				nPosition = nValueEnd + 1;
+
+				nfBool bIsDefaultNameSpace = (nAttributeNameLength == 5) && fnMatches(pBuffer, nSize, nAttributeStart, "xmlns");
+				if (bIsDefaultNameSpace || fnMatches(pBuffer, nSize, nAttributeStart, "xmlns:")) {
+					SPLITTERNAMESPACE NameSpace;
+					if (!bIsDefaultNameSpace)
+						NameSpace.m_sPrefix.assign(pBuffer + nAttributeStart + 6, (size_t)(nAttributeNameLength - 6));
+					NameSpace.m_sURI.assign(pBuffer + nValueStart, (size_t)(nValueEnd - nValueStart));
+					NameSpace.m_sDeclaration.assign(pBuffer + nAttributeStart, (size_t)(nPosition - nAttributeStart));
+					if (NameSpace.m_sURI.find('&') != std::string::npos)
+						return false;
+					Element.m_NameSpaces.push_back(NameSpace);
+				}
+			}
+
+			// Classify the element by its parent. The content of slices is not classified.
+			eSplitterElementKind ParentKind = Elements.empty() ? eskDocument : Elements.back().m_Kind;
+			Element.m_Kind = eskOther;
+			if ((ParentKind == eskDocument) || (ParentKind == eskModel) || (ParentKind == eskResources) || (ParentKind == eskSliceStack)) {
+				const nfChar * pName = pBuffer + Element.m_nNameStart;
+				const nfChar * pColon = (const nfChar *)memchr(pName, ':', (size_t)Element.m_nNameLength);
+				std::string sPrefix;
+				std::string sLocalName;
+				if (pColon) {
+					sPrefix.assign(pName, pColon - pName);
+					sLocalName.assign(pColon + 1, (size_t)(Element.m_nNameLength - (pColon - pName) - 1));
+				}
+				else
+					sLocalName.assign(pName, (size_t)Element.m_nNameLength);
+
+				std::string sNameSpace;
+				if (!fnResolveNameSpace(Elements, Element, sPrefix, sNameSpace))
+					return false;
+
+				if (ParentKind == eskDocument) {
+					if ((sLocalName != XML_3MF_ELEMENT_MODEL) || (sNameSpace != XML_3MF_NAMESPACE_CORESPEC100))
+						return false;
+					Element.m_Kind = eskModel;
+				}
+				else if ((ParentKind == eskModel) && (sLocalName == XML_3MF_ELEMENT_RESOURCES) && (sNameSpace == XML_3MF_NAMESPACE_CORESPEC100)) {
+					Element.m_Kind = eskResources;
+				}
+				else if (ParentKind == eskResources) {
+					// Other resources might validate the slices while they are still empty
+					if ((sLocalName != XML_3MF_ELEMENT_SLICESTACKRESOURCE) || (sNameSpace != XML_3MF_NAMESPACE_SLICESPEC))
+						return false;
+					Element.m_Kind = eskSliceStack;
+
+					// The slices of a chunk are read with the namespaces that are in scope of their slicestack
+					std::map<std::string, std::string> Declarations;
+					for (auto & Ancestor : Elements)
+						for (auto & NameSpace : Ancestor.m_NameSpaces)
+							Declarations[NameSpace.m_sPrefix] = NameSpace.m_sDeclaration;
+					for (auto & NameSpace : Element.m_NameSpaces)
+						Declarations[NameSpace.m_sPrefix] = NameSpace.m_sDeclaration;
+
+					SLICESTACKRANGE SliceStack;
+					SliceStack.m_sName.assign(pName, (size_t)Element.m_nNameLength);
+					for (auto & Declaration : Declarations)
+						SliceStack.m_sNameSpaces += " " + Declaration.second;
+					m_SliceStacks.push_back(SliceStack);
+				}
+				else if ((ParentKind == eskSliceStack) && (sLocalName == XML_3MF_ELEMENT_SLICE)) {
+					Element.m_Kind = eskSlice;
+
+					SLICERANGE Range;
+					Range.m_nStart = nTagStart;
+					Range.m_nContentStart = nPosition;
+					Range.m_nContentEnd = nPosition;
+					Range.m_nEnd = nPosition;
+					m_SliceStacks.back().m_Slices.push_back(Range);
+					m_nSliceCount++;
+				}
+			}
+
+			if (!bIsEmptyElement)
+				Elements.push_back(Element);
+		}
+
+		if (!Elements.empty())
+			return false;
+
+		return m_nSliceCount > 0;
+	}
+
+	void CModelReader_Slice1507_SliceSplitter::buildSkeleton()
+	{
+		nfUint64 nContentSize = 0;
+		for (auto & SliceStack : m_SliceStacks)
+			for (auto & Range : SliceStack.m_Slices)
+				nContentSize += Range.m_nContentEnd - Range.m_nContentStart;
+
+		m_Skeleton.clear();
+		m_Skeleton.reserve((size_t)(m_Buffer.size() - nContentSize));
+
+		nfUint64 nPosition = 0;
+		for (auto & SliceStack : m_SliceStacks) {
+			for (auto & Range : SliceStack.m_Slices) {
+				m_Skeleton.insert(m_Skeleton.end(), m_Buffer.begin() + (size_t)nPosition, m_Buffer.begin() + (size_t)Range.m_nContentStart);
+				nPosition = Range.m_nContentEnd;
+			}
+		}
+		m_Skeleton.insert(m_Skeleton.end(), m_Buffer.begin() + (size_t)nPosition, m_Buffer.end());
+	}
+
+	nfBool CModelReader_Slice1507_SliceSplitter::isSplit()
+	{
+		return m_bIsSplit;
+	}
+
+	nfUint64 CModelReader_Slice1507_SliceSplitter::getSliceCount()
+	{
+		return m_nSliceCount;
+	}
+
+	PImportStream CModelReader_Slice1507_SliceSplitter::getSkeletonStream()
+	{
+		std::vector<nfByte> & Document = m_bIsSplit ? m_Skeleton : m_Buffer;
+		// Shared memory streams do not accept null pointers
+		static const nfByte cEmptyDocument = 0;
+		if (Document.empty())
+			return std::make_shared<CImportStream_Shared_Memory>(&cEmptyDocument, 0);
+		return std::make_shared<CImportStream_Shared_Memory>(Document.data(), Document.size());
+	}
+
+	void CModelReader_Slice1507_SliceSplitter::readSliceChunk(_In_ const SLICESTACKRANGE & SliceStack, _In_ nfUint64 nFirstSlice, _In_ nfUint64 nEndSlice,
+		_In_ CModelSliceStack * pSliceStack, _In_ PModelWarnings pWarnings)
+	{
+		const nfChar * pBuffer = (const nfChar *)m_Buffer.data();
+
+		nfUint64 nDocumentSize = 2 * SliceStack.m_sName.length() + SliceStack.m_sNameSpaces.length() + 5;
+		for (nfUint64 nIndex = nFirstSlice; nIndex < nEndSlice; nIndex++)
+			nDocumentSize += SliceStack.m_Slices[(size_t)nIndex].m_nEnd - SliceStack.m_Slices[(size_t)nIndex].m_nStart;
+
+		std::string sDocument;
+		sDocument.reserve((size_t)nDocumentSize);
+		sDocument += "<" + SliceStack.m_sName + SliceStack.m_sNameSpaces + ">";
+		for (nfUint64 nIndex = nFirstSlice; nIndex < nEndSlice; nIndex++) {
+			const SLICERANGE & Range = SliceStack.m_Slices[(size_t)nIndex];
+			sDocument.append(pBuffer + Range.m_nStart, (size_t)(Range.m_nEnd - Range.m_nStart));
+		}
+		sDocument += "</" + SliceStack.m_sName + ">";
+
+		PImportStream pStream = std::make_shared<CImportStream_Shared_Memory>((const nfByte *)sDocument.data(), sDocument.length());
+		PXmlReader pXMLReader = fnCreateXMLReaderInstance(pStream, std::make_shared<CProgressMonitor>());
+
+		eXmlReaderNodeType NodeType;
+		while (!pXMLReader->IsEOF()) {
+			if (!pXMLReader->Read(NodeType))
+				break;
+
+			if (NodeType == XMLREADERNODETYPE_STARTELEMENT) {
+				CModelReaderNode_Slice1507_SliceChunk XMLNode(pSliceStack, (nfUint32)nFirstSlice, (nfUint32)nEndSlice, pWarnings);
+				XMLNode.parseXML(pXMLReader.get());
+				return;
+			}
+		}
+
+		throw CNMRException(NMR_ERROR_SLICES_SPLITMISMATCH);
+	}
+
+	void CModelReader_Slice1507_SliceSplitter::readSlices(_In_ const std::vector<PModelSliceStack> & SliceStacks, _In_ PModelWarnings pWarnings,
+		_In_ PProgressMonitor pProgressMonitor, _In_ nfUint32 nThreadCount)
+	{
+		if (!pWarnings)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+		if (!m_bIsSplit)
+			return;
+
+		if (SliceStacks.size() != m_SliceStacks.size())
+			throw CNMRException(NMR_ERROR_SLICES_SPLITMISMATCH);
+
+		typedef struct {
+			size_t m_nSliceStack;
+			nfUint64 m_nFirstSlice;
+			nfUint64 m_nEndSlice;
+		} SLICECHUNK;
+
+		std::vector<SLICECHUNK> Chunks;
+		for (size_t nSliceStack = 0; nSliceStack < SliceStacks.size(); nSliceStack++) {
+			nfUint64 nSliceCount = m_SliceStacks[nSliceStack].m_Slices.size();
+			if (!SliceStacks[nSliceStack] || (SliceStacks[nSliceStack]->getSliceCount() != nSliceCount))
+				throw CNMRException(NMR_ERROR_SLICES_SPLITMISMATCH);
+
+			for (nfUint64 nFirstSlice = 0; nFirstSlice < nSliceCount; nFirstSlice += NMR_SLICESPLITTER_CHUNKSIZE) {
+				SLICECHUNK Chunk;
+				Chunk.m_nSliceStack = nSliceStack;
+				Chunk.m_nFirstSlice = nFirstSlice;
+				Chunk.m_nEndSlice = std::min(nSliceCount, nFirstSlice + NMR_SLICESPLITTER_CHUNKSIZE);
+				Chunks.push_back(Chunk);
+			}
+		}
+
+		// Chunks are read in batches, so that the progress can be reported and the read be cancelled from this thread
+		nfUint64 nBatchSize = std::max((nfUint64)nThreadCount, (nfUint64)1) * 4;
+		for (nfUint64 nBatchStart = 0; nBatchStart < Chunks.size(); nBatchStart += nBatchSize) {
+			nfUint64 nBatchEnd = std::min((nfUint64)Chunks.size(), nBatchStart + nBatchSize);
+
+			// CModelWarnings is not thread-safe, every chunk collects its own warnings
+			std::vector<PModelWarnings> ChunkWarnings((size_t)(nBatchEnd - nBatchStart));
+			for (auto & pChunkWarnings : ChunkWarnings) {
+				pChunkWarnings = std::make_shared<CModelWarnings>();
+				pChunkWarnings->setCriticalWarningLevel(pWarnings->getCriticalWarningLevel());
+			}
+
+			fnParallelFor(nThreadCount, nBatchEnd - nBatchStart, [&](nfUint64 nIndex) {
+				const SLICECHUNK & Chunk = Chunks[(size_t)(nBatchStart + nIndex)];
+				readSliceChunk(m_SliceStacks[Chunk.m_nSliceStack], Chunk.m_nFirstSlice, Chunk.m_nEndSlice,
+					SliceStacks[Chunk.m_nSliceStack].get(), ChunkWarnings[(size_t)nIndex]);
+			});
+
+			for (auto & pChunkWarnings : ChunkWarnings) {
+				for (nfUint32 nIndex = 0; nIndex < pChunkWarnings->getWarningCount(); nIndex++) {
+					PModelReaderWarning pWarning = pChunkWarnings->getWarning(nIndex);
+					pWarnings->addWarning(pWarning->getErrorCode(), pWarning->getWarningLevel());
+				}
+			}
+
+			if (pProgressMonitor) {
+				// The chunks are parsed without the progress monitor, so their slices and XML are counted here
+				for (nfUint64 nChunk = nBatchStart; nChunk < nBatchEnd; nChunk++) {
+					const SLICECHUNK & Chunk = Chunks[(size_t)nChunk];
+					const SLICESTACKRANGE & SliceStack = m_SliceStacks[Chunk.m_nSliceStack];
+					for (nfUint64 nSlice = Chunk.m_nFirstSlice; nSlice < Chunk.m_nEndSlice; nSlice++)
+						pProgressMonitor->AddToCounter(PROGRESSCOUNTER_XMLBYTES, SliceStack.m_Slices[(size_t)nSlice].m_nEnd - SliceStack.m_Slices[(size_t)nSlice].m_nStart);
+					pProgressMonitor->AddToCounter(PROGRESSCOUNTER_SLICES, Chunk.m_nEndSlice - Chunk.m_nFirstSlice);
+				}
+
+				pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_READSLICES);
+				pProgressMonitor->ReportProgressAndQueryCancelled(true);
+			}
+		}
+	}
+
+}
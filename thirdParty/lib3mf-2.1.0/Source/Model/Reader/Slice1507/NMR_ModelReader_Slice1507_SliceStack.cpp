@@ -32,6 +32,7 @@ Abstract:
 #include "Model/Reader/Slice1507/NMR_ModelReader_Slice1507_SliceRef.h"
 #include "Model/Reader/Slice1507/NMR_ModelReader_Slice1507_Slice.h"
 #include "Common/NMR_StringUtils.h"
+#include "Common/NMR_Trace.h"
 #include "Model/Classes/NMR_ModelConstants.h"
 
 namespace NMR {
@@ -61,6 +62,7 @@ namespace NMR {
 
 			pXMLNode = std::make_shared<CModelReaderNode_Slices1507_Slice>(m_pSliceStackResource.get(), m_pWarnings);
 			pXMLNode->parseXML(pXMLReader);
+			m_pProgressMonitor->AddToCounter(PROGRESSCOUNTER_SLICES, 1);
 		}
 		else if (strcmp(pChildName, XML_3MF_ELEMENT_SLICEREFRESOURCE) == 0) {
 			if (!m_pSliceStackResource->AllowsReferences())
@@ -93,6 +95,8 @@ namespace NMR {
 
 	void CModelReaderNode_Slice1507_SliceStack::parseXML(_In_ CXmlReader * pXMLReader)
 	{
+		NMR_TRACE_SCOPE("CModelReaderNode_Slice1507_SliceStack::parseXML");
+
 		// Parse name
 		parseName(pXMLReader);
 
@@ -38,6 +38,7 @@ A build reader model node is a parser for the build node of an XML Model Stream.
 #include "Common/NMR_StringUtils.h"
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_Exception_Windows.h"
+#include "Common/NMR_Trace.h"
 
 namespace NMR {
 
@@ -50,6 +51,8 @@ namespace NMR {
 
 	void CModelReaderNode100_Build::parseXML(_In_ CXmlReader * pXMLReader)
 	{
+		NMR_TRACE_SCOPE("CModelReaderNode100_Build::parseXML");
+
 		// Parse name
 		parseName(pXMLReader);
 
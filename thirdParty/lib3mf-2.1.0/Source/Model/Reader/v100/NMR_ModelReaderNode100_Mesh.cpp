@@ -40,6 +40,7 @@ A mesh reader model node is a parser for the mesh node of an XML Model Stream.
 #include "Common/NMR_StringUtils.h"
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_Exception_Windows.h"
+#include "Common/NMR_Trace.h"
 
 namespace NMR {
 
@@ -65,6 +66,8 @@ namespace NMR {
 
 	void CModelReaderNode100_Mesh::parseXML(_In_ CXmlReader * pXMLReader)
 	{
+		NMR_TRACE_SCOPE("CModelReaderNode100_Mesh::parseXML");
+
 		// Parse name
 		parseName(pXMLReader);
 
@@ -104,22 +107,24 @@ namespace NMR {
 
 			if (strcmp(pChildName, XML_3MF_ELEMENT_VERTICES) == 0)
 			{
-				if (m_pMesh->getNodeCount() % PROGRESS_READUPDATE == PROGRESS_READUPDATE - 1) {
-					m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_READMESH);
-					m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
-				}
+				m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_READMESH);
+				m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
+
+				nfUint32 nNodeCount = m_pMesh->getNodeCount();
 				PModelReaderNode pXMLNode = std::make_shared<CModelReaderNode100_Vertices>(m_pMesh, m_pWarnings);
 				pXMLNode->parseXML(pXMLReader);
+				m_pProgressMonitor->AddToCounter(PROGRESSCOUNTER_NODES, m_pMesh->getNodeCount() - nNodeCount);
 			}
 			else if (strcmp(pChildName, XML_3MF_ELEMENT_TRIANGLES) == 0)
 			{
-				if (m_pMesh->getFaceCount() % PROGRESS_READUPDATE == PROGRESS_READUPDATE - 1) {
-					m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_READMESH);
-					m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
-				}
+				m_pProgressMonitor->SetProgressIdentifier(ProgressIdentifier::PROGRESS_READMESH);
+				m_pProgressMonitor->ReportProgressAndQueryCancelled(true);
+
+				nfUint32 nFaceCount = m_pMesh->getFaceCount();
 				PModelReaderNode100_Triangles pXMLNode = std::make_shared<CModelReaderNode100_Triangles>(m_pModel, m_pMesh, m_pWarnings,
 					m_pObjectLevelPropertyID, m_nObjectLevelPropertyIndex);
 				pXMLNode->parseXML(pXMLReader);
+				m_pProgressMonitor->AddToCounter(PROGRESSCOUNTER_TRIANGLES, m_pMesh->getFaceCount() - nFaceCount);
 				if (m_pObjectLevelPropertyID && m_pObjectLevelPropertyID->getPackageModelPath() == 0) {
 					// warn, if object does not have an object-level property, but a triangle has one
 					if (pXMLNode->getUsedPropertyID() != 0) {
@@ -139,8 +144,10 @@ namespace NMR {
 		if (strcmp(pNameSpace, XML_3MF_NAMESPACE_BEAMLATTICESPEC) == 0) {
 			if (strcmp(pChildName, XML_3MF_ELEMENT_BEAMLATTICE) == 0)
 			{
+				nfUint32 nBeamCount = m_pMesh->getBeamCount();
 				PModelReaderNode_BeamLattice1702_BeamLattice pXMLNode = std::make_shared<CModelReaderNode_BeamLattice1702_BeamLattice>(m_pModel, m_pMesh, m_pWarnings);
 				pXMLNode->parseXML(pXMLReader);
+				m_pProgressMonitor->AddToCounter(PROGRESSCOUNTER_BEAMS, m_pMesh->getBeamCount() - nBeamCount);
 
 				pXMLNode->retrieveClippingInfo(m_eClipMode, m_bHasClippingMeshID, m_nClippingMeshID);
 				pXMLNode->retrieveRepresentationInfo(m_bHasRepresentationMeshID, m_nRepresentationMeshID);
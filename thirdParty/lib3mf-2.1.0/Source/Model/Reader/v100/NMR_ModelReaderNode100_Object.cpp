@@ -45,6 +45,7 @@ Stream.
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_Exception_Windows.h"
 #include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
+#include "Common/NMR_Trace.h"
 
 namespace NMR {
 
@@ -75,6 +76,8 @@ namespace NMR {
 
 	void CModelReaderNode100_Object::parseXML(_In_ CXmlReader * pXMLReader)
 	{
+		NMR_TRACE_SCOPE("CModelReaderNode100_Object::parseXML");
+
 		// Parse name
 		parseName(pXMLReader);
 
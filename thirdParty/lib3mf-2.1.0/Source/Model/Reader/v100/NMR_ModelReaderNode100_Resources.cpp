@@ -45,6 +45,7 @@ XML Model Stream.
 #include "Common/NMR_StringUtils.h"
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_Exception_Windows.h"
+#include "Common/NMR_Trace.h"
 #include "Model/Classes/NMR_ModelConstants_Slices.h"
 
 namespace NMR {
@@ -62,6 +63,8 @@ namespace NMR {
 
 	void CModelReaderNode100_Resources::parseXML(_In_ CXmlReader * pXMLReader)
 	{
+		NMR_TRACE_SCOPE("CModelReaderNode100_Resources::parseXML");
+
 		// Parse name
 		parseName(pXMLReader);
 
@@ -39,6 +39,7 @@ XML Model Stream.
 #include "Common/NMR_StringUtils.h"
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_Exception_Windows.h"
+#include "Common/NMR_Trace.h"
 #include "Model/Reader/NMR_ModelReader_ColorMapping.h"
 
 namespace NMR {
@@ -54,6 +55,7 @@ namespace NMR {
 		m_nDefaultResourceIndex = nDefaultPropertyIndex;
 
 		m_nUsedResourceID = 0;
+		m_nCachedResourceID = 0;
 
 		m_pModel = pModel;
 		m_pMesh = pMesh;
@@ -61,6 +63,8 @@ namespace NMR {
 
 	void CModelReaderNode100_Triangles::parseXML(_In_ CXmlReader * pXMLReader)
 	{
+		NMR_TRACE_SCOPE("CModelReaderNode100_Triangles::parseXML");
+
 		// Parse Name
 		parseName(pXMLReader);
 
@@ -133,11 +137,17 @@ namespace NMR {
 						// set potential default properties (i.e. used pid)
 						m_nUsedResourceID = nModelResourceID;
 
-						PPackageResourceID pID = m_pModel->findPackageResourceID(m_pModel->currentPath(), nModelResourceID);
+						if ((nModelResourceID != m_nCachedResourceID) || !m_pCachedPackageResourceID) {
+							m_nCachedResourceID = nModelResourceID;
+							m_pCachedPackageResourceID = m_pModel->findPackageResourceID(m_pModel->currentModelPath(), nModelResourceID);
+							m_pCachedResource = m_pCachedPackageResourceID ? m_pModel->findResource(m_pCachedPackageResourceID->getUniqueID()) : nullptr;
+						}
+
+						PPackageResourceID pID = m_pCachedPackageResourceID;
 						if (pID.get()) {
 							// Find and Assign Resource of this Property
-							PModelResource pResource = m_pModel->findResource(pID->getUniqueID());
-							if (pResource.get () != nullptr) {
+							CModelResource * pResource = m_pCachedResource.get();
+							if (pResource != nullptr) {
 								if (!pResource->hasResourceIndexMap())
 									pResource->buildResourceIndexMap();
 
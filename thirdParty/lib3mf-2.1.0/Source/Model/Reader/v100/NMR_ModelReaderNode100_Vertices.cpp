@@ -39,6 +39,7 @@ XML Model Stream.
 #include "Common/NMR_StringUtils.h"
 #include "Common/NMR_Exception.h"
 #include "Common/NMR_Exception_Windows.h"
+#include "Common/NMR_Trace.h"
 
 namespace NMR {
 
@@ -51,6 +52,8 @@ namespace NMR {
 
 	void CModelReaderNode100_Vertices::parseXML(_In_ CXmlReader * pXMLReader)
 	{
+		NMR_TRACE_SCOPE("CModelReaderNode100_Vertices::parseXML");
+
 		// Parse Name
 		parseName(pXMLReader);
 
@@ -166,6 +166,20 @@ namespace NMR {
 		return pPart;
 	}
 
+	POpcPackagePart CKeyStoreOpcPackageWriter::addDeferredPart(_In_ std::string sPath)
+	{
+		// Encrypted parts call the content encryption callback, which is not required to be thread-safe
+		if (m_pContext.keyStore()->findResourceData(sPath) != nullptr)
+			return nullptr;
+
+		return m_pPackageWriter->addDeferredPart(sPath);
+	}
+
+	void CKeyStoreOpcPackageWriter::writeDeferredParts()
+	{
+		m_pPackageWriter->writeDeferredParts();
+	}
+
 	void CKeyStoreOpcPackageWriter::close() {
 		PSecureContext const & secureContext = m_pContext.secureContext();
 		PKeyStore const & keyStore = m_pContext.keyStore();
@@ -34,6 +34,8 @@ A model writer exports the in memory represenation into a model file.
 #include "Model/Writer/NMR_ModelWriter.h" 
 
 #include "Model/Classes/NMR_ModelConstants.h" 
+#include "Model/Classes/NMR_ModelMeshObject.h" 
+#include "Common/Mesh/NMR_MeshLayoutOptimizer.h" 
 #include "Common/Platform/NMR_XmlWriter.h" 
 #include "Common/NMR_Exception.h" 
 #include "Common/NMR_Exception_Windows.h" 
@@ -49,7 +51,9 @@ namespace NMR {
 
 	CModelWriter::CModelWriter(_In_ PModel pModel):
 		CModelContext(pModel),
-		m_nDecimalPrecision(6)
+		m_nDecimalPrecision(6),
+		m_bOptimizeMeshLayout(false),
+		m_nCompressionThreadCount(0)
 	{
 	}
 
@@ -65,4 +69,39 @@ namespace NMR {
 		return m_nDecimalPrecision;
 	}
 
+	void CModelWriter::SetOptimizeMeshLayout(nfBool bOptimizeMeshLayout)
+	{
+		m_bOptimizeMeshLayout = bOptimizeMeshLayout;
+	}
+
+	nfBool CModelWriter::GetOptimizeMeshLayout()
+	{
+		return m_bOptimizeMeshLayout;
+	}
+
+	void CModelWriter::SetCompressionThreadCount(nfUint32 nThreadCount)
+	{
+		m_nCompressionThreadCount = nThreadCount;
+	}
+
+	nfUint32 CModelWriter::GetCompressionThreadCount()
+	{
+		return m_nCompressionThreadCount;
+	}
+
+	void CModelWriter::optimizeMeshLayouts()
+	{
+		if (!m_bOptimizeMeshLayout)
+			return;
+
+		CMeshLayoutOptimizer Optimizer(true, true, true);
+
+		nfUint32 nResourceCount = model()->getResourceCount();
+		for (nfUint32 nIndex = 0; nIndex < nResourceCount; nIndex++) {
+			CModelMeshObject * pMeshObject = dynamic_cast<CModelMeshObject *>(model()->getResource(nIndex).get());
+			if (pMeshObject != nullptr)
+				Optimizer.optimize(pMeshObject->getMesh());
+		}
+	}
+
 }
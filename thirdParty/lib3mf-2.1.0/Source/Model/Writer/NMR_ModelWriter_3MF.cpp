@@ -42,6 +42,7 @@ A model writer exports the in memory represenation into a 3MF file.
 #include "Common/Platform/NMR_XmlWriter.h"
 #include "Common/Platform/NMR_Platform.h"
 #include "Common/3MF_ProgressMonitor.h"
+#include "Common/NMR_Trace.h"
 
 namespace NMR {
 
@@ -52,10 +53,17 @@ namespace NMR {
 
 	void CModelWriter_3MF::exportToStream(_In_ PExportStream pStream)
 	{
+		NMR_TRACE_SCOPE("CModelWriter_3MF::exportToStream");
+
 		if (pStream == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
-		monitor()->SetProgressIdentifier(ProgressIdentifier::PROGRESS_CREATEOPCPACKAGE);
+		monitor()->StartStatistics(ProgressIdentifier::PROGRESS_CREATEOPCPACKAGE);
+		nfUint64 nStartPosition = pStream->getPosition();
+
+		// Reorder mesh data for locality, if requested
+		optimizeMeshLayouts();
+
 		monitor()->ReportProgressAndQueryCancelled(true);
 
 		// Create new OPC Package
@@ -72,6 +80,7 @@ namespace NMR {
 
 		// Release Memory
 		releasePackage();
+		monitor()->AddToCounter(PROGRESSCOUNTER_PACKAGEBYTES, pStream->getPosition() - nStartPosition);
 
 		monitor()->IncrementProgress(1);
 
@@ -90,6 +99,7 @@ namespace NMR {
 
 		pXMLWriter->WriteEndDocument();
 		pXMLWriter->Flush();
+		monitor()->AddToCounter(PROGRESSCOUNTER_XMLBYTES, pXMLWriter->GetBytesWritten());
 	}
 
 	void CModelWriter_3MF::writeModelStream(_In_ CXmlWriter * pXMLWriter, _In_ CModel * pModel)
@@ -108,5 +118,6 @@ namespace NMR {
 		pXMLWriter->WriteEndDocument();
 
 		pXMLWriter->Flush();
+		monitor()->AddToCounter(PROGRESSCOUNTER_XMLBYTES, pXMLWriter->GetBytesWritten());
 	}
 }
@@ -47,7 +47,9 @@ using LibZ and a native XML writer implementation.
 #include "Common/NMR_StringUtils.h" 
 #include "Common/3MF_ProgressMonitor.h"
 #include "Common/NMR_ModelWarnings.h"
+#include "Common/NMR_ParallelFor.h"
 #include <functional>
+#include <set>
 #include <sstream>
 
 namespace NMR {
@@ -104,6 +106,7 @@ namespace NMR {
 			PImportStream pPackageThumbnailStream = pPackageThumbnail->getStream();
 			pPackageThumbnailStream->seekPosition(0, true);
 			pExportStream->copyFrom(pPackageThumbnailStream.get(), pPackageThumbnailStream->retrieveSize(), MODELWRITER_NATIVE_BUFFERSIZE);
+			monitor()->AddToCounter(PROGRESSCOUNTER_ATTACHMENTBYTES, pPackageThumbnailStream->retrieveSize());
 			// add root relationship
 			m_pPackageWriter->addRootRelationship(pPackageThumbnail->getRelationShipType(), pThumbnailPart.get());
 		}
@@ -185,36 +188,84 @@ namespace NMR {
 		nfUint32 nCount = pModel->getAttachmentCount();
 		nfUint32 nIndex;
 
-		if (nCount > 0) {
-			for (nIndex = 0; nIndex < nCount; nIndex++) {
+		// Attachments are compressed in batches of consecutive deferred parts. Parts that cannot be
+		// deferred end a batch, so that the package keeps the order of the attachments.
+		std::vector<std::pair<PModelAttachment, POpcPackagePart>> DeferredAttachments;
+		std::set<CImportStream *> DeferredStreams;
 
-				monitor()->SetProgressIdentifier(ProgressIdentifier::PROGRESS_WRITEATTACHMENTS);
-				monitor()->ReportProgressAndQueryCancelled(true);
+		for (nIndex = 0; nIndex < nCount; nIndex++) {
 
-				PModelAttachment pAttachment = pModel->getModelAttachment(nIndex);
-				PImportStream pStream = pAttachment->getStream();
-				
-				std::string sPath = fnIncludeLeadingPathDelimiter(pAttachment->getPathURI());
-				std::string sRelationShipType = pAttachment->getRelationShipType();
+			monitor()->SetProgressIdentifier(ProgressIdentifier::PROGRESS_WRITEATTACHMENTS);
+			monitor()->ReportProgressAndQueryCancelled(true);
 
-				if (pStream.get() == nullptr)
-					throw CNMRException(NMR_ERROR_INVALIDPARAM);
+			PModelAttachment pAttachment = pModel->getModelAttachment(nIndex);
+			PImportStream pStream = pAttachment->getStream();
+			std::string sPath = fnIncludeLeadingPathDelimiter(pAttachment->getPathURI());
 
-				// create Attachment Part
-				POpcPackagePart pAttachmentPart = m_pPackageWriter->addPart(sPath);
-				PExportStream pExportStream = pAttachmentPart->getExportStream();
+			if (pStream.get() == nullptr)
+				throw CNMRException(NMR_ERROR_INVALIDPARAM);
 
-				// Copy data
-				pStream->seekPosition(0, true);
-				pExportStream->copyFrom(pStream.get(), pStream->retrieveSize(), MODELWRITER_NATIVE_BUFFERSIZE);
+			// A stream shared by several attachments can only be read by one thread at a time
+			POpcPackagePart pAttachmentPart;
+			if ((GetCompressionThreadCount() > 1) && (DeferredStreams.count(pStream.get()) == 0))
+				pAttachmentPart = m_pPackageWriter->addDeferredPart(sPath);
 
-				// add relationships
-				m_pPackageWriter->addPartRelationship(pModelPart, sRelationShipType.c_str(), pAttachmentPart.get());
+			if (pAttachmentPart.get() != nullptr) {
+				DeferredAttachments.push_back(std::make_pair(pAttachment, pAttachmentPart));
+				DeferredStreams.insert(pStream.get());
+				continue;
+			}
 
-				m_pPackageWriter->addWriterSpecificRelationships(pModelPart, pAttachmentPart.get());
+			writeDeferredAttachments(DeferredAttachments, pModelPart);
+			DeferredStreams.clear();
 
-				monitor()->IncrementProgress(1);
-			}
+			// create Attachment Part
+			pAttachmentPart = m_pPackageWriter->addPart(sPath);
+			copyAttachment(pAttachment.get(), pAttachmentPart.get());
+			addAttachmentRelationships(pAttachment.get(), pModelPart, pAttachmentPart);
 		}
+
+		writeDeferredAttachments(DeferredAttachments, pModelPart);
+	}
+
+	void CModelWriter_3MF_Native::copyAttachment(_In_ CModelAttachment * pAttachment, _In_ COpcPackagePart * pAttachmentPart)
+	{
+		PImportStream pStream = pAttachment->getStream();
+		PExportStream pExportStream = pAttachmentPart->getExportStream();
+
+		// Copy data
+		pStream->seekPosition(0, true);
+		pExportStream->copyFrom(pStream.get(), pStream->retrieveSize(), MODELWRITER_NATIVE_BUFFERSIZE);
+		// Non-root models are counted as XML when they are written
+		if (pAttachment->getRelationShipType() != PACKAGE_START_PART_RELATIONSHIP_TYPE)
+			monitor()->AddToCounter(PROGRESSCOUNTER_ATTACHMENTBYTES, pStream->retrieveSize());
+	}
+
+	void CModelWriter_3MF_Native::addAttachmentRelationships(_In_ CModelAttachment * pAttachment, _In_ POpcPackagePart pModelPart, _In_ POpcPackagePart pAttachmentPart)
+	{
+		std::string sRelationShipType = pAttachment->getRelationShipType();
+
+		// add relationships
+		m_pPackageWriter->addPartRelationship(pModelPart, sRelationShipType.c_str(), pAttachmentPart.get());
+
+		m_pPackageWriter->addWriterSpecificRelationships(pModelPart, pAttachmentPart.get());
+
+		monitor()->IncrementProgress(1);
+	}
+
+	void CModelWriter_3MF_Native::writeDeferredAttachments(_In_ std::vector<std::pair<PModelAttachment, POpcPackagePart>> & DeferredAttachments, _In_ POpcPackagePart pModelPart)
+	{
+		if (DeferredAttachments.empty())
+			return;
+
+		fnParallelFor(GetCompressionThreadCount(), DeferredAttachments.size(), [&](nfUint64 nIndex) {
+			copyAttachment(DeferredAttachments[(size_t)nIndex].first.get(), DeferredAttachments[(size_t)nIndex].second.get());
+		});
+		m_pPackageWriter->writeDeferredParts();
+
+		for (auto & attachment : DeferredAttachments)
+			addAttachmentRelationships(attachment.first.get(), pModelPart, attachment.second);
+
+		DeferredAttachments.clear();
 	}
 }
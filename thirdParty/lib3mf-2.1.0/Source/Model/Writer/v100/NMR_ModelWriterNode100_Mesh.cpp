@@ -39,8 +39,12 @@ This is the class for exporting the 3mf mesh node.
 #include "Common/NMR_StringUtils.h"
 
 #include "Common/3MF_ProgressMonitor.h"
+#include "Common/NMR_Trace.h"
 
 #include <cmath>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 #ifdef __GNUC__
 #include <stdio.h>
@@ -83,7 +87,7 @@ namespace NMR {
 		return  fabs(a - b) * putFactor > 0.1;
 	}
 
-	std::string capModeToString(eModelBeamLatticeCapMode eCapMode) {
+	const nfChar * capModeToString(eModelBeamLatticeCapMode eCapMode) {
 		switch (eCapMode) {
 		case eModelBeamLatticeCapMode::MODELBEAMLATTICECAPMODE_SPHERE: return XML_3MF_BEAMLATTICE_CAPMODE_SPHERE; break;
 		case eModelBeamLatticeCapMode::MODELBEAMLATTICECAPMODE_HEMISPHERE: return XML_3MF_BEAMLATTICE_CAPMODE_HEMISPHERE; break;
@@ -103,6 +107,70 @@ namespace NMR {
 		}
 	}
 
+	// Returns the default radius of the beamlattice. The configured radius is kept, unless more beams with
+	// r1 == r2 share another radius, so that these beams can omit both radii.
+	nfDouble selectDefaultBeamRadius(_In_ const CMeshBeamStore & beams, _In_ nfDouble dConfiguredRadius)
+	{
+		nfDouble dRadius;
+		if (beams.getUniformRadius(dRadius))
+			return (dRadius > 0) ? dRadius : dConfiguredRadius;
+
+		std::unordered_map<nfDouble, nfUint64> Usage;
+		nfUint32 nBeamCount = beams.getCount();
+		nfUint32 nBlockSize = std::min(nBeamCount, (nfUint32)NMR_MESH_BEAMCOPYBLOCKSIZE);
+		std::vector<nfDouble> Radii(nBlockSize * 2);
+		for (nfUint32 nStart = 0; nStart < nBeamCount; nStart += nBlockSize) {
+			nfUint32 nCount = std::min(nBlockSize, nBeamCount - nStart);
+			beams.getRadii(nStart, nCount, Radii.data());
+			for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++) {
+				nfDouble dRadius1 = Radii[nIndex * 2];
+				if ((dRadius1 == Radii[nIndex * 2 + 1]) && (dRadius1 > 0))
+					Usage[dRadius1]++;
+			}
+		}
+
+		nfDouble dDefaultRadius = dConfiguredRadius;
+		nfUint64 nDefaultUsage = 0;
+		auto iConfigured = Usage.find(dConfiguredRadius);
+		if (iConfigured != Usage.end())
+			nDefaultUsage = iConfigured->second;
+		for (auto iUsage = Usage.begin(); iUsage != Usage.end(); iUsage++) {
+			// the smaller radius wins a tie, so that the output does not depend on the hash order
+			if ((iUsage->second > nDefaultUsage) ||
+				((iUsage->second == nDefaultUsage) && (dDefaultRadius != dConfiguredRadius) && (iUsage->first < dDefaultRadius))) {
+				dDefaultRadius = iUsage->first;
+				nDefaultUsage = iUsage->second;
+			}
+		}
+		return dDefaultRadius;
+	}
+
+	// Returns the default cap mode of the beamlattice. The configured cap mode is kept, unless another
+	// cap mode is used more often, so that these cap modes can be omitted.
+	eModelBeamLatticeCapMode selectDefaultCapMode(_In_ const CMeshBeamStore & beams, _In_ eModelBeamLatticeCapMode eConfiguredCapMode)
+	{
+		const std::vector<MESHBEAMCAPRUN> & capModeRuns = beams.getCapModeRuns();
+		nfUint64 nUsage[3] = { 0, 0, 0 };
+		for (size_t nRun = 0; nRun < capModeRuns.size(); nRun++) {
+			nfUint32 nRunEnd = (nRun + 1 < capModeRuns.size()) ? capModeRuns[nRun + 1].m_nStart : beams.getCount();
+			nfUint32 nRunLength = nRunEnd - capModeRuns[nRun].m_nStart;
+			for (nfUint32 j = 0; j < 2; j++) {
+				nfInt32 nCapMode = capModeRuns[nRun].m_capMode[j];
+				if ((nCapMode >= 0) && (nCapMode < 3))
+					nUsage[nCapMode] += nRunLength;
+			}
+		}
+
+		eModelBeamLatticeCapMode eCapMode = eConfiguredCapMode;
+		eModelBeamLatticeCapMode CapModes[3] = { eModelBeamLatticeCapMode::MODELBEAMLATTICECAPMODE_SPHERE,
+			eModelBeamLatticeCapMode::MODELBEAMLATTICECAPMODE_HEMISPHERE, eModelBeamLatticeCapMode::MODELBEAMLATTICECAPMODE_BUTT };
+		for (nfUint32 j = 0; j < 3; j++) {
+			if (nUsage[CapModes[j]] > nUsage[eCapMode])
+				eCapMode = CapModes[j];
+		}
+		return eCapMode;
+	}
+
 	std::string ballModeToString(eModelBeamLatticeBallMode eBallMode) {
 		switch (eBallMode) {
 		case eModelBeamLatticeBallMode::MODELBEAMLATTICEBALLMODE_NONE: return XML_3MF_BEAMLATTICE_BALLMODE_NONE; break;
@@ -115,6 +183,8 @@ namespace NMR {
 
 	void CModelWriterNode100_Mesh::writeToXML()
 	{
+		NMR_TRACE_SCOPE("CModelWriterNode100_Mesh::writeToXML");
+
 		__NMRASSERT(m_pXMLWriter);
 		__NMRASSERT(m_pModel);
 
@@ -151,6 +221,7 @@ namespace NMR {
 			}
 		}
 		writeFullEndElement();
+		m_pProgressMonitor->AddToCounter(PROGRESSCOUNTER_NODES, nNodeCount);
 
 		// Retrieve Mesh Informations
 		CMeshInformation_Properties * pProperties = NULL;
@@ -247,6 +318,7 @@ namespace NMR {
 			writeEndElement();  */
 		}
 		writeFullEndElement();
+		m_pProgressMonitor->AddToCounter(PROGRESSCOUNTER_TRIANGLES, nFaceCount);
 
 		if (bMeshHasAProperty && !(nObjectLevelPropertyID != 0)) {
 			throw CNMRException(NMR_ERROR_MISSINGOBJECTLEVELPID);
@@ -254,12 +326,21 @@ namespace NMR {
 
 		if (m_bWriteBeamLatticeExtension) {
 			if (nBeamCount > 0) {
+				m_pProgressMonitor->AddToCounter(PROGRESSCOUNTER_BEAMS, nBeamCount);
 				// write beamlattice
 				writeStartElementWithPrefix(XML_3MF_ELEMENT_BEAMLATTICE, XML_3MF_NAMESPACEPREFIX_BEAMLATTICE);
-				nfDouble dDefaultRadius = pMesh->getDefaultBeamRadius();
+				CMeshBeamStore & beams = pMesh->getBeamStore();
+				nfDouble dDefaultRadius = selectDefaultBeamRadius(beams, pMesh->getDefaultBeamRadius());
 				nfDouble dDefaultBallRadius = pMesh->getDefaultBallRadius();
 				nfBool bWriteBallsElement = nBallCount > 0;
-				writeFloatAttribute(XML_3MF_ATTRIBUTE_BEAMLATTICE_RADIUS, float(dDefaultRadius));
+				{
+					// Use the same representation as the beam radii, so that elided radii read back identically
+					std::array<nfChar, MODELWRITERMESH100_LINEBUFFERSIZE> radiusString;
+					nfUint32 nRadiusLength = 0;
+					putDouble(dDefaultRadius, radiusString, nRadiusLength);
+					radiusString[nRadiusLength] = 0;
+					writeConstStringAttribute(XML_3MF_ATTRIBUTE_BEAMLATTICE_RADIUS, radiusString.data());
+				}
 				writeFloatAttribute(XML_3MF_ATTRIBUTE_BEAMLATTICE_MINLENGTH, float(pMesh->getBeamLatticeMinLength()));
 				eModelBeamLatticeBallMode eBallMode = pMesh->getBeamLatticeBallMode();
 
@@ -308,15 +389,23 @@ namespace NMR {
 					writeIntAttribute(XML_3MF_ATTRIBUTE_BEAMLATTICE_REPRESENTATIONMESH, pID->getModelResourceID());
 				}
 
-				eModelBeamLatticeCapMode eDefaultCapMode = pMesh->getBeamLatticeCapMode();
-				writeConstStringAttribute(XML_3MF_ATTRIBUTE_BEAMLATTICE_CAPMODE, capModeToString(eDefaultCapMode).c_str());
+				eModelBeamLatticeCapMode eDefaultCapMode = selectDefaultCapMode(beams, pMesh->getBeamLatticeCapMode());
+				writeConstStringAttribute(XML_3MF_ATTRIBUTE_BEAMLATTICE_CAPMODE, capModeToString(eDefaultCapMode));
 				{
 					// write beamlattice: beams
 					writeStartElementWithPrefix(XML_3MF_ELEMENT_BEAMS, XML_3MF_NAMESPACEPREFIX_BEAMLATTICE);
-					for (nBeamIndex = 0; nBeamIndex < nBeamCount; nBeamIndex++) {
-						// write beamlattice: beam
-						MESHBEAM * pMeshBeam = pMesh->getBeam(nBeamIndex);
-						writeBeamData(pMeshBeam, dDefaultRadius, eDefaultCapMode);
+					const nfInt32 * pNodeIndices = beams.getNodeIndices();
+					nfUint32 nBlockSize = std::min(nBeamCount, (nfUint32)NMR_MESH_BEAMCOPYBLOCKSIZE);
+					std::vector<nfDouble> Radii(nBlockSize * 2);
+					std::vector<nfInt32> CapModes(nBlockSize * 2);
+					for (nfUint32 nStart = 0; nStart < nBeamCount; nStart += nBlockSize) {
+						nfUint32 nCount = std::min(nBlockSize, nBeamCount - nStart);
+						beams.getRadii(nStart, nCount, Radii.data());
+						beams.getCapModes(nStart, nCount, CapModes.data());
+						for (nBeamIndex = 0; nBeamIndex < nCount; nBeamIndex++) {
+							// write beamlattice: beam
+							writeBeamData(&pNodeIndices[(nStart + nBeamIndex) * 2], &Radii[nBeamIndex * 2], &CapModes[nBeamIndex * 2], dDefaultRadius, eDefaultCapMode);
+						}
 					}
 					writeFullEndElement();
 
@@ -704,37 +793,36 @@ namespace NMR {
 		m_pXMLWriter->WriteRawLine(&m_TriangleLine[0], m_nTriangleBufferPos);
 	}	
 
-	__NMR_INLINE void CModelWriterNode100_Mesh::writeBeamData(_In_ MESHBEAM * pBeam, _In_ nfDouble dRadius, _In_ eModelBeamLatticeCapMode eDefaultCapMode)
+	__NMR_INLINE void CModelWriterNode100_Mesh::writeBeamData(_In_ const nfInt32 * pNodeIndices, _In_ const nfDouble * pRadii, _In_ const nfInt32 * pCapModes,
+		_In_ nfDouble dDefaultRadius, _In_ eModelBeamLatticeCapMode eDefaultCapMode)
 	{
-		__NMRASSERT(pBeam);
+		__NMRASSERT(pNodeIndices);
+		__NMRASSERT(pRadii);
+		__NMRASSERT(pCapModes);
 		m_nBeamBufferPos = MODELWRITERMESH100_BEAMLATTICE_BEAMSTARTLENGTH;
-		putBeamUInt32(pBeam->m_nodeindices[0]);
-		const std::string sV2 = "\" " + std::string(XML_3MF_ATTRIBUTE_BEAMLATTICE_V2) + "=\"";
-		putBeamString(sV2.c_str());
-		putBeamUInt32(pBeam->m_nodeindices[1]);
+		putBeamUInt32(pNodeIndices[0]);
+		putBeamString("\" " XML_3MF_ATTRIBUTE_BEAMLATTICE_V2 "=\"");
+		putBeamUInt32(pNodeIndices[1]);
 
-		nfBool bWriteR2 = stringRepresentationsDiffer(pBeam->m_radius[0], pBeam->m_radius[1], m_nPutDoubleFactor);
-		nfBool bWriteR1 = bWriteR2 || stringRepresentationsDiffer(pBeam->m_radius[0], dRadius, m_nPutDoubleFactor);
+		// r2 defaults to r1, and r1 defaults to the lattice radius
+		nfBool bWriteR2 = (pRadii[0] != pRadii[1]) && stringRepresentationsDiffer(pRadii[0], pRadii[1], m_nPutDoubleFactor);
+		nfBool bWriteR1 = bWriteR2 || ((pRadii[0] != dDefaultRadius) && stringRepresentationsDiffer(pRadii[0], dDefaultRadius, m_nPutDoubleFactor));
 		if (bWriteR1) {
-			const std::string sR1 = "\" " + std::string(XML_3MF_ATTRIBUTE_BEAMLATTICE_R1) + "=\"";
-			putBeamString(sR1.c_str());
-			putBeamDouble(pBeam->m_radius[0]);
+			putBeamString("\" " XML_3MF_ATTRIBUTE_BEAMLATTICE_R1 "=\"");
+			putBeamDouble(pRadii[0]);
 		}
 		if (bWriteR2) {
-			const std::string sR2 = "\" " + std::string(XML_3MF_ATTRIBUTE_BEAMLATTICE_R2) + "=\"";
-			putBeamString(sR2.c_str());
-			putBeamDouble(pBeam->m_radius[1]);
+			putBeamString("\" " XML_3MF_ATTRIBUTE_BEAMLATTICE_R2 "=\"");
+			putBeamDouble(pRadii[1]);
 		}
 
-		if ( eDefaultCapMode != pBeam->m_capMode[0] ) {
-			const std::string sCap1 = "\" " + std::string(XML_3MF_ATTRIBUTE_BEAMLATTICE_CAP1) + "=\""
-				                                           + capModeToString(eModelBeamLatticeCapMode(pBeam->m_capMode[0]));
-			putBeamString(sCap1.c_str());
+		if (eDefaultCapMode != pCapModes[0]) {
+			putBeamString("\" " XML_3MF_ATTRIBUTE_BEAMLATTICE_CAP1 "=\"");
+			putBeamString(capModeToString(eModelBeamLatticeCapMode(pCapModes[0])));
 		}
-		if (eDefaultCapMode != pBeam->m_capMode[1]) {
-			const std::string sCap2 = "\" " + std::string(XML_3MF_ATTRIBUTE_BEAMLATTICE_CAP2) + "=\""
-				+ capModeToString(eModelBeamLatticeCapMode(pBeam->m_capMode[1]));
-			putBeamString(sCap2.c_str());
+		if (eDefaultCapMode != pCapModes[1]) {
+			putBeamString("\" " XML_3MF_ATTRIBUTE_BEAMLATTICE_CAP2 "=\"");
+			putBeamString(capModeToString(eModelBeamLatticeCapMode(pCapModes[1])));
 		}
 
 		putBeamString("\"/>");
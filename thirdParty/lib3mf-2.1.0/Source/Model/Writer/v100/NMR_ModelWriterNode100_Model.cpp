@@ -331,12 +331,11 @@ namespace NMR {
 					if (pSlice->getVertexCount() >= 2) {
 						writeStartElementWithPrefix(XML_3MF_ELEMENT_SLICEVERTICES, XML_3MF_NAMESPACEPREFIX_SLICE);
 
+						const NVEC2 * pVertices = pSlice->getVertices();
 						for (nfUint32 nVertexIndex = 0; nVertexIndex < pSlice->getVertexCount(); nVertexIndex++) {
 							writeStartElementWithPrefix(XML_3MF_ELEMENT_VERTEX, XML_3MF_NAMESPACEPREFIX_SLICE);
-							nfFloat x, y;
-							pSlice->getVertex(nVertexIndex, &x, &y);
-							writeFloatAttribute(XML_3MF_ATTRIBUTE_SLICEVERTEX_X, x);
-							writeFloatAttribute(XML_3MF_ATTRIBUTE_SLICEVERTEX_Y, y);
+							writeFloatAttribute(XML_3MF_ATTRIBUTE_SLICEVERTEX_X, pVertices[nVertexIndex].m_fields[0]);
+							writeFloatAttribute(XML_3MF_ATTRIBUTE_SLICEVERTEX_Y, pVertices[nVertexIndex].m_fields[1]);
 							writeEndElement();
 						}
 						writeFullEndElement();
@@ -347,26 +346,29 @@ namespace NMR {
 					}
 
 					for (nfUint32 nPolygonIndex = 0; nPolygonIndex < pSlice->getPolygonCount(); nPolygonIndex++) {
-						if (pSlice->getPolygonIndexCount(nPolygonIndex) >= 2) {
+						nfUint32 nIndexCount = pSlice->getPolygonIndexCount(nPolygonIndex);
+						if (nIndexCount >= 2) {
+							const nfUint32 * pIndices = pSlice->getPolygonIndices(nPolygonIndex);
 							writeStartElementWithPrefix(XML_3MF_ELEMENT_SLICEPOLYGON, XML_3MF_NAMESPACEPREFIX_SLICE);
-							writeIntAttribute(XML_3MF_ATTRIBUTE_SLICEPOLYGON_STARTV, pSlice->getPolygonIndex(nPolygonIndex, 0));
+							writeIntAttribute(XML_3MF_ATTRIBUTE_SLICEPOLYGON_STARTV, pIndices[0]);
 
-							for (nfUint32 nIndexIndex = 1; nIndexIndex < pSlice->getPolygonIndexCount(nPolygonIndex); nIndexIndex++) {
+							for (nfUint32 nIndexIndex = 1; nIndexIndex < nIndexCount; nIndexIndex++) {
 								writeStartElementWithPrefix(XML_3MF_ELEMENT_SLICESEGMENT, XML_3MF_NAMESPACEPREFIX_SLICE);
-								writeIntAttribute(XML_3MF_ATTRIBUTE_SLICESEGMENT_V2, pSlice->getPolygonIndex(nPolygonIndex, nIndexIndex));
+								writeIntAttribute(XML_3MF_ATTRIBUTE_SLICESEGMENT_V2, pIndices[nIndexIndex]);
 								writeEndElement();
 							}
 
 							writeFullEndElement();
 						}
 						else {
-							if (pSlice->getPolygonIndexCount(nPolygonIndex) == 1)
+							if (nIndexCount == 1)
 								throw CNMRException(NMR_ERROR_SLICE_ONEPOINT);
 						}
 					}
 
 					writeFullEndElement();
 				}
+				m_pProgressMonitor->AddToCounter(PROGRESSCOUNTER_SLICES, pSliceStackResource->getSliceCount());
 			}
 			writeFullEndElement();
 		}
@@ -0,0 +1,131 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+Benchmark_Utilities.h: Defines a minimal registry and timing helpers for the
+lib3mf benchmarks
+
+--*/
+
+#ifndef __NMR_BENCHMARK_UTILITIES
+#define __NMR_BENCHMARK_UTILITIES
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Lib3MFBenchmark
+{
+	class CBenchmarkContext;
+	typedef void(*BenchmarkFunction)(CBenchmarkContext & context);
+
+	// A timed case (m_sUnit is empty) or a reported figure of a case
+	struct sBenchmarkResult {
+		std::string m_sBenchmark;
+		std::string m_sCase;
+		uint64_t m_nItems;
+		double m_dSeconds;
+		double m_dValue;
+		std::string m_sUnit;
+		// Resident set size of the process before the case
+		uint64_t m_nResidentBytes;
+		// Peak resident set size of the process while the case ran, see measureResidentBytes
+		uint64_t m_nPeakResidentBytes;
+	};
+
+	class CBenchmarkContext {
+	private:
+		std::string m_sBenchmark;
+		uint32_t m_nRepetitions;
+		std::vector<sBenchmarkResult> & m_Results;
+	public:
+		CBenchmarkContext(const std::string & sBenchmark, uint32_t nRepetitions, std::vector<sBenchmarkResult> & results);
+
+		// Runs fnBody m_nRepetitions times and records the fastest run.
+		// nItems is the amount of work done per run and is used to derive the throughput.
+		void measure(const std::string & sCase, uint64_t nItems, const std::function<void()> & fnBody);
+
+		// Prints a non-timing figure of a case, e.g. an output size.
+		void report(const std::string & sCase, double dValue, const std::string & sUnit);
+	};
+
+	class CBenchmarkRegistry {
+	public:
+		struct sEntry {
+			std::string m_sName;
+			BenchmarkFunction m_fnBenchmark;
+		};
+		static std::vector<sEntry> & entries();
+		static void add(const std::string & sName, BenchmarkFunction fnBenchmark);
+	};
+
+	struct CBenchmarkRegistrar {
+		CBenchmarkRegistrar(const char * pGroup, const char * pName, BenchmarkFunction fnBenchmark)
+		{
+			CBenchmarkRegistry::add(std::string(pGroup) + "." + pName, fnBenchmark);
+		}
+	};
+
+	// Prevents the optimizer from removing a computation whose result is otherwise unused
+	template <typename T>
+	inline void doNotOptimize(T const & value)
+	{
+		static volatile const void * s_pSink;
+		s_pSink = &value;
+	}
+
+	// Returns the current resident set size of the process in bytes, 0 if unknown
+	uint64_t getResidentBytes();
+
+	// Resets the peak resident set size of the process. Returns false if the platform does not support it.
+	bool resetPeakResidentBytes();
+
+	// Returns the peak resident set size of the process since the last reset in bytes, 0 if unknown
+	uint64_t getPeakResidentBytes();
+
+	// Runs fnRun and returns the peak resident set size while it ran. Where the peak cannot be reset,
+	// this is the larger of the resident set sizes sampled before and after fnRun.
+	uint64_t measureResidentBytes(const std::function<void()> & fnRun);
+
+	// Writes all results as a JSON document
+	void writeResultsJSON(std::ostream & stream, const std::vector<sBenchmarkResult> & results);
+
+	inline double secondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+#define LIB3MF_BENCHMARK(Group, Name) \
+	static void Benchmark_##Group##_##Name(Lib3MFBenchmark::CBenchmarkContext & context); \
+	static Lib3MFBenchmark::CBenchmarkRegistrar s_Registrar_##Group##_##Name(#Group, #Name, Benchmark_##Group##_##Name); \
+	static void Benchmark_##Group##_##Name(Lib3MFBenchmark::CBenchmarkContext & context)
+
+#endif //__NMR_BENCHMARK_UTILITIES
@@ -0,0 +1,271 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+AllBenchmarks.cpp: Defines the entry point of the lib3mf benchmark runner
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Lib3MFBenchmark
+{
+	CBenchmarkContext::CBenchmarkContext(const std::string & sBenchmark, uint32_t nRepetitions, std::vector<sBenchmarkResult> & results)
+		: m_sBenchmark(sBenchmark), m_nRepetitions(nRepetitions), m_Results(results)
+	{
+	}
+
+	void CBenchmarkContext::measure(const std::string & sCase, uint64_t nItems, const std::function<void()> & fnBody)
+	{
+		double dBest = -1.0;
+		sBenchmarkResult result;
+		result.m_nResidentBytes = getResidentBytes();
+		result.m_nPeakResidentBytes = measureResidentBytes([&]() {
+			for (uint32_t nRun = 0; nRun < m_nRepetitions; nRun++) {
+				auto start = std::chrono::steady_clock::now();
+				fnBody();
+				double dSeconds = secondsSince(start);
+				if ((dBest < 0.0) || (dSeconds < dBest))
+					dBest = dSeconds;
+			}
+		});
+
+		result.m_sBenchmark = m_sBenchmark;
+		result.m_sCase = sCase;
+		result.m_nItems = nItems;
+		result.m_dSeconds = dBest;
+		result.m_dValue = 0.0;
+		m_Results.push_back(result);
+
+		double dGrowth = (double)result.m_nPeakResidentBytes - (double)result.m_nResidentBytes;
+		std::cout << std::left << std::setw(40) << m_sBenchmark << std::setw(32) << sCase
+			<< std::right << std::setw(12) << std::fixed << std::setprecision(3) << dBest * 1000.0 << " ms"
+			<< std::setw(16) << std::setprecision(0) << (dBest > 0.0 ? nItems / dBest : 0.0) << " items/s"
+			<< std::setw(10) << (result.m_nPeakResidentBytes / (1024.0 * 1024.0)) << " MiB case peak"
+			<< std::showpos << std::setw(8) << (dGrowth / (1024.0 * 1024.0)) << std::noshowpos << " MiB" << std::endl;
+	}
+
+	void CBenchmarkContext::report(const std::string & sCase, double dValue, const std::string & sUnit)
+	{
+		sBenchmarkResult result;
+		result.m_sBenchmark = m_sBenchmark;
+		result.m_sCase = sCase;
+		result.m_nItems = 0;
+		result.m_dSeconds = 0.0;
+		result.m_dValue = dValue;
+		result.m_sUnit = sUnit;
+		result.m_nResidentBytes = getResidentBytes();
+		result.m_nPeakResidentBytes = result.m_nResidentBytes;
+		m_Results.push_back(result);
+
+		std::cout << std::left << std::setw(40) << m_sBenchmark << std::setw(32) << sCase
+			<< std::right << std::setw(15) << std::fixed << std::setprecision(3) << dValue << " " << sUnit << std::endl;
+	}
+
+	uint64_t getResidentBytes()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return 0;
+		return (uint64_t)counters.WorkingSetSize;
+#elif defined(__APPLE__)
+		mach_task_basic_info_data_t info;
+		mach_msg_type_number_t nCount = MACH_TASK_BASIC_INFO_COUNT;
+		if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &nCount) != KERN_SUCCESS)
+			return 0;
+		return (uint64_t)info.resident_size;
+#else
+		// the second field of statm is the resident size in pages
+		std::ifstream statm("/proc/self/statm");
+		uint64_t nSize = 0;
+		uint64_t nResidentPages = 0;
+		if (!(statm >> nSize >> nResidentPages))
+			return 0;
+		return nResidentPages * (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+	}
+
+	bool resetPeakResidentBytes()
+	{
+#if defined(_WIN32) || defined(__APPLE__)
+		return false;
+#else
+		// Linux resets the peak resident size (VmHWM) of the process when "5" is written to clear_refs
+		std::ofstream clearRefs("/proc/self/clear_refs");
+		clearRefs << "5";
+		clearRefs.close();
+		return !clearRefs.fail();
+#endif
+	}
+
+	uint64_t getPeakResidentBytes()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return 0;
+		return (uint64_t)counters.PeakWorkingSetSize;
+#elif defined(__APPLE__)
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return 0;
+		return (uint64_t)usage.ru_maxrss;
+#else
+		std::ifstream status("/proc/self/status");
+		std::string sLine;
+		while (std::getline(status, sLine)) {
+			if (sLine.compare(0, 6, "VmHWM:") == 0)
+				return std::strtoull(sLine.c_str() + 6, nullptr, 10) * 1024;
+		}
+		return 0;
+#endif
+	}
+
+	uint64_t measureResidentBytes(const std::function<void()> & fnRun)
+	{
+		uint64_t nBefore = getResidentBytes();
+		if (resetPeakResidentBytes()) {
+			fnRun();
+			return std::max(getPeakResidentBytes(), nBefore);
+		}
+
+		fnRun();
+		return std::max(getResidentBytes(), nBefore);
+	}
+
+	static std::string escapeJSON(const std::string & sValue)
+	{
+		std::string sResult;
+		for (char c : sValue) {
+			if ((c == '"') || (c == '\\'))
+				sResult += '\\';
+			sResult += c;
+		}
+		return sResult;
+	}
+
+	void writeResultsJSON(std::ostream & stream, const std::vector<sBenchmarkResult> & results)
+	{
+		std::stringstream sStream;
+		sStream << std::setprecision(9);
+		sStream << "{\n\t\"results\": [";
+		for (size_t nIndex = 0; nIndex < results.size(); nIndex++) {
+			const sBenchmarkResult & result = results[nIndex];
+			sStream << ((nIndex > 0) ? ",\n" : "\n") << "\t\t{ \"benchmark\": \"" << escapeJSON(result.m_sBenchmark)
+				<< "\", \"case\": \"" << escapeJSON(result.m_sCase) << "\", ";
+			if (result.m_sUnit.empty()) {
+				sStream << "\"items\": " << result.m_nItems << ", \"seconds\": " << result.m_dSeconds
+					<< ", \"itemsPerSecond\": " << ((result.m_dSeconds > 0.0) ? result.m_nItems / result.m_dSeconds : 0.0);
+			}
+			else {
+				sStream << "\"value\": " << result.m_dValue << ", \"unit\": \"" << escapeJSON(result.m_sUnit) << "\"";
+			}
+			sStream << ", \"residentBytes\": " << result.m_nResidentBytes
+				<< ", \"peakResidentBytes\": " << result.m_nPeakResidentBytes << " }";
+		}
+		sStream << "\n\t]\n}\n";
+		stream << sStream.str();
+	}
+
+	std::vector<CBenchmarkRegistry::sEntry> & CBenchmarkRegistry::entries()
+	{
+		static std::vector<sEntry> s_Entries;
+		return s_Entries;
+	}
+
+	void CBenchmarkRegistry::add(const std::string & sName, BenchmarkFunction fnBenchmark)
+	{
+		sEntry entry;
+		entry.m_sName = sName;
+		entry.m_fnBenchmark = fnBenchmark;
+		entries().push_back(entry);
+	}
+}
+
+using namespace Lib3MFBenchmark;
+
+int main(int argc, char **argv)
+{
+	std::string sFilter;
+	std::string sJSONFile;
+	uint32_t nRepetitions = 3;
+
+	for (int i = 1; i < argc; i++) {
+		if ((strcmp(argv[i], "--filter") == 0) && (i + 1 < argc)) {
+			sFilter = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--repetitions") == 0) && (i + 1 < argc)) {
+			nRepetitions = (uint32_t)std::max(1, atoi(argv[++i]));
+		}
+		else if ((strcmp(argv[i], "--json") == 0) && (i + 1 < argc)) {
+			sJSONFile = argv[++i];
+		}
+		else {
+			std::cerr << "usage: " << argv[0] << " [--filter <substring>] [--repetitions <n>] [--json <file>]" << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<sBenchmarkResult> results;
+	for (auto entry : CBenchmarkRegistry::entries()) {
+		if (!sFilter.empty() && (entry.m_sName.find(sFilter) == std::string::npos))
+			continue;
+
+		CBenchmarkContext context(entry.m_sName, nRepetitions, results);
+		entry.m_fnBenchmark(context);
+	}
+
+	if (!sJSONFile.empty()) {
+		std::ofstream stream(sJSONFile);
+		writeResultsJSON(stream, results);
+		if (!stream) {
+			std::cerr << "could not write " << sJSONFile << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
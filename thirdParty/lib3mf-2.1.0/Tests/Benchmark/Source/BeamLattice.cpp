@@ -0,0 +1,140 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+BeamLattice.cpp: Measures the memory footprint of the beam storage and the
+throughput of building, writing and reading beam lattices with uniform,
+single precision and double precision radii
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelMeshObject.h"
+#include "Model/Classes/NMR_ModelBuildItem.h"
+#include "Model/Writer/NMR_ModelWriter_3MF_Native.h"
+#include "Model/Reader/NMR_ModelReader_3MF_Native.h"
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Shared_Memory.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NMR;
+
+// Creates the nodes of a cubic grid and the beams along its edges.
+// Radii and cap modes of each beam are given by fnRadius and fnCapMode.
+static PMesh createLattice(nfUint32 nGridSize, std::function<nfDouble(nfUint32)> fnRadius, std::function<nfInt32(nfUint32)> fnCapMode)
+{
+	PMesh pMesh = std::make_shared<CMesh>();
+	for (nfUint32 nZ = 0; nZ < nGridSize; nZ++)
+		for (nfUint32 nY = 0; nY < nGridSize; nY++)
+			for (nfUint32 nX = 0; nX < nGridSize; nX++)
+				pMesh->addNode(nX * 2.0f, nY * 2.0f, nZ * 2.0f);
+
+	std::vector<nfInt32> NodeIndices;
+	for (nfUint32 nZ = 0; nZ < nGridSize; nZ++) {
+		for (nfUint32 nY = 0; nY < nGridSize; nY++) {
+			for (nfUint32 nX = 0; nX < nGridSize; nX++) {
+				nfInt32 nNode = (nZ * nGridSize + nY) * nGridSize + nX;
+				if (nX + 1 < nGridSize)
+					NodeIndices.insert(NodeIndices.end(), { nNode, nNode + 1 });
+				if (nY + 1 < nGridSize)
+					NodeIndices.insert(NodeIndices.end(), { nNode, nNode + (nfInt32)nGridSize });
+				if (nZ + 1 < nGridSize)
+					NodeIndices.insert(NodeIndices.end(), { nNode, nNode + (nfInt32)(nGridSize * nGridSize) });
+			}
+		}
+	}
+
+	nfUint32 nBeamCount = (nfUint32)(NodeIndices.size() / 2);
+	std::vector<nfDouble> Radii(NodeIndices.size());
+	std::vector<nfInt32> CapModes(NodeIndices.size());
+	for (nfUint32 nBeam = 0; nBeam < nBeamCount; nBeam++) {
+		Radii[nBeam * 2] = Radii[nBeam * 2 + 1] = fnRadius(nBeam);
+		CapModes[nBeam * 2] = CapModes[nBeam * 2 + 1] = fnCapMode(nBeam);
+	}
+	pMesh->addBeams(nBeamCount, NodeIndices.data(), Radii.data(), CapModes.data());
+	return pMesh;
+}
+
+static PExportStreamMemory writeLatticeToMemory(PMesh pMesh)
+{
+	PModel pModel = std::make_shared<CModel>();
+	PModelMeshObject pObject = std::make_shared<CModelMeshObject>(1, pModel.get(), pMesh);
+	pModel->addResource(pObject);
+	pModel->addBuildItem(std::make_shared<CModelBuildItem>(pObject.get(), pModel->createHandle()));
+
+	PExportStreamMemory pStream = std::make_shared<CExportStreamMemory>();
+	CModelWriter_3MF_Native writer(pModel);
+	writer.exportToStream(pStream);
+	return pStream;
+}
+
+LIB3MF_BENCHMARK(BeamLattice, Storage)
+{
+	const nfUint32 nGridSize = 60;
+	const std::pair<std::string, std::function<nfDouble(nfUint32)>> radii[] = {
+		{ "uniform", [](nfUint32) { return 0.5; } },
+		{ "float", [](nfUint32 nBeam) { return 0.25 + (nBeam % 8) / 32.0; } },
+		{ "double", [](nfUint32 nBeam) { return 0.1 * (1 + nBeam % 7); } },
+	};
+	auto fnCapMode = [](nfUint32 nBeam) { return (nBeam % 1000 == 0) ? (nfInt32)MODELBEAMLATTICECAPMODE_BUTT : (nfInt32)MODELBEAMLATTICECAPMODE_SPHERE; };
+
+	for (const auto & radius : radii) {
+		std::string sSuffix = "/" + radius.first;
+
+		PMesh pMesh;
+		nfUint32 nBeamCount = 3 * nGridSize * nGridSize * (nGridSize - 1);
+		context.measure("build" + sSuffix, nBeamCount, [&]() {
+			pMesh = createLattice(nGridSize, radius.second, fnCapMode);
+		});
+		context.report("memory" + sSuffix, (double)pMesh->getBeamStore().getMemoryUsage() / nBeamCount, "bytes/beam");
+
+		std::vector<nfInt32> CapModes(nBeamCount * 2);
+		context.measure("getcapmodes" + sSuffix, nBeamCount, [&]() {
+			pMesh->getBeamStore().getCapModes(0, nBeamCount, CapModes.data());
+			Lib3MFBenchmark::doNotOptimize(CapModes[nBeamCount]);
+		});
+
+		PExportStreamMemory pStream;
+		context.measure("write" + sSuffix, nBeamCount, [&]() {
+			pStream = writeLatticeToMemory(pMesh);
+		});
+		context.report("size" + sSuffix, pStream->getDataSize() / 1024.0, "KiB");
+
+		context.measure("read" + sSuffix, nBeamCount, [&]() {
+			PModel pModel = std::make_shared<CModel>();
+			CModelReader_3MF_Native reader(pModel);
+			reader.readStream(std::make_shared<CImportStream_Shared_Memory>(pStream->getData(), pStream->getDataSize()));
+			Lib3MFBenchmark::doNotOptimize(pModel->getResourceCount());
+		});
+	}
+}
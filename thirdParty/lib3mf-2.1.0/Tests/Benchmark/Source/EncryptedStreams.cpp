@@ -0,0 +1,197 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+EncryptedStreams.cpp: Measures the throughput of the encrypted (and compressed)
+part streams of secure content, using a trivial XOR cipher callback, and the
+read time of packages with many encrypted model parts at varying decryption
+thread counts
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include "Common/Platform/NMR_ExportStream_Encrypted.h"
+#include "Common/Platform/NMR_ExportStream_Compressed.h"
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Encrypted.h"
+#include "Common/Platform/NMR_ImportStream_Compressed.h"
+#include "Common/Platform/NMR_ImportStream_Shared_Memory.h"
+#include "Common/NMR_ParallelFor.h"
+#include "Common/NMR_SecureContext.h"
+#include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelMeshObject.h"
+#include "Model/Classes/NMR_ModelBuildItem.h"
+#include "Model/Classes/NMR_KeyStore.h"
+#include "Model/Classes/NMR_KeyStoreFactory.h"
+#include "Model/Writer/NMR_ModelWriter_3MF_Native.h"
+#include "Model/Reader/NMR_ModelReader_3MF_Native.h"
+
+#include <cmath>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace NMR;
+
+static ContentEncryptionDescriptor createXORDescriptor(nfBool bInPlace)
+{
+	ContentEncryptionDescriptor descriptor;
+	descriptor.m_sDekDecryptData.m_pUserData = nullptr;
+	descriptor.m_bInPlace = bInPlace;
+	descriptor.m_fnCrypt = [](nfUint64 size, const nfByte * pIn, nfByte * pOut, ContentEncryptionContext & context) {
+		for (nfUint64 nIndex = 0; nIndex < size; nIndex++)
+			pOut[nIndex] = pIn[nIndex] ^ 0x5a;
+		return size;
+	};
+	return descriptor;
+}
+
+// XML-like content, so that the compressed variants see realistic ratios
+static std::vector<nfByte> createContent(nfUint64 cbSize)
+{
+	std::vector<nfByte> content;
+	content.reserve((size_t)cbSize);
+	nfUint32 nIndex = 0;
+	while (content.size() < cbSize) {
+		std::string sLine = "<vertex x=\"" + std::to_string(nIndex % 1000) + ".5\" y=\"" + std::to_string((nIndex * 7) % 1000) + "\" z=\"1\" />\n";
+		content.insert(content.end(), sLine.begin(), sLine.end());
+		nIndex++;
+	}
+	content.resize((size_t)cbSize);
+	return content;
+}
+
+LIB3MF_BENCHMARK(EncryptedStreams, Throughput)
+{
+	const nfUint64 cbSize = 64 * 1024 * 1024;
+	// typical write granularity of the XML writer and of copyFrom
+	const nfUint64 cbWriteChunk = 64 * 1024;
+	std::vector<nfByte> content = createContent(cbSize);
+
+	for (nfBool bCompressed : { false, true }) {
+		std::string sSuffix = bCompressed ? "/deflate" : "/stored";
+
+		PExportStreamMemory pCipherStream;
+		context.measure("write" + sSuffix, cbSize, [&]() {
+			pCipherStream = std::make_shared<CExportStreamMemory>();
+			PExportStream pStream = std::make_shared<CExportStream_Encrypted>(pCipherStream, createXORDescriptor(false));
+			if (bCompressed)
+				pStream = std::make_shared<CExportStream_Compressed>(pStream);
+			for (nfUint64 cbOffset = 0; cbOffset < cbSize; cbOffset += cbWriteChunk)
+				pStream->writeBuffer(content.data() + cbOffset, std::min(cbWriteChunk, cbSize - cbOffset));
+			pStream->close();
+		});
+
+		for (nfBool bInPlace : { false, true }) {
+			std::vector<nfByte> plain;
+			context.measure("read" + sSuffix + (bInPlace ? "/inplace" : "/copy"), cbSize, [&]() {
+				PImportStream pStream = std::make_shared<CImportStream_Encrypted>(
+					std::make_shared<CImportStream_Shared_Memory>(pCipherStream->getData(), pCipherStream->getDataSize()), createXORDescriptor(bInPlace));
+				if (bCompressed)
+					pStream = std::make_shared<CImportStream_Compressed>(pStream);
+				PImportStream pMemory = pStream->copyToMemory();
+				plain.resize((size_t)pMemory->retrieveSize());
+				pMemory->readBuffer(plain.data(), plain.size(), true);
+			});
+
+			if (plain != content)
+				throw std::runtime_error("encrypted stream round trip failed");
+		}
+	}
+}
+
+static PMesh createGridMesh(nfUint32 nGridSize, nfFloat fHeight)
+{
+	PMesh pMesh = std::make_shared<CMesh>();
+	for (nfUint32 nY = 0; nY < nGridSize; nY++)
+		for (nfUint32 nX = 0; nX < nGridSize; nX++)
+			pMesh->addNode(fnVEC3_make(nX * 0.5f, nY * 0.5f, fHeight + std::sin(nX * 0.1f) * std::cos(nY * 0.1f)));
+
+	for (nfUint32 nY = 0; nY + 1 < nGridSize; nY++) {
+		for (nfUint32 nX = 0; nX + 1 < nGridSize; nX++) {
+			nfUint32 nIndex = nY * nGridSize + nX;
+			pMesh->addFace(nIndex, nIndex + 1, nIndex + nGridSize + 1);
+			pMesh->addFace(nIndex, nIndex + nGridSize + 1, nIndex + nGridSize);
+		}
+	}
+	return pMesh;
+}
+
+// Every mesh object lives in its own deflated and encrypted model part
+static PExportStreamMemory writeEncryptedParts(nfUint32 nPartCount, nfUint32 nGridSize)
+{
+	PModel pModel = std::make_shared<CModel>();
+	PKeyStoreResourceDataGroup pGroup = CKeyStoreFactory::makeResourceDataGroup(std::make_shared<CUUID>(), std::vector<nfByte>(32, 0));
+	pModel->getKeyStore()->addResourceDataGroup(pGroup);
+
+	std::string sRootPath = pModel->currentPath();
+	for (nfUint32 nPart = 0; nPart < nPartCount; nPart++) {
+		std::string sPath = "/3D/part" + std::to_string(nPart) + ".model";
+		pModel->setCurrentPath(sPath);
+		PModelMeshObject pObject = std::make_shared<CModelMeshObject>(nPart + 1, pModel.get(), createGridMesh(nGridSize, (nfFloat)nPart));
+		pModel->addResource(pObject);
+		pModel->setCurrentPath(sRootPath);
+		pModel->addBuildItem(std::make_shared<CModelBuildItem>(pObject.get(), pModel->createHandle()));
+
+		PKeyStoreCEKParams pParams = CKeyStoreFactory::makeCEKParams(true, eKeyStoreEncryptAlgorithm::AES256_GCM, std::vector<nfByte>());
+		pModel->getKeyStore()->addResourceData(CKeyStoreFactory::makeResourceData(pGroup, pModel->findOrCreateModelPath(sPath), pParams));
+	}
+
+	PExportStreamMemory pStream = std::make_shared<CExportStreamMemory>();
+	CModelWriter_3MF_Native writer(pModel);
+	writer.secureContext()->setDekCtx(createXORDescriptor(false));
+	writer.exportToStream(pStream);
+	return pStream;
+}
+
+LIB3MF_BENCHMARK(EncryptedStreams, ParallelParts)
+{
+	const nfUint32 nPartCount = 64;
+	const nfUint32 nGridSize = 100;
+	PExportStreamMemory pPackage = writeEncryptedParts(nPartCount, nGridSize);
+	context.report("size", pPackage->getDataSize() / 1024.0, "KiB");
+
+	std::vector<nfUint32> threadCounts = { 1, 2, 4 };
+	if (fnGetHardwareThreadCount() > 4)
+		threadCounts.push_back(fnGetHardwareThreadCount());
+
+	for (nfUint32 nThreadCount : threadCounts) {
+		context.measure("read/" + std::to_string(nThreadCount) + "t", nPartCount, [&]() {
+			PModel pModel = std::make_shared<CModel>();
+			CModelReader_3MF_Native reader(pModel);
+			reader.setDecryptionThreadCount(nThreadCount);
+			reader.secureContext()->setDekCtx(createXORDescriptor(false));
+			reader.readStream(std::make_shared<CImportStream_Shared_Memory>(pPackage->getData(), pPackage->getDataSize()));
+			if (pModel->getObjectCount() != nPartCount)
+				throw std::runtime_error("encrypted parts were not read");
+		});
+	}
+}
@@ -0,0 +1,166 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+MeshLayout.cpp: Measures the effect of the mesh layout optimization on the
+vertex cache miss ratio, the compressed 3MF size and the read time of a
+shuffled triangle mesh
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelMeshObject.h"
+#include "Model/Classes/NMR_ModelBuildItem.h"
+#include "Model/Writer/NMR_ModelWriter_3MF_Native.h"
+#include "Model/Reader/NMR_ModelReader_3MF_Native.h"
+#include "Common/Mesh/NMR_MeshLayoutOptimizer.h"
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Shared_Memory.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace NMR;
+
+// Creates a wavy height field with shuffled nodes and faces, as written by exporters
+// that emit their internal hash map order.
+static PMesh createShuffledMesh(nfUint32 nGridSize)
+{
+	std::mt19937 generator(42);
+
+	std::vector<nfUint32> NodeOrder(nGridSize * nGridSize);
+	for (nfUint32 nIndex = 0; nIndex < NodeOrder.size(); nIndex++)
+		NodeOrder[nIndex] = nIndex;
+	std::shuffle(NodeOrder.begin(), NodeOrder.end(), generator);
+
+	std::vector<NVEC3> Positions(NodeOrder.size());
+	for (nfUint32 nY = 0; nY < nGridSize; nY++) {
+		for (nfUint32 nX = 0; nX < nGridSize; nX++) {
+			NVEC3 & vPosition = Positions[NodeOrder[nY * nGridSize + nX]];
+			vPosition.m_fields[0] = nX * 0.5f;
+			vPosition.m_fields[1] = nY * 0.5f;
+			vPosition.m_fields[2] = 2.0f * std::sin(nX * 0.1f) * std::cos(nY * 0.1f);
+		}
+	}
+
+	std::vector<std::array<nfInt32, 3>> Faces;
+	Faces.reserve((size_t)(nGridSize - 1) * (nGridSize - 1) * 2);
+	for (nfUint32 nY = 0; nY + 1 < nGridSize; nY++) {
+		for (nfUint32 nX = 0; nX + 1 < nGridSize; nX++) {
+			nfInt32 n00 = NodeOrder[nY * nGridSize + nX];
+			nfInt32 n10 = NodeOrder[nY * nGridSize + nX + 1];
+			nfInt32 n01 = NodeOrder[(nY + 1) * nGridSize + nX];
+			nfInt32 n11 = NodeOrder[(nY + 1) * nGridSize + nX + 1];
+			Faces.push_back({ { n00, n10, n11 } });
+			Faces.push_back({ { n00, n11, n01 } });
+		}
+	}
+	std::shuffle(Faces.begin(), Faces.end(), generator);
+
+	PMesh pMesh = std::make_shared<CMesh>();
+	for (const NVEC3 & vPosition : Positions)
+		pMesh->addNode(vPosition);
+	for (const auto & Face : Faces)
+		pMesh->addFace(Face[0], Face[1], Face[2]);
+	return pMesh;
+}
+
+// Average number of FIFO vertex cache misses per face
+static double vertexCacheMissRatio(CMesh * pMesh, nfUint32 nCacheSize)
+{
+	std::deque<nfInt32> Cache;
+	nfUint64 nMisses = 0;
+	nfUint32 nFaceCount = pMesh->getFaceCount();
+	for (nfUint32 nIndex = 0; nIndex < nFaceCount; nIndex++) {
+		MESHFACE * pFace = pMesh->getFace(nIndex);
+		for (nfUint32 j = 0; j < 3; j++) {
+			if (std::find(Cache.begin(), Cache.end(), pFace->m_nodeindices[j]) == Cache.end()) {
+				nMisses++;
+				Cache.push_back(pFace->m_nodeindices[j]);
+				if (Cache.size() > nCacheSize)
+					Cache.pop_front();
+			}
+		}
+	}
+	return nFaceCount > 0 ? (double)nMisses / nFaceCount : 0.0;
+}
+
+static PExportStreamMemory writeMeshToMemory(PMesh pMesh)
+{
+	PModel pModel = std::make_shared<CModel>();
+	PModelMeshObject pObject = std::make_shared<CModelMeshObject>(1, pModel.get(), pMesh);
+	pModel->addResource(pObject);
+	pModel->addBuildItem(std::make_shared<CModelBuildItem>(pObject.get(), pModel->createHandle()));
+
+	PExportStreamMemory pStream = std::make_shared<CExportStreamMemory>();
+	CModelWriter_3MF_Native writer(pModel);
+	writer.exportToStream(pStream);
+	return pStream;
+}
+
+LIB3MF_BENCHMARK(MeshLayout, Grid)
+{
+	const nfUint32 gridSizes[] = { 100, 500 };
+
+	for (nfUint32 nGridSize : gridSizes) {
+		std::string sSuffix = "/" + std::to_string(nGridSize * nGridSize) + "v";
+		PMesh pShuffled = createShuffledMesh(nGridSize);
+		nfUint32 nFaceCount = pShuffled->getFaceCount();
+
+		PMesh pOptimized;
+		context.measure("optimize" + sSuffix, nFaceCount, [&]() {
+			pOptimized = std::make_shared<CMesh>(pShuffled.get());
+			CMeshLayoutOptimizer Optimizer(true, true, true);
+			Optimizer.optimize(pOptimized.get());
+		});
+
+		const std::pair<std::string, PMesh> layouts[] = { { "shuffled", pShuffled }, { "optimized", pOptimized } };
+		for (const auto & layout : layouts) {
+			context.report("acmr/" + layout.first + sSuffix, vertexCacheMissRatio(layout.second.get(), 32), "misses/face");
+
+			PExportStreamMemory pStream;
+			context.measure("write/" + layout.first + sSuffix, nFaceCount, [&]() {
+				pStream = writeMeshToMemory(layout.second);
+			});
+			context.report("size/" + layout.first + sSuffix, pStream->getDataSize() / 1024.0, "KiB");
+
+			context.measure("read/" + layout.first + sSuffix, nFaceCount, [&]() {
+				PModel pModel = std::make_shared<CModel>();
+				CModelReader_3MF_Native reader(pModel);
+				reader.readStream(std::make_shared<CImportStream_Shared_Memory>(pStream->getData(), pStream->getDataSize()));
+				Lib3MFBenchmark::doNotOptimize(pModel->getResourceCount());
+			});
+		}
+	}
+}
@@ -0,0 +1,121 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+MeshMerge.cpp: Measures merging a build plate of instanced, colored parts into one
+mesh with an increasing number of threads
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include "Common/Math/NMR_Matrix.h"
+#include "Common/Mesh/NMR_Mesh.h"
+#include "Common/Mesh/NMR_MeshMerger.h"
+#include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
+#include "Common/NMR_ParallelFor.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NMR;
+
+// Height field of nGridSize x nGridSize nodes with a color per node
+static PMesh createColoredPart(nfUint32 nGridSize, UniqueResourceID nResourceID)
+{
+	PMesh pMesh = std::make_shared<CMesh>();
+	for (nfUint32 nY = 0; nY < nGridSize; nY++)
+		for (nfUint32 nX = 0; nX < nGridSize; nX++)
+			pMesh->addNode(fnVEC3_make(nX * 0.1f, nY * 0.1f, std::sin(nX * 0.2f) * std::cos(nY * 0.2f)));
+
+	for (nfUint32 nY = 0; nY + 1 < nGridSize; nY++) {
+		for (nfUint32 nX = 0; nX + 1 < nGridSize; nX++) {
+			nfUint32 nIndex = nY * nGridSize + nX;
+			pMesh->addFace(nIndex, nIndex + 1, nIndex + nGridSize + 1);
+			pMesh->addFace(nIndex, nIndex + nGridSize + 1, nIndex + nGridSize);
+		}
+	}
+
+	PMeshInformation_Properties pInformation = std::make_shared<CMeshInformation_Properties>(pMesh->getFaceCount());
+	pMesh->createMeshInformationHandler()->addInformation(pInformation);
+	for (nfUint32 nFace = 0; nFace < pMesh->getFaceCount(); nFace++) {
+		MESHFACE * pFace = pMesh->getFace(nFace);
+		MESHINFORMATION_PROPERTIES * pData = (MESHINFORMATION_PROPERTIES*)pInformation->getFaceData(nFace);
+		pData->m_nUniqueResourceID = nResourceID;
+		for (nfUint32 j = 0; j < 3; j++)
+			pData->m_nPropertyIDs[j] = 1 + pFace->m_nodeindices[j];
+	}
+	return pMesh;
+}
+
+LIB3MF_BENCHMARK(MeshMerge, InstancedPlate)
+{
+	const nfUint32 nInstanceCount = 500;
+	const nfUint32 nPartCount = 4;
+	const nfUint32 nGridSize = 40;
+
+	std::vector<PMesh> Parts;
+	for (nfUint32 nPart = 0; nPart < nPartCount; nPart++)
+		Parts.push_back(createColoredPart(nGridSize, 1 + nPart));
+
+	std::map<UniqueResourceID, UniqueResourceID> Mapping;
+	for (nfUint32 nPart = 0; nPart < nPartCount; nPart++)
+		Mapping[1 + nPart] = 100 + nPart;
+
+	nfUint64 nFaceCount = (nfUint64)nInstanceCount * Parts[0]->getFaceCount();
+	std::vector<nfUint32> ThreadCounts = { 1, 2, 4 };
+	nfUint32 nHardwareThreads = fnGetHardwareThreadCount();
+	if (nHardwareThreads > 4)
+		ThreadCounts.push_back(nHardwareThreads);
+
+	for (nfUint32 nThreadCount : ThreadCounts) {
+		context.measure("plate/" + std::to_string(nInstanceCount) + "x/" + std::to_string(nThreadCount) + "t", nFaceCount, [&]() {
+			CMeshMerger merger;
+			merger.setThreadCount(nThreadCount);
+			merger.setResourceIDMapping(Mapping);
+			for (nfUint32 nInstance = 0; nInstance < nInstanceCount; nInstance++) {
+				NMATRIX3 mMatrix = fnMATRIX3_translation(fnVEC3_make((nInstance % 25) * 5.0f, (nInstance / 25) * 5.0f, 0.0f));
+				merger.addInstance(Parts[nInstance % nPartCount].get(), mMatrix);
+			}
+			CMesh mesh;
+			merger.merge(&mesh);
+		});
+	}
+
+	// One merge per instance, as done before the merger collected all instances
+	context.measure("plate/" + std::to_string(nInstanceCount) + "x/sequential", nFaceCount, [&]() {
+		CMesh mesh;
+		for (nfUint32 nInstance = 0; nInstance < nInstanceCount; nInstance++) {
+			NMATRIX3 mMatrix = fnMATRIX3_translation(fnVEC3_make((nInstance % 25) * 5.0f, (nInstance / 25) * 5.0f, 0.0f));
+			mesh.mergeMesh(Parts[nInstance % nPartCount].get(), mMatrix);
+		}
+		mesh.patchMeshInformationResources(Mapping);
+	});
+}
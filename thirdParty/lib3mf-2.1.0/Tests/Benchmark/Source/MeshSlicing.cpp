@@ -0,0 +1,102 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+MeshSlicing.cpp: Measures the throughput of generating slices from a mesh with
+10 million triangles, with one and several slicing threads
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include "Common/Mesh/NMR_Mesh.h"
+#include "Common/Mesh/NMR_MeshSlicer.h"
+#include "Model/Classes/NMR_ModelSlice.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NMR;
+
+// A torus standing upright, so that slices cut through both of its rings,
+// sampled in nRings x nSegments quads
+static PMesh createTorus(nfUint32 nRings, nfUint32 nSegments)
+{
+	PMesh pMesh = std::make_shared<CMesh>();
+	const nfFloat fPi = 3.14159265f;
+	for (nfUint32 nRing = 0; nRing < nRings; nRing++) {
+		nfFloat fTheta = 2.0f * fPi * nRing / nRings;
+		for (nfUint32 nSegment = 0; nSegment < nSegments; nSegment++) {
+			nfFloat fPhi = 2.0f * fPi * nSegment / nSegments;
+			nfFloat fRadius = 40.0f + 15.0f * cosf(fPhi);
+			pMesh->addNode(fRadius * cosf(fTheta), 15.0f * sinf(fPhi), fRadius * sinf(fTheta));
+		}
+	}
+	for (nfUint32 nRing = 0; nRing < nRings; nRing++) {
+		for (nfUint32 nSegment = 0; nSegment < nSegments; nSegment++) {
+			nfInt32 n00 = nRing * nSegments + nSegment;
+			nfInt32 n01 = nRing * nSegments + (nSegment + 1) % nSegments;
+			nfInt32 n10 = ((nRing + 1) % nRings) * nSegments + nSegment;
+			nfInt32 n11 = ((nRing + 1) % nRings) * nSegments + (nSegment + 1) % nSegments;
+			pMesh->addFace(n00, n10, n11);
+			pMesh->addFace(n00, n11, n01);
+		}
+	}
+	return pMesh;
+}
+
+LIB3MF_BENCHMARK(MeshSlicing, Torus)
+{
+	// 2 x 2240 x 2240 = 10.04 million triangles
+	PMesh pMesh = createTorus(2240, 2240);
+	CMeshSlicer slicer(pMesh.get());
+
+	// Layers of 0.1mm, sampled in their middle
+	const nfDouble dLayerHeight = 0.1;
+	nfUint32 nLayerCount = (nfUint32)std::ceil((slicer.getZMax() - slicer.getZMin()) / dLayerHeight);
+	std::vector<nfDouble> PlaneZ(nLayerCount);
+	for (nfUint32 nLayer = 0; nLayer < nLayerCount; nLayer++)
+		PlaneZ[nLayer] = slicer.getZMin() + (nLayer + 0.5) * dLayerHeight;
+
+	nfUint64 nVertexCount = 0;
+	for (nfUint32 nThreadCount : { 1, 2, 4, 8 }) {
+		context.measure("slice/" + std::to_string(nThreadCount) + "threads", nLayerCount, [&]() {
+			std::vector<PSlice> Slices(nLayerCount);
+			for (nfUint32 nLayer = 0; nLayer < nLayerCount; nLayer++)
+				Slices[nLayer] = std::make_shared<CSlice>(PlaneZ[nLayer]);
+			slicer.slice(PlaneZ, Slices, nThreadCount);
+
+			nVertexCount = 0;
+			for (PSlice & pSlice : Slices)
+				nVertexCount += pSlice->getVertexCount();
+			Lib3MFBenchmark::doNotOptimize(nVertexCount);
+		});
+	}
+	context.report("vertices", (double)nVertexCount / nLayerCount, "vertices/slice");
+}
@@ -0,0 +1,424 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+Models.cpp: Measures the read, write, validate, merge and STL import/export
+throughput of deterministically generated models of several kinds (plain
+meshes, per-vertex colors, textures, beam lattices, slice stacks, production
+multi-part and encrypted packages) at several sizes
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Shared_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Unique_Memory.h"
+#include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
+#include "Common/NMR_SecureContext.h"
+#include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelMeshObject.h"
+#include "Model/Classes/NMR_ModelComponentsObject.h"
+#include "Model/Classes/NMR_ModelBuildItem.h"
+#include "Model/Classes/NMR_ModelColorGroup.h"
+#include "Model/Classes/NMR_ModelTexture2D.h"
+#include "Model/Classes/NMR_ModelTexture2DGroup.h"
+#include "Model/Classes/NMR_ModelSliceStack.h"
+#include "Model/Classes/NMR_ModelConstants.h"
+#include "Model/Classes/NMR_KeyStore.h"
+#include "Model/Classes/NMR_KeyStoreFactory.h"
+#include "Model/Writer/NMR_ModelWriter_3MF_Native.h"
+#include "Model/Writer/NMR_ModelWriter_STL.h"
+#include "Model/Reader/NMR_ModelReader_3MF_Native.h"
+#include "Model/Reader/NMR_ModelReader_STL.h"
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace NMR;
+
+// A size every model kind is measured at: the edge length of the generated grid,
+// or the number of slices
+struct sModelSize {
+	const char * m_pszName;
+	nfUint32 m_nSize;
+};
+
+// 2 x (n-1)^2 triangles: about 10 thousand, 100 thousand and 1 million
+static const sModelSize s_MeshSizes[] = { { "small", 72 }, { "medium", 225 }, { "large", 708 } };
+
+// Number of parts of the production and encrypted packages
+static const nfUint32 s_nPartCount = 16;
+
+static ContentEncryptionDescriptor createXORDescriptor()
+{
+	ContentEncryptionDescriptor descriptor;
+	descriptor.m_sDekDecryptData.m_pUserData = nullptr;
+	descriptor.m_bInPlace = false;
+	descriptor.m_fnCrypt = [](nfUint64 size, const nfByte * pIn, nfByte * pOut, ContentEncryptionContext & context) {
+		for (nfUint64 nIndex = 0; nIndex < size; nIndex++)
+			pOut[nIndex] = pIn[nIndex] ^ 0x5a;
+		return size;
+	};
+	return descriptor;
+}
+
+// A wavy height field of nGridSize x nGridSize nodes
+static PMesh createGridMesh(nfUint32 nGridSize, nfFloat fOffset)
+{
+	PMesh pMesh = std::make_shared<CMesh>();
+	for (nfUint32 nY = 0; nY < nGridSize; nY++)
+		for (nfUint32 nX = 0; nX < nGridSize; nX++)
+			pMesh->addNode(fnVEC3_make(fOffset + nX * 0.5f, nY * 0.5f, std::sin(nX * 0.1f) * std::cos(nY * 0.1f)));
+
+	for (nfUint32 nY = 0; nY + 1 < nGridSize; nY++) {
+		for (nfUint32 nX = 0; nX + 1 < nGridSize; nX++) {
+			nfUint32 nIndex = nY * nGridSize + nX;
+			pMesh->addFace(nIndex, nIndex + 1, nIndex + nGridSize + 1);
+			pMesh->addFace(nIndex, nIndex + nGridSize + 1, nIndex + nGridSize);
+		}
+	}
+	return pMesh;
+}
+
+// Assigns the property nFirstPropertyID + node index to every corner of the mesh,
+// and nFirstPropertyID to the object
+static void setVertexProperties(CMesh * pMesh, UniqueResourceID nResourceID, ModelPropertyID nFirstPropertyID)
+{
+	PMeshInformation_Properties pInformation = std::make_shared<CMeshInformation_Properties>(pMesh->getFaceCount());
+	pMesh->createMeshInformationHandler()->addInformation(pInformation);
+	for (nfUint32 nFace = 0; nFace < pMesh->getFaceCount(); nFace++) {
+		MESHFACE * pFace = pMesh->getFace(nFace);
+		MESHINFORMATION_PROPERTIES * pData = (MESHINFORMATION_PROPERTIES*)pInformation->getFaceData(nFace);
+		pData->m_nUniqueResourceID = nResourceID;
+		for (nfUint32 j = 0; j < 3; j++)
+			pData->m_nPropertyIDs[j] = nFirstPropertyID + pFace->m_nodeindices[j];
+	}
+
+	MESHINFORMATION_PROPERTIES * pDefaultData = new MESHINFORMATION_PROPERTIES;
+	pDefaultData->m_nUniqueResourceID = nResourceID;
+	for (nfUint32 j = 0; j < 3; j++)
+		pDefaultData->m_nPropertyIDs[j] = nFirstPropertyID;
+	pInformation->setDefaultData((MESHINFORMATIONFACEDATA*)pDefaultData);
+}
+
+static PModelMeshObject addMeshObject(CModel * pModel, ModelResourceID nID, PMesh pMesh)
+{
+	PModelMeshObject pObject = std::make_shared<CModelMeshObject>(nID, pModel, pMesh);
+	pModel->addResource(pObject);
+	pModel->addBuildItem(std::make_shared<CModelBuildItem>(pObject.get(), pModel->createHandle()));
+	return pObject;
+}
+
+static PModel createPlainModel(nfUint32 nGridSize)
+{
+	PModel pModel = std::make_shared<CModel>();
+	addMeshObject(pModel.get(), 1, createGridMesh(nGridSize, 0.0f));
+	return pModel;
+}
+
+static PModel createColorModel(nfUint32 nGridSize)
+{
+	PModel pModel = std::make_shared<CModel>();
+	PModelColorGroupResource pColorGroup = std::make_shared<CModelColorGroupResource>(1, pModel.get());
+	pModel->addResource(pColorGroup);
+	std::vector<nfColor> colors(nGridSize * nGridSize);
+	for (nfUint32 nIndex = 0; nIndex < colors.size(); nIndex++)
+		colors[nIndex] = 0xff000000 | ((nIndex * 2654435761u) & 0xffffff);
+	ModelPropertyID nFirstPropertyID = pColorGroup->addColors(colors.data(), (nfUint32)colors.size());
+
+	PMesh pMesh = createGridMesh(nGridSize, 0.0f);
+	setVertexProperties(pMesh.get(), pColorGroup->getPackageResourceID()->getUniqueID(), nFirstPropertyID);
+	addMeshObject(pModel.get(), 2, pMesh);
+	return pModel;
+}
+
+static PModel createTextureModel(nfUint32 nGridSize)
+{
+	PModel pModel = std::make_shared<CModel>();
+
+	// The image content is not decoded, only its size matters
+	std::vector<nfByte> image(1024 * 1024);
+	const nfByte pngSignature[] = { 0x89, 'P', 'N', 'G', 0x0d, 0x0a, 0x1a, 0x0a };
+	for (size_t nIndex = 0; nIndex < image.size(); nIndex++)
+		image[nIndex] = (nIndex < sizeof(pngSignature)) ? pngSignature[nIndex] : (nfByte)((nIndex * 2654435761u) >> 24);
+	PModelAttachment pAttachment = pModel->addAttachment(std::string(PACKAGE_TEXTURE_URI_BASE) + "/texture.png", PACKAGE_TEXTURE_RELATIONSHIP_TYPE,
+		std::make_shared<CImportStream_Unique_Memory>(image.data(), image.size()));
+
+	PModelTexture2DResource pTexture = CModelTexture2DResource::make(1, pModel.get(), pAttachment);
+	pTexture->setContentType(MODELTEXTURETYPE_PNG);
+	pModel->addResource(pTexture);
+
+	PModelTexture2DGroupResource pGroup = std::make_shared<CModelTexture2DGroupResource>(2, pModel.get(), pTexture);
+	pModel->addResource(pGroup);
+	std::vector<MODELTEXTURE2DCOORDINATE> coordinates(nGridSize * nGridSize);
+	for (nfUint32 nIndex = 0; nIndex < coordinates.size(); nIndex++) {
+		coordinates[nIndex].m_dU = (nIndex % nGridSize) / (nfDouble)nGridSize;
+		coordinates[nIndex].m_dV = (nIndex / nGridSize) / (nfDouble)nGridSize;
+	}
+	ModelPropertyID nFirstPropertyID = pGroup->addUVCoordinates(coordinates.data(), (nfUint32)coordinates.size());
+
+	PMesh pMesh = createGridMesh(nGridSize, 0.0f);
+	setVertexProperties(pMesh.get(), pGroup->getPackageResourceID()->getUniqueID(), nFirstPropertyID);
+	addMeshObject(pModel.get(), 3, pMesh);
+	return pModel;
+}
+
+// The nodes of a cubic grid and the beams along its edges
+static PModel createLatticeModel(nfUint32 nGridSize)
+{
+	PMesh pMesh = std::make_shared<CMesh>();
+	for (nfUint32 nZ = 0; nZ < nGridSize; nZ++)
+		for (nfUint32 nY = 0; nY < nGridSize; nY++)
+			for (nfUint32 nX = 0; nX < nGridSize; nX++)
+				pMesh->addNode(fnVEC3_make(nX * 2.0f, nY * 2.0f, nZ * 2.0f));
+
+	std::vector<nfInt32> NodeIndices;
+	for (nfUint32 nZ = 0; nZ < nGridSize; nZ++) {
+		for (nfUint32 nY = 0; nY < nGridSize; nY++) {
+			for (nfUint32 nX = 0; nX < nGridSize; nX++) {
+				nfInt32 nNode = (nZ * nGridSize + nY) * nGridSize + nX;
+				if (nX + 1 < nGridSize)
+					NodeIndices.insert(NodeIndices.end(), { nNode, nNode + 1 });
+				if (nY + 1 < nGridSize)
+					NodeIndices.insert(NodeIndices.end(), { nNode, nNode + (nfInt32)nGridSize });
+				if (nZ + 1 < nGridSize)
+					NodeIndices.insert(NodeIndices.end(), { nNode, nNode + (nfInt32)(nGridSize * nGridSize) });
+			}
+		}
+	}
+	std::vector<nfDouble> Radii(NodeIndices.size());
+	std::vector<nfInt32> CapModes(NodeIndices.size(), MODELBEAMLATTICECAPMODE_SPHERE);
+	for (size_t nIndex = 0; nIndex < Radii.size(); nIndex++)
+		Radii[nIndex] = 0.25 + ((nIndex / 2) % 8) / 32.0;
+	pMesh->addBeams((nfUint32)(NodeIndices.size() / 2), NodeIndices.data(), Radii.data(), CapModes.data());
+
+	PModel pModel = std::make_shared<CModel>();
+	addMeshObject(pModel.get(), 1, pMesh);
+	return pModel;
+}
+
+// A slice stack in its own part with 8 circles of 64 vertices per slice
+static PModel createSliceModel(nfUint32 nSliceCount)
+{
+	PModel pModel = std::make_shared<CModel>();
+	PModelSliceStack pSliceStack = std::make_shared<CModelSliceStack>(1, pModel.get(), 0.0);
+	for (nfUint32 nSlice = 0; nSlice < nSliceCount; nSlice++) {
+		PSlice pSlice = pSliceStack->AddSlice(0.1 * (nSlice + 1));
+		for (nfUint32 nPolygon = 0; nPolygon < 8; nPolygon++) {
+			nfUint32 nFirstVertex = pSlice->getVertexCount();
+			nfUint32 nPolygonIndex = pSlice->beginPolygon();
+			for (nfUint32 nVertex = 0; nVertex < 64; nVertex++) {
+				nfFloat fAngle = 6.2831853f * nVertex / 64;
+				pSlice->addPolygonIndex(nPolygonIndex, pSlice->addVertex(nPolygon * 10.0f + std::cos(fAngle), nSlice * 0.01f + std::sin(fAngle)));
+			}
+			pSlice->addPolygonIndex(nPolygonIndex, nFirstVertex);
+		}
+	}
+	pSliceStack->SetOwnPath("/2D/slices.model");
+	pModel->addResource(pSliceStack);
+
+	PModelSliceStack pRootStack = std::make_shared<CModelSliceStack>(2, pModel.get(), 0.0);
+	pRootStack->AddSliceRef(pSliceStack);
+	pModel->addResource(pRootStack);
+	return pModel;
+}
+
+// s_nPartCount mesh objects, each in its own model part, assembled by a components
+// object of the root part. If bEncrypted is set, every part is encrypted.
+static PModel createMultiPartModel(nfUint32 nGridSize, nfBool bEncrypted)
+{
+	PModel pModel = std::make_shared<CModel>();
+	PKeyStoreResourceDataGroup pGroup;
+	if (bEncrypted) {
+		pGroup = CKeyStoreFactory::makeResourceDataGroup(std::make_shared<CUUID>(), std::vector<nfByte>(32, 0));
+		pModel->getKeyStore()->addResourceDataGroup(pGroup);
+	}
+
+	std::string sRootPath = pModel->currentPath();
+	PModelComponentsObject pAssembly = std::make_shared<CModelComponentsObject>(s_nPartCount + 1, pModel.get());
+	for (nfUint32 nPart = 0; nPart < s_nPartCount; nPart++) {
+		std::string sPath = "/3D/part" + std::to_string(nPart) + ".model";
+		pModel->setCurrentPath(sPath);
+		PModelMeshObject pObject = std::make_shared<CModelMeshObject>(nPart + 1, pModel.get(), createGridMesh(nGridSize, 0.0f));
+		pModel->addResource(pObject);
+		pModel->setCurrentPath(sRootPath);
+		pAssembly->addComponent(std::make_shared<CModelComponent>(pObject.get(), fnMATRIX3_translation(fnVEC3_make(nPart * nGridSize * 0.5f, 0.0f, 0.0f))));
+
+		if (bEncrypted) {
+			PKeyStoreCEKParams pParams = CKeyStoreFactory::makeCEKParams(true, eKeyStoreEncryptAlgorithm::AES256_GCM, std::vector<nfByte>());
+			pModel->getKeyStore()->addResourceData(CKeyStoreFactory::makeResourceData(pGroup, pModel->findOrCreateModelPath(sPath), pParams));
+		}
+	}
+	pModel->addResource(pAssembly);
+	pModel->addBuildItem(std::make_shared<CModelBuildItem>(pAssembly.get(), pModel->createHandle()));
+	return pModel;
+}
+
+static nfUint64 countTriangles(CModel * pModel)
+{
+	nfUint64 nCount = 0;
+	for (nfUint32 nIndex = 0; nIndex < pModel->getObjectCount(); nIndex++) {
+		CModelMeshObject * pMeshObject = dynamic_cast<CModelMeshObject *>(pModel->getObject(nIndex));
+		if (pMeshObject != nullptr)
+			nCount += pMeshObject->getMesh()->getFaceCount();
+	}
+	return nCount;
+}
+
+static PModel readPackage(PExportStreamMemory pPackage, nfBool bEncrypted)
+{
+	PModel pModel = std::make_shared<CModel>();
+	CModelReader_3MF_Native reader(pModel);
+	if (bEncrypted)
+		reader.secureContext()->setDekCtx(createXORDescriptor());
+	reader.readStream(std::make_shared<CImportStream_Shared_Memory>(pPackage->getData(), pPackage->getDataSize()));
+	return pModel;
+}
+
+// Measures writing and reading pModel, and validating, merging and exporting to
+// and importing from STL the read model. nItems is the number of triangles, beams or
+// slices the model consists of. Merging and STL are skipped for models without meshes.
+static void measureModel(Lib3MFBenchmark::CBenchmarkContext & context, const std::string & sSize, PModel pModel, nfUint64 nItems, nfBool bEncrypted)
+{
+	PExportStreamMemory pPackage;
+	context.measure("write/" + sSize, nItems, [&]() {
+		pPackage = std::make_shared<CExportStreamMemory>();
+		CModelWriter_3MF_Native writer(pModel);
+		if (bEncrypted)
+			writer.secureContext()->setDekCtx(createXORDescriptor());
+		writer.exportToStream(pPackage);
+	});
+	context.report("size/" + sSize, pPackage->getDataSize() / 1024.0, "KiB");
+
+	PModel pReadModel;
+	context.measure("read/" + sSize, nItems, [&]() {
+		pReadModel = readPackage(pPackage, bEncrypted);
+	});
+
+	context.measure("validate/" + sSize, nItems, [&]() {
+		nfUint32 nValidCount = 0;
+		for (nfUint32 nIndex = 0; nIndex < pReadModel->getObjectCount(); nIndex++) {
+			CModelObject * pObject = pReadModel->getObject(nIndex);
+			nfBool bValid = pObject->isValid();
+			CModelMeshObject * pMeshObject = dynamic_cast<CModelMeshObject *>(pObject);
+			if (pMeshObject != nullptr)
+				bValid = bValid && pMeshObject->getMesh()->checkSanity() && pMeshObject->isManifoldAndOriented();
+			if (bValid)
+				nValidCount++;
+		}
+		Lib3MFBenchmark::doNotOptimize(nValidCount);
+	});
+
+	if (pReadModel->getObjectCount() == 0)
+		return;
+
+	context.measure("merge/" + sSize, nItems, [&]() {
+		CMesh mesh;
+		pReadModel->mergeToMesh(&mesh);
+		Lib3MFBenchmark::doNotOptimize(mesh.getFaceCount());
+	});
+
+	nfUint64 nTriangleCount = countTriangles(pReadModel.get());
+	if (nTriangleCount == 0)
+		return;
+
+	PExportStreamMemory pSTL;
+	context.measure("stlexport/" + sSize, nItems, [&]() {
+		pSTL = std::make_shared<CExportStreamMemory>();
+		CModelWriter_STL writer(pReadModel);
+		writer.exportToStream(pSTL);
+	});
+
+	context.measure("stlimport/" + sSize, nItems, [&]() {
+		PModel pSTLModel = std::make_shared<CModel>();
+		CModelReader_STL reader(pSTLModel);
+		reader.readStream(std::make_shared<CImportStream_Shared_Memory>(pSTL->getData(), pSTL->getDataSize()));
+		Lib3MFBenchmark::doNotOptimize(pSTLModel->getObjectCount());
+	});
+}
+
+static void measureMeshModels(Lib3MFBenchmark::CBenchmarkContext & context, PModel (*fnCreateModel)(nfUint32))
+{
+	for (const sModelSize & size : s_MeshSizes) {
+		PModel pModel = fnCreateModel(size.m_nSize);
+		measureModel(context, size.m_pszName, pModel, countTriangles(pModel.get()), false);
+	}
+}
+
+LIB3MF_BENCHMARK(Models, Plain)
+{
+	measureMeshModels(context, createPlainModel);
+}
+
+LIB3MF_BENCHMARK(Models, VertexColors)
+{
+	measureMeshModels(context, createColorModel);
+}
+
+LIB3MF_BENCHMARK(Models, Textures)
+{
+	measureMeshModels(context, createTextureModel);
+}
+
+LIB3MF_BENCHMARK(Models, BeamLattice)
+{
+	// 3 x n^2 x (n-1) beams: about 10 thousand, 100 thousand and 1 million
+	const sModelSize sizes[] = { { "small", 16 }, { "medium", 33 }, { "large", 70 } };
+	for (const sModelSize & size : sizes) {
+		PModel pModel = createLatticeModel(size.m_nSize);
+		nfUint64 nBeamCount = 3ull * size.m_nSize * size.m_nSize * (size.m_nSize - 1);
+		measureModel(context, size.m_pszName, pModel, nBeamCount, false);
+	}
+}
+
+LIB3MF_BENCHMARK(Models, SliceStack)
+{
+	const sModelSize sizes[] = { { "small", 100 }, { "medium", 500 }, { "large", 2000 } };
+	for (const sModelSize & size : sizes)
+		measureModel(context, size.m_pszName, createSliceModel(size.m_nSize), size.m_nSize, false);
+}
+
+LIB3MF_BENCHMARK(Models, Production)
+{
+	for (const sModelSize & size : s_MeshSizes) {
+		// the parts together have about as many triangles as the single mesh models
+		PModel pModel = createMultiPartModel(size.m_nSize / 4, false);
+		measureModel(context, size.m_pszName, pModel, countTriangles(pModel.get()), false);
+	}
+}
+
+LIB3MF_BENCHMARK(Models, Encrypted)
+{
+	for (const sModelSize & size : s_MeshSizes) {
+		PModel pModel = createMultiPartModel(size.m_nSize / 4, true);
+		measureModel(context, size.m_pszName, pModel, countTriangles(pModel.get()), true);
+	}
+}
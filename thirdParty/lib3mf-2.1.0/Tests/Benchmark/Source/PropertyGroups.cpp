@@ -0,0 +1,117 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+PropertyGroups.cpp: Measures adding, deduplicating, reading and writer-side
+index mapping of large color groups
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelColorGroup.h"
+#include "Common/MeshInformation/NMR_MeshInformation_Properties.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace NMR;
+
+LIB3MF_BENCHMARK(PropertyGroups, Colors)
+{
+	const nfUint32 colorCounts[] = { 1000, 100000, 1000000 };
+
+	for (nfUint32 nColorCount : colorCounts) {
+		CModel model;
+		// package resource IDs are not released with their resource
+		ModelResourceID nNextResourceID = 1;
+		std::vector<nfColor> colors(nColorCount);
+		for (nfUint32 nIndex = 0; nIndex < nColorCount; nIndex++)
+			colors[nIndex] = 0xff000000 | nIndex;
+
+		context.measure("add/" + std::to_string(nColorCount), nColorCount, [&]() {
+			CModelColorGroupResource colorGroup(nNextResourceID++, &model);
+			for (nfColor cColor : colors)
+				colorGroup.addColor(cColor);
+			Lib3MFBenchmark::doNotOptimize(colorGroup.getCount());
+		});
+
+		context.measure("addbulk/" + std::to_string(nColorCount), nColorCount, [&]() {
+			CModelColorGroupResource colorGroup(nNextResourceID++, &model);
+			colorGroup.addColors(colors.data(), nColorCount);
+			Lib3MFBenchmark::doNotOptimize(colorGroup.getCount());
+		});
+
+		// per-corner colors of a scan with few distinct colors
+		std::vector<nfColor> cornerColors(nColorCount);
+		for (nfUint32 nIndex = 0; nIndex < nColorCount; nIndex++)
+			cornerColors[nIndex] = 0xff000000 | ((nIndex * 7) % 10);
+		std::vector<ModelPropertyID> cornerPropertyIDs(nColorCount);
+		context.measure("adddedup/" + std::to_string(nColorCount), nColorCount, [&]() {
+			CModelColorGroupResource colorGroup(nNextResourceID++, &model);
+			colorGroup.addColorsDeduplicated(cornerColors.data(), nColorCount, cornerPropertyIDs.data());
+			Lib3MFBenchmark::doNotOptimize(colorGroup.getCount());
+		});
+
+		PModelColorGroupResource pColorGroup = std::make_shared<CModelColorGroupResource>(nNextResourceID++, &model);
+		model.addResource(pColorGroup);
+		nfUint32 nFirstPropertyID = pColorGroup->addColors(colors.data(), nColorCount);
+
+		// random access pattern, identical for every color count
+		std::mt19937 generator(42);
+		std::uniform_int_distribution<nfUint32> distribution(0, nColorCount - 1);
+		std::vector<ModelPropertyID> accessPattern(nColorCount);
+		for (auto & nAccess : accessPattern)
+			nAccess = nFirstPropertyID + distribution(generator);
+
+		context.measure("get/" + std::to_string(nColorCount), nColorCount, [&]() {
+			nfColor cSum = 0;
+			for (ModelPropertyID nPropertyID : accessPattern)
+				cSum += pColorGroup->getColor(nPropertyID);
+			Lib3MFBenchmark::doNotOptimize(cSum);
+		});
+
+		std::vector<nfColor> readColors(nColorCount);
+		context.measure("getbulk/" + std::to_string(nColorCount), nColorCount, [&]() {
+			pColorGroup->getColors(readColors.data());
+			Lib3MFBenchmark::doNotOptimize(readColors[0]);
+		});
+
+		UniqueResourceID nUniqueID = pColorGroup->getPackageResourceID()->getUniqueID();
+		context.measure("indexmap/" + std::to_string(nColorCount), nColorCount, [&]() {
+			CMeshInformation_PropertyIndexMapping mapping;
+			for (nfUint32 nIndex = 0; nIndex < nColorCount; nIndex++)
+				mapping.registerPropertyID(nUniqueID, nFirstPropertyID + nIndex, nIndex);
+			nfUint32 nSum = 0;
+			for (ModelPropertyID nPropertyID : accessPattern)
+				nSum += mapping.mapPropertyIDToIndex(nUniqueID, nPropertyID);
+			Lib3MFBenchmark::doNotOptimize(nSum);
+		});
+	}
+}
@@ -0,0 +1,85 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+ResourceLookup.cpp: Measures the lookup throughput of model resources by
+UniqueResourceID and by (path, ModelResourceID) against the resource count
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelColorGroup.h"
+
+#include <memory>
+#include <random>
+
+using namespace NMR;
+
+LIB3MF_BENCHMARK(ResourceLookup, ByUniqueAndModelID)
+{
+	const nfUint32 nLookups = 1000000;
+	const nfUint32 resourceCounts[] = { 10, 100, 1000, 10000, 100000 };
+
+	for (nfUint32 nResourceCount : resourceCounts) {
+		CModel model;
+		std::vector<UniqueResourceID> uniqueIDs;
+		std::vector<ModelResourceID> modelIDs;
+		uniqueIDs.reserve(nResourceCount);
+		modelIDs.reserve(nResourceCount);
+
+		for (nfUint32 nIndex = 0; nIndex < nResourceCount; nIndex++) {
+			PModelColorGroupResource pColorGroup = std::make_shared<CModelColorGroupResource>(model.generateResourceID(), &model);
+			model.addResource(pColorGroup);
+			uniqueIDs.push_back(pColorGroup->getPackageResourceID()->getUniqueID());
+			modelIDs.push_back(pColorGroup->getPackageResourceID()->getModelResourceID());
+		}
+
+		// random access pattern, identical for every resource count
+		std::mt19937 generator(42);
+		std::uniform_int_distribution<nfUint32> distribution(0, nResourceCount - 1);
+		std::vector<nfUint32> accessPattern(nLookups);
+		for (auto & nAccess : accessPattern)
+			nAccess = distribution(generator);
+
+		context.measure("unique/" + std::to_string(nResourceCount), nLookups, [&]() {
+			size_t nFound = 0;
+			for (nfUint32 nAccess : accessPattern)
+				nFound += (model.findResource(uniqueIDs[nAccess]).get() != nullptr);
+			Lib3MFBenchmark::doNotOptimize(nFound);
+		});
+
+		PPackageModelPath pPath = model.currentModelPath();
+		context.measure("path+id/" + std::to_string(nResourceCount), nLookups, [&]() {
+			size_t nFound = 0;
+			for (nfUint32 nAccess : accessPattern)
+				nFound += (model.findPackageResourceID(pPath, modelIDs[nAccess]).get() != nullptr);
+			Lib3MFBenchmark::doNotOptimize(nFound);
+		});
+	}
+}
@@ -0,0 +1,112 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+SliceStack.cpp: Measures the memory footprint of slices and the throughput of
+reading a slice model part serially and with several slice reading threads
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include "Model/Classes/NMR_Model.h"
+#include "Model/Classes/NMR_ModelSliceStack.h"
+#include "Model/Writer/NMR_ModelWriter_3MF_Native.h"
+#include "Model/Reader/NMR_ModelReader_3MF_Native.h"
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+#include "Common/Platform/NMR_ImportStream_Shared_Memory.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NMR;
+
+// Creates a slicestack in its own part, with nPolygons closed polygons of
+// nVertices vertices per slice, and a root slicestack that references it.
+static PModel createSliceModel(nfUint32 nSliceCount, nfUint32 nPolygons, nfUint32 nVertices)
+{
+	PModel pModel = std::make_shared<CModel>();
+	PModelSliceStack pSliceStack = std::make_shared<CModelSliceStack>(1, pModel.get(), 0.0);
+	for (nfUint32 nSlice = 0; nSlice < nSliceCount; nSlice++) {
+		PSlice pSlice = pSliceStack->AddSlice(0.1 * (nSlice + 1));
+		pSlice->reserveVertices(nPolygons * nVertices);
+		for (nfUint32 nPolygon = 0; nPolygon < nPolygons; nPolygon++) {
+			nfUint32 nFirstVertex = pSlice->getVertexCount();
+			nfUint32 nPolygonIndex = pSlice->beginPolygon();
+			for (nfUint32 nVertex = 0; nVertex < nVertices; nVertex++) {
+				nfFloat fAngle = 6.2831853f * nVertex / nVertices;
+				pSlice->addPolygonIndex(nPolygonIndex, pSlice->addVertex(nPolygon * 10.0f + std::cos(fAngle), nSlice * 0.01f + std::sin(fAngle)));
+			}
+			pSlice->addPolygonIndex(nPolygonIndex, nFirstVertex);
+		}
+	}
+	pSliceStack->SetOwnPath("/2D/slices.model");
+	pModel->addResource(pSliceStack);
+
+	PModelSliceStack pRootStack = std::make_shared<CModelSliceStack>(2, pModel.get(), 0.0);
+	pRootStack->AddSliceRef(pSliceStack);
+	pModel->addResource(pRootStack);
+	return pModel;
+}
+
+LIB3MF_BENCHMARK(SliceStack, Read)
+{
+	const nfUint32 nSliceCount = 2000;
+	const nfUint32 nPolygons = 8;
+	const nfUint32 nVertices = 64;
+
+	PModel pModel;
+	context.measure("build", nSliceCount, [&]() {
+		pModel = createSliceModel(nSliceCount, nPolygons, nVertices);
+	});
+
+	PModelSliceStack pSliceStack = std::dynamic_pointer_cast<CModelSliceStack>(pModel->getResource(0));
+	nfUint64 nMemory = 0;
+	for (nfUint32 nSlice = 0; nSlice < nSliceCount; nSlice++)
+		nMemory += pSliceStack->getSlice(nSlice)->getMemoryUsage();
+	context.report("memory", (double)nMemory / (nSliceCount * nPolygons), "bytes/polygon");
+
+	PExportStreamMemory pStream = std::make_shared<CExportStreamMemory>();
+	context.measure("write", nSliceCount, [&]() {
+		pStream = std::make_shared<CExportStreamMemory>();
+		CModelWriter_3MF_Native writer(pModel);
+		writer.exportToStream(pStream);
+	});
+	context.report("size", pStream->getDataSize() / 1024.0, "KiB");
+
+	for (nfUint32 nThreadCount : { 1, 2, 4, 8 }) {
+		context.measure("read/threads" + std::to_string(nThreadCount), nSliceCount, [&]() {
+			PModel pReadModel = std::make_shared<CModel>();
+			CModelReader_3MF_Native reader(pReadModel);
+			reader.setSliceThreadCount(nThreadCount);
+			reader.readStream(std::make_shared<CImportStream_Shared_Memory>(pStream->getData(), pStream->getDataSize()));
+			Lib3MFBenchmark::doNotOptimize(pReadModel->getResourceCount());
+		});
+	}
+}
@@ -0,0 +1,299 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+SpatialIndex.cpp: Measures building the bounding volume hierarchies over the
+triangles and beams of a mesh and the throughput of box, closest point and
+ray queries, compared to testing every primitive
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include "Common/Mesh/NMR_Mesh.h"
+#include "Common/Mesh/NMR_MeshBVH.h"
+#include "Common/Math/NMR_Vector.h"
+#include "Common/NMR_ParallelFor.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace NMR;
+
+// A closed surface of revolution with a wavy profile, sampled in nRings x nSegments quads
+static PMesh createSurface(nfUint32 nRings, nfUint32 nSegments)
+{
+	PMesh pMesh = std::make_shared<CMesh>();
+	const nfFloat fPi = 3.14159265f;
+	for (nfUint32 nRing = 0; nRing <= nRings; nRing++) {
+		nfFloat fTheta = fPi * nRing / nRings;
+		for (nfUint32 nSegment = 0; nSegment < nSegments; nSegment++) {
+			nfFloat fPhi = 2.0f * fPi * nSegment / nSegments;
+			nfFloat fRadius = 50.0f + 5.0f * sinf(fTheta * 7.0f) * cosf(fPhi * 5.0f);
+			pMesh->addNode(fRadius * sinf(fTheta) * cosf(fPhi), fRadius * sinf(fTheta) * sinf(fPhi), fRadius * cosf(fTheta));
+		}
+	}
+	for (nfUint32 nRing = 0; nRing < nRings; nRing++) {
+		for (nfUint32 nSegment = 0; nSegment < nSegments; nSegment++) {
+			nfInt32 n00 = nRing * nSegments + nSegment;
+			nfInt32 n01 = nRing * nSegments + (nSegment + 1) % nSegments;
+			nfInt32 n10 = n00 + nSegments;
+			nfInt32 n11 = n01 + nSegments;
+			pMesh->addFace(n00, n10, n11);
+			pMesh->addFace(n00, n11, n01);
+		}
+	}
+	return pMesh;
+}
+
+// The beams along the edges of a cubic grid with a spacing of 2 and varying radii
+static PMesh createLattice(nfUint32 nGridSize)
+{
+	PMesh pMesh = std::make_shared<CMesh>();
+	for (nfUint32 nZ = 0; nZ < nGridSize; nZ++)
+		for (nfUint32 nY = 0; nY < nGridSize; nY++)
+			for (nfUint32 nX = 0; nX < nGridSize; nX++)
+				pMesh->addNode(nX * 2.0f, nY * 2.0f, nZ * 2.0f);
+
+	std::vector<nfInt32> NodeIndices;
+	for (nfUint32 nZ = 0; nZ < nGridSize; nZ++) {
+		for (nfUint32 nY = 0; nY < nGridSize; nY++) {
+			for (nfUint32 nX = 0; nX < nGridSize; nX++) {
+				nfInt32 nNode = (nZ * nGridSize + nY) * nGridSize + nX;
+				if (nX + 1 < nGridSize)
+					NodeIndices.insert(NodeIndices.end(), { nNode, nNode + 1 });
+				if (nY + 1 < nGridSize)
+					NodeIndices.insert(NodeIndices.end(), { nNode, nNode + (nfInt32)nGridSize });
+				if (nZ + 1 < nGridSize)
+					NodeIndices.insert(NodeIndices.end(), { nNode, nNode + (nfInt32)(nGridSize * nGridSize) });
+			}
+		}
+	}
+
+	nfUint32 nBeamCount = (nfUint32)(NodeIndices.size() / 2);
+	std::vector<nfDouble> Radii(NodeIndices.size());
+	std::vector<nfInt32> CapModes(NodeIndices.size(), MODELBEAMLATTICECAPMODE_SPHERE);
+	for (nfUint32 nBeam = 0; nBeam < nBeamCount; nBeam++) {
+		Radii[nBeam * 2] = 0.2 + (nBeam % 5) * 0.05;
+		Radii[nBeam * 2 + 1] = 0.2 + (nBeam % 3) * 0.05;
+	}
+	pMesh->addBeams(nBeamCount, NodeIndices.data(), Radii.data(), CapModes.data());
+	return pMesh;
+}
+
+static std::vector<NVEC3> createPoints(nfUint32 nCount, nfFloat fMin, nfFloat fMax)
+{
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<nfFloat> distribution(fMin, fMax);
+	std::vector<NVEC3> Points(nCount);
+	for (NVEC3 & vPoint : Points)
+		vPoint = fnVEC3_make(distribution(generator), distribution(generator), distribution(generator));
+	return Points;
+}
+
+// Reference ray cast, testing every triangle
+static nfBool rayCastBruteForce(CMesh * pMesh, const NVEC3 & vOrigin, const NVEC3 & vDirection, nfDouble & dDistance)
+{
+	nfBool bHit = false;
+	dDistance = 1e30;
+	nfUint32 nFaceCount = pMesh->getFaceCount();
+	for (nfUint32 nFace = 0; nFace < nFaceCount; nFace++) {
+		MESHFACE * pFace = pMesh->getFace(nFace);
+		NVEC3 vA = pMesh->getNode(pFace->m_nodeindices[0])->m_position;
+		NVEC3 vE1 = fnVEC3_sub(pMesh->getNode(pFace->m_nodeindices[1])->m_position, vA);
+		NVEC3 vE2 = fnVEC3_sub(pMesh->getNode(pFace->m_nodeindices[2])->m_position, vA);
+		NVEC3 vP = fnVEC3_crossproduct(vDirection, vE2);
+		nfFloat fDet = fnVEC3_dotproduct(vE1, vP);
+		if (fDet == 0.0f)
+			continue;
+		NVEC3 vT = fnVEC3_sub(vOrigin, vA);
+		nfFloat fU = fnVEC3_dotproduct(vT, vP) / fDet;
+		if ((fU < 0.0f) || (fU > 1.0f))
+			continue;
+		NVEC3 vQ = fnVEC3_crossproduct(vT, vE1);
+		nfFloat fV = fnVEC3_dotproduct(vDirection, vQ) / fDet;
+		if ((fV < 0.0f) || (fU + fV > 1.0f))
+			continue;
+		nfDouble dT = fnVEC3_dotproduct(vE2, vQ) / fDet;
+		if ((dT >= 0.0) && (dT < dDistance)) {
+			dDistance = dT;
+			bHit = true;
+		}
+	}
+	return bHit;
+}
+
+LIB3MF_BENCHMARK(SpatialIndex, Faces)
+{
+	PMesh pMesh = createSurface(400, 400);
+	nfUint32 nFaceCount = pMesh->getFaceCount();
+
+	context.measure("build/1thread", nFaceCount, [&]() {
+		CMeshBVH bvh(pMesh.get(), eMeshBVHPrimitive::Faces, 1);
+		Lib3MFBenchmark::doNotOptimize(bvh.getNodeCount());
+	});
+	context.measure("build/hardwarethreads", nFaceCount, [&]() {
+		CMeshBVH bvh(pMesh.get(), eMeshBVHPrimitive::Faces, fnGetHardwareThreadCount());
+		Lib3MFBenchmark::doNotOptimize(bvh.getNodeCount());
+	});
+
+	CMeshBVH * pBVH = pMesh->getFaceBVH();
+	context.report("memory", (double)pBVH->getMemoryUsage() / nFaceCount, "bytes/triangle");
+
+	const nfUint32 nQueryCount = 20000;
+	std::vector<NVEC3> Points = createPoints(nQueryCount, -80.0f, 80.0f);
+	context.measure("closest", nQueryCount, [&]() {
+		nfDouble dSum = 0.0;
+		for (const NVEC3 & vPoint : Points) {
+			nfUint32 nIndex;
+			NVEC3 vClosestPoint;
+			nfDouble dDistance;
+			pBVH->findClosest(vPoint, nIndex, vClosestPoint, dDistance);
+			dSum += dDistance;
+		}
+		Lib3MFBenchmark::doNotOptimize(dSum);
+	});
+
+	// rays from random points towards the center
+	context.measure("raycast", nQueryCount, [&]() {
+		nfUint32 nHits = 0;
+		for (const NVEC3 & vPoint : Points) {
+			nfUint32 nIndex;
+			nfDouble dDistance;
+			nHits += pBVH->rayCast(vPoint, fnVEC3_scale(vPoint, -1.0f), 1.0, nIndex, dDistance);
+		}
+		Lib3MFBenchmark::doNotOptimize(nHits);
+	});
+
+	const nfUint32 nBruteForceCount = 50;
+	context.measure("raycast/bruteforce", nBruteForceCount, [&]() {
+		nfUint32 nHits = 0;
+		for (nfUint32 nQuery = 0; nQuery < nBruteForceCount; nQuery++) {
+			nfDouble dDistance;
+			nHits += rayCastBruteForce(pMesh.get(), Points[nQuery], fnVEC3_scale(Points[nQuery], -1.0f), dDistance) && (dDistance <= 1.0);
+		}
+		Lib3MFBenchmark::doNotOptimize(nHits);
+	});
+
+	context.measure("inbox", nQueryCount, [&]() {
+		std::vector<nfUint32> Indices;
+		for (const NVEC3 & vPoint : Points) {
+			NOUTBOX3 oBox;
+			oBox.m_min = fnVEC3_make(vPoint.m_fields[0] - 2.0f, vPoint.m_fields[1] - 2.0f, vPoint.m_fields[2] - 2.0f);
+			oBox.m_max = fnVEC3_make(vPoint.m_fields[0] + 2.0f, vPoint.m_fields[1] + 2.0f, vPoint.m_fields[2] + 2.0f);
+			Indices.clear();
+			pBVH->findInBox(oBox, Indices);
+		}
+		Lib3MFBenchmark::doNotOptimize(Indices.size());
+	});
+}
+
+LIB3MF_BENCHMARK(SpatialIndex, Beams)
+{
+	const nfUint32 nGridSize = 40;
+	PMesh pMesh = createLattice(nGridSize);
+	nfUint32 nBeamCount = pMesh->getBeamCount();
+
+	context.measure("build/1thread", nBeamCount, [&]() {
+		CMeshBVH bvh(pMesh.get(), eMeshBVHPrimitive::Beams, 1);
+		Lib3MFBenchmark::doNotOptimize(bvh.getNodeCount());
+	});
+	context.measure("build/hardwarethreads", nBeamCount, [&]() {
+		CMeshBVH bvh(pMesh.get(), eMeshBVHPrimitive::Beams, fnGetHardwareThreadCount());
+		Lib3MFBenchmark::doNotOptimize(bvh.getNodeCount());
+	});
+
+	CMeshBVH * pBVH = pMesh->getBeamBVH();
+	context.report("memory", (double)pBVH->getMemoryUsage() / nBeamCount, "bytes/beam");
+
+	const nfUint32 nQueryCount = 20000;
+	nfFloat fExtent = (nGridSize - 1) * 2.0f;
+	std::vector<NVEC3> Points = createPoints(nQueryCount, -2.0f, fExtent + 2.0f);
+	context.measure("closest", nQueryCount, [&]() {
+		nfDouble dSum = 0.0;
+		for (const NVEC3 & vPoint : Points) {
+			nfUint32 nIndex;
+			NVEC3 vClosestPoint;
+			nfDouble dDistance;
+			pBVH->findClosest(vPoint, nIndex, vClosestPoint, dDistance);
+			dSum += dDistance;
+		}
+		Lib3MFBenchmark::doNotOptimize(dSum);
+	});
+
+	context.measure("raycast", nQueryCount, [&]() {
+		nfUint32 nHits = 0;
+		NVEC3 vDirection = fnVEC3_make(0.31f, 0.17f, 1.0f);
+		for (const NVEC3 & vPoint : Points) {
+			nfUint32 nIndex;
+			nfDouble dDistance;
+			nHits += pBVH->rayCast(vPoint, vDirection, 1000.0, nIndex, dDistance);
+		}
+		Lib3MFBenchmark::doNotOptimize(nHits);
+	});
+
+	context.measure("inbox", nQueryCount, [&]() {
+		std::vector<nfUint32> Indices;
+		for (const NVEC3 & vPoint : Points) {
+			NOUTBOX3 oBox;
+			oBox.m_min = fnVEC3_make(vPoint.m_fields[0] - 1.0f, vPoint.m_fields[1] - 1.0f, vPoint.m_fields[2] - 1.0f);
+			oBox.m_max = fnVEC3_make(vPoint.m_fields[0] + 1.0f, vPoint.m_fields[1] + 1.0f, vPoint.m_fields[2] + 1.0f);
+			Indices.clear();
+			pBVH->findInBox(oBox, Indices);
+		}
+		Lib3MFBenchmark::doNotOptimize(Indices.size());
+	});
+
+	// reference box query, testing the bounding box of every beam
+	const nfUint32 nBruteForceCount = 200;
+	const nfInt32 * pNodeIndices = pMesh->getBeamStore().getNodeIndices();
+	std::vector<nfDouble> Radii((size_t)nBeamCount * 2);
+	pMesh->getBeamStore().getRadii(0, nBeamCount, Radii.data());
+	context.measure("inbox/bruteforce", nBruteForceCount, [&]() {
+		std::vector<nfUint32> Indices;
+		for (nfUint32 nQuery = 0; nQuery < nBruteForceCount; nQuery++) {
+			const NVEC3 & vPoint = Points[nQuery];
+			Indices.clear();
+			for (nfUint32 nBeam = 0; nBeam < nBeamCount; nBeam++) {
+				nfBool bOverlaps = true;
+				for (nfUint32 j = 0; j < 3; j++) {
+					nfFloat fPosition1 = pMesh->getNode(pNodeIndices[nBeam * 2])->m_position.m_fields[j];
+					nfFloat fPosition2 = pMesh->getNode(pNodeIndices[nBeam * 2 + 1])->m_position.m_fields[j];
+					nfDouble dMin = std::min(fPosition1 - Radii[nBeam * 2], fPosition2 - Radii[nBeam * 2 + 1]);
+					nfDouble dMax = std::max(fPosition1 + Radii[nBeam * 2], fPosition2 + Radii[nBeam * 2 + 1]);
+					if ((dMin > vPoint.m_fields[j] + 1.0f) || (dMax < vPoint.m_fields[j] - 1.0f))
+						bOverlaps = false;
+				}
+				if (bOverlaps)
+					Indices.push_back(nBeam);
+			}
+		}
+		Lib3MFBenchmark::doNotOptimize(Indices.size());
+	});
+}
@@ -0,0 +1,80 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+UUIDs.cpp: Measures the creation of random UUIDs, single, in bulk and from
+several threads at once, and their uniqueness registration in a model
+
+--*/
+
+#include "Benchmark_Utilities.h"
+
+#include "Common/NMR_UUID.h"
+#include "Common/NMR_ParallelFor.h"
+#include "Model/Classes/NMR_Model.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NMR;
+
+LIB3MF_BENCHMARK(UUIDs, Generate)
+{
+	const nfUint32 nCount = 200000;
+
+	context.measure("single", nCount, [&]() {
+		for (nfUint32 nIndex = 0; nIndex < nCount; nIndex++)
+			Lib3MFBenchmark::doNotOptimize(CUUID().key().m_nLow);
+	});
+
+	std::vector<PUUID> UUIDs;
+	context.measure("bulk", nCount, [&]() {
+		CUUID::generate(nCount, UUIDs);
+	});
+
+	nfUint32 nThreadCount = fnGetHardwareThreadCount();
+	context.measure("threads/" + std::to_string(nThreadCount) + "t", nCount, [&]() {
+		fnParallelFor(nThreadCount, nThreadCount, [&](nfUint64 nThread) {
+			for (nfUint32 nIndex = 0; nIndex < nCount / nThreadCount; nIndex++)
+				Lib3MFBenchmark::doNotOptimize(CUUID().key().m_nLow);
+		});
+	});
+}
+
+LIB3MF_BENCHMARK(UUIDs, Register)
+{
+	const nfUint32 nCount = 200000;
+	std::vector<PUUID> UUIDs;
+	CUUID::generate(nCount, UUIDs);
+
+	context.measure("register", nCount, [&]() {
+		PModel pModel = std::make_shared<CModel>();
+		for (auto & pUUID : UUIDs)
+			pModel->registerUUID(pUUID);
+	});
+}
@@ -33,6 +33,9 @@ UnitTest_BeamLattice.cpp: Defines Unittests for the BeamLattice class
 #include "UnitTest_Utilities.h"
 #include "lib3mf_implicit.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace Lib3MF
 {
 	class BeamLattice : public ::testing::Test {
@@ -476,6 +479,276 @@ namespace Lib3MF
 		}
 	}
 
+	TEST_F(BeamLattice, GeometryBulkMixedRadiiAndCapModes)
+	{
+		const int nBeamCount = 50;
+		sPosition p;
+		for (int i = 0; i < nBeamCount; i++) {
+			p.m_Coordinates[0] = (float)i;
+			p.m_Coordinates[1] = 2.0f;
+			p.m_Coordinates[2] = 0.0f;
+			mesh->AddVertex(p);
+		}
+
+		// Start with equal radii and cap modes, then make single beams deviate
+		std::vector<sBeam> beams(nBeamCount);
+		for (int i = 0; i < nBeamCount; i++) {
+			beams[i].m_Indices[0] = i;
+			beams[i].m_Indices[1] = i + 3;
+			beams[i].m_Radii[0] = 0.25;
+			beams[i].m_Radii[1] = 0.25;
+			beams[i].m_CapModes[0] = eBeamLatticeCapMode::Sphere;
+			beams[i].m_CapModes[1] = eBeamLatticeCapMode::Sphere;
+		}
+		beamLattice->SetBeams(beams);
+
+		beams[7].m_Radii[1] = 0.5;
+		beams[20].m_CapModes[0] = eBeamLatticeCapMode::Butt;
+		beams[21].m_CapModes[0] = eBeamLatticeCapMode::Butt;
+		beams[22].m_CapModes[1] = eBeamLatticeCapMode::HemiSphere;
+		beams[nBeamCount - 1].m_CapModes[1] = eBeamLatticeCapMode::HemiSphere;
+		for (int i : { 7, 20, 21, 22, nBeamCount - 1 })
+			beamLattice->SetBeam(i, beams[i]);
+		// a radius that single precision cannot hold
+		beams[30].m_Radii[0] = 0.1;
+		beamLattice->SetBeam(30, beams[30]);
+		// merge a cap mode run again
+		beams[21].m_CapModes[0] = eBeamLatticeCapMode::Sphere;
+		beamLattice->SetBeam(21, beams[21]);
+
+		std::vector<sBeam> outBeams;
+		beamLattice->GetBeams(outBeams);
+		ASSERT_EQ(outBeams.size(), beams.size());
+		for (int i = 0; i < nBeamCount; i++) {
+			sBeam beam = beamLattice->GetBeam(i);
+			for (int j = 0; j < 2; j++) {
+				ASSERT_EQ(outBeams[i].m_Indices[j], beams[i].m_Indices[j]);
+				ASSERT_EQ(outBeams[i].m_Radii[j], beams[i].m_Radii[j]);
+				ASSERT_EQ(outBeams[i].m_CapModes[j], beams[i].m_CapModes[j]);
+				ASSERT_EQ(beam.m_Radii[j], beams[i].m_Radii[j]);
+				ASSERT_EQ(beam.m_CapModes[j], beams[i].m_CapModes[j]);
+			}
+		}
+
+		// An invalid beam must not replace the existing beams
+		std::vector<sBeam> invalidBeams(beams);
+		invalidBeams[10].m_Radii[0] = -1.0;
+		ASSERT_SPECIFIC_THROW(beamLattice->SetBeams(invalidBeams), ELib3MFException);
+		ASSERT_EQ(beamLattice->GetBeamCount(), (Lib3MF_uint32)nBeamCount);
+
+		auto writer = model->QueryWriter("3mf");
+		std::vector<Lib3MF_uint8> buffer;
+		writer->WriteToBuffer(buffer);
+
+		auto readModel = wrapper->CreateModel();
+		auto reader = readModel->QueryReader("3mf");
+		reader->SetStrictModeActive(true);
+		reader->ReadFromBuffer(buffer);
+
+		std::vector<sBeam> readBeams;
+		auto meshObjects = readModel->GetMeshObjects();
+		while (meshObjects->MoveNext()) {
+			auto readBeamLattice = meshObjects->GetCurrentMeshObject()->BeamLattice();
+			if (readBeamLattice->GetBeamCount() > 0)
+				readBeamLattice->GetBeams(readBeams);
+		}
+		ASSERT_EQ(readBeams.size(), beams.size());
+		for (int i = 0; i < nBeamCount; i++) {
+			for (int j = 0; j < 2; j++) {
+				ASSERT_EQ(readBeams[i].m_Indices[j], beams[i].m_Indices[j]);
+				ASSERT_NEAR(readBeams[i].m_Radii[j], beams[i].m_Radii[j], 1e-6);
+				ASSERT_EQ(readBeams[i].m_CapModes[j], beams[i].m_CapModes[j]);
+			}
+		}
+	}
+
+	TEST_F(BeamLattice, BeamOptions)
+	{
+		Lib3MF_double dRadius;
+		eBeamLatticeCapMode eCapMode;
+		beamLattice->GetBeamOptions(dRadius, eCapMode);
+		ASSERT_DOUBLE_EQ(dRadius, 1.0);
+		ASSERT_EQ(eCapMode, eBeamLatticeCapMode::Sphere);
+
+		beamLattice->SetBeamOptions(2.5, eBeamLatticeCapMode::Butt);
+		beamLattice->GetBeamOptions(dRadius, eCapMode);
+		ASSERT_DOUBLE_EQ(dRadius, 2.5);
+		ASSERT_EQ(eCapMode, eBeamLatticeCapMode::Butt);
+
+		ASSERT_SPECIFIC_THROW(beamLattice->SetBeamOptions(0.0, eBeamLatticeCapMode::Sphere), ELib3MFException);
+	}
+
+	TEST_F(BeamLattice, BeamOptionsWriteRead)
+	{
+		sPosition p;
+		for (int i = 0; i < 11; i++) {
+			p.m_Coordinates[0] = (float)i;
+			p.m_Coordinates[1] = 2.0f;
+			p.m_Coordinates[2] = 0.0f;
+			mesh->AddVertex(p);
+		}
+
+		auto writeAndReadBeamOptions = [&](const std::vector<double> & radii, Lib3MF_double & dRadius, eBeamLatticeCapMode & eCapMode) {
+			std::vector<sBeam> beams(radii.size());
+			const eBeamLatticeCapMode CapModes[3] = { eBeamLatticeCapMode::Sphere, eBeamLatticeCapMode::HemiSphere, eBeamLatticeCapMode::Butt };
+			for (size_t i = 0; i < radii.size(); i++) {
+				beams[i].m_Indices[0] = (Lib3MF_uint32)i;
+				beams[i].m_Indices[1] = (Lib3MF_uint32)i + 3;
+				beams[i].m_Radii[0] = radii[i];
+				beams[i].m_Radii[1] = radii[i];
+				beams[i].m_CapModes[0] = CapModes[i % 3];
+				beams[i].m_CapModes[1] = CapModes[i % 3];
+			}
+			beamLattice->SetBeams(beams);
+
+			auto writer = model->QueryWriter("3mf");
+			std::vector<Lib3MF_uint8> buffer;
+			writer->WriteToBuffer(buffer);
+
+			auto readModel = wrapper->CreateModel();
+			auto reader = readModel->QueryReader("3mf");
+			reader->SetStrictModeActive(true);
+			reader->ReadFromBuffer(buffer);
+
+			std::vector<sBeam> readBeams;
+			auto meshObjects = readModel->GetMeshObjects();
+			while (meshObjects->MoveNext()) {
+				auto readBeamLattice = meshObjects->GetCurrentMeshObject()->BeamLattice();
+				if (readBeamLattice->GetBeamCount() > 0) {
+					readBeamLattice->GetBeams(readBeams);
+					readBeamLattice->GetBeamOptions(dRadius, eCapMode);
+				}
+			}
+			ASSERT_EQ(readBeams.size(), beams.size());
+			for (size_t i = 0; i < beams.size(); i++) {
+				for (int j = 0; j < 2; j++) {
+					ASSERT_DOUBLE_EQ(readBeams[i].m_Radii[j], beams[i].m_Radii[j]);
+					ASSERT_EQ(readBeams[i].m_CapModes[j], beams[i].m_CapModes[j]);
+				}
+			}
+		};
+
+		Lib3MF_double dRadius;
+		eBeamLatticeCapMode eCapMode;
+		beamLattice->SetBeamOptions(2.0, eBeamLatticeCapMode::HemiSphere);
+
+		// No radius and no cap mode is used more often than the configured ones, so they are kept
+		writeAndReadBeamOptions({ 1.0, 2.0, 3.0, 1.0, 2.0, 3.0, 1.0, 2.0, 3.0 }, dRadius, eCapMode);
+		ASSERT_DOUBLE_EQ(dRadius, 2.0);
+		ASSERT_EQ(eCapMode, eBeamLatticeCapMode::HemiSphere);
+
+		// A radius that most beams share, but not a majority of them, replaces the configured one.
+		// Sphere caps are used as often as the configured hemisphere caps, so these are kept.
+		writeAndReadBeamOptions({ 1.0, 1.0, 1.0, 1.0, 2.0, 3.0, 2.0, 3.0, 2.0, 3.0, 4.0 }, dRadius, eCapMode);
+		ASSERT_DOUBLE_EQ(dRadius, 1.0);
+		ASSERT_EQ(eCapMode, eBeamLatticeCapMode::HemiSphere);
+	}
+
+	TEST_F(BeamLattice, SpatialQueries)
+	{
+		sBeam beam;
+		beam.m_CapModes[0] = eBeamLatticeCapMode::Sphere;
+		beam.m_CapModes[1] = eBeamLatticeCapMode::Sphere;
+		beam.m_Radii[0] = 0.1;
+		beam.m_Radii[1] = 0.1;
+		beam.m_Indices[0] = 0;
+		beam.m_Indices[1] = 1;
+		beamLattice->AddBeam(beam);
+		beam.m_Indices[0] = 1;
+		beam.m_Indices[1] = 2;
+		beamLattice->AddBeam(beam);
+
+		sBox box;
+		box.m_MinCoordinate[0] = -1.0f; box.m_MinCoordinate[1] = 0.2f; box.m_MinCoordinate[2] = -1.0f;
+		box.m_MaxCoordinate[0] = 1.0f; box.m_MaxCoordinate[1] = 0.5f; box.m_MaxCoordinate[2] = 1.0f;
+		std::vector<Lib3MF_uint32> beams;
+		beamLattice->GetBeamsInBox(box, beams);
+		ASSERT_EQ(beams, std::vector<Lib3MF_uint32>({ 0 }));
+		box.m_MinCoordinate[1] = 0.95f;
+		box.m_MaxCoordinate[1] = 1.0f;
+		beamLattice->GetBeamsInBox(box, beams);
+		std::sort(beams.begin(), beams.end());
+		ASSERT_EQ(beams, std::vector<Lib3MF_uint32>({ 0, 1 }));
+
+		Lib3MF_uint32 nBeam;
+		sPosition closestPoint;
+		double dDistance;
+		ASSERT_TRUE(beamLattice->FindClosestBeam(fnCreateVertex(1.0f, 0.5f, 0.0f), nBeam, closestPoint, dDistance));
+		ASSERT_EQ(nBeam, 0);
+		ASSERT_NEAR(dDistance, 0.9, 1e-6);
+		ASSERT_NEAR(closestPoint.m_Coordinates[0], 0.1f, 1e-6);
+		ASSERT_NEAR(closestPoint.m_Coordinates[1], 0.5f, 1e-6);
+		ASSERT_NEAR(closestPoint.m_Coordinates[2], 0.0f, 1e-6);
+
+		// points inside a beam are their own closest point
+		ASSERT_TRUE(beamLattice->FindClosestBeam(fnCreateVertex(0.0f, 0.5f, 0.05f), nBeam, closestPoint, dDistance));
+		ASSERT_EQ(nBeam, 0);
+		ASSERT_EQ(dDistance, 0.0);
+		ASSERT_EQ(closestPoint.m_Coordinates[2], 0.05f);
+
+		ASSERT_TRUE(beamLattice->RayCastBeams(fnCreateVertex(-1.0f, 0.5f, 0.0f), fnCreateVertex(1.0f, 0.0f, 0.0f), 10.0, nBeam, dDistance));
+		ASSERT_EQ(nBeam, 0);
+		ASSERT_NEAR(dDistance, 0.9, 1e-6);
+		ASSERT_TRUE(beamLattice->RayCastBeams(fnCreateVertex(0.0f, 1.0f, 3.0f), fnCreateVertex(0.0f, 0.0f, -1.0f), 10.0, nBeam, dDistance));
+		ASSERT_EQ(nBeam, 1);
+		ASSERT_NEAR(dDistance, 1.9, 1e-6);
+		ASSERT_FALSE(beamLattice->RayCastBeams(fnCreateVertex(-1.0f, 0.5f, 0.0f), fnCreateVertex(-1.0f, 0.0f, 0.0f), 10.0, nBeam, dDistance));
+
+		// beams with different radii are rounded cones
+		beam.m_Indices[0] = 0;
+		beam.m_Indices[1] = 1;
+		beam.m_Radii[0] = 0.3;
+		beam.m_Radii[1] = 0.1;
+		beamLattice->SetBeam(0, beam);
+		ASSERT_TRUE(beamLattice->FindClosestBeam(fnCreateVertex(1.0f, 0.5f, 0.0f), nBeam, closestPoint, dDistance));
+		ASSERT_EQ(nBeam, 0);
+		ASSERT_NEAR(dDistance, sqrt(0.96) - 0.2, 1e-6);
+		ASSERT_TRUE(beamLattice->FindClosestBeam(fnCreateVertex(1.0f, 0.0f, 0.0f), nBeam, closestPoint, dDistance));
+		ASSERT_NEAR(dDistance, 0.7, 1e-6);
+
+		beamLattice->SetBeams(std::vector<sBeam>());
+		ASSERT_FALSE(beamLattice->FindClosestBeam(fnCreateVertex(1.0f, 0.0f, 0.0f), nBeam, closestPoint, dDistance));
+	}
+
+	TEST_F(BeamLattice, BeamsInsideClippingMesh)
+	{
+		sBeam beam;
+		beam.m_CapModes[0] = eBeamLatticeCapMode::Sphere;
+		beam.m_CapModes[1] = eBeamLatticeCapMode::Sphere;
+		beam.m_Radii[0] = 0.1;
+		beam.m_Radii[1] = 0.1;
+		beam.m_Indices[0] = 0;
+		beam.m_Indices[1] = 1;
+		beamLattice->AddBeam(beam);
+		beam.m_Indices[0] = 1;
+		beam.m_Indices[1] = 2;
+		beamLattice->AddBeam(beam);
+
+		std::vector<Lib3MF_uint32> beams;
+		try {
+			beamLattice->GetBeamsInsideClippingMesh(beams);
+			ASSERT_FALSE(true);
+		}
+		catch (ELib3MFException& e) {
+			ASSERT_EQ(e.getErrorCode(), LIB3MF_ERROR_INVALIDPARAM);
+		}
+
+		// a box around the first beam, the third node is outside
+		std::vector<sPosition> vertices;
+		std::vector<sTriangle> triangles;
+		fnCreateBox(vertices, triangles);
+		for (auto & vertex : vertices) {
+			vertex.m_Coordinates[0] = vertex.m_Coordinates[0] / 100.0f - 0.5f;
+			vertex.m_Coordinates[1] = vertex.m_Coordinates[1] / 50.0f - 0.5f;
+			vertex.m_Coordinates[2] = vertex.m_Coordinates[2] / 100.0f - 0.5f;
+		}
+		otherMesh->SetGeometry(vertices, triangles);
+		beamLattice->SetClipping(eBeamLatticeClipMode::Inside, otherMesh->GetResourceID());
+
+		beamLattice->GetBeamsInsideClippingMesh(beams);
+		ASSERT_EQ(beams, std::vector<Lib3MF_uint32>({ 0 }));
+	}
+
 	TEST_F(BeamLattice, BeamSet)
 	{
 		auto beamSet = beamLattice->AddBeamSet();
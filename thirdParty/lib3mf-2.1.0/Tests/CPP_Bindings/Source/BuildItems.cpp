@@ -33,6 +33,9 @@ UnitTest_BuildItems.cpp: Defines Unittests for the BuildItems class
 #include "UnitTest_Utilities.h"
 #include "lib3mf_implicit.hpp"
 
+#include <algorithm>
+#include <set>
+
 namespace Lib3MF
 {
 	class BuildItems : public ::testing::Test {
@@ -108,6 +111,34 @@ namespace Lib3MF
 		}
 	}
 
+	TEST_F(BuildItems, TestGeneratedUUIDs)
+	{
+		auto buildItems = BuildItems::model->GetBuildItems();
+		ASSERT_TRUE(buildItems->MoveNext());
+		auto object = buildItems->GetCurrent()->GetObjectResource();
+
+		std::set<std::string> uuids;
+		const Lib3MF_uint32 nItemCount = 1000;
+		for (Lib3MF_uint32 i = 0; i < nItemCount; i++) {
+			auto buildItem = model->AddBuildItem(object.get(), wrapper->GetIdentityTransform());
+			bool bHasUUID = false;
+			std::string uuid = buildItem->GetUUID(bHasUUID);
+			ASSERT_TRUE(bHasUUID);
+			// version 4, variant 10xx
+			ASSERT_EQ(uuid.length(), 36);
+			ASSERT_EQ(uuid[14], '4');
+			ASSERT_NE(std::string("89ab").find(uuid[19]), std::string::npos);
+			uuids.insert(uuid);
+		}
+		ASSERT_EQ(uuids.size(), nItemCount);
+
+		// Uniqueness is checked on the value, independent of its spelling
+		std::string uuid = *uuids.begin();
+		std::transform(uuid.begin(), uuid.end(), uuid.begin(), ::toupper);
+		auto buildItem = model->AddBuildItem(object.get(), wrapper->GetIdentityTransform());
+		ASSERT_SPECIFIC_THROW(buildItem->SetUUID(uuid), ELib3MFException);
+	}
+
 	TEST_F(BuildItems, TestTransformations)
 	{
 		auto buildItems = BuildItems::model->GetBuildItems();
@@ -101,4 +101,101 @@ namespace Lib3MF
 		ASSERT_EQ(wrapper->RGBAToColor(5, 15, 25, 35).m_Red, colorGroup->GetColor(propertyIDs[1]).m_Red);
 	}
 
+	TEST_F(ColorGroup, AddGetColors)
+	{
+		std::vector<sColor> colors;
+		for (Lib3MF_uint8 i = 0; i < 200; i++) {
+			colors.push_back(wrapper->RGBAToColor(i, 255 - i, i / 2, 255));
+		}
+		colorGroup->AddColor(wrapper->RGBAToColor(1, 2, 3, 4));
+		Lib3MF_uint32 nFirstPropertyID = colorGroup->AddColors(colors);
+		ASSERT_EQ(colorGroup->GetCount(), colors.size() + 1);
+
+		std::vector<Lib3MF_uint32> propertyIDs;
+		colorGroup->GetAllPropertyIDs(propertyIDs);
+		ASSERT_EQ(propertyIDs[1], nFirstPropertyID);
+		for (size_t i = 0; i < colors.size(); i++) {
+			ASSERT_EQ(propertyIDs[i + 1], nFirstPropertyID + i);
+			ASSERT_EQ(colorGroup->GetColor(nFirstPropertyID + Lib3MF_uint32(i)).m_Green, colors[i].m_Green);
+		}
+
+		colorGroup->RemoveColor(nFirstPropertyID);
+		std::vector<sColor> obtainedColors;
+		colorGroup->GetColors(obtainedColors);
+		ASSERT_EQ(obtainedColors.size(), colors.size());
+		ASSERT_EQ(obtainedColors[0].m_Red, 1);
+		for (size_t i = 1; i < colors.size(); i++) {
+			ASSERT_EQ(obtainedColors[i].m_Red, colors[i].m_Red);
+			ASSERT_EQ(obtainedColors[i].m_Green, colors[i].m_Green);
+			ASSERT_EQ(obtainedColors[i].m_Blue, colors[i].m_Blue);
+			ASSERT_EQ(obtainedColors[i].m_Alpha, colors[i].m_Alpha);
+		}
+	}
+
+	TEST_F(ColorGroup, RemoveColorsKeepsPropertyIDs)
+	{
+		std::vector<sColor> colors(1000, wrapper->RGBAToColor(0, 0, 0, 255));
+		for (size_t i = 0; i < colors.size(); i++) {
+			colors[i].m_Red = Lib3MF_uint8(i % 256);
+		}
+		Lib3MF_uint32 nFirstPropertyID = colorGroup->AddColors(colors);
+		for (Lib3MF_uint32 i = 0; i < 990; i++) {
+			colorGroup->RemoveColor(nFirstPropertyID + i);
+		}
+		ASSERT_EQ(colorGroup->GetCount(), 10);
+		ASSERT_SPECIFIC_THROW(colorGroup->GetColor(nFirstPropertyID), ELib3MFException);
+
+		Lib3MF_uint32 nNewPropertyID = colorGroup->AddColor(wrapper->RGBAToColor(1, 2, 3, 4));
+		ASSERT_EQ(nNewPropertyID, nFirstPropertyID + 1000);
+
+		std::vector<Lib3MF_uint32> propertyIDs;
+		colorGroup->GetAllPropertyIDs(propertyIDs);
+		ASSERT_EQ(propertyIDs.size(), 11);
+		for (Lib3MF_uint32 i = 0; i < 10; i++) {
+			ASSERT_EQ(propertyIDs[i], nFirstPropertyID + 990 + i);
+			ASSERT_EQ(colorGroup->GetColor(propertyIDs[i]).m_Red, colors[990 + i].m_Red);
+		}
+		ASSERT_EQ(propertyIDs[10], nNewPropertyID);
+	}
+
+	TEST_F(ColorGroup, AddColorsDeduplicated)
+	{
+		std::vector<sColor> palette = {
+			wrapper->RGBAToColor(255, 0, 0, 255),
+			wrapper->RGBAToColor(0, 255, 0, 255),
+			wrapper->RGBAToColor(0, 0, 255, 255),
+			wrapper->RGBAToColor(0, 0, 255, 128)
+		};
+		Lib3MF_uint32 nExistingPropertyID = colorGroup->AddColor(palette[1]);
+
+		std::vector<sColor> colors;
+		for (size_t i = 0; i < 3000; i++) {
+			colors.push_back(palette[(i * 7) % palette.size()]);
+		}
+
+		std::vector<Lib3MF_uint32> propertyIDs;
+		colorGroup->AddColorsDeduplicated(colors, propertyIDs);
+		ASSERT_EQ(propertyIDs.size(), colors.size());
+		ASSERT_EQ(colorGroup->GetCount(), palette.size());
+
+		for (size_t i = 0; i < colors.size(); i++) {
+			sColor color = colorGroup->GetColor(propertyIDs[i]);
+			ASSERT_EQ(color.m_Red, colors[i].m_Red);
+			ASSERT_EQ(color.m_Green, colors[i].m_Green);
+			ASSERT_EQ(color.m_Blue, colors[i].m_Blue);
+			ASSERT_EQ(color.m_Alpha, colors[i].m_Alpha);
+			if (colors[i].m_Green == 255) {
+				ASSERT_EQ(propertyIDs[i], nExistingPropertyID);
+			}
+		}
+
+		// colors changed after deduplication are no longer matched
+		colorGroup->SetColor(nExistingPropertyID, wrapper->RGBAToColor(1, 2, 3, 4));
+		std::vector<Lib3MF_uint32> newPropertyIDs;
+		colorGroup->AddColorsDeduplicated(CInputVector<sColor>(&palette[1], 1), newPropertyIDs);
+		ASSERT_EQ(newPropertyIDs.size(), 1);
+		ASSERT_NE(newPropertyIDs[0], nExistingPropertyID);
+		ASSERT_EQ(colorGroup->GetCount(), palette.size() + 1);
+	}
+
 }
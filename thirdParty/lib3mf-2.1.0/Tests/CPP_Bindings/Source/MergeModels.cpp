@@ -88,4 +88,68 @@ namespace Lib3MF
 		ExpectEqModels(m_pModel, pReadModel);
 	}
 
+	TEST_F(MergeModels, MergeInstancedComponents)
+	{
+		auto pModel = wrapper->CreateModel();
+		auto pColorGroup = pModel->AddColorGroup();
+		Lib3MF_uint32 nRed = pColorGroup->AddColor(wrapper->RGBAToColor(255, 0, 0, 255));
+
+		std::vector<sPosition> vertices = { { { 0.0f, 0.0f, 0.0f } }, { { 1.0f, 0.0f, 0.0f } }, { { 0.0f, 1.0f, 0.0f } }, { { 0.0f, 0.0f, 1.0f } } };
+		std::vector<sTriangle> triangles = { { { 2, 1, 0 } }, { { 0, 1, 3 } }, { { 1, 2, 3 } }, { { 2, 0, 3 } } };
+		auto pColored = pModel->AddMeshObject();
+		pColored->SetGeometry(vertices, triangles);
+		sTriangleProperties properties;
+		properties.m_ResourceID = pColorGroup->GetResourceID();
+		properties.m_PropertyIDs[0] = properties.m_PropertyIDs[1] = properties.m_PropertyIDs[2] = nRed;
+		pColored->SetAllTriangleProperties(std::vector<sTriangleProperties>(triangles.size(), properties));
+		pColored->SetObjectLevelProperty(pColorGroup->GetResourceID(), nRed);
+		auto pPlain = pModel->AddMeshObject();
+		pPlain->SetGeometry(vertices, triangles);
+
+		const Lib3MF_uint32 nInstanceCount = 500;
+		auto pPlate = pModel->AddComponentsObject();
+		for (Lib3MF_uint32 nIndex = 0; nIndex < nInstanceCount; nIndex++) {
+			CObject * pObject = (nIndex % 2 == 0) ? (CObject *)pColored.get() : (CObject *)pPlain.get();
+			pPlate->AddComponent(pObject, wrapper->GetTranslationTransform(2.0f * nIndex, 0.0f, 0.0f));
+		}
+		pModel->AddBuildItem(pPlate.get(), wrapper->GetTranslationTransform(0.0f, 0.0f, 5.0f));
+
+		auto pMergedModel = pModel->MergeToModel();
+		auto pMergedColorGroups = pMergedModel->GetColorGroups();
+		ASSERT_TRUE(pMergedColorGroups->MoveNext());
+		auto pMergedColorGroup = pMergedColorGroups->GetCurrentColorGroup();
+		auto pMeshObjects = pMergedModel->GetMeshObjects();
+		ASSERT_EQ(pMeshObjects->Count(), 1);
+		ASSERT_TRUE(pMeshObjects->MoveNext());
+		auto pMerged = pMeshObjects->GetCurrentMeshObject();
+		ASSERT_EQ(pMerged->GetVertexCount(), nInstanceCount * vertices.size());
+		ASSERT_EQ(pMerged->GetTriangleCount(), nInstanceCount * triangles.size());
+
+		std::vector<sPosition> mergedVertices;
+		std::vector<sTriangle> mergedTriangles;
+		std::vector<sTriangleProperties> mergedProperties;
+		pMerged->GetVertices(mergedVertices);
+		pMerged->GetTriangleIndices(mergedTriangles);
+		pMerged->GetAllTriangleProperties(mergedProperties);
+		for (Lib3MF_uint32 nIndex = 0; nIndex < nInstanceCount; nIndex++) {
+			for (size_t nVertex = 0; nVertex < vertices.size(); nVertex++) {
+				const sPosition & position = mergedVertices[nIndex * vertices.size() + nVertex];
+				EXPECT_FLOAT_EQ(position.m_Coordinates[0], vertices[nVertex].m_Coordinates[0] + 2.0f * nIndex);
+				EXPECT_FLOAT_EQ(position.m_Coordinates[1], vertices[nVertex].m_Coordinates[1]);
+				EXPECT_FLOAT_EQ(position.m_Coordinates[2], vertices[nVertex].m_Coordinates[2] + 5.0f);
+			}
+			for (size_t nTriangle = 0; nTriangle < triangles.size(); nTriangle++) {
+				size_t nMergedTriangle = nIndex * triangles.size() + nTriangle;
+				for (int j = 0; j < 3; j++)
+					EXPECT_EQ(mergedTriangles[nMergedTriangle].m_Indices[j], triangles[nTriangle].m_Indices[j] + nIndex * vertices.size());
+				if (nIndex % 2 == 0) {
+					EXPECT_EQ(mergedProperties[nMergedTriangle].m_ResourceID, pMergedColorGroup->GetResourceID());
+					EXPECT_EQ(mergedProperties[nMergedTriangle].m_PropertyIDs[0], nRed);
+				}
+				else
+					EXPECT_EQ(mergedProperties[nMergedTriangle].m_ResourceID, 0);
+			}
+		}
+	}
+
 }
@@ -33,6 +33,10 @@ UnitTest_MeshObject.cpp: Defines Unittests for the mesh object class
 #include "UnitTest_Utilities.h"
 #include "lib3mf_implicit.hpp"
 
+#include <algorithm>
+#include <map>
+#include <set>
+
 namespace Lib3MF
 {
 	class MeshObject : public ::testing::Test {
@@ -191,6 +195,124 @@ namespace Lib3MF
 		
 	}
 
+	TEST_F(MeshObject, OptimizeLayout)
+	{
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+
+		// color each corner by its vertex, so the properties can be traced through the reordering
+		auto colorGroup = model->AddColorGroup();
+		std::map<Lib3MF_uint32, Lib3MF_uint32> vertexOfColor;
+		std::vector<Lib3MF_uint32> colorOfVertex(8);
+		for (Lib3MF_uint32 i = 0; i < 8; i++) {
+			colorOfVertex[i] = colorGroup->AddColor(wrapper->RGBAToColor(Lib3MF_uint8(i * 30), 0, 0, 255));
+			vertexOfColor[colorOfVertex[i]] = i;
+		}
+
+		std::vector<sTriangleProperties> properties(12);
+		for (Lib3MF_uint32 i = 0; i < 12; i++) {
+			properties[i].m_ResourceID = colorGroup->GetResourceID();
+			for (int j = 0; j < 3; j++)
+				properties[i].m_PropertyIDs[j] = colorOfVertex[pTriangles[i].m_Indices[j]];
+		}
+		mesh->SetAllTriangleProperties(properties);
+
+		mesh->OptimizeLayout(true, true, true);
+		ASSERT_EQ(mesh->GetVertexCount(), 8);
+		ASSERT_EQ(mesh->GetTriangleCount(), 12);
+		ASSERT_TRUE(mesh->IsManifoldAndOriented());
+
+		std::vector<sPosition> vctPositions;
+		std::vector<sTriangle> vctTriangles;
+		std::vector<sTriangleProperties> vctProperties;
+		mesh->GetVertices(vctPositions);
+		mesh->GetTriangleIndices(vctTriangles);
+		mesh->GetAllTriangleProperties(vctProperties);
+
+		std::set<std::vector<Lib3MF_uint32>> originalTriangles;
+		std::set<std::vector<Lib3MF_uint32>> optimizedTriangles;
+		for (Lib3MF_uint32 i = 0; i < 12; i++) {
+			std::vector<Lib3MF_uint32> originalCorners(3);
+			std::vector<Lib3MF_uint32> optimizedCorners(3);
+			for (int j = 0; j < 3; j++) {
+				originalCorners[j] = pTriangles[i].m_Indices[j];
+
+				// the corner's color must still belong to the vertex at its position
+				ASSERT_EQ(vctProperties[i].m_ResourceID, colorGroup->GetResourceID());
+				Lib3MF_uint32 nOriginalVertex = vertexOfColor[vctProperties[i].m_PropertyIDs[j]];
+				const sPosition & position = vctPositions[vctTriangles[i].m_Indices[j]];
+				for (int k = 0; k < 3; k++)
+					ASSERT_EQ(position.m_Coordinates[k], pVertices[nOriginalVertex].m_Coordinates[k]);
+				optimizedCorners[j] = nOriginalVertex;
+			}
+			std::rotate(originalCorners.begin(), std::min_element(originalCorners.begin(), originalCorners.end()), originalCorners.end());
+			std::rotate(optimizedCorners.begin(), std::min_element(optimizedCorners.begin(), optimizedCorners.end()), optimizedCorners.end());
+			originalTriangles.insert(originalCorners);
+			optimizedTriangles.insert(optimizedCorners);
+		}
+		ASSERT_TRUE(originalTriangles == optimizedTriangles);
+
+		// vertices are numbered in order of their first use
+		Lib3MF_uint32 nNextVertex = 0;
+		for (Lib3MF_uint32 i = 0; i < 12; i++) {
+			for (int j = 0; j < 3; j++) {
+				ASSERT_LE(vctTriangles[i].m_Indices[j], nNextVertex);
+				if (vctTriangles[i].m_Indices[j] == nNextVertex)
+					nNextVertex++;
+			}
+		}
+	}
+
+	TEST_F(MeshObject, SpatialQueries)
+	{
+		Lib3MF_uint32 nTriangle;
+		sPosition closestPoint;
+		double dDistance;
+		ASSERT_FALSE(mesh->FindClosestTriangle(fnCreateVertex(0.0f, 0.0f, 0.0f), nTriangle, closestPoint, dDistance));
+
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+
+		// only the top face overlaps a small box just above its center
+		sBox box;
+		box.m_MinCoordinate[0] = 10.0f; box.m_MinCoordinate[1] = 10.0f; box.m_MinCoordinate[2] = 299.0f;
+		box.m_MaxCoordinate[0] = 20.0f; box.m_MaxCoordinate[1] = 20.0f; box.m_MaxCoordinate[2] = 301.0f;
+		std::vector<Lib3MF_uint32> triangles;
+		mesh->GetTrianglesInBox(box, triangles);
+		std::sort(triangles.begin(), triangles.end());
+		ASSERT_EQ(triangles, std::vector<Lib3MF_uint32>({ 2, 3 }));
+
+		ASSERT_TRUE(mesh->FindClosestTriangle(fnCreateVertex(50.0f, 100.0f, -10.0f), nTriangle, closestPoint, dDistance));
+		ASSERT_TRUE(nTriangle <= 1);
+		ASSERT_NEAR(dDistance, 10.0, 1e-5);
+		ASSERT_NEAR(closestPoint.m_Coordinates[0], 50.0f, 1e-4);
+		ASSERT_NEAR(closestPoint.m_Coordinates[1], 100.0f, 1e-4);
+		ASSERT_NEAR(closestPoint.m_Coordinates[2], 0.0f, 1e-4);
+
+		// distances are measured in units of the direction
+		ASSERT_TRUE(mesh->RayCastTriangles(fnCreateVertex(50.0f, 100.0f, -10.0f), fnCreateVertex(0.0f, 0.0f, 2.0f), 100.0, nTriangle, dDistance));
+		ASSERT_TRUE(nTriangle <= 1);
+		ASSERT_NEAR(dDistance, 5.0, 1e-5);
+		ASSERT_FALSE(mesh->RayCastTriangles(fnCreateVertex(50.0f, 100.0f, -10.0f), fnCreateVertex(0.0f, 0.0f, 2.0f), 4.0, nTriangle, dDistance));
+		ASSERT_FALSE(mesh->RayCastTriangles(fnCreateVertex(50.0f, 100.0f, -10.0f), fnCreateVertex(0.0f, 0.0f, -1.0f), 100.0, nTriangle, dDistance));
+
+		try {
+			mesh->RayCastTriangles(fnCreateVertex(50.0f, 100.0f, -10.0f), fnCreateVertex(0.0f, 0.0f, 0.0f), 100.0, nTriangle, dDistance);
+			ASSERT_FALSE(true);
+		}
+		catch (ELib3MFException& e) {
+			ASSERT_EQ(e.getErrorCode(), LIB3MF_ERROR_INVALIDPARAM);
+		}
+
+		// moving vertices updates the index
+		for (Lib3MF_uint32 i = 4; i < 8; i++) {
+			sPosition position = pVertices[i];
+			position.m_Coordinates[2] = 400.0f;
+			mesh->SetVertex(i, position);
+		}
+		ASSERT_TRUE(mesh->RayCastTriangles(fnCreateVertex(50.0f, 100.0f, 350.0f), fnCreateVertex(0.0f, 0.0f, 1.0f), 100.0, nTriangle, dDistance));
+		ASSERT_TRUE((nTriangle == 2) || (nTriangle == 3));
+		ASSERT_NEAR(dDistance, 50.0, 1e-5);
+	}
+
 	TEST_F(MeshObject, IsManifoldAndOriented)
 	{
 		ASSERT_FALSE(mesh->IsManifoldAndOriented());
@@ -175,4 +175,18 @@ namespace Lib3MF
 		ASSERT_EQ(oldID, newId);
 	}
 
+	TEST_F(Model, GetResourcesByID)
+	{
+		std::vector<Lib3MF_uint32> uniqueIDs;
+		for (int i = 0; i < 1000; i++) {
+			auto colorGroup = m_pModel->AddColorGroup();
+			uniqueIDs.push_back(colorGroup->GetUniqueResourceID());
+		}
+		for (auto nID : uniqueIDs) {
+			auto colorGroup = m_pModel->GetColorGroupByID(nID);
+			ASSERT_EQ(colorGroup->GetUniqueResourceID(), nID);
+		}
+		ASSERT_SPECIFIC_THROW(m_pModel->GetColorGroupByID(uniqueIDs.back() + 1), ELib3MFException);
+	}
+
 }
@@ -33,6 +33,8 @@ UnitTest_Writer.cpp: Defines Unittests for the Writer classes
 #include "UnitTest_Utilities.h"
 #include "lib3mf_implicit.hpp"
 
+#include <algorithm>
+
 namespace Lib3MF
 {
 	class ProgressCallbackTest : public ::testing::Test {
@@ -115,5 +117,113 @@ namespace Lib3MF
 		}
 	}
 
+	struct sProgressRecorder {
+		std::vector<Lib3MF_double> m_Progress;
+		std::vector<eProgressIdentifier> m_Identifiers;
+		bool m_bCancel;
+	};
+
+	// Records all reports. Cancels on the second report of writing the objects, which follows the first one
+	// within the callback interval.
+	void Callback_Record(bool* pAbort, Lib3MF_double dProgress, eProgressIdentifier identifier, Lib3MF_pvoid pUserData)
+	{
+		sProgressRecorder* pRecorder = reinterpret_cast<sProgressRecorder*>(pUserData);
+		bool bWritingObjects = (identifier == eProgressIdentifier::WRITENOBJECTS) &&
+			(std::find(pRecorder->m_Identifiers.begin(), pRecorder->m_Identifiers.end(), identifier) != pRecorder->m_Identifiers.end());
+		pRecorder->m_Progress.push_back(dProgress);
+		pRecorder->m_Identifiers.push_back(identifier);
+		*pAbort = pRecorder->m_bCancel && bWritingObjects;
+	}
+
+	TEST_F(ProgressCallbackTest, WriteReportsDone)
+	{
+		sProgressRecorder recorder;
+		recorder.m_bCancel = false;
+		std::vector<Lib3MF_uint8> buffer;
+		writer3MF->SetProgressCallback(Callback_Record, &recorder);
+		writer3MF->WriteToBuffer(buffer);
+
+		// The write is faster than the callback interval, but the final report is never dropped
+		ASSERT_FALSE(recorder.m_Identifiers.empty());
+		EXPECT_EQ(recorder.m_Identifiers.back(), eProgressIdentifier::DONE);
+		EXPECT_DOUBLE_EQ(recorder.m_Progress.back(), 1.0);
+		for (size_t nReport = 1; nReport < recorder.m_Progress.size(); nReport++)
+			EXPECT_GE(recorder.m_Progress[nReport], recorder.m_Progress[nReport - 1]);
+	}
+
+	TEST_F(ProgressCallbackTest, WriteCancelled)
+	{
+		auto baseMesh = model->GetMeshObjects();
+		ASSERT_TRUE(baseMesh->MoveNext());
+		std::vector<sPosition> vertices;
+		std::vector<sTriangle> triangles;
+		baseMesh->GetCurrentMeshObject()->GetVertices(vertices);
+		baseMesh->GetCurrentMeshObject()->GetTriangleIndices(triangles);
+		for (int nMesh = 0; nMesh < 4; nMesh++)
+			model->AddMeshObject()->SetGeometry(vertices, triangles);
+
+		sProgressRecorder recorder;
+		recorder.m_bCancel = true;
+		std::vector<Lib3MF_uint8> buffer;
+		writer3MF->SetProgressCallback(Callback_Record, &recorder);
+		try {
+			writer3MF->WriteToBuffer(buffer);
+			FAIL() << "The write was not cancelled.";
+		}
+		catch (ELib3MFException& e) {
+			EXPECT_EQ(e.getErrorCode(), LIB3MF_ERROR_CALCULATIONABORTED) << e.what();
+		}
+
+		// The cancelling report is passed on when its phase ends, and the write stops before it is done
+		EXPECT_EQ(std::count(recorder.m_Identifiers.begin(), recorder.m_Identifiers.end(), eProgressIdentifier::WRITENOBJECTS), 2);
+		EXPECT_EQ(std::count(recorder.m_Identifiers.begin(), recorder.m_Identifiers.end(), eProgressIdentifier::DONE), 0);
+	}
+
+	TEST_F(ProgressCallbackTest, Statistics)
+	{
+		auto localModel = wrapper->CreateModel();
+		auto reader = localModel->QueryReader("3mf");
+		reader->ReadFromFile(InFolder + "Pyramid.3mf");
+
+		Lib3MF_uint64 nVertexCount = 0;
+		Lib3MF_uint64 nTriangleCount = 0;
+		auto meshObjects = localModel->GetMeshObjects();
+		while (meshObjects->MoveNext()) {
+			auto meshObject = meshObjects->GetCurrentMeshObject();
+			nVertexCount += meshObject->GetVertexCount();
+			nTriangleCount += meshObject->GetTriangleCount();
+		}
+
+		auto readStatistics = reader->GetStatistics();
+		EXPECT_EQ(readStatistics->GetCounter(eStatisticsCounter::Nodes), nVertexCount);
+		EXPECT_EQ(readStatistics->GetCounter(eStatisticsCounter::Triangles), nTriangleCount);
+		EXPECT_GT(readStatistics->GetCounter(eStatisticsCounter::PackageBytes), (Lib3MF_uint64)0);
+		EXPECT_GT(readStatistics->GetCounter(eStatisticsCounter::XMLBytes), (Lib3MF_uint64)0);
+		EXPECT_EQ(readStatistics->GetCounter(eStatisticsCounter::ProgressCallbacks), (Lib3MF_uint64)0);
+
+		// The phases are exclusive and add up to the total
+		double dPhaseSum = 0.0;
+		for (int nPhase = (int)eProgressIdentifier::QUERYCANCELED; nPhase <= (int)eProgressIdentifier::WRITEKEYSTORE; nPhase++)
+			dPhaseSum += readStatistics->GetPhaseDuration((eProgressIdentifier)nPhase);
+		EXPECT_GT(readStatistics->GetTotalDuration(), 0.0);
+		EXPECT_NEAR(dPhaseSum, readStatistics->GetTotalDuration(), 1e-9);
+		EXPECT_GT(readStatistics->GetPhaseDuration(eProgressIdentifier::READROOTMODEL), 0.0);
+		EXPECT_EQ(readStatistics->GetPhaseDuration(eProgressIdentifier::WRITEROOTMODEL), 0.0);
+
+		std::vector<Lib3MF_uint8> buffer;
+		writer3MF->SetProgressCallback(Callback_Positive, ProgressCallbackTest::m_spUserData);
+		writer3MF->WriteToBuffer(buffer);
+		auto writeStatistics = writer3MF->GetStatistics();
+		EXPECT_EQ(writeStatistics->GetCounter(eStatisticsCounter::PackageBytes), (Lib3MF_uint64)buffer.size());
+		EXPECT_EQ(writeStatistics->GetCounter(eStatisticsCounter::Nodes), nVertexCount);
+		EXPECT_EQ(writeStatistics->GetCounter(eStatisticsCounter::Triangles), nTriangleCount);
+		EXPECT_GT(writeStatistics->GetCounter(eStatisticsCounter::ProgressCallbacks), (Lib3MF_uint64)0);
+		EXPECT_GT(writeStatistics->GetPhaseDuration(eProgressIdentifier::WRITEROOTMODEL), 0.0);
+		EXPECT_NE(writeStatistics->GetSummary().find("Writing root model"), std::string::npos);
+
+		// Statistics are snapshots, the reader's are unchanged by the write
+		EXPECT_EQ(reader->GetStatistics()->GetCounter(eStatisticsCounter::Nodes), nVertexCount);
+	}
+
 
 }
@@ -292,6 +292,80 @@ namespace Lib3MF
 		}
 	}
 
+	TEST_F(Properties, GetAllTriangleColors)
+	{
+		auto colorGroup = model->AddColorGroup();
+		auto red = colorGroup->AddColor(wrapper->RGBAToColor(255, 0, 0, 255));
+		auto blue = colorGroup->AddColor(wrapper->RGBAToColor(0, 0, 255, 51));
+		auto baseMaterialGroup = model->AddBaseMaterialGroup();
+		auto material = baseMaterialGroup->AddMaterial("SomeMaterial", wrapper->RGBAToColor(0, 102, 0, 255));
+
+		Lib3MF_uint32 nTriangleCount = mesh->GetTriangleCount();
+		std::vector<sTriangleProperties> properties(nTriangleCount);
+		for (Lib3MF_uint32 i = 0; i < nTriangleCount; i++) {
+			if (i % 3 == 0) {
+				properties[i].m_ResourceID = colorGroup->GetResourceID();
+				properties[i].m_PropertyIDs[0] = red;
+				properties[i].m_PropertyIDs[1] = blue;
+				properties[i].m_PropertyIDs[2] = red;
+			}
+			else if (i % 3 == 1) {
+				properties[i].m_ResourceID = baseMaterialGroup->GetResourceID();
+				properties[i].m_PropertyIDs[0] = material;
+				properties[i].m_PropertyIDs[1] = material;
+				properties[i].m_PropertyIDs[2] = material;
+			}
+			else {
+				properties[i].m_ResourceID = 0;
+				properties[i].m_PropertyIDs[0] = 0;
+				properties[i].m_PropertyIDs[1] = 0;
+				properties[i].m_PropertyIDs[2] = 0;
+			}
+		}
+		mesh->SetAllTriangleProperties(properties);
+		mesh->SetObjectLevelProperty(colorGroup->GetResourceID(), blue);
+
+		std::vector<Lib3MF_single> rgbaValues;
+		std::vector<Lib3MF_uint32> resourceIDs;
+		mesh->GetAllTriangleColors(rgbaValues, resourceIDs);
+		ASSERT_EQ(rgbaValues.size(), 12 * nTriangleCount);
+		ASSERT_EQ(resourceIDs.size(), nTriangleCount);
+
+		for (Lib3MF_uint32 i = 0; i < nTriangleCount; i++) {
+			const Lib3MF_single * pRGBA = &rgbaValues[i * 12];
+			if (i % 3 == 0) {
+				EXPECT_EQ(resourceIDs[i], colorGroup->GetResourceID());
+				EXPECT_FLOAT_EQ(pRGBA[0], 1.0f);
+				EXPECT_FLOAT_EQ(pRGBA[6], 1.0f);
+				EXPECT_FLOAT_EQ(pRGBA[7], 0.2f);
+				EXPECT_FLOAT_EQ(pRGBA[8], 1.0f);
+			}
+			else if (i % 3 == 1) {
+				EXPECT_EQ(resourceIDs[i], baseMaterialGroup->GetResourceID());
+				for (int j = 0; j < 3; j++) {
+					EXPECT_FLOAT_EQ(pRGBA[j * 4 + 0], 0.0f);
+					EXPECT_FLOAT_EQ(pRGBA[j * 4 + 1], 0.4f);
+					EXPECT_FLOAT_EQ(pRGBA[j * 4 + 3], 1.0f);
+				}
+			}
+			else {
+				// object-level property
+				EXPECT_EQ(resourceIDs[i], colorGroup->GetResourceID());
+				for (int j = 0; j < 3; j++) {
+					EXPECT_FLOAT_EQ(pRGBA[j * 4 + 2], 1.0f);
+					EXPECT_FLOAT_EQ(pRGBA[j * 4 + 3], 0.2f);
+				}
+			}
+		}
+
+		std::vector<Lib3MF_double> uvValues;
+		mesh->GetAllTriangleTex2Coords(uvValues, resourceIDs);
+		ASSERT_EQ(uvValues.size(), 6 * nTriangleCount);
+		for (Lib3MF_uint32 i = 0; i < nTriangleCount; i++) {
+			EXPECT_EQ(resourceIDs[i], 0);
+		}
+	}
+
 	TEST_F(Properties, WriteMeshWithoutProperties)
 	{
 		auto writer = model->QueryWriter("3mf");
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <mutex>
 
 namespace Lib3MF {
 
@@ -178,6 +179,70 @@ namespace Lib3MF {
 			}
 		}
 
+		static void inPlaceDEKCallback(
+			Lib3MF_ContentEncryptionParams params,
+			Lib3MF_uint64 inSize,
+			const Lib3MF_uint8 * inBuffer,
+			const Lib3MF_uint64 outSize,
+			Lib3MF_uint64 * outNeededSize,
+			Lib3MF_uint8 * outBuffer,
+			Lib3MF_pvoid userData,
+			Lib3MF_uint64 * status) {
+			if (0 != inSize && nullptr != inBuffer && nullptr != outBuffer)
+				ASSERT_EQ(inBuffer, outBuffer);
+			testDEKCallback(params, inSize, inBuffer, outSize, outNeededSize, outBuffer, userData, status);
+		}
+
+		static void lockedDEKCallback(
+			Lib3MF_ContentEncryptionParams params,
+			Lib3MF_uint64 inSize,
+			const Lib3MF_uint8 * inBuffer,
+			const Lib3MF_uint64 outSize,
+			Lib3MF_uint64 * outNeededSize,
+			Lib3MF_uint8 * outBuffer,
+			Lib3MF_pvoid userData,
+			Lib3MF_uint64 * status) {
+			static std::mutex callbackMutex;
+			std::lock_guard<std::mutex> lock(callbackMutex);
+			testDEKCallback(params, inSize, inBuffer, outSize, outNeededSize, outBuffer, userData, status);
+		}
+
+		// Writes a model whose mesh objects each live in their own encrypted part
+		void writeMultiPartEncryptedModel(Lib3MF_uint32 nPartCount, bool compressed, std::vector<Lib3MF_uint8> & buffer) {
+			PModel multiPartModel = wrapper->CreateModel();
+			multiPartModel->SetRandomNumberCallback(notRandomBytesAtAll, nullptr);
+			auto keyStore = multiPartModel->GetKeyStore();
+			auto consumer = keyStore->AddConsumer("LIB3MF#TEST", "contentKey", publicKey);
+			auto rdGroup = keyStore->AddResourceDataGroup();
+			rdGroup->AddAccessRight(consumer.get(), eWrappingAlgorithm::RSA_OAEP, eMgfAlgorithm::MGF1_SHA1, eDigestMethod::SHA1);
+			std::vector<Lib3MF_uint8> aad = { 'l', 'i', 'b', '3', 'm', 'f' };
+
+			for (Lib3MF_uint32 nPart = 0; nPart < nPartCount; nPart++) {
+				std::vector<sPosition> vertices(pVertices, pVertices + 8);
+				for (auto & vertex : vertices)
+					vertex.m_Coordinates[2] += (Lib3MF_single)nPart;
+
+				auto meshObject = multiPartModel->AddMeshObject();
+				meshObject->SetGeometry(vertices, CLib3MFInputVector<sTriangle>(pTriangles, 12));
+				auto part = multiPartModel->FindOrCreatePackagePart("/3D/part" + std::to_string(nPart) + ".model");
+				meshObject->SetPackagePart(part.get());
+				multiPartModel->AddBuildItem(meshObject.get(), wrapper->GetIdentityTransform());
+
+				keyStore->AddResourceData(rdGroup.get(), part.get(), eEncryptionAlgorithm::AES256_GCM,
+					(compressed ? eCompression::Deflate : eCompression::NoCompression), aad);
+			}
+
+			PWriter writer = multiPartModel->QueryWriter("3mf");
+			DEKCallbackData contentData;
+			writer->SetContentEncryptionCallback(testDEKCallback, (Lib3MF_pvoid)&contentData);
+			KEKCallbackData wrappingData;
+			wrappingData.value = 1;
+			wrappingData.consumerId = "LIB3MF#TEST";
+			wrappingData.keyId = "contentKey";
+			writer->AddKeyWrappingCallback(wrappingData.consumerId, testKEKCallback, (Lib3MF_pvoid)&wrappingData);
+			writer->WriteToBuffer(buffer);
+		}
+
 		void generateTestFiles(bool compressed, std::string const & fileName) {
 			std::vector<Lib3MF_uint8> buffer;
 			{
@@ -558,6 +623,74 @@ namespace Lib3MF {
 		ASSERT_GE(data.context.begin()->second, 1);
 	}
 
+	TEST_F(SecureContentT, InPlaceDecryptionReadTest) {
+		auto reader = model->QueryReader("3mf");
+		DEKCallbackData data;
+		reader->SetInPlaceDecryption(true);
+		reader->SetContentEncryptionCallback(inPlaceDEKCallback, (Lib3MF_pvoid)&data);
+		reader->ReadFromFile(sTestFilesPath + UNENCRYPTEDCOMPRESSEDKEYSTORE);
+		ASSERT_EQ(data.context.size(), 1);
+		ASSERT_GE(data.context.begin()->second, 1);
+
+		PModel referenceModel = wrapper->CreateModel();
+		auto referenceReader = referenceModel->QueryReader("3mf");
+		DEKCallbackData referenceData;
+		referenceReader->SetContentEncryptionCallback(testDEKCallback, (Lib3MF_pvoid)&referenceData);
+		referenceReader->ReadFromFile(sTestFilesPath + UNENCRYPTEDCOMPRESSEDKEYSTORE);
+
+		auto meshObjects = model->GetMeshObjects();
+		auto referenceMeshObjects = referenceModel->GetMeshObjects();
+		ASSERT_EQ(meshObjects->Count(), referenceMeshObjects->Count());
+		while (meshObjects->MoveNext() && referenceMeshObjects->MoveNext()) {
+			ASSERT_EQ(meshObjects->GetCurrentMeshObject()->GetVertexCount(), referenceMeshObjects->GetCurrentMeshObject()->GetVertexCount());
+			ASSERT_EQ(meshObjects->GetCurrentMeshObject()->GetTriangleCount(), referenceMeshObjects->GetCurrentMeshObject()->GetTriangleCount());
+		}
+	}
+
+	TEST_F(SecureContentT, ParallelDecryptionReadTest) {
+		const Lib3MF_uint32 nPartCount = 16;
+		for (bool compressed : { false, true }) {
+			std::vector<Lib3MF_uint8> buffer;
+			writeMultiPartEncryptedModel(nPartCount, compressed, buffer);
+
+			PModel parallelModel = wrapper->CreateModel();
+			auto reader = parallelModel->QueryReader("3mf");
+			ASSERT_EQ(reader->GetDecryptionThreadCount(), 0);
+			reader->SetDecryptionThreadCount(4);
+			ASSERT_EQ(reader->GetDecryptionThreadCount(), 4);
+			DEKCallbackData data;
+			reader->SetContentEncryptionCallback(lockedDEKCallback, (Lib3MF_pvoid)&data);
+			reader->ReadFromBuffer(buffer);
+			ASSERT_EQ(data.context.size(), nPartCount);
+
+			PModel serialModel = wrapper->CreateModel();
+			auto serialReader = serialModel->QueryReader("3mf");
+			DEKCallbackData serialData;
+			serialReader->SetContentEncryptionCallback(testDEKCallback, (Lib3MF_pvoid)&serialData);
+			serialReader->ReadFromBuffer(buffer);
+			ASSERT_EQ(serialData.context.size(), data.context.size());
+			for (auto & callCount : data.context)
+				ASSERT_EQ(callCount.second, serialData.context.begin()->second);
+
+			auto meshObjects = parallelModel->GetMeshObjects();
+			auto serialMeshObjects = serialModel->GetMeshObjects();
+			ASSERT_EQ(meshObjects->Count(), nPartCount);
+			ASSERT_EQ(meshObjects->Count(), serialMeshObjects->Count());
+			while (meshObjects->MoveNext() && serialMeshObjects->MoveNext()) {
+				auto meshObject = meshObjects->GetCurrentMeshObject();
+				auto serialMeshObject = serialMeshObjects->GetCurrentMeshObject();
+				ASSERT_EQ(meshObject->PackagePart()->GetPath(), serialMeshObject->PackagePart()->GetPath());
+				std::vector<sPosition> vertices, serialVertices;
+				meshObject->GetVertices(vertices);
+				serialMeshObject->GetVertices(serialVertices);
+				ASSERT_EQ(vertices.size(), serialVertices.size());
+				for (size_t i = 0; i < vertices.size(); i++)
+					for (int j = 0; j < 3; j++)
+						ASSERT_EQ(vertices[i].m_Coordinates[j], serialVertices[i].m_Coordinates[j]);
+			}
+		}
+	}
+
 	TEST_F(SecureContentT, DEKWriteTest) {
 		readUnencryptedKeyStore();
 		auto writer = model->QueryWriter("3mf");
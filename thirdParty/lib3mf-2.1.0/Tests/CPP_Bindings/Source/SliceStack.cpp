@@ -125,6 +125,99 @@ namespace Lib3MF
 		auto sliceAB1 = stack->GetSlice(0);
 	}
 
+	// Signed area of a closed slice polygon, positive for counterclockwise polygons
+	double SlicePolygonArea(PSlice slice, Lib3MF_uint64 nPolygon)
+	{
+		std::vector<sPosition2D> vVertices;
+		std::vector<Lib3MF_uint32> vIndices;
+		slice->GetVertices(vVertices);
+		slice->GetPolygonIndices(nPolygon, vIndices);
+		EXPECT_EQ(vIndices.front(), vIndices.back());
+
+		double dArea = 0.0;
+		for (size_t i = 0; i + 1 < vIndices.size(); i++) {
+			const sPosition2D & a = vVertices[vIndices[i]];
+			const sPosition2D & b = vVertices[vIndices[i + 1]];
+			dArea += 0.5 * ((double)a.m_Coordinates[0] * b.m_Coordinates[1] - (double)b.m_Coordinates[0] * a.m_Coordinates[1]);
+		}
+		return dArea;
+	}
+
+	TEST_F(SliceStack, GenerateFromMeshObject)
+	{
+		std::vector<sPosition> vVertices;
+		std::vector<sTriangle> vTriangles;
+		fnCreateBox(vVertices, vTriangles);
+		mesh->SetGeometry(vVertices, vTriangles);
+
+		auto stack = model->AddSliceStackFromMeshObject(mesh.get(), 10.0);
+		ASSERT_DOUBLE_EQ(stack->GetBottomZ(), 0.0);
+		ASSERT_EQ(stack->GetSliceCount(), 10);
+		for (Lib3MF_uint64 iSlice = 0; iSlice < stack->GetSliceCount(); iSlice++) {
+			auto slice = stack->GetSlice(iSlice);
+			ASSERT_DOUBLE_EQ(slice->GetZTop(), 10.0 * (iSlice + 1));
+			ASSERT_EQ(slice->GetPolygonCount(), 1);
+			ASSERT_NEAR(SlicePolygonArea(slice, 0), 100.0 * 100.0, 1e-2);
+		}
+
+		ASSERT_SPECIFIC_THROW(model->AddSliceStackFromMeshObject(mesh.get(), 0.0), ELib3MFException);
+
+		// Nodes on a plane count as above it: the bottom face does not touch the plane at 0,
+		// the side faces reach up to the plane at 100
+		std::vector<double> vZValues = { 0.0, 50.0, 100.0, 150.0 };
+		auto stackAtHeights = model->AddSliceStackFromMeshObjectAtHeights(mesh.get(), -1.0, vZValues);
+		ASSERT_EQ(stackAtHeights->GetSliceCount(), 4);
+		ASSERT_EQ(stackAtHeights->GetSlice(0)->GetPolygonCount(), 0);
+		ASSERT_EQ(stackAtHeights->GetSlice(1)->GetPolygonCount(), 1);
+		ASSERT_NEAR(SlicePolygonArea(stackAtHeights->GetSlice(1), 0), 100.0 * 100.0, 1e-2);
+		ASSERT_EQ(stackAtHeights->GetSlice(2)->GetPolygonCount(), 1);
+		ASSERT_EQ(stackAtHeights->GetSlice(3)->GetPolygonCount(), 0);
+
+		std::vector<double> vDecreasingZValues = { 50.0, 10.0 };
+		ASSERT_SPECIFIC_THROW(model->AddSliceStackFromMeshObjectAtHeights(mesh.get(), 0.0, vDecreasingZValues), ELib3MFException);
+
+		// Two boxes give two polygons per slice
+		std::vector<sPosition> vTwoBoxVertices = vVertices;
+		std::vector<sTriangle> vTwoBoxTriangles = vTriangles;
+		for (auto vertex : vVertices) {
+			vertex.m_Coordinates[0] += 200.0f;
+			vTwoBoxVertices.push_back(vertex);
+		}
+		for (auto triangle : vTriangles) {
+			for (int j = 0; j < 3; j++)
+				triangle.m_Indices[j] += (Lib3MF_uint32)vVertices.size();
+			vTwoBoxTriangles.push_back(triangle);
+		}
+		auto twoBoxes = model->AddMeshObject();
+		twoBoxes->SetGeometry(vTwoBoxVertices, vTwoBoxTriangles);
+		auto twoBoxStack = model->AddSliceStackFromMeshObject(twoBoxes.get(), 25.0);
+		ASSERT_EQ(twoBoxStack->GetSliceCount(), 4);
+		for (Lib3MF_uint64 iSlice = 0; iSlice < twoBoxStack->GetSliceCount(); iSlice++) {
+			auto slice = twoBoxStack->GetSlice(iSlice);
+			ASSERT_EQ(slice->GetPolygonCount(), 2);
+			ASSERT_NEAR(SlicePolygonArea(slice, 0), 100.0 * 100.0, 1e-2);
+			ASSERT_NEAR(SlicePolygonArea(slice, 1), 100.0 * 100.0, 1e-2);
+		}
+
+		// The generated slicestack can be assigned and written
+		twoBoxes->AssignSliceStack(twoBoxStack.get());
+		std::vector<Lib3MF_uint8> buffer;
+		model->QueryWriter("3mf")->WriteToBuffer(buffer);
+		auto readModel = wrapper->CreateModel();
+		readModel->QueryReader("3mf")->ReadFromBuffer(buffer);
+		auto readMeshObjects = readModel->GetMeshObjects();
+		Lib3MF_uint32 nSlicedObjects = 0;
+		while (readMeshObjects->MoveNext()) {
+			auto readMeshObject = readMeshObjects->GetCurrentMeshObject();
+			if (readMeshObject->GetTriangleCount() == vTwoBoxTriangles.size()) {
+				ASSERT_TRUE(readMeshObject->HasSlices(false));
+				ASSERT_EQ(readMeshObject->GetSliceStack()->GetSliceCount(), 4);
+				nSlicedObjects++;
+			}
+		}
+		ASSERT_EQ(nSlicedObjects, 1);
+	}
+
 
 	class SliceStackArrangement : public ::testing::Test {
 	protected:
@@ -395,6 +488,90 @@ namespace Lib3MF
 		checkSliceModels(readModel, readModelAgain);
 	}
 
+	TEST_F(SliceStackWriting, ReadSlicesInParallel)
+	{
+		auto stack1 = model->AddSliceStack(0);
+		auto stack2 = model->AddSliceStack(0.1 * 125);
+		stack1->SetOwnPath("/2D/parallel.model");
+		stack2->SetOwnPath("/2D/parallel.model");
+
+		// more slices than fit into one chunk, with varying polygon layouts
+		for (Lib3MF_uint32 iSlice = 0; iSlice < 250; iSlice++) {
+			auto stack = (iSlice < 125) ? stack1 : stack2;
+			auto slice = stack->AddSlice(0.1 * (iSlice + 1));
+			if (iSlice % 7 == 3)
+				continue;
+
+			Lib3MF_uint32 nPolygons = 1 + iSlice % 3;
+			std::vector<sPosition2D> vVertices;
+			for (Lib3MF_uint32 iVertex = 0; iVertex < 4 * nPolygons; iVertex++) {
+				sPosition2D pos;
+				pos.m_Coordinates[0] = (float)(iVertex % 2 + iSlice);
+				pos.m_Coordinates[1] = (float)(iVertex / 2);
+				vVertices.push_back(pos);
+			}
+			slice->SetVertices(vVertices);
+			for (Lib3MF_uint32 iPolygon = 0; iPolygon < nPolygons; iPolygon++) {
+				std::vector<Lib3MF_uint32> vPolygon = { 4 * iPolygon, 4 * iPolygon + 1, 4 * iPolygon + 3, 4 * iPolygon + 2 };
+				if (iPolygon % 2 == 0)
+					vPolygon.push_back(4 * iPolygon);
+				slice->AddPolygon(vPolygon);
+			}
+		}
+		auto stack3 = model->AddSliceStack(0);
+		stack3->AddSliceStackReference(stack1.get());
+		stack3->AddSliceStackReference(stack2.get());
+
+		std::vector<Lib3MF_uint8> buffer;
+		writer->WriteToBuffer(buffer);
+
+		auto serialModel = wrapper->CreateModel();
+		auto serialReader = serialModel->QueryReader("3mf");
+		serialReader->ReadFromBuffer(buffer);
+
+		auto parallelModel = wrapper->CreateModel();
+		auto reader = parallelModel->QueryReader("3mf");
+		ASSERT_EQ(reader->GetSliceThreadCount(), 0);
+		reader->SetSliceThreadCount(4);
+		ASSERT_EQ(reader->GetSliceThreadCount(), 4);
+		reader->ReadFromBuffer(buffer);
+		ASSERT_EQ(reader->GetWarningCount(), serialReader->GetWarningCount());
+
+		checkSliceModels(serialModel, parallelModel);
+
+		auto serialStacks = serialModel->GetSliceStacks();
+		auto parallelStacks = parallelModel->GetSliceStacks();
+		ASSERT_EQ(serialStacks->Count(), 4);
+		while (serialStacks->MoveNext()) {
+			ASSERT_TRUE(parallelStacks->MoveNext());
+			auto serialStack = serialStacks->GetCurrentSliceStack();
+			auto parallelStack = parallelStacks->GetCurrentSliceStack();
+			ASSERT_EQ(serialStack->GetSliceCount(), parallelStack->GetSliceCount());
+			for (Lib3MF_uint64 iSlice = 0; iSlice < serialStack->GetSliceCount(); iSlice++) {
+				auto serialSlice = serialStack->GetSlice(iSlice);
+				auto parallelSlice = parallelStack->GetSlice(iSlice);
+				ASSERT_DOUBLE_EQ(serialSlice->GetZTop(), parallelSlice->GetZTop());
+
+				std::vector<sPosition2D> vSerialVertices, vParallelVertices;
+				serialSlice->GetVertices(vSerialVertices);
+				parallelSlice->GetVertices(vParallelVertices);
+				ASSERT_EQ(vSerialVertices.size(), vParallelVertices.size());
+				for (size_t iVertex = 0; iVertex < vSerialVertices.size(); iVertex++) {
+					ASSERT_EQ(vSerialVertices[iVertex].m_Coordinates[0], vParallelVertices[iVertex].m_Coordinates[0]);
+					ASSERT_EQ(vSerialVertices[iVertex].m_Coordinates[1], vParallelVertices[iVertex].m_Coordinates[1]);
+				}
+
+				ASSERT_EQ(serialSlice->GetPolygonCount(), parallelSlice->GetPolygonCount());
+				for (Lib3MF_uint64 iPolygon = 0; iPolygon < serialSlice->GetPolygonCount(); iPolygon++) {
+					std::vector<Lib3MF_uint32> vSerialIndices, vParallelIndices;
+					serialSlice->GetPolygonIndices(iPolygon, vSerialIndices);
+					parallelSlice->GetPolygonIndices(iPolygon, vParallelIndices);
+					ASSERT_EQ(vSerialIndices, vParallelIndices);
+				}
+			}
+		}
+	}
+
 
 
 	class SliceStackReading : public ::testing::Test {
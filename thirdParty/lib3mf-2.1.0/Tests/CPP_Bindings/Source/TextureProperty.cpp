@@ -148,5 +148,70 @@ namespace Lib3MF
 		}
 		ASSERT_EQ(texture2DGroupCount, 1);
 	}
-	
+
+	TEST_F(TextureProperty, AddGetTex2Coords)
+	{
+		auto texture2DGroup = model->AddTexture2DGroup(texture2D.get());
+		Lib3MF_uint64 nTriangleCount = mesh->GetTriangleCount();
+
+		std::vector<sTex2Coord> coords;
+		for (Lib3MF_uint64 i = 0; i < nTriangleCount; i++) {
+			coords.push_back({ 1.0*i / nTriangleCount, 1.0 - 1.0*i / nTriangleCount });
+			coords.push_back({ 1.0*(i + 1) / nTriangleCount, 1.0 - 1.0*i / nTriangleCount });
+			coords.push_back({ 1.0*i / nTriangleCount, 1.0 - 1.0*(i + 1) / nTriangleCount });
+		}
+		Lib3MF_uint32 nFirstPropertyID = texture2DGroup->AddTex2Coords(coords);
+		ASSERT_EQ(texture2DGroup->GetCount(), coords.size());
+
+		std::vector<sTriangleProperties> properties(nTriangleCount);
+		for (Lib3MF_uint64 i = 0; i < nTriangleCount; i++) {
+			properties[i].m_ResourceID = texture2DGroup->GetResourceID();
+			for (Lib3MF_uint64 j = 0; j < 3; j++) {
+				properties[i].m_PropertyIDs[j] = nFirstPropertyID + Lib3MF_uint32(3 * i + j);
+			}
+		}
+		mesh->SetAllTriangleProperties(properties);
+
+		std::vector<sTex2Coord> obtainedCoords;
+		texture2DGroup->GetTex2Coords(obtainedCoords);
+		ASSERT_EQ(obtainedCoords.size(), coords.size());
+		for (size_t i = 0; i < coords.size(); i++) {
+			EXPECT_DOUBLE_EQ(obtainedCoords[i].m_U, coords[i].m_U);
+			EXPECT_DOUBLE_EQ(obtainedCoords[i].m_V, coords[i].m_V);
+			sTex2Coord uvcoord = texture2DGroup->GetTex2Coord(nFirstPropertyID + Lib3MF_uint32(i));
+			EXPECT_DOUBLE_EQ(uvcoord.m_U, coords[i].m_U);
+			EXPECT_DOUBLE_EQ(uvcoord.m_V, coords[i].m_V);
+		}
+
+		std::vector<Lib3MF_double> uvValues;
+		std::vector<Lib3MF_uint32> resourceIDs;
+		mesh->GetAllTriangleTex2Coords(uvValues, resourceIDs);
+		ASSERT_EQ(uvValues.size(), 2 * coords.size());
+		for (Lib3MF_uint64 i = 0; i < nTriangleCount; i++) {
+			EXPECT_EQ(resourceIDs[i], texture2DGroup->GetResourceID());
+		}
+		for (size_t i = 0; i < coords.size(); i++) {
+			EXPECT_DOUBLE_EQ(uvValues[i * 2], coords[i].m_U);
+			EXPECT_DOUBLE_EQ(uvValues[i * 2 + 1], coords[i].m_V);
+		}
+
+		auto writer = model->QueryWriter("3mf");
+		std::vector<Lib3MF_uint8> buffer;
+		writer->WriteToBuffer(buffer);
+
+		auto readModel = wrapper->CreateModel();
+		auto reader = readModel->QueryReader("3mf");
+		reader->ReadFromBuffer(buffer);
+
+		auto iterator = readModel->GetTexture2DGroups();
+		ASSERT_TRUE(iterator->MoveNext());
+		std::vector<sTex2Coord> readCoords;
+		iterator->GetCurrentTexture2DGroup()->GetTex2Coords(readCoords);
+		ASSERT_EQ(readCoords.size(), coords.size());
+		for (size_t i = 0; i < coords.size(); i++) {
+			EXPECT_NEAR(readCoords[i].m_U, coords[i].m_U, 1e-6);
+			EXPECT_NEAR(readCoords[i].m_V, coords[i].m_V, 1e-6);
+		}
+	}
+
 }
@@ -107,6 +107,33 @@ namespace Lib3MF
 		auto model = wrapper->CreateModel();
 	}
 
+	TEST(Wrapper, RetrieveTrace)
+	{
+		wrapper->ClearTrace();
+
+		auto model = wrapper->CreateModel();
+		auto writer = model->QueryWriter("3mf");
+		std::vector<Lib3MF_uint8> buffer;
+		writer->WriteToBuffer(buffer);
+		auto reader = wrapper->CreateModel()->QueryReader("3mf");
+		reader->ReadFromBuffer(buffer);
+
+		std::string sTrace;
+		bool bIsEnabled = wrapper->RetrieveTrace(sTrace);
+		ASSERT_EQ(sTrace.find("{\"traceEvents\":["), 0);
+		if (bIsEnabled) {
+			ASSERT_NE(sTrace.find("\"name\":\"CModelReader_3MF::readStream\""), std::string::npos);
+			ASSERT_NE(sTrace.find("\"name\":\"CModelWriter_3MF::exportToStream\""), std::string::npos);
+		}
+		else {
+			ASSERT_EQ(sTrace.find("\"ph\""), std::string::npos);
+		}
+
+		wrapper->ClearTrace();
+		wrapper->RetrieveTrace(sTrace);
+		ASSERT_EQ(sTrace.find("\"ph\""), std::string::npos);
+	}
+
 	TEST(Wrapper, CheckError)
 	{
 		wrapper->CheckError(nullptr, 0);
@@ -154,6 +154,73 @@ namespace Lib3MF
 		ASSERT_TRUE(buffer.size() < bufferLargr.size());
 	}
 
+	TEST_F(Writer, 3MFOptimizeMeshLayout)
+	{
+		auto mesh = model->AddMeshObject();
+		mesh->SetGeometry(CLib3MFInputVector<sPosition>(pVertices, 8), CLib3MFInputVector<sTriangle>(pTriangles, 12));
+
+		ASSERT_FALSE(writer3MF->GetOptimizeMeshLayout());
+		writer3MF->SetOptimizeMeshLayout(true);
+		ASSERT_TRUE(writer3MF->GetOptimizeMeshLayout());
+
+		std::vector<Lib3MF_uint8> buffer;
+		writer3MF->WriteToBuffer(buffer);
+		ASSERT_EQ(mesh->GetVertexCount(), 8);
+		ASSERT_EQ(mesh->GetTriangleCount(), 12);
+		ASSERT_TRUE(mesh->IsManifoldAndOriented());
+
+		auto readModel = wrapper->CreateModel();
+		readModel->QueryReader("3mf")->ReadFromBuffer(buffer);
+		auto meshObjects = readModel->GetMeshObjects();
+		Lib3MF_uint32 nTriangleCount = 0;
+		while (meshObjects->MoveNext())
+			nTriangleCount += meshObjects->GetCurrentMeshObject()->GetTriangleCount();
+
+		Lib3MF_uint32 nExpectedTriangleCount = 0;
+		meshObjects = model->GetMeshObjects();
+		while (meshObjects->MoveNext())
+			nExpectedTriangleCount += meshObjects->GetCurrentMeshObject()->GetTriangleCount();
+		ASSERT_EQ(nTriangleCount, nExpectedTriangleCount);
+	}
+
+	TEST_F(Writer, 3MFCompressionThreads)
+	{
+		const std::string sRelationshipType = "http://schemas.custom.com/attachment";
+		for (int nAttachment = 0; nAttachment < 6; nAttachment++) {
+			std::string sPayload;
+			for (int nLine = 0; nLine < 2000 * (nAttachment + 1); nLine++)
+				sPayload += "<line index=\"" + std::to_string(nLine) + "\" value=\"" + std::to_string(nLine * nAttachment) + "\"/>\n";
+			auto attachment = model->AddAttachment("/Metadata/attachment" + std::to_string(nAttachment) + ".xml", sRelationshipType);
+			attachment->ReadFromBuffer(CInputVector<Lib3MF_uint8>((const Lib3MF_uint8*)sPayload.data(), sPayload.size()));
+		}
+
+		std::vector<Lib3MF_uint8> serialBuffer;
+		writer3MF->WriteToBuffer(serialBuffer);
+
+		ASSERT_EQ(writer3MF->GetCompressionThreadCount(), 0);
+		writer3MF->SetCompressionThreadCount(4);
+		ASSERT_EQ(writer3MF->GetCompressionThreadCount(), 4);
+		std::vector<Lib3MF_uint8> parallelBuffer;
+		writer3MF->WriteToBuffer(parallelBuffer);
+
+		// The package does not depend on the number of threads
+		ASSERT_EQ(serialBuffer, parallelBuffer);
+
+		auto readModel = wrapper->CreateModel();
+		auto reader = readModel->QueryReader("3mf");
+		reader->AddRelationToRead(sRelationshipType);
+		reader->ReadFromBuffer(parallelBuffer);
+		ASSERT_EQ(readModel->GetAttachmentCount(), model->GetAttachmentCount());
+		for (Lib3MF_uint32 nIndex = 0; nIndex < model->GetAttachmentCount(); nIndex++) {
+			auto attachment = model->GetAttachment(nIndex);
+			auto readAttachment = readModel->FindAttachment(attachment->GetPath());
+			std::vector<Lib3MF_uint8> expected, actual;
+			attachment->WriteToBuffer(expected);
+			readAttachment->WriteToBuffer(actual);
+			ASSERT_EQ(expected, actual);
+		}
+	}
+
 	TEST_F(Writer, STLCompare)
 	{
 		// This test is atleast functional